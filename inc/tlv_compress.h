@@ -0,0 +1,59 @@
+/**
+ * @file tlv_compress.h
+ * @brief TLV FRAM存储系统数据块压缩（LZSS）
+ *
+ * 压缩数据格式：
+ *   [原始长度 uint16 小端] 之后按组排列,每组以1字节标志开头（低位在前,1为匹配,0为字面量）,
+ *   其后最多8项：字面量1字节；匹配2字节 [距离-1] [长度-TLV_LZ_MIN_MATCH]
+ * 匹配距离不超过TLV_LZ_WINDOW_SIZE,解压只需保留该长度的历史数据
+ */
+
+#ifndef TLV_COMPRESS_H
+#define TLV_COMPRESS_H
+
+#include "tlv_config.h"
+#include "tlv_types.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ============================ 压缩 ============================ */
+
+/**
+ * @brief 压缩数据
+ * @param src 原始数据
+ * @param src_len 原始数据长度
+ * @param dst 输出缓冲区（不能与src重叠）
+ * @param dst_cap 输出缓冲区容量
+ * @return 压缩后长度, 0表示输出超过dst_cap（调用者按原始数据存储）
+ */
+uint16_t tlv_lz_encode(const void *src, uint16_t src_len, void *dst, uint16_t dst_cap);
+
+/* ============================ 解压 ============================ */
+
+/**
+ * @brief 初始化解压状态
+ * @param dec 解压状态
+ * @param window 历史窗口（TLV_LZ_WINDOW_SIZE字节）,NULL表示输出缓冲区保存全部已解压数据
+ */
+void tlv_lz_decoder_init(tlv_lz_decoder_t *dec, uint8_t *window);
+
+/**
+ * @brief 分段解压
+ * @param dec 解压状态
+ * @param in 压缩数据
+ * @param in_len 压缩数据长度
+ * @param consumed 输出本次消费的压缩数据字节数（末尾不完整的匹配项不消费,调用者从该位置续传）
+ * @param out 输出缓冲区：window为NULL时为完整输出缓冲区起点（从已输出位置续写）,否则为本次输出起点
+ * @param out_len 输出缓冲区容量：window为NULL时为完整缓冲区容量,否则为本次最多输出字节数
+ * @param produced 输出本次解压的字节数
+ * @return 0: 成功, TLV_ERROR_CORRUPTED: 数据非法, TLV_ERROR_NO_BUFFER_MEMORY: 原始长度超过缓冲区容量
+ */
+int tlv_lz_decode(tlv_lz_decoder_t *dec, const void *in, uint16_t in_len, uint16_t *consumed,
+                  void *out, uint16_t out_len, uint16_t *produced);
+
+/**
+ * @brief 原始数据是否已全部解压
+ */
+bool tlv_lz_decode_done(const tlv_lz_decoder_t *dec);
+
+#endif /* TLV_COMPRESS_H */
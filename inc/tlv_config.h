@@ -14,17 +14,45 @@
 
 /* ============================ 基础配置 ============================ */
  
-/** FRAM总大小 */
+/** FRAM总大小（默认存储布局,tlv_format()使用；tlv_format_geometry()可按实际器件选择其他容量） */
+#ifndef TLV_FRAM_SIZE
 #define TLV_FRAM_SIZE                (128 * 1024)     // 128KB
+#endif
+
+/** 存储布局允许的最大FRAM容量（格式化时校验,移植层地址检查的上限） */
+#ifndef TLV_FRAM_MAX_SIZE
+#define TLV_FRAM_MAX_SIZE            TLV_FRAM_SIZE
+#endif
+
+/** 存储布局允许的最小FRAM容量 */
+#define TLV_FRAM_MIN_SIZE            (64 * 1024)
  
-/** 支持的最大Tag数量 */
+/** 支持的最大Tag数量（索引表常驻RAM,增大时需同步调整TLV_DATA_ADDR与TLV_INDEX_HASH_SIZE） */
+#ifndef TLV_MAX_TAG_COUNT
 #define TLV_MAX_TAG_COUNT            256       
+#endif
+
+/** 索引哈希表槽位数（2的幂,至少为Tag数量的2倍,保证负载因子<=50%） */
+#ifndef TLV_INDEX_HASH_SIZE
+#define TLV_INDEX_HASH_SIZE          512
+#endif
  
+/** 元数据表最大条目数（元数据表无序时用于构建排序查找表）*/
+#ifndef TLV_MAX_META_COUNT
+#define TLV_MAX_META_COUNT           TLV_MAX_TAG_COUNT
+#endif
+
 /** 使用CRC16 */
 #define TLV_USE_CRC16                1
  
-/** 不使用线程安全（裸机环境） */
+/**
+ * 线程安全（RTOS环境）：移植层提供读写锁与短临界区（见tlv_port.h）
+ * 读操作持共享锁可并发执行,写操作持独占锁；碎片整理与备份分段加锁,段间其他任务可继续访问
+ * 裸机环境保持为0,所有加锁操作编译为空
+ */
+#ifndef TLV_THREAD_SAFE
 #define TLV_THREAD_SAFE              0
+#endif
  
 /** 启用版本兼容迁移 */
 #define TLV_ENABLE_MIGRATION         1
@@ -35,28 +63,283 @@
 /** 启动时自动批量迁移（可选）*/
 #define TLV_AUTO_MIGRATE_ON_BOOT     0
 
-/** 使用碎片自动整理功能 */
+/**
+ * 写回模式（Write-Back）
+ * - 索引表只落盘发生变化的单个条目（8字节）及其所在页的CRC16,整表CRC延迟到tlv_flush()
+ * - Header中仅统计字段变化（total_writes、last_update_time）时合并到tlv_flush()再落盘,
+ *   空间布局字段（next_free_addr、used_space等）变化时仍立即落盘
+ * 掉电恢复：每个索引页有独立CRC,整表CRC失效但所有页CRC有效时仍视为索引有效；
+ *          页CRC未写完时逐条校验该页指向的数据块；启动时以索引为准修正Header中的
+ *          next_free_addr/tag_count。掉电只会丢失未flush的统计字段。
+ * 设为0时行为与旧版本一致（每次写入保存整个索引表与Header）
+ */
+#ifndef TLV_WRITE_BACK_MODE
+#define TLV_WRITE_BACK_MODE          1
+#endif
+
+/** 每个索引页包含的条目数（每页独立CRC16） */
+#ifndef TLV_INDEX_ENTRIES_PER_PAGE
+#define TLV_INDEX_ENTRIES_PER_PAGE   32
+#endif
+
+/** 使用碎片自动整理功能（写操作只调度,由空闲任务调用tlv_defrag_step执行） */
 #define TLV_AUTO_CLEAN_FRAGEMENT     1
 
-/** 触发碎片整理的百分比 */
-#define TLV_AUTO_DEFRAG_THRESHOLD    20
+/**
+ * GC触发策略：尾部连续可分配空间低于数据区的TLV_GC_HEADROOM_PERCENT,且可回收空间不少于TLV_GC_MIN_RECLAIM时触发；
+ * 分配在空洞与尾部均失败时另行触发。只比较Header中维护的空间字段,每次写入O(1)
+ */
+#ifndef TLV_GC_HEADROOM_PERCENT
+#define TLV_GC_HEADROOM_PERCENT      10
+#endif
+
+/** 余量触发所需的最少可回收字节数（回收量太少的整理不值得） */
+#ifndef TLV_GC_MIN_RECLAIM
+#define TLV_GC_MIN_RECLAIM           256
+#endif
+
+/** 旧策略兼容：定义时碎片化百分比达到该值也触发GC,不论余量（默认不定义） */
+/* #define TLV_AUTO_DEFRAG_THRESHOLD    20 */
+
+/** 线程安全模式下tlv_defragment()每个加锁段最多搬移的字节数 */
+#ifndef TLV_DEFRAG_SECTION_BYTES
+#define TLV_DEFRAG_SECTION_BYTES     512
+#endif
+
+/**
+ * 磨损均衡：Tag累计写入次数每达到TLV_WEAR_RELOCATE_WRITES的整数倍时,即使可原地覆盖也迁移到新地址
+ * 判断只使用块信息缓存中的write_count,不额外访问FRAM；迁移优先使用尾部空间,分配失败时退回原地更新
+ * 提交日志模式(TLV_JOURNAL_ENABLE)下写入本就总是换址,开启后到达间隔的写入改为优先从尾部分配
+ */
+#ifndef TLV_WEAR_LEVELING
+#define TLV_WEAR_LEVELING            0
+#endif
+
+/** 触发迁移的写入次数间隔（必须为2的幂）,累计写入次数不低于该值的Tag统计为热点Tag */
+#ifndef TLV_WEAR_RELOCATE_WRITES
+#define TLV_WEAR_RELOCATE_WRITES     1024
+#endif
+
+/**
+ * 后台巡检（tlv_scrub_step）：每轮最多记录的损坏Tag数,超出部分只计数
+ */
+#ifndef TLV_SCRUB_MAX_REPORT
+#define TLV_SCRUB_MAX_REPORT         8
+#endif
+
+/**
+ * 巡检发现损坏时自动修复：仅限backup_enable的Tag,用RAM缓存中的最新数据或与损坏块同一次写入的镜像副本重写
+ */
+#ifndef TLV_SCRUB_AUTO_REPAIR
+#define TLV_SCRUB_AUTO_REPAIR        1
+#endif
 
 /** 调试模式     */
 #define TLV_DEBUG                    0 
 
 /** 使用断言     */
 #define TLV_ENABLE_STATIC_ASSERT     1
+/* ============================ CRC16配置 ============================ */
+/** CRC16实现后端（结果与Modbus CRC16逐位一致） */
+#define TLV_CRC16_BACKEND_TABLE      0  // 逐字节查表（512字节表,默认）
+#define TLV_CRC16_BACKEND_SLICE4     1  // 切片查表,每次4字节（2KB表）
+#define TLV_CRC16_BACKEND_SLICE8     2  // 切片查表,每次8字节（4KB表）
+#define TLV_CRC16_BACKEND_PORT       3  // 移植层实现 tlv_port_crc16_update（硬件CRC/DMA）
+
+#ifndef TLV_CRC16_BACKEND
+#define TLV_CRC16_BACKEND            TLV_CRC16_BACKEND_TABLE
+#endif
+
+#if (TLV_CRC16_BACKEND < TLV_CRC16_BACKEND_TABLE) || (TLV_CRC16_BACKEND > TLV_CRC16_BACKEND_PORT)
+#error "TLV_CRC16_BACKEND invalid"
+#endif
+
 /* ============================ 内存配置 ============================ */
  
 /** 读写缓冲区大小（静态分配） */
 #define TLV_BUFFER_SIZE              512
+
+/**
+ * 数据块信息缓存（每个索引槽位缓存块长度与write_count）
+ * 写入、删除、获取长度时无需再读取旧块Header,读取时可一次传输整个块
+ * RAM占用：TLV_MAX_TAG_COUNT * sizeof(tlv_block_info_t)
+ */
+#ifndef TLV_BLOCK_INFO_CACHE
+#define TLV_BLOCK_INFO_CACHE         1
+#endif
+
+/**
+ * 热点小Tag的RAM缓存（写穿透）：元数据cache_enable为1且max_length不超过槽大小的Tag
+ * 读取命中时不访问FRAM,写入成功后同步更新,池满时淘汰最久未使用的槽
+ * RAM占用：TLV_RAM_CACHE_SLOTS * (TLV_RAM_CACHE_SLOT_SIZE + 8) 字节
+ */
+#ifndef TLV_RAM_CACHE_ENABLE
+#define TLV_RAM_CACHE_ENABLE         1
+#endif
+
+/** RAM缓存槽数量 */
+#ifndef TLV_RAM_CACHE_SLOTS
+#define TLV_RAM_CACHE_SLOTS          8
+#endif
+
+/** RAM缓存槽数据大小（可缓存的最大数据长度） */
+#ifndef TLV_RAM_CACHE_SLOT_SIZE
+#define TLV_RAM_CACHE_SLOT_SIZE      16
+#endif
+
+/**
+ * 范围读取（tlv_read_range）是否校验整块CRC
+ * 启用时每个数据块写入后首次范围读取校验一次整块,结果缓存在块信息缓存中直到下次写入；
+ * 未启用块信息缓存时每次范围读取都校验整块
+ */
+#ifndef TLV_READ_RANGE_VERIFY_CRC
+#define TLV_READ_RANGE_VERIFY_CRC    1
+#endif
+
+/**
+ * 空闲区段复用（最佳适配）：每次同步备份(tlv_backup_all)后由索引重建空闲区段表,
+ * 写入优先复用合适的空洞,释放的块与相邻空洞合并,紧邻尾部时直接退回next_free_addr
+ * 已提交块释放后在下次备份前暂不复用（备份区的索引仍可能指向它）,事务或分段写入中
+ * 尾部空间不足时使备份失效后复用；初始化后首次备份前只从尾部分配
+ * RAM占用：TLV_MAX_FREE_EXTENTS * 12 字节（事务快照中另有一份副本）
+ */
+#ifndef TLV_FREE_EXTENT_REUSE
+#define TLV_FREE_EXTENT_REUSE        1
+#endif
+
+/** 空闲区段表容量（表满时丢弃最小区段,留待碎片整理回收） */
+#ifndef TLV_MAX_FREE_EXTENTS
+#define TLV_MAX_FREE_EXTENTS         16
+#endif
+
+/**
+ * 数据块压缩（LZSS）：元数据compress_enable的Tag经tlv_write/tlv_txn_write写入时压缩到静态缓冲区,
+ * 压缩后更小才按压缩块存储；读取时透明解压（读取压缩块的能力始终编译,与此开关无关）。
+ * 流式写入与异步写入不压缩；流式读取压缩块时每个句柄另需TLV_LZ_WINDOW_SIZE字节历史窗口；
+ * 按范围读写不支持压缩块
+ */
+#ifndef TLV_COMPRESS_ENABLE
+#define TLV_COMPRESS_ENABLE          0
+#endif
+
+/** 参与压缩的最小数据长度（更短的数据压缩收益不足以抵消长度前缀与标志字节） */
+#ifndef TLV_COMPRESS_MIN_SIZE
+#define TLV_COMPRESS_MIN_SIZE        32
+#endif
+
+/**
+ * 读路径临时缓冲区大小（仅线程安全模式,位于调用栈上）
+ * 并发的读操作不能共用静态缓冲区：块传输合并与分批CRC校验改用该缓冲区,
+ * 整块不超过该大小时仍一次传输,否则按段分别传输
+ */
+#ifndef TLV_READ_SCRATCH_SIZE
+#define TLV_READ_SCRATCH_SIZE        64
+#endif
+
+/**
+ * 移植层是否实现分散/聚集接口 tlv_port_fram_writev/readv
+ * 块读写可合并为一次SPI传输（只发送一次命令与地址）；
+ * 为0时能放入静态缓冲区的块经缓冲区合并传输,否则按段分别传输
+ */
+#ifndef TLV_PORT_VECTOR_IO
+#define TLV_PORT_VECTOR_IO           0
+#endif
+
+/**
+ * 异步读写（tlv_read_async/tlv_write_async）：移植层实现DMA驱动的
+ * tlv_port_fram_read_async/write_async,传输期间CPU继续执行,由tlv_async_poll()推进并回调
+ */
+#ifndef TLV_ASYNC_ENABLE
+#define TLV_ASYNC_ENABLE             0
+#endif
+
+/**
+ * 异步传输完成的检测方式
+ * 0: 中断模式,DMA完成中断中调用传输完成回调
+ * 1: 轮询模式（无RTOS的裸机）,tlv_async_poll()调用tlv_port_fram_async_poll()检查DMA状态
+ */
+#ifndef TLV_PORT_ASYNC_POLL
+#define TLV_PORT_ASYNC_POLL          0
+#endif
+
+/**
+ * 双片FRAM组合端口（移植层示例 tlv_port_dual_fram_ops,使用前以tlv_bind_port()绑定）
+ * TLV_FRAM_SIZE为两片容量之和,逻辑地址低于TLV_FRAM_CHIP0_SIZE的部分位于片0,其余位于片1；
+ * 备份区位于地址空间末尾,因此与Header/索引区分处两片
+ */
+#ifndef TLV_PORT_DUAL_FRAM
+#define TLV_PORT_DUAL_FRAM           0
+#endif
+
+/** 片0容量（字节,须覆盖Header与索引区） */
+#ifndef TLV_FRAM_CHIP0_SIZE
+#define TLV_FRAM_CHIP0_SIZE          (TLV_FRAM_SIZE / 2)
+#endif
  
+/* ============================ 快速启动 ============================ */
+/**
+ * 快速启动：tlv_deinit()/tlv_flush()在Header中写入正常关机标记,
+ * 带标记启动时跳过索引整表CRC与逐页校验,索引页校验推迟到tlv_init_verify_step()
+ * 或首次修改操作之前；首次修改前清除FRAM中的标记（多一次Header写入）
+ */
+#ifndef TLV_FAST_BOOT
+#define TLV_FAST_BOOT                0
+#endif
+
 /* ============================ 流式操作 ============================ */
 /** 最大同时流操作数 */
 #ifndef TLV_MAX_STREAM_HANDLES
 #define TLV_MAX_STREAM_HANDLES  2
 #endif
 
+/**
+ * 每个流句柄的暂存缓冲区大小（字节）
+ * 写入时合并小数据段后再整段写入FRAM（末尾CRC与最后一段数据一并写入）,
+ * 读取时按此大小预读后续数据,减少FRAM传输次数；0表示不使用暂存
+ * RAM占用：TLV_MAX_STREAM_HANDLES * TLV_STREAM_BUFFER_SIZE
+ */
+#ifndef TLV_STREAM_BUFFER_SIZE
+#define TLV_STREAM_BUFFER_SIZE  64
+#endif
+
+/* ============================ 性能统计 ============================ */
+/**
+ * 性能统计：各操作的调用次数、错误次数、耗时最小/最大/平均值与对数直方图,以及端口传输字节数
+ * 计时使用移植层tlv_port_get_perf_tick()；关闭时不编译任何统计代码
+ * RAM占用：约 (TLV_PERF_HIST_BUCKETS * 4 + 28) * 10 字节
+ */
+#ifndef TLV_PERF_STATS
+#define TLV_PERF_STATS          0
+#endif
+
+/** 耗时直方图桶数：桶0为0个tick,桶i为[2^(i-1), 2^i)个tick,最后一个桶包含所有更大的值 */
+#ifndef TLV_PERF_HIST_BUCKETS
+#define TLV_PERF_HIST_BUCKETS   16
+#endif
+
+/* ============================ 事务操作 ============================ */
+/** 单个事务最多包含的写入条目数（同时决定tlv_write_batch的最大数量） */
+#ifndef TLV_MAX_TXN_ENTRIES
+#define TLV_MAX_TXN_ENTRIES     16
+#endif
+
+/* ============================ 提交日志 ============================ */
+/**
+ * 提交日志：写入/删除只追加一条12字节的记录（Tag、新地址、长度、CRC）作为提交点,
+ * 索引页与Header在检查点（日志写满、tlv_flush、备份、反初始化）时批量落盘；
+ * 启动时只重放上次检查点之后的日志尾部,检查点写索引时掉电也无需从备份区整区恢复
+ * 日志位于管理区未使用部分（事务日志之后、TLV_DATA_ADDR之前）,不参与备份。
+ * 默认启用；启用时写入总是换址（不原地覆盖旧块）,0为索引直写/写回模式
+ */
+#ifndef TLV_JOURNAL_ENABLE
+#define TLV_JOURNAL_ENABLE      1
+#endif
+
+/** 提交日志容量（记录数,每条12字节；写满时自动检查点） */
+#ifndef TLV_JOURNAL_ENTRIES
+#define TLV_JOURNAL_ENTRIES     64
+#endif
+
 /* ============================ 错误处理配置 ============================ */
  
 /** 启用错误历史记录（需要额外 256 字节 RAM） */
@@ -74,17 +357,55 @@
 #define TLV_HEADER_ADDR              0x0000
  
 /** Tag索引表起始地址 */
+#ifndef TLV_INDEX_ADDR
 #define TLV_INDEX_ADDR               0x0200
+#endif
  
-/** 数据区起始地址 */
+/** 数据区起始地址（同时是管理区大小,须容纳索引表、索引页CRC表与事务日志） */
+#ifndef TLV_DATA_ADDR
 #define TLV_DATA_ADDR                0x1000
+#endif
  
-/** 备份区起始地址 */
-#define TLV_BACKUP_ADDR              0x1F000
+/**
+ * 默认布局的备份区起始地址：备份区位于FRAM末尾,大小与管理区相同。
+ * 运行时以系统Header中记录的存储布局为准（见tlv_geometry_t）
+ */
+#define TLV_BACKUP_ADDR              (TLV_FRAM_SIZE - (TLV_DATA_ADDR - TLV_HEADER_ADDR))
  
+/**
+ * Tag镜像区大小（字节,0为关闭）：位于备份区之前、从数据区末尾划出,按元数据表顺序为每个
+ * backup_enable的Tag（日志Tag除外）预留一个最大长度的块槽位,放不下的Tag不镜像。启用或调整大小后需重新格式化,
+ * 按旧布局格式化的存储区不启用镜像
+ */
+#ifndef TLV_MIRROR_SIZE
+#define TLV_MIRROR_SIZE              0
+#endif
+
+/** 默认布局的Tag镜像区起始地址（同时是数据区结束地址） */
+#define TLV_MIRROR_ADDR              (TLV_BACKUP_ADDR - TLV_MIRROR_SIZE)
+
 /** 备份区数据区大小   */
 #define TLV_DATA_REGION_SIZE         (TLV_FRAM_SIZE - TLV_BACKUP_ADDR)
 
+/**
+ * 差量备份页大小：管理区按页跟踪修改,备份只复制脏页,每页在备份区末尾的CRC表中有独立CRC
+ * 两页必须能同时放入静态缓冲区（恢复时比较备份页与管理区页）
+ */
+#ifndef TLV_BACKUP_PAGE_SIZE
+#define TLV_BACKUP_PAGE_SIZE         256
+#endif
+
+/** 备份区页数（上限,实际只覆盖管理区已使用部分） */
+#define TLV_BACKUP_PAGE_COUNT        (TLV_DATA_REGION_SIZE / TLV_BACKUP_PAGE_SIZE)
+
+/**
+ * 线程安全模式下tlv_backup_all()的分段轮数：每轮逐页加锁复制脏页,
+ * 轮数用尽仍有脏页（备份期间持续写入）时,剩余页在同一加锁段内完成,保证备份区自洽
+ */
+#ifndef TLV_BACKUP_SECTION_PASSES
+#define TLV_BACKUP_SECTION_PASSES    2
+#endif
+
 /* ============================ 系统版本 ============================ */
 #define TLV_SYSTEM_VERSION          0x0100      // V1.0
 
@@ -139,12 +460,37 @@
 #define TLV_ERROR_INVALID_STATE     -11
 /* ============================ 编译检查 ============================ */
  
-#if TLV_FRAM_SIZE < (64 * 1024)
+#if TLV_FRAM_SIZE < TLV_FRAM_MIN_SIZE
     #error "FRAM size too small, minimum 64KB required"
 #endif
+
+#if TLV_FRAM_MAX_SIZE < TLV_FRAM_SIZE
+    #error "TLV_FRAM_MAX_SIZE must not be smaller than TLV_FRAM_SIZE"
+#endif
  
-#if TLV_MAX_TAG_COUNT > 256
-    #error "Too many tags, maximum 256 supported (no hashtable)"
+// 索引页位图为uint32_t（最多32页）；Tag数受存储布局的限制由tlv_types.h中的STATIC_ASSERT检查
+#if TLV_MAX_TAG_COUNT > 32 * TLV_INDEX_ENTRIES_PER_PAGE
+    #error "Too many tags, at most 32 index pages (32 * TLV_INDEX_ENTRIES_PER_PAGE tags) supported"
+#endif
+
+#if TLV_PORT_DUAL_FRAM && (TLV_FRAM_CHIP0_SIZE < TLV_DATA_ADDR || TLV_FRAM_CHIP0_SIZE > TLV_BACKUP_ADDR)
+    #error "TLV_FRAM_CHIP0_SIZE must hold header/index and leave the backup region on chip 1"
+#endif
+
+#if TLV_WEAR_RELOCATE_WRITES == 0 || (TLV_WEAR_RELOCATE_WRITES & (TLV_WEAR_RELOCATE_WRITES - 1)) != 0
+    #error "TLV_WEAR_RELOCATE_WRITES must be a power of 2"
+#endif
+
+#if TLV_MIRROR_ADDR < TLV_DATA_ADDR + (TLV_BACKUP_ADDR - TLV_DATA_ADDR) / 2
+    #error "TLV_MIRROR_SIZE must not exceed half of the data region"
+#endif
+
+#if (TLV_INDEX_HASH_SIZE & (TLV_INDEX_HASH_SIZE - 1)) != 0
+    #error "TLV_INDEX_HASH_SIZE must be a power of 2"
+#endif
+
+#if TLV_INDEX_HASH_SIZE < (TLV_MAX_TAG_COUNT * 2)
+    #error "TLV_INDEX_HASH_SIZE must be at least 2x TLV_MAX_TAG_COUNT"
 #endif
 
 /* ============================ 断言检查 ============================ */
@@ -20,11 +20,28 @@ extern "C" {
  */
 const char* tlv_get_version(void); 
 
+/**
+ * @brief 绑定FRAM设备操作表
+ * @param ops 操作表（NULL恢复默认的tlv_port_fram_*接口）,须在系统运行期间保持有效
+ * @return 0: 成功, TLV_ERROR_INVALID_STATE: 系统已初始化, TLV_ERROR_INVALID_PARAM: 操作表缺少必需的接口
+ * @note 在tlv_init()之前调用；多片FRAM可绑定移植层提供的组合操作表
+ */
+int tlv_bind_port(const struct tlv_port_ops *ops);
+
 /**
  * @brief 初始化TLV存储系统
  * @return 初始化结果
  */
 tlv_init_result_t tlv_init(void);
+
+/**
+ * @brief 快速启动后逐页校验索引（每次调用校验一页）
+ * @return 1: 仍有未校验的页, 0: 校验完成, 其他: 错误码
+ * @note TLV_FAST_BOOT启用且上次正常关机时,tlv_init()跳过索引页校验以缩短启动时间；
+ *       可在空闲任务中循环调用本函数完成校验,未完成时首次修改操作前会一次性完成。
+ *       发现损坏页时自动从备份恢复
+ */
+int tlv_init_verify_step(void);
  
 /**
  * @brief 反初始化TLV存储系统
@@ -35,9 +52,27 @@ int tlv_deinit(void);
 /**
  * @brief 格式化FRAM存储区
  * @param magic 魔数（可选,0使用默认）
- * @return 0: 成功, 其他: 错误码
+ * @return 0: 成功, TLV_ERROR_INVALID_STATE: 异步操作未结束, 其他: 错误码
  */
 int tlv_format(uint32_t magic);
+
+/**
+ * @brief 按指定存储布局格式化FRAM存储区
+ * @param magic 魔数（可选,0使用默认）
+ * @param geometry 存储布局：FRAM容量与镜像区大小,记录在系统Header中,
+ *                 之后的tlv_init()按此布局定位备份区与镜像区
+ * @return 0: 成功, TLV_ERROR_INVALID_PARAM: 布局不合法（此时不改动FRAM）, 其他: 错误码
+ * @note fram_size须在TLV_FRAM_MIN_SIZE ~ TLV_FRAM_MAX_SIZE之间,镜像区不超过数据区一半;
+ *       同一固件可服务不同容量的FRAM,TLV_FRAM_MAX_SIZE只需不小于最大的器件
+ */
+int tlv_format_geometry(uint32_t magic, const tlv_geometry_t *geometry);
+
+/**
+ * @brief 获取当前存储布局
+ * @param geometry 输出存储布局
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_get_geometry(tlv_geometry_t *geometry);
  
 /**
  * @brief 获取系统状态
@@ -64,6 +99,31 @@ int tlv_write(uint16_t tag, const void *data, uint16_t len);
  * @return 0: 成功, 其他: 错误码
  */
 int tlv_read(uint16_t tag, void *buf, uint16_t *len);
+
+/**
+ * @brief 按范围读取TLV数据（只传输payload中[offset, offset+len)部分）
+ * @param tag Tag值
+ * @param offset payload内偏移
+ * @param buf 输出缓冲区
+ * @param len 读取长度
+ * @return 0: 成功, TLV_ERROR_INVALID_PARAM: 范围越界或数据已压缩, TLV_ERROR_VERSION: 数据待迁移, 其他: 错误码
+ * @note TLV_READ_RANGE_VERIFY_CRC启用时块写入后首次范围读取会校验整块CRC,之后直接读取所需字节；
+ *       旧版本数据的布局与当前版本不同,需先以tlv_read()完成迁移；压缩存储的数据只能整块读取
+ */
+int tlv_read_range(uint16_t tag, uint16_t offset, void *buf, uint16_t len);
+
+/**
+ * @brief 按范围原地改写TLV数据（只传输payload中[offset, offset+len)部分,块长度不变）
+ * @param tag Tag值（须已存在）
+ * @param offset payload内偏移
+ * @param data 新数据
+ * @param len 改写长度
+ * @return 0: 成功, TLV_ERROR_INVALID_PARAM: 范围越界、日志Tag或数据已压缩, TLV_ERROR_NOT_FOUND: Tag不存在,
+ *         TLV_ERROR_VERSION: 数据待迁移, 其他: 错误码
+ * @note 块CRC由旧CRC增量推导,write_count递增,不落盘索引；掉电时块CRC不匹配,与原地tlv_write等价。
+ *       到达磨损均衡换址周期时退回整块改写
+ */
+int tlv_write_range(uint16_t tag, uint16_t offset, const void *data, uint16_t len);
  
 /**
  * @brief 删除TLV数据
@@ -75,6 +135,8 @@ int tlv_delete(uint16_t tag);
 /**
  * @brief 强制保存所有挂起的更改
  * @return 0: 成功, 其他: 错误码
+ * @note 写回模式(TLV_WRITE_BACK_MODE)下只补写整表CRC与合并的Header统计字段；
+ *       未flush时掉电仅丢失total_writes/last_update_time,已写入的数据与索引不受影响
  */
 int tlv_flush(void);
  
@@ -88,7 +150,7 @@ bool tlv_exists(uint16_t tag);
 /**
  * @brief 获取Tag数据长度
  * @param tag Tag值
- * @param len 输出长度
+ * @param len 输出长度（压缩存储时为原始长度）
  * @return 0: 成功, 其他: 错误码
  */
 int tlv_get_length(uint16_t tag, uint16_t *len);
@@ -107,15 +169,47 @@ int tlv_read_batch(const uint16_t *tags, uint16_t count,
                    void **buffers, uint16_t *lengths);
  
 /**
- * @brief 批量写入
+ * @brief 批量写入（原子：全部成功或全部不生效）
  * @param tags Tag数组
- * @param count Tag数量
+ * @param count Tag数量（不超过TLV_MAX_TXN_ENTRIES）
  * @param datas 数据数组
  * @param lengths 长度数组
- * @return 成功写入的数量
+ * @return 成功写入的数量（== count）, <0: 错误码（没有任何Tag被修改）
  */
 int tlv_write_batch(const uint16_t *tags, uint16_t count,
                     const void **datas, const uint16_t *lengths);
+/* ============================ 事务API ============================ */
+
+/**
+ * @brief 开始事务
+ * @return 0: 成功, 其他: 错误码
+ * @note 事务期间tlv_write/tlv_delete/tlv_defragment/分段写入返回TLV_ERROR_INVALID_STATE,
+ *       tlv_read读取的仍是已提交的数据；线程安全模式下其他任务的写操作同样返回该错误
+ */
+int tlv_txn_begin(void);
+
+/**
+ * @brief 事务内写入（数据立即落盘到新分配的空间,提交前不可见）
+ * @param tag Tag值
+ * @param data 数据指针
+ * @param len 数据长度
+ * @return 0: 成功, 其他: 错误码（事务保持进行中,可继续写入或取消）
+ */
+int tlv_txn_write(uint16_t tag, const void *data, uint16_t len);
+
+/**
+ * @brief 提交事务：一次写入提交日志,再发布索引与Header
+ * @return 0: 成功, 其他: 错误码（提交日志未落盘,没有任何Tag被修改）
+ * @note 提交日志落盘即为提交点,之后掉电会在下次tlv_init()时重放；之后发布索引或Header
+ *       失败时仍返回0（事务已生效,RAM中全部Tag已更新）,日志保留到下次修改前重新落盘
+ */
+int tlv_txn_commit(void);
+
+/**
+ * @brief 取消事务,已写入的数据块空间被回收
+ */
+void tlv_txn_abort(void);
+
 /* ============================ 流操作API ============================ */
 
 /**
@@ -181,6 +275,100 @@ int tlv_read_end(tlv_stream_handle_t handle);
  */
 void tlv_read_abort(tlv_stream_handle_t handle);
 
+/* ============================ 环形日志API ============================ */
+
+/**
+ * @brief 向环形日志Tag追加一条记录
+ * @param tag 日志Tag（元数据log_record_size非0）
+ * @param record 记录数据
+ * @param len 记录长度（不超过log_record_size）
+ * @return 0: 成功, 其他: 错误码
+ * @note 首次追加时按max_length分配固定大小的日志块；此后只写入记录槽位与8字节控制头,
+ *       不保存索引与Header。槽位写满后覆盖最旧的记录。日志Tag不能用tlv_write等接口写入
+ */
+int tlv_append(uint16_t tag, const void *record, uint16_t len);
+
+/**
+ * @brief 读取环形日志中序号不小于from_seq的最早一条记录
+ * @param tag 日志Tag
+ * @param from_seq 起始序号（早于最旧记录时从最旧记录开始）
+ * @param buf 输出缓冲区
+ * @param len 缓冲区大小（输入）,记录长度（输出）
+ * @param seq 输出记录序号,以*seq + 1继续读取下一条
+ * @return 0: 成功, TLV_ERROR_NOT_FOUND: 没有更新的记录,
+ *         TLV_ERROR_CRC_FAILED: 该记录损坏（*seq已设置,可跳过）, 其他: 错误码
+ */
+int tlv_log_read(uint16_t tag, uint32_t from_seq, void *buf, uint16_t *len, uint32_t *seq);
+
+/**
+ * @brief 获取环形日志中可读记录的序号范围
+ * @param first_seq 输出最旧记录序号
+ * @param next_seq 输出下一条追加记录的序号（first_seq == next_seq表示为空）
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_log_info(uint16_t tag, uint32_t *first_seq, uint32_t *next_seq);
+
+#if TLV_ASYNC_ENABLE
+/* ============================ 异步API ============================ */
+
+/**
+ * @brief 启动异步读取（DMA传输,CPU不等待）
+ * @param tag Tag值
+ * @param buf 输出缓冲区（回调前保持有效）
+ * @param buf_size 缓冲区大小
+ * @param callback 完成回调,len为实际数据长度
+ * @param user_data 用户数据
+ * @return 0: 已启动, 其他: 错误码（不会调用回调）
+ * @note 同一时刻只有一个异步操作；需要版本迁移的数据在完成阶段同步迁移
+ */
+int tlv_read_async(uint16_t tag, void *buf, uint16_t buf_size,
+                   tlv_async_callback_t callback, void *user_data);
+
+/**
+ * @brief 启动异步写入（DMA传输,CPU不等待）
+ * @param tag Tag值
+ * @param data 数据指针（回调前保持有效且不能修改）
+ * @param len 数据长度
+ * @param callback 完成回调
+ * @param user_data 用户数据
+ * @return 0: 已启动, 其他: 错误码（不会调用回调）
+ * @note 数据总是写入新分配的块,完成阶段提交索引；回调前读取到的仍是旧数据。
+ *       异步操作进行中时写入、删除、事务、分段写入与碎片整理返回TLV_ERROR_INVALID_STATE
+ */
+int tlv_write_async(uint16_t tag, const void *data, uint16_t len,
+                    tlv_async_callback_t callback, void *user_data);
+
+/**
+ * @brief 推进异步操作（主循环或存储任务中周期调用）
+ * @return 1: 异步操作进行中, 0: 空闲
+ * @note 一次传输完成后启动下一段传输；全部完成时校验/提交,并在此调用完成回调
+ */
+int tlv_async_poll(void);
+
+/**
+ * @brief 是否有异步操作进行中
+ * @return true: 进行中, false: 空闲
+ */
+bool tlv_async_busy(void);
+#endif
+
+#if TLV_PERF_STATS
+/* ============================ 性能统计API ============================ */
+
+/**
+ * @brief 获取性能统计
+ * @param stats 统计输出
+ * @return 0: 成功, 其他: 错误码
+ * @note 接口耗时从调用开始计到返回（含等待锁的时间）；端口耗时只统计同步传输
+ */
+int tlv_get_perf_stats(tlv_perf_stats_t *stats);
+
+/**
+ * @brief 清零性能统计
+ */
+void tlv_reset_perf_stats(void);
+#endif
+
 /* ============================ 错误处理API ============================ */
  
 /**
@@ -237,6 +425,7 @@ int tlv_get_statistics(tlv_statistics_t *stats);
  * @param callback 回调函数
  * @param user_data 用户数据
  * @return 遍历的Tag数量
+ * @note 回调在锁外执行,回调中可以调用读写接口
  */
 typedef void (*tlv_foreach_callback_t)(uint16_t tag, void *user_data);
 int tlv_foreach(tlv_foreach_callback_t callback, void *user_data);
@@ -244,10 +433,47 @@ int tlv_foreach(tlv_foreach_callback_t callback, void *user_data);
 /* ============================ 维护管理API ============================ */
  
 /**
- * @brief 碎片整理
+ * @brief 碎片整理（一次性完成,耗时与数据量成正比）
  * @return 0: 成功, 其他: 错误码
+ * @note 线程安全模式或启用提交日志时按TLV_DEFRAG_SECTION_BYTES分段执行增量整理（任意时刻掉电都安全）,
+ *       线程安全模式下段间其他任务可以读写
  */
 int tlv_defragment(void);
+
+/**
+ * @brief 增量碎片整理（单步,适合在空闲任务中调用）
+ * @param budget_bytes 本步最多搬移的字节数（至少搬移一个块）
+ * @return 1: 仍有工作, 0: 已完成, <0: 错误码
+ * @note 每步只提交单个索引条目,任意时刻掉电都安全；步与步之间可以正常读写。
+ *       事务或分段写入进行中时返回TLV_ERROR_INVALID_STATE
+ */
+int tlv_defrag_step(uint32_t budget_bytes);
+
+/**
+ * @brief 是否有待执行的碎片整理
+ * @return true: 自动整理已调度或增量整理进行中
+ * @note 写操作只按GC策略调度整理（见tlv_set_gc_callback）,默认不同步执行；
+ *       仅当尾部空间不足以分配时才同步整理
+ */
+bool tlv_defrag_pending(void);
+
+/**
+ * @brief 获取GC统计（不访问FRAM）
+ * @param stats 统计输出
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_get_gc_stats(tlv_gc_stats_t *stats);
+
+/**
+ * @brief 注册GC回调,由应用决定整理延后执行还是立即执行
+ * @param callback 回调函数（NULL恢复默认：余量不足时调度,分配失败时立即整理）
+ * @param user_data 用户数据
+ * @return 0: 成功, 其他: 错误码
+ * @note 策略只在没有已调度或进行中的整理时触发。TLV_GC_NOW在触发它的同步写接口返回前持写锁整理完成
+ *       （异步写入完成时触发的推迟到下一次写接口）；分配失败时返回TLV_GC_DEFER或TLV_GC_SKIP,
+ *       该次写入返回TLV_ERROR_NO_MEMORY_SPACE
+ */
+int tlv_set_gc_callback(tlv_gc_callback_t callback, void *user_data);
  
 /**
  * @brief 校验所有数据
@@ -255,18 +481,69 @@ int tlv_defragment(void);
  * @return 0: 成功, 其他: 错误码
  */
 int tlv_verify_all(uint32_t *corrupted_count);
+
+/**
+ * @brief 增量后台巡检（单步）：从游标处按地址顺序校验数据块
+ * @param budget_bytes 本步最多校验的块字节数（至少校验一个块）
+ * @return 1: 本轮仍有工作, 0: 本轮已完成, <0: 错误码
+ * @note 物理相邻的块经静态缓冲区一次传输读入后逐块校验CRC,超过缓冲区的块单独分批校验；
+ *       损坏的Tag记入结果列表,TLV_SCRUB_AUTO_REPAIR时backup_enable的Tag用RAM缓存或镜像内容重写。
+ *       每步持写锁,步与步之间可以正常读写；本轮完成后再次调用开始新一轮
+ */
+int tlv_scrub_step(uint32_t budget_bytes);
+
+/**
+ * @brief 获取后台巡检结果
+ * @param result 输出当前轮（进行中）或最近完成一轮的结果
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_get_scrub_result(tlv_scrub_result_t *result);
  
 /**
  * @brief 备份所有数据到备份区
  * @return 0: 成功, 其他: 错误码
+ * @note 差量备份：只复制自上次备份后修改过的管理区页（TLV_BACKUP_PAGE_SIZE）,
+ *       每页在备份区末尾有独立CRC,撕裂的备份页在恢复时被跳过；
+ *       线程安全模式下逐页分段加锁,最后一段内复制剩余脏页
  */
 int tlv_backup_all(void);
+
+/**
+ * @brief 同步Tag镜像区：把backup_enable的Tag复制到镜像槽位
+ * @return 0: 成功, 其他: 错误码
+ * @note 写操作不更新镜像,由本函数或tlv_backup_all()批量同步；块Header与镜像一致的Tag不复制,
+ *       CRC校验失败的块不覆盖镜像。tlv_read遇到CRC失败时,若镜像与损坏块属于同一次写入（长度与
+ *       写入计数相同）则返回镜像数据。未启用TLV_MIRROR_SIZE时直接返回0
+ */
+int tlv_mirror_sync(void);
  
 /**
  * @brief 从备份区恢复数据
- * @return 0: 成功, 其他: 错误码
+ * @return 0: 成功, TLV_ERROR_INVALID_STATE: 事务、读写流或异步操作未结束, 其他: 错误码
+ * @note 与管理区内容一致的页不重写；兼容旧格式的整区备份。恢复中途掉电时下次tlv_init()重新恢复并返回TLV_INIT_RECOVERED
  */
 int tlv_restore_from_backup(void);
+
+/**
+ * @brief 导出数据镜像（全部有效数据块的紧凑快照,格式见tlv_image_header_t）
+ * @param write 镜像输出回调,按顺序收到Header、数据块与CRC,单次不超过TLV_BUFFER_SIZE字节
+ * @param user_data 用户数据
+ * @return 0: 成功, TLV_ERROR_CRC_FAILED: 存在损坏的数据块（已中止）, 其他: 错误码
+ * @note 回调在写锁内执行,回调中不能调用存储系统接口
+ */
+int tlv_export_image(tlv_image_write_t write, void *user_data);
+
+/**
+ * @brief 导入数据镜像,替换全部数据（适合产线批量写入）
+ * @param read 镜像输入回调,按顺序读取Header、数据块与CRC
+ * @param user_data 用户数据
+ * @return 0: 成功, TLV_ERROR_CORRUPTED: 镜像不合法, TLV_ERROR_CRC_FAILED: 数据CRC不符, 其他: 错误码
+ * @note 镜像Header校验通过后作废系统Header,数据块按TLV_BUFFER_SIZE大块顺序写入数据区（同时解析块Header
+ *       重建索引）,最后一次性提交索引表与Header,导入期间不读取FRAM。提交前失败时格式化为空存储
+ *       （保留魔数与存储布局）,掉电时上电为首次启动。与普通写入一样,备份区由之后的tlv_backup_all()更新。
+ *       镜像中的Tag须存在于元数据表,压缩块要求本构建启用压缩；回调在写锁内执行
+ */
+int tlv_import_image(tlv_image_read_t read, void *user_data);
  
 /* ============================ 空间管理API ============================ */
  
@@ -33,6 +33,22 @@ void tlv_index_deinit(const tlv_context_t *ctx);
  * @return 0: 成功, 其他: 错误码
  */
 int tlv_index_load(const tlv_context_t *ctx);
+
+/**
+ * @brief 从FRAM加载索引表,不做CRC校验（快速启动）
+ * @param ctx 全局上下文
+ * @return 0: 成功, 其他: 错误码
+ * @note 调用方须随后以tlv_index_verify_page()逐页校验
+ */
+int tlv_index_load_unverified(const tlv_context_t *ctx);
+
+/**
+ * @brief 校验单个索引页
+ * @param ctx 全局上下文
+ * @param page 索引页号
+ * @return 0: 有效（页CRC过期但所指数据块均有效时修复页CRC）, TLV_ERROR_CRC_FAILED: 页损坏, 其他: 错误码
+ */
+int tlv_index_verify_page(const tlv_context_t *ctx, uint32_t page);
  
 /**
  * @brief 将索引表保存到FRAM
@@ -40,6 +56,46 @@ int tlv_index_load(const tlv_context_t *ctx);
  * @return 0: 成功, 其他: 错误码
  */
 int tlv_index_save(const tlv_context_t *ctx);
+
+/**
+ * @brief 只保存前page_count个索引页,以及整表CRC与索引页CRC表
+ * @param ctx 全局上下文
+ * @param page_count 保存的索引页数（其余页在FRAM中须已与RAM一致）
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_index_save_pages(const tlv_context_t *ctx, uint32_t page_count);
+
+/**
+ * @brief 只保存位图中的索引页,以及整表CRC与索引页CRC表（提交日志检查点）
+ * @param ctx 全局上下文
+ * @param page_mask 待保存的索引页位图（其余页在FRAM中须已与RAM一致,可为0）
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_index_save_page_mask(const tlv_context_t *ctx, uint32_t page_mask);
+
+/**
+ * @brief 只保存单个索引条目及其所在页的CRC（写回模式）
+ * @param ctx 全局上下文
+ * @param entry 索引条目指针（必须属于ctx->index_table）
+ * @return 0: 成功, 其他: 错误码
+ * @note 整表CRC被标记为过期,由tlv_index_save_crc()在flush时更新
+ */
+int tlv_index_save_entry(const tlv_context_t *ctx, const tlv_index_entry_t *entry);
+ 
+/**
+ * @brief 重新计算并只保存整表CRC
+ * @param ctx 全局上下文
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_index_save_crc(const tlv_context_t *ctx);
+
+/**
+ * @brief 标记管理区写入范围所在的备份页为脏（差量备份）
+ * @param ctx 全局上下文
+ * @param addr 写入起始地址（管理区内）
+ * @param size 写入长度
+ */
+void tlv_index_mark_backup_dirty(const tlv_context_t *ctx, uint32_t addr, uint32_t size);
  
 /**
  * @brief 校验索引表完整性
@@ -48,10 +104,18 @@ int tlv_index_save(const tlv_context_t *ctx);
  */
 int tlv_index_verify(const tlv_context_t *ctx);
  
+/**
+ * @brief 根据索引表重建RAM哈希表
+ * @param ctx 全局上下文
+ * @return 0: 成功, 其他: 错误码
+ * @note 索引表被整体替换（加载、恢复、排序）后必须调用
+ */
+int tlv_index_rebuild_hash(const tlv_context_t *ctx);
+ 
 /* ============================ 索引查找 ============================ */
  
 /**
- * @brief 查找Tag索引（线性搜索）
+ * @brief 查找Tag索引（哈希查找,未建立哈希表时线性搜索）
  * @param ctx 全局上下文
  * @param tag Tag值
  * @return 索引指针,NULL表示未找到
@@ -59,7 +123,7 @@ int tlv_index_verify(const tlv_context_t *ctx);
 tlv_index_entry_t* tlv_index_find(const tlv_context_t *ctx, uint16_t tag);
  
 /**
- * @brief 快速查找（优化版）
+ * @brief 快速查找（与tlv_index_find等价,保留用于兼容）
  * @param ctx 全局上下文
  * @param tag Tag值
  * @return 索引指针,NULL表示未找到
@@ -9,6 +9,82 @@ extern "C" {
 #endif
 
 
+/* ============================ 元数据查找 ============================ */
+/**
+ * @brief 构建元数据查找表（初始化时调用一次）
+ *
+ * 校验元数据表（Tag非0、非0xFFFF且不重复）。若表已按Tag升序排列则直接二分查找,
+ * 否则在RAM中构建按Tag排序的下标表。
+ *
+ * @param meta_table 元数据表
+ * @param size 元数据表条目数（不含0xFFFF终止符）
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_meta_lookup_build(const tlv_meta_const_t *meta_table, uint16_t size);
+
+/**
+ * @brief 根据Tag查找元数据（所有元数据查找的统一入口）
+ *
+ * @param meta_table 元数据表
+ * @param tag 要查询的TLV标签值
+ * @return 元数据指针,NULL表示未找到
+ * @note meta_table为已构建查找表的元数据表时二分查找,否则线性遍历到0xFFFF终止符
+ */
+const tlv_meta_const_t *tlv_meta_find(const tlv_meta_const_t *meta_table, uint16_t tag);
+
+/* ============================ 元数据声明宏 ============================ */
+/**
+ * @brief 元数据表的单一声明（X-macro）
+ *
+ * 元数据在一个列表宏中声明一次,由下列展开宏分别生成元数据表、行号与类型化访问函数：
+ * @code
+ * #define TLV_META_LIST(X, B) \
+ *     X(BootCount,   TAG_SYSTEM_BOOT_COUNT, uint32_t, 4,   5, 1, 0, NULL, 1, 0, 0) \
+ *     B(UserHistory, TAG_USER_HISTORY,                512, 3, 1, 0, NULL, 0, 0, 1)
+ *
+ * static const tlv_meta_const_t TABLE[] = { TLV_META_LIST(TLV_META_ROW, TLV_META_ROW_RAW) {0xFFFF} };
+ * enum { TLV_META_LIST(TLV_META_ROW_INDEX, TLV_META_ROW_INDEX_RAW) TLV_META_ROW_COUNT };
+ * TLV_META_LIST(TLV_META_ACCESSOR, TLV_META_NONE)
+ * @endcode
+ *
+ * X为定长类型的Tag：X(Name, Tag, Type, MaxLen, Prior, Ver, Bkup, Migrate, Cache, LogRecord, Compress),
+ * 生成tlv_get_<Name>(Type *)与tlv_set_<Name>(const Type *),编译时检查sizeof(Type) <= MaxLen；
+ * B为变长数据或日志Tag,字段相同但没有Type,不生成访问函数,仍使用tlv_read/tlv_write。
+ *
+ * @note 访问函数经tlv_read/tlv_write访问,元数据与索引查找本身已是二分/哈希；
+ *       读取时存储长度与sizeof(Type)不一致返回TLV_ERROR_VERSION（数据布局与类型不符）
+ */
+#define TLV_META_ROW(Name, Tag, Type, MaxLen, Prior, Ver, Bkup, Migrate, Cache, LogRecord, Compress) \
+    {(Tag), (MaxLen), (Prior), (Ver), (Bkup), #Name, (Migrate), (Cache), (LogRecord), (Compress)},
+
+#define TLV_META_ROW_RAW(Name, Tag, MaxLen, Prior, Ver, Bkup, Migrate, Cache, LogRecord, Compress) \
+    {(Tag), (MaxLen), (Prior), (Ver), (Bkup), #Name, (Migrate), (Cache), (LogRecord), (Compress)},
+
+/** 元数据表中的行号：tlv_get_meta_table()[TLV_META_ROW_<Name>] 直接取元数据,无需查找 */
+#define TLV_META_ROW_INDEX(Name, Tag, Type, MaxLen, Prior, Ver, Bkup, Migrate, Cache, LogRecord, Compress) \
+    TLV_META_ROW_##Name,
+
+#define TLV_META_ROW_INDEX_RAW(Name, Tag, MaxLen, Prior, Ver, Bkup, Migrate, Cache, LogRecord, Compress) \
+    TLV_META_ROW_##Name,
+
+/** 类型化访问函数（需包含tlv_fram.h） */
+#define TLV_META_ACCESSOR(Name, Tag, Type, MaxLen, Prior, Ver, Bkup, Migrate, Cache, LogRecord, Compress) \
+    static inline int tlv_get_##Name(Type *out)                                                    \
+    {                                                                                              \
+        STATIC_ASSERT(sizeof(Type) <= (MaxLen), "Type of " #Name " exceeds its max length");      \
+        uint16_t len = (uint16_t)sizeof(Type);                                                     \
+        int ret = tlv_read((Tag), out, &len);                                                      \
+        return (ret == TLV_OK && len != sizeof(Type)) ? TLV_ERROR_VERSION : ret;                   \
+    }                                                                                              \
+    static inline int tlv_set_##Name(const Type *in)                                               \
+    {                                                                                              \
+        STATIC_ASSERT(sizeof(Type) <= (MaxLen), "Type of " #Name " exceeds its max length");      \
+        return tlv_write((Tag), in, (uint16_t)sizeof(Type));                                       \
+    }
+
+/** 不生成内容（用于忽略列表中的某一类项） */
+#define TLV_META_NONE(...)
+
 /* ============================ 内联函数 ============================ */
 /**
  * @brief 根据TLV标签值获取对应的标签名称
@@ -18,17 +94,8 @@ extern "C" {
  */
 static inline const char *tlv_get_tag_name(const tlv_meta_const_t *meta_table, uint16_t tag)
 {
-    // 遍历TLV元数据映射表查找匹配的标签
-    for (int i = 0; meta_table[i].tag != 0xFFFF; i++)
-    {
-        // 找到匹配的标签时,返回对应的名称
-        if (meta_table[i].tag == tag)
-        {
-            return meta_table[i].name ? meta_table[i].name : "Unknown";
-        }
-    }
-    // 未找到匹配的标签,返回默认名称
-    return "Unknown";
+    const tlv_meta_const_t *meta = tlv_meta_find(meta_table, tag);
+    return (meta && meta->name) ? meta->name : "Unknown";
 }
 
 /**
@@ -39,17 +106,8 @@ static inline const char *tlv_get_tag_name(const tlv_meta_const_t *meta_table, u
  */
 static inline uint16_t tlv_get_tag_max_length(const tlv_meta_const_t *meta_table, uint16_t tag)
 {
-    // 遍历TLV元数据映射表查找匹配的标签
-    for (int i = 0; meta_table[i].tag != 0xFFFF; i++)
-    {
-        // 找到匹配的标签,返回其最大长度
-        if (meta_table[i].tag == tag)
-        {
-            return meta_table[i].max_length;
-        }
-    }
-    // 未找到匹配的标签,返回0
-    return 0;
+    const tlv_meta_const_t *meta = tlv_meta_find(meta_table, tag);
+    return meta ? meta->max_length : 0;
 }
 
 /**
@@ -31,11 +31,38 @@ int tlv_migrate_tag(const tlv_context_t *ctx,
                     uint16_t max_size,
                     uint8_t current_ver);
 
- /**
- * @brief 批量迁移所有Tag（可选）
- * @return 迁移的Tag数量< 0: 错误
+/**
+ * @brief 批量迁移所有Tag（循环调用tlv_migrate_step直到完成）
+ * @return 本轮迁移的Tag数量, <0: 错误
  */
 int tlv_migrate_all(void);
+
+/**
+ * @brief 增量批量迁移（单步）
+ * @param budget_bytes 本步最多迁移的数据字节数（至少迁移一个Tag）
+ * @return 1: 仍有工作, 0: 已完成, <0: 错误码
+ * @note 首次调用时扫描需要迁移的Tag并开始一轮；每步最多TLV_MAX_TXN_ENTRIES个Tag,
+ *       在一个事务中写入并一次提交（一次索引与Header保存）。本轮结束前不调度自动碎片整理。
+ *       可在空闲任务中周期调用,步与步之间可正常读写
+ */
+int tlv_migrate_step(uint32_t budget_bytes);
+
+/**
+ * @brief 设置迁移大Tag用的工作缓冲区
+ * @param buf 缓冲区（NULL表示取消）
+ * @param size 缓冲区大小
+ * @return 0: 成功, 其他: 错误码
+ * @note 元数据max_length超过TLV_BUFFER_SIZE的Tag迁移时需要容纳整个数据,缓冲区须在迁移完成前保持有效；
+ *       未设置或容量不足时该Tag计入失败
+ */
+int tlv_migrate_set_buffer(void *buf, uint16_t size);
+
+/**
+ * @brief 获取本轮批量迁移进度
+ * @param progress 进度输出
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_get_migration_progress(tlv_migrate_progress_t *progress);
  
 /**
  * @brief 获取迁移统计信息（可选）
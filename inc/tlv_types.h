@@ -43,6 +43,16 @@ typedef enum
 
 /* ============================ 系统管理结构 ============================ */
 #pragma pack(1)
+/**
+ * 存储布局（格式化时选定并记录在系统Header中）
+ * 管理区（Header、索引表、事务日志）位置固定；备份区位于FRAM末尾,镜像区紧邻其前,其余为数据区
+ */
+typedef struct
+{
+    uint32_t fram_size;   // FRAM容量
+    uint32_t mirror_size; // Tag镜像区大小（0为关闭）
+} tlv_geometry_t;
+
 /** 系统Header结构（128字节） */
 typedef struct
 {
@@ -58,10 +68,21 @@ typedef struct
     uint32_t used_space;        // 已用空间
     uint32_t fragment_count;    // 碎片的数量
     uint32_t fragment_size;     // 碎片的大小
-    uint8_t reserved[210];      // 保留扩展
+    uint32_t clean_marker;      // 正常关机或恢复进行中标记（TLV_CLEAN_SHUTDOWN_MAGIC/TLV_RESTORE_PENDING_MAGIC,运行期间为0）
+    uint32_t clean_generation;  // 正常关机计数（每次写入标记时递增）
+    uint16_t clean_index_crc;   // 写入标记时的索引整表CRC（校验Header与索引表属于同一次关机）
+    tlv_geometry_t geometry;    // 存储布局（全0表示旧版本格式化,按默认布局）
+    uint32_t header_seq;        // 保存序号（两份副本交替保存,启动时取序号较新的有效副本）
+    uint8_t reserved[188];      // 保留扩展
     uint16_t header_crc16;      // Header自身CRC16（改为2字节）
 } tlv_system_header_t;
 
+/** 系统Header副本数：交替保存,保存中途掉电时另一份仍是上一次保存的内容 */
+#define TLV_HEADER_COPIES 2
+
+/** 第n份系统Header副本的地址（紧邻排列在索引表之前） */
+#define TLV_HEADER_COPY_ADDR(n) (TLV_HEADER_ADDR + (uint32_t)(n) * sizeof(tlv_system_header_t))
+
 /** Tag索引表项结构（8字节,简化） */
 typedef struct
 {
@@ -77,6 +98,19 @@ typedef struct
     tlv_index_entry_t entries[TLV_MAX_TAG_COUNT];
     uint16_t index_crc16; // 索引表CRC16
 } tlv_index_table_t;
+
+/** 索引页数量 */
+#define TLV_INDEX_PAGE_COUNT \
+    ((TLV_MAX_TAG_COUNT + TLV_INDEX_ENTRIES_PER_PAGE - 1) / TLV_INDEX_ENTRIES_PER_PAGE)
+
+/** 索引页CRC表（紧跟索引表存储,用于校验按条目增量写入的索引） */
+typedef struct
+{
+    uint16_t page_crc16[TLV_INDEX_PAGE_COUNT]; // 每个索引页的CRC16
+} tlv_index_page_crc_t;
+
+/** 索引页CRC表起始地址 */
+#define TLV_INDEX_PAGE_CRC_ADDR (TLV_INDEX_ADDR + sizeof(tlv_index_table_t))
 /* ============================ 数据块结构 ============================ */
 /** TLV数据块Header结构（14字节,CRC16版本） */
 typedef struct
@@ -91,6 +125,50 @@ typedef struct
 // 数据块大小计算
 #define TLV_BLOCK_SIZE(dataLen) (sizeof(tlv_data_block_header_t) + dataLen + sizeof(uint16_t))
 
+/** 块标志：环形日志块,块CRC只覆盖Header,数据区为日志控制头与记录槽位,每条记录自带CRC */
+#define TLV_BLOCK_FLAG_LOG 0x01
+/** 块标志：压缩块,数据区为LZSS压缩数据（见tlv_compress.h）,Header.length为压缩后长度,块CRC覆盖压缩数据 */
+#define TLV_BLOCK_FLAG_COMPRESSED 0x02
+
+/* ============================ 压缩相关 ============================ */
+/** 压缩数据的原始长度前缀大小 */
+#define TLV_LZ_HEADER_SIZE 2
+/** 历史窗口大小（最大匹配距离） */
+#define TLV_LZ_WINDOW_SIZE 256
+/** 最短匹配长度 */
+#define TLV_LZ_MIN_MATCH 3
+/** 最长匹配长度 */
+#define TLV_LZ_MAX_MATCH (TLV_LZ_MIN_MATCH + 255)
+
+/** 分段解压状态 */
+typedef struct
+{
+    uint8_t *window;     // 历史窗口（环形）,NULL表示输出缓冲区保存全部已解压数据
+    uint16_t raw_len;    // 原始数据长度（解析长度前缀后有效）
+    uint16_t out_pos;    // 已输出字节数
+    uint16_t match_dist; // 进行中的匹配距离
+    uint16_t match_left; // 进行中的匹配剩余长度
+    uint8_t flags;       // 当前标志字节（已移出已处理的位）
+    uint8_t flag_bits;   // 当前标志字节剩余位数
+    uint8_t header_len;  // 已解析的长度前缀字节数
+} tlv_lz_decoder_t;
+
+/** 环形日志控制头（位于日志块数据区起始处,每次追加后重写） */
+typedef struct
+{
+    uint32_t next_seq;    // 下一条记录的序号（已写入记录为[next_seq - 槽位数, next_seq)）
+    uint16_t record_size; // 单条记录最大长度（创建时取自元数据,决定槽位布局）
+    uint16_t crc16;       // 控制头CRC16（撕裂时扫描记录槽位恢复next_seq）
+} tlv_log_ctrl_t;
+
+/** 环形日志记录头（每个槽位为记录头 + record_size字节数据,序号为seq的记录位于槽位seq % 槽位数） */
+typedef struct
+{
+    uint32_t seq;    // 记录序号
+    uint16_t length; // 记录数据长度
+    uint16_t crc16;  // 记录CRC16（seq、length与数据）
+} tlv_log_record_t;
+
 /** 完整的TLV数据块,永远不会实例化这个数组,仅表示数据结构 */
 typedef struct
 {
@@ -134,6 +212,9 @@ typedef struct
     uint8_t backup_enable;        // 是否需要备份
     const char *name;             // 描述名称(调试用)
     tlv_migration_func_t migrate; // 迁移函数（可选）
+    uint8_t cache_enable;         // 是否缓存到RAM（读取频繁的小Tag）
+    uint16_t log_record_size;     // 环形日志Tag的单条记录最大长度（0为普通Tag,见tlv_append）
+    uint8_t compress_enable;      // 是否压缩存储（需TLV_COMPRESS_ENABLE,适合校准表等冗余度高的大Tag）
 } tlv_meta_const_t;
 
 /** 运行时信息结构（简化） */
@@ -143,6 +224,23 @@ typedef struct
     const tlv_meta_const_t *meta; // 指向常量元数据
 } tlv_runtime_info_t;
 
+/** 空闲区段 */
+typedef struct
+{
+    uint32_t addr; // 起始地址
+    uint32_t size; // 区段大小
+    bool held;     // 上次备份以来释放（备份区的索引可能仍引用,暂不复用）
+} tlv_free_extent_t;
+
+/** 空闲区段表（按地址升序,相邻区段已合并） */
+typedef struct
+{
+    bool is_valid;                                   // 表是否可用于分配
+    bool backup_revoked;                             // 备份已因空间不足失效,释放的块可直接复用
+    uint16_t count;                                  // 区段数量
+    tlv_free_extent_t extents[TLV_MAX_FREE_EXTENTS]; // 区段
+} tlv_free_list_t;
+
 /** 事务快照结构 */
 typedef struct
 {
@@ -152,18 +250,52 @@ typedef struct
     uint32_t fragment_count; // 快照时的碎片数量
     uint32_t fragment_size;  // 快照时的碎片大小
     uint32_t tag_count;      // 快照时的Tag数量
+#if TLV_FREE_EXTENT_REUSE
+    tlv_free_list_t free_list; // 快照时的空闲区段表
+#endif
     bool is_active;          // 快照是否激活
 } tlv_transaction_snapshot_t;
 
+/** 数据块信息缓存项（按索引槽位存放,data_addr与索引条目一致时有效） */
+typedef struct
+{
+    uint32_t data_addr;   // 缓存对应的数据块地址（0表示无效）
+    uint32_t write_count; // 数据块写入次数
+    uint16_t length;      // 数据长度
+    bool crc_verified;    // 自写入后整块CRC已校验通过
+} tlv_block_info_t;
+
+/** RAM缓存槽 */
+typedef struct
+{
+    uint16_t tag;                          // 缓存的Tag（0表示空闲）
+    uint16_t length;                       // 数据长度
+    uint32_t last_use;                     // 最近使用序号（LRU淘汰）
+    uint8_t data[TLV_RAM_CACHE_SLOT_SIZE]; // 数据
+} tlv_ram_cache_slot_t;
+
+struct tlv_port_ops; // FRAM设备操作表（见tlv_port.h）
+
 /** 全局上下文结构 */
 typedef struct
 {
     tlv_state_t state;                      // 系统状态
+    const struct tlv_port_ops *ops;         // 绑定的FRAM设备操作表
     tlv_system_header_t *header;            // 系统Header指针
     tlv_index_table_t *index_table;         // 索引表指针
+    uint16_t *index_hash;                   // 索引哈希表指针（Tag->槽位+1,0表示空）
+    tlv_block_info_t *block_info;           // 数据块信息缓存指针（NULL表示未启用）
     const tlv_meta_const_t *meta_table;     // 元数据表
     uint16_t meta_table_size;               // 元数据表大小
     tlv_transaction_snapshot_t snapshot;    // 事务快照
+    bool header_dirty;                      // Header有未落盘的统计字段（写回模式）
+    bool index_crc_dirty;                   // FRAM中整表CRC已过期（写回模式）
+    uint32_t backup_dirty;                  // 自上次备份后被修改的管理区页（位图）
+    bool clean_marked;                      // FRAM中的Header仍带有正常关机标记（首次修改前清除）
+    uint8_t header_copy;                    // FRAM中最新的Header副本（下次保存写入另一份）
+    uint32_t index_unverified;              // 快速启动后尚未校验的索引页（位图）
+    uint32_t backup_addr;                   // 备份区起始地址（存储布局决定,同时是数据块地址上限）
+    uint32_t mirror_addr;                   // 镜像区起始地址（存储布局决定）
     uint8_t static_buffer[TLV_BUFFER_SIZE]; // 静态分配的缓冲区
 } tlv_context_t;
 
@@ -179,9 +311,94 @@ typedef struct
     uint32_t used_space;       // 已用空间
     uint32_t fragmentation;    // 碎片化程度
     uint32_t corruption_count; // 损坏计数
+    uint32_t cache_hits;       // RAM缓存命中次数
+    uint32_t cache_misses;     // RAM缓存未命中次数（仅统计可缓存的Tag）
+    uint32_t cache_hit_rate;   // RAM缓存命中率（百分比）
+    uint32_t hot_tags;         // 热点Tag数（累计写入次数不低于TLV_WEAR_RELOCATE_WRITES）
+    uint32_t max_write_count;  // 单个Tag的最大累计写入次数
+    uint32_t wear_relocations; // 初始化以来磨损均衡触发的迁移次数
 } tlv_statistics_t;
+
+/** GC统计（均由Header空间字段与计数器直接得出,O(1)） */
+typedef struct
+{
+    uint32_t region_size;      // 数据区大小
+    uint32_t used_space;       // 有效数据块占用的空间
+    uint32_t reclaimable;      // 可回收空间（空洞,整理后并入尾部）
+    uint32_t headroom;         // 尾部连续可分配空间
+    uint32_t fragment_count;   // 空洞数量
+    uint32_t gc_triggers;      // 初始化以来策略触发次数
+    uint32_t sync_compactions; // 初始化以来同步整理次数
+    uint32_t pending;          // 1: 整理已调度或进行中
+} tlv_gc_stats_t;
 #pragma pack()
 
+/** GC触发原因 */
+typedef enum
+{
+    TLV_GC_REASON_HEADROOM = 0,  // 尾部余量低于TLV_GC_HEADROOM_PERCENT且可回收空间足够
+    TLV_GC_REASON_ALLOC,         // 本次分配在空洞与尾部均失败,整理后可以满足
+    TLV_GC_REASON_FRAGMENTATION  // 碎片化达到TLV_AUTO_DEFRAG_THRESHOLD（仅定义该宏时）
+} tlv_gc_reason_t;
+
+/** GC动作（由GC回调返回） */
+typedef enum
+{
+    TLV_GC_DEFER = 0, // 调度增量整理,由空闲任务调用tlv_defrag_step执行
+    TLV_GC_NOW,       // 立即同步整理
+    TLV_GC_SKIP       // 本次不整理
+} tlv_gc_action_t;
+
+/**
+ * @brief GC回调：决定整理的执行时机
+ * @param reason 触发原因
+ * @param required 分配失败的字节数（TLV_GC_REASON_ALLOC）,其他原因为0
+ * @param stats 触发时的GC统计
+ * @param user_data 注册时的用户数据
+ * @return 整理动作
+ * @note 在写锁内调用,回调中不能调用存储系统接口
+ */
+typedef tlv_gc_action_t (*tlv_gc_callback_t)(tlv_gc_reason_t reason, uint32_t required, const tlv_gc_stats_t *stats,
+                                             void *user_data);
+
+#if TLV_PERF_STATS
+/** 性能统计的操作类型 */
+typedef enum
+{
+    TLV_PERF_OP_READ = 0,   // tlv_read
+    TLV_PERF_OP_WRITE,      // tlv_write
+    TLV_PERF_OP_DELETE,     // tlv_delete
+    TLV_PERF_OP_FLUSH,      // tlv_flush
+    TLV_PERF_OP_DEFRAG,     // tlv_defragment/tlv_defrag_step与写入时的同步整理
+    TLV_PERF_OP_BACKUP,     // tlv_backup_all
+    TLV_PERF_OP_VERIFY,     // tlv_verify_all
+    TLV_PERF_OP_MIGRATE,    // 读取时的版本迁移（含写回）与tlv_migrate_step
+    TLV_PERF_OP_PORT_READ,  // 端口同步读取（含分散读取）
+    TLV_PERF_OP_PORT_WRITE, // 端口同步写入（含聚集写入）
+    TLV_PERF_OP_COUNT
+} tlv_perf_op_t;
+
+/** 单个操作的耗时统计（单位：tlv_port_get_perf_tick的tick） */
+typedef struct
+{
+    uint32_t count;                            // 调用次数
+    uint32_t errors;                           // 返回错误码的次数
+    uint32_t min_ticks;                        // 最短耗时
+    uint32_t max_ticks;                        // 最长耗时
+    uint32_t avg_ticks;                        // 平均耗时（tlv_get_perf_stats时计算）
+    uint64_t total_ticks;                      // 累计耗时
+    uint32_t histogram[TLV_PERF_HIST_BUCKETS]; // 耗时对数直方图
+} tlv_perf_op_stats_t;
+
+/** 性能统计 */
+typedef struct
+{
+    tlv_perf_op_stats_t ops[TLV_PERF_OP_COUNT]; // 按tlv_perf_op_t索引
+    uint64_t bytes_read;                        // 端口读取字节数（含异步）
+    uint64_t bytes_written;                     // 端口写入字节数（含异步）
+} tlv_perf_stats_t;
+#endif
+
 /* ============================ 流式操作相关 ============================ */
 /** 流句柄类型（不透明类型） */
 typedef int32_t tlv_stream_handle_t;
@@ -211,6 +428,17 @@ typedef struct
     tlv_index_entry_t *old_index; // 旧索引指针（用于标记脏块）
     uint32_t old_block_size;      // 旧块大小（用于碎片统计）
     uint32_t magic;               // 魔数（用于验证句柄有效性）
+#if TLV_COMPRESS_ENABLE
+    uint16_t stored_len;          // 压缩块的数据区长度（读取压缩块时有效）
+    bool compressed;              // 读取的是压缩块（total_len为原始长度）
+    tlv_lz_decoder_t lz;          // 分段解压状态
+    uint8_t lz_window[TLV_LZ_WINDOW_SIZE]; // 解压历史窗口
+#endif
+#if TLV_STREAM_BUFFER_SIZE > 0
+    uint16_t buf_len;             // 暂存字节数（写：待写入；读：已预读）
+    uint16_t buf_pos;             // 读取时已取走的暂存字节数
+    uint8_t buf[TLV_STREAM_BUFFER_SIZE]; // 暂存缓冲区
+#endif
 } tlv_stream_context_internal_t;
 
 /** 流式操作上下文 */
@@ -221,6 +449,272 @@ typedef struct
 
 /** 句柄魔数（用于验证） */
 #define TLV_STREAM_MAGIC 0x53545246 // "STRF" (STReam Frame)
+
+/* ============================ 异步操作相关 ============================ */
+/** 单次写入的空间与索引规划（tlv_write与tlv_write_async共用） */
+typedef struct
+{
+    const tlv_meta_const_t *meta; // 元数据
+    tlv_index_entry_t *index;     // 现有索引（新Tag为NULL）
+    uint32_t target_addr;         // 新数据块地址
+    uint32_t old_addr;            // 旧数据块地址
+    uint32_t old_block_size;      // 旧块大小
+    uint32_t new_block_size;      // 新块大小
+    uint32_t write_count;         // 新块写入次数
+    uint16_t len;                 // 数据块数据长度（压缩时为压缩后长度）
+    uint16_t raw_len;             // 原始数据长度
+    const void *block_data;       // 写入数据块的数据（压缩时指向static_buffer）
+    uint8_t block_flags;          // 数据块标志
+    bool is_update;               // 原地覆盖旧块
+    bool need_add_index;          // 需要新增索引
+    bool need_relocate;           // 旧块迁移到新地址
+} tlv_write_plan_t;
+
+/** 打开的环形日志（由块Header与控制头解析出的布局） */
+typedef struct
+{
+    uint32_t data_addr;   // 日志块地址
+    uint32_t next_seq;    // 下一条记录的序号
+    uint16_t record_size; // 单条记录最大长度
+    uint16_t slot_count;  // 记录槽位数
+} tlv_log_ring_t;
+
+/**
+ * @brief 异步操作完成回调（在tlv_async_poll()中调用,不在中断上下文）
+ * @param tag Tag值
+ * @param result 0: 成功, 其他: 错误码
+ * @param len 读取的数据长度（写入时为写入长度）
+ * @param user_data 用户数据
+ */
+typedef void (*tlv_async_callback_t)(uint16_t tag, int result, uint16_t len, void *user_data);
+
+/** 异步操作类型 */
+typedef enum
+{
+    TLV_ASYNC_OP_NONE = 0,  // 空闲
+    TLV_ASYNC_OP_READ = 1,  // 读取
+    TLV_ASYNC_OP_WRITE = 2, // 写入
+} tlv_async_op_t;
+
+/** 异步传输阶段：数据块按 Header -> Data -> CRC16 分三次传输 */
+typedef enum
+{
+    TLV_ASYNC_STAGE_HEADER = 0,
+    TLV_ASYNC_STAGE_DATA = 1,
+    TLV_ASYNC_STAGE_CRC = 2,
+    TLV_ASYNC_STAGE_DONE = 3,
+} tlv_async_stage_t;
+
+/** 异步操作上下文（同一时刻只有一个异步操作） */
+typedef struct
+{
+    uint8_t op;                     // 操作类型 tlv_async_op_t
+    uint8_t stage;                  // 当前传输阶段 tlv_async_stage_t
+    bool from_cache;                // 读取命中RAM缓存,无需传输
+    volatile bool xfer_pending;     // 传输进行中（完成回调中清除）
+    volatile int xfer_result;       // 最近一次传输的结果
+    uint16_t tag;                   // Tag值
+    uint32_t addr;                  // 数据块地址
+    void *buf;                      // 读：输出缓冲区；写：用户数据（回调前保持有效）
+    uint16_t buf_size;              // 输出缓冲区大小
+    uint16_t len;                   // 数据长度
+    tlv_data_block_header_t header; // 数据块Header
+    uint16_t crc16;                 // 数据块CRC16
+    tlv_write_plan_t plan;          // 写入规划
+    tlv_async_callback_t callback;  // 完成回调
+    void *user_data;                // 用户数据
+} tlv_async_context_t;
+
+/* ============================ 事务相关 ============================ */
+/** 事务挂起条目（RAM） */
+typedef struct
+{
+    uint16_t tag;         // Tag值
+    uint8_t version;      // 数据版本号
+    uint32_t data_addr;   // 新数据块地址
+    uint32_t block_size;  // 新数据块大小
+    uint32_t write_count; // 新数据块写入次数
+} tlv_txn_pending_t;
+
+/** 事务上下文 */
+typedef struct
+{
+    bool is_active;                                // 事务是否进行中
+    uint16_t count;                                // 挂起条目数
+    uint16_t new_tag_count;                        // 需要新增索引的Tag数
+    tlv_txn_pending_t pending[TLV_MAX_TXN_ENTRIES]; // 挂起条目
+} tlv_txn_context_t;
+
+/** 增量碎片整理上下文 */
+typedef struct
+{
+    bool is_active;    // 整理进行中
+    bool is_scheduled; // 自动整理已调度
+    bool compact_now;  // GC回调要求在写接口返回前同步整理
+    uint32_t cursor;   // 已压缩区域末端
+    uint32_t vacated_start; // 上次备份以来腾出的区域（备份区中的索引可能仍引用,不能搬入）
+    uint32_t vacated_end;
+} tlv_defrag_context_t;
+
+/** 批量迁移进度 */
+typedef struct
+{
+    bool active;       // 本轮迁移进行中（期间不调度自动碎片整理）
+    uint16_t total;    // 本轮开始时需要迁移的Tag数
+    uint16_t migrated; // 已迁移的Tag数
+    uint16_t failed;   // 无法迁移的Tag数（无迁移函数、版本降级、超出缓冲区或数据损坏）
+} tlv_migrate_progress_t;
+
+/** 增量批量迁移上下文 */
+typedef struct
+{
+    tlv_migrate_progress_t progress; // 本轮进度
+    uint32_t next_tag;               // 下一个检查的Tag（按Tag值递增遍历,不受索引槽位重排影响）
+    uint8_t *work_buf;               // 超过TLV_BUFFER_SIZE的Tag使用的工作缓冲区（可为NULL）
+    uint16_t work_size;              // 工作缓冲区大小
+} tlv_migrate_context_t;
+
+/** 后台巡检结果（当前轮或最近完成的一轮） */
+typedef struct
+{
+    bool active;                                   // 本轮巡检进行中
+    uint16_t scanned;                              // 已校验的块数
+    uint16_t corrupted;                            // 发现损坏的块数（含超出记录容量的部分）
+    uint16_t repaired;                             // 已自动修复的块数
+    uint16_t corrupted_tags[TLV_SCRUB_MAX_REPORT]; // 损坏Tag列表（前TLV_SCRUB_MAX_REPORT个）
+} tlv_scrub_result_t;
+
+/** 后台巡检上下文 */
+typedef struct
+{
+    tlv_scrub_result_t result; // 本轮结果
+    uint32_t cursor;           // 下一个待校验的地址（按地址递增遍历,不受索引槽位重排影响）
+} tlv_scrub_context_t;
+
+#pragma pack(1)
+/** 事务提交日志（FRAM,重做日志：提交点在日志落盘,启动时重放） */
+typedef struct
+{
+    uint16_t magic;                                // 日志魔数（0表示无待重放事务）
+    uint16_t count;                                // 记录数
+    tlv_index_entry_t records[TLV_MAX_TXN_ENTRIES]; // 待发布的索引条目
+    uint16_t crc16;                                // 日志CRC16（magic ~ records）
+} tlv_txn_log_t;
+#pragma pack()
+
+/** 事务日志魔数 */
+#define TLV_TXN_LOG_MAGIC 0x5458 // "TX"
+
+/** 正常关机标记 */
+#define TLV_CLEAN_SHUTDOWN_MAGIC 0x434C4E53 // "CLNS"
+
+/** 备份恢复进行中标记（恢复中途掉电时下次启动重新恢复） */
+#define TLV_RESTORE_PENDING_MAGIC 0x52535450 // "RSTP"
+
+/** 事务日志起始地址（紧跟索引页CRC表） */
+#define TLV_TXN_LOG_ADDR (TLV_INDEX_PAGE_CRC_ADDR + sizeof(tlv_index_page_crc_t))
+
+#pragma pack(1)
+/** 备份页CRC表（位于备份区末尾,管理区未使用部分不参与备份） */
+typedef struct
+{
+    uint16_t magic;                             // 表魔数（不匹配表示旧格式整区备份）
+    uint16_t page_crc16[TLV_BACKUP_PAGE_COUNT]; // 各备份页CRC16
+} tlv_backup_crc_table_t;
+#pragma pack()
+
+/** 备份页CRC表魔数 */
+#define TLV_BACKUP_CRC_MAGIC 0x4250 // "BP"
+
+/** 备份页CRC表在备份区内的偏移（位于备份区末尾,即FRAM末尾） */
+#define TLV_BACKUP_CRC_OFFSET (TLV_DATA_REGION_SIZE - sizeof(tlv_backup_crc_table_t))
+
+/** 需要备份的页数（覆盖Header、索引表、索引页CRC表与事务日志） */
+#define TLV_BACKUP_COVER_PAGES \
+    ((TLV_TXN_LOG_ADDR + sizeof(tlv_txn_log_t) - TLV_HEADER_ADDR + TLV_BACKUP_PAGE_SIZE - 1) / TLV_BACKUP_PAGE_SIZE)
+
+/** 全部备份页的脏页位图 */
+#define TLV_BACKUP_DIRTY_ALL (UINT32_MAX >> (32 - TLV_BACKUP_COVER_PAGES))
+
+/* ============================ 提交日志 ============================ */
+#pragma pack(1)
+/** 提交日志Header（FRAM,只在检查点与初始化时写入） */
+typedef struct
+{
+    uint32_t epoch;  // 检查点代号（每次检查点加1,记录CRC包含代号,旧代号的记录自动失效）
+    uint16_t magic;  // 日志魔数
+    uint16_t crc16;  // Header CRC16（epoch ~ magic）
+} tlv_journal_header_t;
+
+/** 提交日志记录（FRAM,顺序追加,写入即为提交点） */
+typedef struct
+{
+    tlv_index_entry_t entry; // 提交后的索引条目（flags无TLV_FLAG_VALID表示删除）
+    uint16_t length;         // 数据长度（块Header中的length）
+    uint16_t crc16;          // 记录CRC16（检查点代号 + entry ~ length）
+} tlv_journal_record_t;
+#pragma pack()
+
+/** 提交日志运行时状态 */
+typedef struct
+{
+    uint32_t epoch;       // 当前检查点代号
+    uint16_t count;       // 已追加的记录数
+    uint32_t dirty_pages; // 自上次检查点后修改过的索引页（位图）
+} tlv_journal_context_t;
+
+/** 提交日志魔数 */
+#define TLV_JOURNAL_MAGIC 0x4A4C // "JL"
+
+/** 提交日志起始地址（备份覆盖的最后一页之后,日志不随管理区备份与恢复） */
+#define TLV_JOURNAL_ADDR (TLV_HEADER_ADDR + TLV_BACKUP_COVER_PAGES * TLV_BACKUP_PAGE_SIZE)
+
+/** 第n条提交日志记录的地址 */
+#define TLV_JOURNAL_RECORD_ADDR(n) \
+    (TLV_JOURNAL_ADDR + sizeof(tlv_journal_header_t) + (uint32_t)(n) * sizeof(tlv_journal_record_t))
+
+/* ============================ 数据镜像 ============================ */
+#pragma pack(1)
+/**
+ * 数据镜像Header（tlv_export_image/tlv_import_image）
+ * 镜像格式：Header + 紧凑排列的数据块（FRAM存储格式,首尾相接）+ 全部数据块字节的CRC16（2字节）,
+ * 索引由导入时按序解析块Header重建
+ */
+typedef struct
+{
+    uint32_t magic;        // 镜像魔数（TLV_IMAGE_MAGIC）
+    uint16_t version;      // 镜像格式版本（TLV_IMAGE_VERSION）
+    uint16_t tag_count;    // 数据块数量
+    uint32_t data_size;    // 数据块总字节数（导入时依次写到数据区起始处）
+    uint16_t reserved;     // 保留（0）
+    uint16_t header_crc16; // 镜像Header自身CRC16（不含本字段）
+} tlv_image_header_t;
+#pragma pack()
+
+/** 数据镜像魔数 */
+#define TLV_IMAGE_MAGIC 0x474D4954 // "TIMG"
+
+/** 数据镜像格式版本 */
+#define TLV_IMAGE_VERSION 1
+
+/**
+ * @brief 数据镜像输出回调（tlv_export_image）
+ * @param data 镜像数据
+ * @param len 数据长度
+ * @param user_data 用户数据
+ * @return 0: 成功, 其他: 中止导出
+ */
+typedef int (*tlv_image_write_t)(const void *data, uint16_t len, void *user_data);
+
+/**
+ * @brief 数据镜像输入回调（tlv_import_image）
+ * @param buf 输出缓冲区,须填满len字节
+ * @param len 需要的字节数
+ * @param user_data 用户数据
+ * @return 0: 成功, 其他: 中止导入（数据不足也应返回错误）
+ */
+typedef int (*tlv_image_read_t)(void *buf, uint16_t len, void *user_data);
+
 /* ============================ 错误上下文 ============================ */
  
 /** 错误信息结构 */
@@ -234,13 +728,13 @@ typedef struct {
 
 /* ============================ 地址范围检查宏 ============================ */
 
-/** 检查地址是否在有效范围内 */
-#define TLV_IS_VALID_ADDR(addr) \
-    ((addr) >= TLV_DATA_ADDR && (addr) < TLV_BACKUP_ADDR)
+/** 检查地址是否在有效范围内（备份区地址由上下文中的存储布局决定） */
+#define TLV_IS_VALID_ADDR(ctx, addr) \
+    ((addr) >= TLV_DATA_ADDR && (addr) < (ctx)->backup_addr)
 
 /** 检查大小是否会导致越界 */
-#define TLV_IS_SIZE_SAFE(addr, size) \
-    ((addr) >= TLV_DATA_ADDR && (addr) + (size) <= TLV_BACKUP_ADDR)
+#define TLV_IS_SIZE_SAFE(ctx, addr, size) \
+    ((addr) >= TLV_DATA_ADDR && (addr) + (size) <= (ctx)->backup_addr)
 
 /** 检查两个区域是否重叠 */
 #define TLV_REGIONS_OVERLAP(start1, size1, start2, size2)         \
@@ -251,12 +745,35 @@ typedef struct {
 STATIC_ASSERT(sizeof(tlv_system_header_t) == 256, "tlv_system_header_t size == 256");
 STATIC_ASSERT(sizeof(tlv_data_block_header_t) == 14, "tlv_data_block_header_t size == 14");
 STATIC_ASSERT(sizeof(tlv_index_entry_t) == 8, "tlv_index_entry_t size == 8");
-STATIC_ASSERT(sizeof(tlv_index_table_t) == 2050, "tlv_index_table_t size == 2050");
+STATIC_ASSERT(sizeof(tlv_image_header_t) == 16, "tlv_image_header_t size == 16");
+STATIC_ASSERT(sizeof(tlv_index_table_t) == TLV_MAX_TAG_COUNT * sizeof(tlv_index_entry_t) + sizeof(uint16_t), "tlv_index_table_t size == entries + crc16");
 
-// 检查索引区域一定大于系统头大小
-STATIC_ASSERT(TLV_INDEX_ADDR >= sizeof(tlv_system_header_t), "TLV_INDEX_ADDR > tlv_system_header_t size");
+// 检查索引区域一定大于系统头大小（两份副本）
+STATIC_ASSERT(TLV_INDEX_ADDR >= TLV_HEADER_COPY_ADDR(TLV_HEADER_COPIES), "TLV_INDEX_ADDR > tlv_system_header_t copies size");
 // 检查数据区域一定大于索引区域大小
 STATIC_ASSERT(TLV_DATA_ADDR >= TLV_INDEX_ADDR + sizeof(tlv_index_table_t), "TLV_DATA_ADDR > tlv_index_table_t size");
+// 检查索引页CRC表不越过数据区
+STATIC_ASSERT(TLV_DATA_ADDR >= TLV_INDEX_PAGE_CRC_ADDR + sizeof(tlv_index_page_crc_t), "TLV_DATA_ADDR > index page crc table end");
+// 检查事务日志不越过数据区
+STATIC_ASSERT(TLV_DATA_ADDR >= TLV_TXN_LOG_ADDR + sizeof(tlv_txn_log_t), "TLV_DATA_ADDR > txn log end");
+// 检查事务日志可在静态缓冲区中组装
+STATIC_ASSERT(sizeof(tlv_txn_log_t) <= TLV_BUFFER_SIZE, "tlv_txn_log_t size <= TLV_BUFFER_SIZE");
+// 检查提交日志记录的大小
+STATIC_ASSERT(sizeof(tlv_journal_record_t) == 12, "tlv_journal_record_t size == 12");
+#if TLV_JOURNAL_ENABLE
+// 检查提交日志不越过数据区
+STATIC_ASSERT(TLV_DATA_ADDR >= TLV_JOURNAL_RECORD_ADDR(TLV_JOURNAL_ENTRIES), "TLV_DATA_ADDR > journal end");
+// 检查提交日志记录数不超过计数器范围
+STATIC_ASSERT(TLV_JOURNAL_ENTRIES > 0 && TLV_JOURNAL_ENTRIES <= UINT16_MAX, "0 < TLV_JOURNAL_ENTRIES <= UINT16_MAX");
+#endif
+// 检查备份页与页CRC表不重叠
+STATIC_ASSERT(TLV_BACKUP_COVER_PAGES * TLV_BACKUP_PAGE_SIZE <= TLV_BACKUP_CRC_OFFSET, "backup pages overlap backup crc table");
+// 检查脏页位图容量
+STATIC_ASSERT(TLV_BACKUP_COVER_PAGES <= 32, "TLV_BACKUP_COVER_PAGES <= 32 (uint32_t bitmap)");
+// 检查待校验索引页位图容量
+STATIC_ASSERT(TLV_INDEX_PAGE_COUNT <= 32, "TLV_INDEX_PAGE_COUNT <= 32 (uint32_t bitmap)");
+// 检查恢复时两页可同时放入静态缓冲区
+STATIC_ASSERT(TLV_BACKUP_PAGE_SIZE * 2 <= TLV_BUFFER_SIZE, "TLV_BACKUP_PAGE_SIZE * 2 <= TLV_BUFFER_SIZE");
 // 检查备份数据区域大小一定等于系统头及索引区域预留大小
 STATIC_ASSERT(TLV_DATA_ADDR - TLV_HEADER_ADDR == TLV_DATA_REGION_SIZE, "TLV_BACKUP_ADDR_size must == tlv_system_header_t and tlv_index_table_t reserve size");
 
@@ -43,6 +43,14 @@ uint16_t tlv_crc16_final(uint16_t crc);
  */
 uint16_t tlv_crc16(const void *data, uint32_t size);
  
+/**
+ * @brief CRC16寄存器跨过size个零字节（增量更新CRC时跨过未修改的数据）
+ * @param crc 当前CRC值（未经tlv_crc16_final）
+ * @param size 零字节个数
+ * @return 等价于tlv_crc16_update(crc, zeros, size)的值
+ */
+uint16_t tlv_crc16_shift(uint16_t crc, uint32_t size);
+ 
 /* ============================ 字节序转换 ============================ */
  
 /**
@@ -0,0 +1,62 @@
+/**
+ * @file tlv_meta_list.h
+ * @author wuwenbo
+ * @brief TLV元数据列表声明
+ * @version 1.0
+ * @date 2025-12-05
+ * 
+ * @copyright Copyright (c) 2025
+ * @note 元数据只在TLV_META_LIST中声明一次,tlv_meta_table.c据此生成元数据表,
+ *       本文件据此生成行号与类型化访问函数（格式见tlv_meta_table.h中的元数据声明宏）。
+ */
+
+#ifndef __TLV_META_LIST_H__
+#define __TLV_META_LIST_H__
+
+#include "tlv_fram.h"
+#include "tlv_meta_table.h"
+#include "tlv_tag.h"
+#include "system_config_versions.h"
+
+/* ============================ 元数据列表 ============================ */
+// X: Name  Tag  Type  MaxLen  Prior  Ver  Bkup  Migrate  Cache  LogRecord  Compress
+// B: Name  Tag        MaxLen  Prior  Ver  Bkup  Migrate  Cache  LogRecord  Compress
+#define TLV_META_LIST(X, B) \
+    X(SystemConfig,        TAG_SYSTEM_CONFIG,         system_config_v1_t, 64, 10, 1, 1, migrate_system_config, 0, 0, 0) \
+    B(SystemCalibration,   TAG_SYSTEM_CALIBRATION,    128, 10, 1, 1, NULL, 0, 0, 1) \
+    B(SerialNumber,        TAG_SYSTEM_SERIAL_NUMBER,  32,  10, 1, 1, NULL, 0, 0, 0) \
+    B(MACAddress,          TAG_SYSTEM_MAC_ADDRESS,    8,   10, 1, 1, NULL, 0, 0, 0) \
+    X(BootCount,           TAG_SYSTEM_BOOT_COUNT,     uint32_t, 4, 5, 1, 0, NULL, 1, 0, 0) \
+                                                                                 \
+    B(SensorCalibTemp,     TAG_SENSOR_CALIB_TEMP,     16,  8,  1, 1, NULL, 0, 0, 0) \
+    B(SensorCalibPressure, TAG_SENSOR_CALIB_PRESSURE, 16,  8,  1, 1, NULL, 0, 0, 0) \
+    B(SensorCalibHumidity, TAG_SENSOR_CALIB_HUMIDITY, 16,  8,  1, 1, NULL, 0, 0, 0) \
+    B(SensorOffsetX,       TAG_SENSOR_OFFSET_X,       12,  6,  1, 0, NULL, 1, 0, 0) \
+    B(SensorOffsetY,       TAG_SENSOR_OFFSET_Y,       12,  6,  1, 0, NULL, 1, 0, 0) \
+    B(SensorOffsetZ,       TAG_SENSOR_OFFSET_Z,       12,  6,  1, 0, NULL, 1, 0, 0) \
+                                                                                 \
+    B(IPAddress,           TAG_NET_IP_ADDRESS,        16,  7,  1, 1, NULL, 1, 0, 0) \
+    B(SubnetMask,          TAG_NET_SUBNET_MASK,       16,  7,  1, 1, NULL, 1, 0, 0) \
+    B(Gateway,             TAG_NET_GATEWAY,           16,  7,  1, 1, NULL, 1, 0, 0) \
+    B(DNSServer,           TAG_NET_DNS_SERVER,        16,  7,  1, 1, NULL, 1, 0, 0) \
+    B(WiFiSSID,            TAG_NET_WIFI_SSID,         64,  7,  1, 1, NULL, 0, 0, 0) \
+    B(WiFiPassword,        TAG_NET_WIFI_PASSWORD,     64,  7,  1, 1, NULL, 0, 0, 0) \
+                                                                                 \
+    B(UserProfile,         TAG_USER_PROFILE,          256, 5,  1, 1, NULL, 0, 0, 0) \
+    B(UserSettings,        TAG_USER_SETTINGS,         128, 5,  1, 1, NULL, 0, 0, 0) \
+    B(UserPreferences,     TAG_USER_PREFERENCES,      64,  5,  1, 0, NULL, 0, 0, 0) \
+    B(UserHistory,         TAG_USER_HISTORY,          512, 3,  1, 0, NULL, 0, 0, 1) \
+    B(UserEventLog,        TAG_USER_EVENT_LOG,        512, 3,  1, 0, NULL, 0, 24, 0)
+
+/* ============================ 行号与访问函数 ============================ */
+/** 元数据表行号（TLV_META_ROW_<Name>）,TLV_META_ROW_COUNT为条目数 */
+enum
+{
+    TLV_META_LIST(TLV_META_ROW_INDEX, TLV_META_ROW_INDEX_RAW)
+    TLV_META_ROW_COUNT
+};
+
+/** 类型化访问函数：tlv_get_<Name>() / tlv_set_<Name>() */
+TLV_META_LIST(TLV_META_ACCESSOR, TLV_META_NONE)
+
+#endif
@@ -44,6 +44,351 @@ int tlv_port_fram_write(uint32_t addr, const void *data, uint32_t size)
     return (ret == 0) ? TLV_OK : TLV_ERROR;
 }
  
+#if TLV_PORT_VECTOR_IO
+int tlv_port_fram_writev(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+    if (!iov || iovcnt == 0) {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 示例实现：逐段写入。若驱动支持片选保持的连续传输,
+    // 可在此只发送一次写命令与地址,再依次发送各段数据
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        if (Fram_Write(addr, iov[i].size, (uint8_t *)iov[i].base) != 0) {
+            return TLV_ERROR;
+        }
+        addr += iov[i].size;
+    }
+
+    return TLV_OK;
+}
+
+int tlv_port_fram_readv(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+    if (!iov || iovcnt == 0) {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        if (Fram_Read(addr, iov[i].size, (uint8_t *)iov[i].base) != 0) {
+            return TLV_ERROR;
+        }
+        addr += iov[i].size;
+    }
+
+    return TLV_OK;
+}
+#endif
+ 
+#if TLV_ASYNC_ENABLE
+/* ============================ 异步传输接口实现 ============================ */
+
+// 示例：假设SPI驱动提供DMA版本 Fram_Read_DMA/Fram_Write_DMA（发送命令与地址后启动DMA并立即返回）,
+// 中断模式下在DMA完成回调（如HAL_SPI_TxRxCpltCallback/HAL_SPI_TxCpltCallback）中释放片选
+// 并调用 tlv_port_fram_dma_complete()；轮询模式下由 tlv_port_fram_async_poll() 检测完成
+static tlv_port_async_cb_t s_async_cb = NULL;
+static void *s_async_arg = NULL;
+
+int tlv_port_fram_read_async(uint32_t addr, void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg)
+{
+    if (!data || size == 0 || !cb) {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    s_async_cb = cb;
+    s_async_arg = arg;
+    if (Fram_Read_DMA(addr, size, (uint8_t *)data) != 0) {
+        s_async_cb = NULL;
+        return TLV_ERROR;
+    }
+
+    return TLV_OK;
+}
+
+int tlv_port_fram_write_async(uint32_t addr, const void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg)
+{
+    if (!data || size == 0 || !cb) {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    s_async_cb = cb;
+    s_async_arg = arg;
+    if (Fram_Write_DMA(addr, size, (uint8_t *)data) != 0) {
+        s_async_cb = NULL;
+        return TLV_ERROR;
+    }
+
+    return TLV_OK;
+}
+
+/**
+ * @brief DMA传输结束（中断模式下在DMA完成中断中调用）
+ * @param result 0: 成功, 其他: 错误码
+ */
+void tlv_port_fram_dma_complete(int result)
+{
+    tlv_port_async_cb_t cb = s_async_cb;
+    s_async_cb = NULL;
+    if (cb) {
+        cb(result, s_async_arg);
+    }
+}
+
+#if TLV_PORT_ASYNC_POLL
+void tlv_port_fram_async_poll(void)
+{
+    // 裸机轮询：DMA已结束时完成本次传输
+    if (s_async_cb && !Fram_DMA_Busy()) {
+        tlv_port_fram_dma_complete(TLV_OK);
+    }
+}
+#endif
+#endif
+
+#if TLV_PORT_DUAL_FRAM
+/* ============================ 双片FRAM组合端口 ============================ */
+
+// 示例：两片FRAM分别挂在SPI1/SPI2,驱动为 Fram_Read/Fram_Write（片0）与 Fram2_Read/Fram2_Write（片1）,
+// 各驱动自行保护所在总线；线程安全模式下持读锁的任务访问不同片上的Tag时可并行传输
+static int dual_chip_xfer(int chip, uint32_t addr, uint8_t *data, uint32_t size, bool is_write)
+{
+    int ret;
+    if (chip == 0) {
+        ret = is_write ? Fram_Write(addr, size, data) : Fram_Read(addr, size, data);
+    } else {
+        ret = is_write ? Fram2_Write(addr, size, data) : Fram2_Read(addr, size, data);
+    }
+
+    return (ret == 0) ? TLV_OK : TLV_ERROR;
+}
+
+/**
+ * @brief 按逻辑地址拆分到两片（跨片边界的传输拆为两次）
+ */
+static int dual_xfer(uint32_t addr, uint8_t *data, uint32_t size, bool is_write)
+{
+    if (!data || size == 0 || addr + size > TLV_FRAM_MAX_SIZE) {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (addr < TLV_FRAM_CHIP0_SIZE) {
+        uint32_t n = TLV_FRAM_CHIP0_SIZE - addr;
+        if (n > size) {
+            n = size;
+        }
+
+        int ret = dual_chip_xfer(0, addr, data, n, is_write);
+        if (ret != TLV_OK || n == size) {
+            return ret;
+        }
+
+        addr += n;
+        data += n;
+        size -= n;
+    }
+
+    return dual_chip_xfer(1, addr - TLV_FRAM_CHIP0_SIZE, data, size, is_write);
+}
+
+static int dual_fram_read(uint32_t addr, void *data, uint32_t size)
+{
+    return dual_xfer(addr, (uint8_t *)data, size, false);
+}
+
+static int dual_fram_write(uint32_t addr, const void *data, uint32_t size)
+{
+    return dual_xfer(addr, (uint8_t *)data, size, true);
+}
+
+#if TLV_PORT_VECTOR_IO
+static int dual_fram_writev(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        if (iov[i].size == 0) {
+            continue;
+        }
+        int ret = dual_xfer(addr, (uint8_t *)iov[i].base, iov[i].size, true);
+        if (ret != TLV_OK) {
+            return ret;
+        }
+        addr += iov[i].size;
+    }
+
+    return TLV_OK;
+}
+
+static int dual_fram_readv(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+    for (uint32_t i = 0; i < iovcnt; i++) {
+        if (iov[i].size == 0) {
+            continue;
+        }
+        int ret = dual_xfer(addr, (uint8_t *)iov[i].base, iov[i].size, false);
+        if (ret != TLV_OK) {
+            return ret;
+        }
+        addr += iov[i].size;
+    }
+
+    return TLV_OK;
+}
+#endif
+
+#if TLV_ASYNC_ENABLE
+/**
+ * @brief 在地址所在片上启动DMA传输（与单片示例共用完成回调 tlv_port_fram_dma_complete）
+ * @note 异步传输一次只传输数据块的一部分,跨片边界的请求不拆分,直接返回错误
+ */
+static int dual_async_start(uint32_t addr, uint8_t *data, uint32_t size, bool is_write,
+                            tlv_port_async_cb_t cb, void *arg)
+{
+    if (!data || size == 0 || !cb || addr + size > TLV_FRAM_MAX_SIZE) {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+    if (addr < TLV_FRAM_CHIP0_SIZE && addr + size > TLV_FRAM_CHIP0_SIZE) {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    s_async_cb = cb;
+    s_async_arg = arg;
+
+    int ret;
+    if (addr < TLV_FRAM_CHIP0_SIZE) {
+        ret = is_write ? Fram_Write_DMA(addr, size, data) : Fram_Read_DMA(addr, size, data);
+    } else {
+        addr -= TLV_FRAM_CHIP0_SIZE;
+        ret = is_write ? Fram2_Write_DMA(addr, size, data) : Fram2_Read_DMA(addr, size, data);
+    }
+
+    if (ret != 0) {
+        s_async_cb = NULL;
+        return TLV_ERROR;
+    }
+
+    return TLV_OK;
+}
+
+static int dual_fram_read_async(uint32_t addr, void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg)
+{
+    return dual_async_start(addr, (uint8_t *)data, size, false, cb, arg);
+}
+
+static int dual_fram_write_async(uint32_t addr, const void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg)
+{
+    return dual_async_start(addr, (uint8_t *)data, size, true, cb, arg);
+}
+#endif
+
+const tlv_port_ops_t tlv_port_dual_fram_ops = {
+    tlv_port_fram_init,
+    dual_fram_read,
+    dual_fram_write,
+#if TLV_PORT_VECTOR_IO
+    dual_fram_writev,
+    dual_fram_readv,
+#endif
+#if TLV_ASYNC_ENABLE
+    dual_fram_read_async,
+    dual_fram_write_async,
+#endif
+};
+#endif
+
+#if TLV_CRC16_BACKEND == TLV_CRC16_BACKEND_PORT
+/* ============================ CRC接口实现 ============================ */
+
+uint16_t tlv_port_crc16_update(uint16_t crc, const void *data, uint32_t size)
+{
+    // STM32硬件CRC示例（需支持可编程多项式的型号,如F0/F3/F7/L4/G4/H7）
+    // hcrc配置：CRC_POLYLENGTH_16B、多项式0x8005、CRC_INPUTDATA_INVERSION_BYTE、
+    //           CRC_OUTPUTDATA_INVERSION_ENABLE、CRC_INPUTDATA_FORMAT_BYTES
+    // 大块数据可改为DMA喂数据,完成后读取DR
+    // 输入/输出反转时寄存器按未反射的顺序运算,续算时INIT须装入位反转后的寄存器值
+    // （0xFFFF反转后不变,只有分段续算的非初值会出错）
+    extern CRC_HandleTypeDef hcrc;
+    hcrc.Instance->INIT = __RBIT(crc) >> 16;
+    __HAL_CRC_DR_RESET(&hcrc);
+    return (uint16_t)HAL_CRC_Accumulate(&hcrc, (uint32_t *)data, size);
+}
+#endif
+ 
+#if TLV_THREAD_SAFE
+/* ============================ 并发接口实现 ============================ */
+
+// FreeRTOS示例：计数信号量记录读者数,独占互斥量保护读者计数与写者
+// 写者持有s_write_mutex期间新读者无法进入；读者全部退出后写者才能获得s_idle
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+static SemaphoreHandle_t s_write_mutex = NULL; // 写者互斥（读者进入时短暂持有）
+static SemaphoreHandle_t s_idle = NULL;        // 无读者时可获取
+static volatile uint32_t s_readers = 0;
+
+int tlv_port_lock_init(void)
+{
+    taskENTER_CRITICAL();
+    if (s_write_mutex == NULL)
+    {
+        s_write_mutex = xSemaphoreCreateMutex();
+        s_idle = xSemaphoreCreateBinary();
+        if (s_idle != NULL)
+        {
+            xSemaphoreGive(s_idle);
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return (s_write_mutex != NULL && s_idle != NULL) ? TLV_OK : TLV_ERROR;
+}
+
+void tlv_port_read_lock(void)
+{
+    xSemaphoreTake(s_write_mutex, portMAX_DELAY);
+    taskENTER_CRITICAL();
+    bool first = (s_readers++ == 0);
+    taskEXIT_CRITICAL();
+    if (first)
+    {
+        xSemaphoreTake(s_idle, portMAX_DELAY);
+    }
+    xSemaphoreGive(s_write_mutex);
+}
+
+void tlv_port_read_unlock(void)
+{
+    // s_idle为二值信号量,可由最后退出的读者（不一定是首个读者）释放
+    taskENTER_CRITICAL();
+    bool last = (--s_readers == 0);
+    taskEXIT_CRITICAL();
+    if (last)
+    {
+        xSemaphoreGive(s_idle);
+    }
+}
+
+void tlv_port_write_lock(void)
+{
+    xSemaphoreTake(s_write_mutex, portMAX_DELAY);
+    xSemaphoreTake(s_idle, portMAX_DELAY);
+}
+
+void tlv_port_write_unlock(void)
+{
+    xSemaphoreGive(s_idle);
+    xSemaphoreGive(s_write_mutex);
+}
+
+void tlv_port_enter_critical(void)
+{
+    taskENTER_CRITICAL();
+}
+
+void tlv_port_exit_critical(void)
+{
+    taskEXIT_CRITICAL();
+}
+#endif
+
 /* ============================ 时间接口实现 ============================ */
  
 uint32_t tlv_port_get_timestamp_s(void)
@@ -56,3 +401,11 @@ uint32_t tlv_port_get_timestamp_ms(void)
 {
     return HAL_GetTick();
 }
+
+#if TLV_PERF_STATS
+uint32_t tlv_port_get_perf_tick(void)
+{
+    // Cortex-M示例：DWT周期计数器（需在初始化时置位CoreDebug->DEMCR的TRCENA与DWT->CTRL的CYCCNTENA）
+    return DWT->CYCCNT;
+}
+#endif
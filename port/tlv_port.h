@@ -39,6 +39,166 @@ int tlv_port_fram_read(uint32_t addr, void *data, uint32_t size);
  */
 int tlv_port_fram_write(uint32_t addr, const void *data, uint32_t size);
  
+/** 分散/聚集传输段 */
+typedef struct
+{
+    void *base;    // 段缓冲区
+    uint32_t size; // 段大小
+} tlv_iovec_t;
+
+#if TLV_PORT_VECTOR_IO
+/**
+ * @brief 聚集写入：将多个段写入FRAM的连续地址（一次传输）
+ * @param addr FRAM起始地址
+ * @param iov 段数组
+ * @param iovcnt 段数量
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_port_fram_writev(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt);
+
+/**
+ * @brief 分散读取：从FRAM的连续地址读取到多个段（一次传输）
+ * @param addr FRAM起始地址
+ * @param iov 段数组
+ * @param iovcnt 段数量
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_port_fram_readv(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt);
+#endif
+
+#if TLV_ASYNC_ENABLE
+/* ============================ 异步传输接口 ============================ */
+
+/**
+ * @brief 异步传输完成回调
+ * @param result 0: 成功, 其他: 错误码
+ * @param arg 启动传输时传入的参数
+ * @note 可在DMA完成中断中调用,回调内只记录结果,不访问FRAM
+ */
+typedef void (*tlv_port_async_cb_t)(int result, void *arg);
+
+/**
+ * @brief 启动异步读取（DMA）
+ * @param addr FRAM地址
+ * @param data 数据缓冲区（传输完成前保持有效）
+ * @param size 读取大小
+ * @param cb 完成回调
+ * @param arg 回调参数
+ * @return 0: 已启动, 其他: 错误码（未启动,不会调用回调）
+ * @note 异步传输进行中时同步读写接口须等待总线空闲
+ */
+int tlv_port_fram_read_async(uint32_t addr, void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg);
+
+/**
+ * @brief 启动异步写入（DMA）
+ * @param addr FRAM地址
+ * @param data 数据缓冲区（传输完成前保持有效）
+ * @param size 写入大小
+ * @param cb 完成回调
+ * @param arg 回调参数
+ * @return 0: 已启动, 其他: 错误码（未启动,不会调用回调）
+ */
+int tlv_port_fram_write_async(uint32_t addr, const void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg);
+
+#if TLV_PORT_ASYNC_POLL
+/**
+ * @brief 轮询异步传输（无中断的裸机轮询模式）
+ * @note 由tlv_async_poll()调用,DMA已完成时在此调用完成回调
+ */
+void tlv_port_fram_async_poll(void);
+#endif
+#endif
+
+/* ============================ 设备操作表 ============================ */
+
+/**
+ * @brief FRAM设备操作表
+ * @note 存储系统经tlv_context_t绑定的操作表访问FRAM（tlv_bind_port）,未绑定时使用上面的
+ *       tlv_port_fram_*接口。地址均为存储系统的逻辑地址（0 ~ TLV_FRAM_MAX_SIZE-1）,
+ *       多片FRAM由操作表把逻辑地址映射到各片,跨片的传输由操作表拆分
+ */
+typedef struct tlv_port_ops
+{
+    int (*init)(void);                                                // 初始化（可为NULL）
+    int (*read)(uint32_t addr, void *data, uint32_t size);            // 读取
+    int (*write)(uint32_t addr, const void *data, uint32_t size);     // 写入
+#if TLV_PORT_VECTOR_IO
+    int (*writev)(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt); // 聚集写入
+    int (*readv)(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt);  // 分散读取
+#endif
+#if TLV_ASYNC_ENABLE
+    int (*read_async)(uint32_t addr, void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg);
+    int (*write_async)(uint32_t addr, const void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg);
+#endif
+} tlv_port_ops_t;
+
+#if TLV_PORT_DUAL_FRAM
+/**
+ * @brief 双片FRAM组合操作表（示例见tlv_port.c）
+ * @note 逻辑地址 [0, TLV_FRAM_CHIP0_SIZE) 映射到片0,其余映射到片1；
+ *       Header、索引区与数据区前段位于片0,数据区后段与备份区位于片1
+ */
+extern const tlv_port_ops_t tlv_port_dual_fram_ops;
+#endif
+
+#if TLV_CRC16_BACKEND == TLV_CRC16_BACKEND_PORT
+/* ============================ CRC接口 ============================ */
+
+/**
+ * @brief 硬件CRC16累加计算
+ * @param crc 当前CRC寄存器值（首次为0xFFFF）
+ * @param data 数据指针
+ * @param size 数据大小
+ * @return 更新后的CRC寄存器值
+ * @note 必须与软件实现逐位一致：多项式0x8005、输入/输出反射、无最终异或、不交换字节
+ */
+uint16_t tlv_port_crc16_update(uint16_t crc, const void *data, uint32_t size);
+#endif
+
+#if TLV_THREAD_SAFE
+/* ============================ 并发接口 ============================ */
+
+/**
+ * @brief 初始化读写锁与临界区所需的OS对象
+ * @return 0: 成功, 其他: 错误码
+ * @note 由tlv_init()在加锁前调用,可能被调用多次,须可重入（已创建时直接返回成功）；
+ *       首次tlv_init()应在其他任务访问存储系统之前完成
+ */
+int tlv_port_lock_init(void);
+
+/**
+ * @brief 获取共享读锁（多个读者可同时持有）
+ * @note 不要求可递归,存储系统内部不会嵌套加锁
+ */
+void tlv_port_read_lock(void);
+
+/**
+ * @brief 释放共享读锁
+ */
+void tlv_port_read_unlock(void);
+
+/**
+ * @brief 获取独占写锁（与所有读者、写者互斥）
+ */
+void tlv_port_write_lock(void);
+
+/**
+ * @brief 释放独占写锁
+ */
+void tlv_port_write_unlock(void);
+
+/**
+ * @brief 进入短临界区
+ * @note 保护持读锁的任务之间共享的RAM缓存与错误记录（临界区内只有几十字节的内存操作,不访问FRAM）
+ */
+void tlv_port_enter_critical(void);
+
+/**
+ * @brief 退出短临界区
+ */
+void tlv_port_exit_critical(void);
+#endif
+
 /* ============================ 时间接口 ============================ */
  
 /**
@@ -53,6 +213,14 @@ uint32_t tlv_port_get_timestamp_s(void);
  */
 uint32_t tlv_port_get_timestamp_ms(void);
  
+#if TLV_PERF_STATS
+/**
+ * @brief 获取性能统计计时tick（高分辨率自由运行计数器,允许回绕）
+ * @return 当前tick,单位由移植层决定（如CPU周期或微秒）
+ */
+uint32_t tlv_port_get_perf_tick(void);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
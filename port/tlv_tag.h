@@ -41,5 +41,6 @@
 #define TAG_USER_SETTINGS           0x4002
 #define TAG_USER_PREFERENCES        0x4003
 #define TAG_USER_HISTORY            0x4004
+#define TAG_USER_EVENT_LOG          0x4005
 
 #endif
@@ -0,0 +1,378 @@
+/**
+ * @file tlv_async.c
+ * @brief TLV FRAM存储系统异步读写（基于端口异步传输的分阶段状态机,由tlv_async_poll推进）
+ */
+
+#include "tlv_core_internal.h"
+
+/* ============================ 全局静态变量 ============================ */
+#if TLV_ASYNC_ENABLE
+// 异步操作上下文
+static tlv_async_context_t g_async_ctx = {0};
+#endif
+
+/* ============================ 私有函数声明 ============================ */
+#if TLV_ASYNC_ENABLE
+static int async_start_transfer(void);
+static void async_transfer_done(int result, void *arg);
+static bool async_advance(void);
+static int async_finish(int ret);
+#endif
+
+/* ============================ 异步操作API实现 ============================ */
+/**
+ * @brief 是否有异步操作进行中（进行中时快照与目标块被占用）
+ */
+bool tlv_core_async_busy(void)
+{
+#if TLV_ASYNC_ENABLE
+    return g_async_ctx.op != TLV_ASYNC_OP_NONE;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 丢弃异步操作上下文（初始化与格式化时调用）
+ */
+void tlv_core_async_reset(void)
+{
+#if TLV_ASYNC_ENABLE
+    memset(&g_async_ctx, 0, sizeof(g_async_ctx));
+#endif
+}
+
+#if TLV_ASYNC_ENABLE
+int tlv_read_async(uint16_t tag, void *buf, uint16_t buf_size,
+                   tlv_async_callback_t callback, void *user_data)
+{
+    if (!buf || buf_size == 0 || tag == 0 || !callback)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    TLV_WRITE_LOCK();
+    int ret = TLV_OK;
+    tlv_index_entry_t *index = NULL;
+    tlv_async_context_t *a = &g_async_ctx;
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        ret = TLV_ERROR;
+    }
+    else if (tlv_core_async_busy())
+    {
+        ret = TLV_ERROR_INVALID_STATE;
+    }
+    else
+    {
+        memset(a, 0, sizeof(*a));
+        a->tag = tag;
+        a->buf = buf;
+        a->buf_size = buf_size;
+        a->len = buf_size;
+        a->callback = callback;
+        a->user_data = user_data;
+
+        // RAM缓存命中时无需传输,下次轮询直接完成
+        ret = tlv_core_ram_cache_read(tag, buf, &a->len);
+        if (ret == TLV_OK)
+        {
+            a->op = TLV_ASYNC_OP_READ;
+            a->from_cache = true;
+            a->stage = TLV_ASYNC_STAGE_DONE;
+        }
+        else if (ret == TLV_ERROR_NOT_FOUND)
+        {
+            index = tlv_index_find(&tlv_core_ctx, tag);
+            if (!index || !(index->flags & TLV_FLAG_VALID))
+            {
+                ret = TLV_ERROR_NOT_FOUND;
+            }
+            else
+            {
+                a->op = TLV_ASYNC_OP_READ;
+                a->addr = index->data_addr;
+                a->stage = TLV_ASYNC_STAGE_HEADER;
+                ret = async_start_transfer();
+                if (ret != TLV_OK)
+                {
+                    tlv_core_async_reset();
+                }
+            }
+        }
+    }
+    TLV_WRITE_UNLOCK();
+
+    return ret;
+}
+
+int tlv_write_async(uint16_t tag, const void *data, uint16_t len,
+                    tlv_async_callback_t callback, void *user_data)
+{
+    if (!callback)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    TLV_WRITE_LOCK();
+    tlv_async_context_t *a = &g_async_ctx;
+
+    // 不原地覆盖：传输期间旧块保持完好,读取到的仍是已提交的数据
+    tlv_write_plan_t plan;
+    int ret = tlv_core_write_prepare(tag, data, len, false, false, &plan);
+    if (ret == TLV_OK)
+    {
+        memset(a, 0, sizeof(*a));
+        a->op = TLV_ASYNC_OP_WRITE;
+        a->stage = TLV_ASYNC_STAGE_HEADER;
+        a->tag = tag;
+        a->addr = plan.target_addr;
+        a->buf = (void *)data;
+        a->len = len;
+        a->plan = plan;
+        a->callback = callback;
+        a->user_data = user_data;
+        a->crc16 = tlv_core_block_header_build(plan.meta, data, len, plan.write_count, 0, &a->header);
+
+        ret = async_start_transfer();
+        if (ret != TLV_OK)
+        {
+            tlv_core_write_rollback(&plan);
+            tlv_core_async_reset();
+        }
+    }
+    TLV_WRITE_UNLOCK();
+
+    return ret;
+}
+
+int tlv_async_poll(void)
+{
+    TLV_WRITE_LOCK();
+    if (!tlv_core_async_busy())
+    {
+        TLV_WRITE_UNLOCK();
+        return 0;
+    }
+
+    if (!async_advance())
+    {
+        TLV_WRITE_UNLOCK();
+        return 1;
+    }
+
+    // 完成：先释放上下文再回调,回调中可以启动下一个异步操作
+    tlv_async_callback_t callback = g_async_ctx.callback;
+    void *user_data = g_async_ctx.user_data;
+    uint16_t tag = g_async_ctx.tag;
+    uint16_t len = g_async_ctx.len;
+    int result = g_async_ctx.xfer_result;
+    tlv_core_async_reset();
+    TLV_WRITE_UNLOCK();
+
+    callback(tag, result, len, user_data);
+    return 0;
+}
+
+bool tlv_async_busy(void)
+{
+    return tlv_core_async_busy();
+}
+
+/**
+ * @brief 启动当前阶段的传输：Header -> Data -> CRC16
+ * @return 0: 已启动, 其他: 错误码
+ */
+static int async_start_transfer(void)
+{
+    tlv_async_context_t *a = &g_async_ctx;
+    uint32_t addr = a->addr;
+    void *ptr;
+    uint32_t size;
+
+    switch (a->stage)
+    {
+    case TLV_ASYNC_STAGE_HEADER:
+        ptr = &a->header;
+        size = sizeof(a->header);
+        break;
+    case TLV_ASYNC_STAGE_DATA:
+        addr += sizeof(tlv_data_block_header_t);
+        ptr = a->buf;
+        size = a->len;
+        break;
+    case TLV_ASYNC_STAGE_CRC:
+        addr += sizeof(tlv_data_block_header_t) + a->len;
+        ptr = &a->crc16;
+        size = sizeof(a->crc16);
+        break;
+    default:
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    a->xfer_pending = true;
+    int ret;
+    if (a->op == TLV_ASYNC_OP_READ)
+    {
+        ret = tlv_core_ctx.ops->read_async(addr, ptr, size, async_transfer_done, NULL);
+    }
+    else
+    {
+        ret = tlv_core_ctx.ops->write_async(addr, ptr, size, async_transfer_done, NULL);
+    }
+
+    if (ret != TLV_OK)
+    {
+        a->xfer_pending = false;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 移植层传输完成回调（可能在中断上下文,只记录结果）
+ */
+static void async_transfer_done(int result, void *arg)
+{
+    (void)arg;
+    g_async_ctx.xfer_result = result;
+    g_async_ctx.xfer_pending = false;
+}
+
+/**
+ * @brief 推进异步操作：上一段传输完成后启动下一段,全部完成或出错时收尾
+ * @return true: 操作已结束（结果在xfer_result中）, false: 仍在进行
+ */
+static bool async_advance(void)
+{
+    tlv_async_context_t *a = &g_async_ctx;
+
+#if TLV_PORT_ASYNC_POLL
+    if (a->xfer_pending)
+    {
+        tlv_port_fram_async_poll();
+    }
+#endif
+
+    if (a->xfer_pending)
+    {
+        return false;
+    }
+
+    int ret = a->xfer_result;
+    if (ret == TLV_OK && a->stage < TLV_ASYNC_STAGE_DONE)
+    {
+        // Header读出后才知道数据长度
+        if (a->op == TLV_ASYNC_OP_READ && a->stage == TLV_ASYNC_STAGE_HEADER)
+        {
+            if (a->header.tag != a->tag)
+            {
+                ret = TLV_ERROR_CORRUPTED;
+            }
+            else if (a->header.flags & TLV_BLOCK_FLAG_COMPRESSED)
+            {
+                // 压缩块由收尾按同步路径解压读取,跳过数据与CRC传输
+                a->stage = TLV_ASYNC_STAGE_CRC;
+            }
+            else if (a->header.length > a->buf_size)
+            {
+                a->len = a->header.length;
+                ret = TLV_ERROR_NO_BUFFER_MEMORY;
+            }
+            else
+            {
+                a->len = a->header.length;
+            }
+        }
+
+        if (ret == TLV_OK)
+        {
+            a->stage++;
+            if (a->stage < TLV_ASYNC_STAGE_DONE)
+            {
+                ret = async_start_transfer();
+                if (ret == TLV_OK)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    a->xfer_result = async_finish(ret);
+    return true;
+}
+
+/**
+ * @brief 收尾：读取校验CRC并更新缓存,写入提交索引或回滚
+ * @param ret 传输结果
+ * @return 最终结果
+ */
+static int async_finish(int ret)
+{
+    tlv_async_context_t *a = &g_async_ctx;
+
+    if (a->op == TLV_ASYNC_OP_WRITE)
+    {
+        if (ret != TLV_OK)
+        {
+            tlv_printf("async write failed: %d\n", ret);
+            tlv_core_write_rollback(&a->plan);
+            return ret;
+        }
+
+        // 结束异步状态后提交,提交过程与同步写入相同
+        tlv_write_plan_t plan = a->plan;
+        a->op = TLV_ASYNC_OP_NONE;
+        return tlv_core_write_commit(&plan, a->buf);
+    }
+
+    if (ret != TLV_OK || a->from_cache)
+    {
+        return ret;
+    }
+
+    if (a->header.flags & TLV_BLOCK_FLAG_COMPRESSED)
+    {
+        a->op = TLV_ASYNC_OP_NONE;
+        a->len = a->buf_size;
+        return tlv_core_read_unlocked(a->tag, a->buf, &a->len, true);
+    }
+
+    uint16_t calc_crc = tlv_crc16_init();
+    calc_crc = tlv_crc16_update(calc_crc, &a->header, sizeof(a->header));
+    calc_crc = tlv_crc16_update(calc_crc, a->buf, tlv_core_block_crc_length(&a->header));
+    if (tlv_crc16_final(calc_crc) != a->crc16)
+    {
+        return TLV_ERROR_CRC_FAILED;
+    }
+
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, a->tag);
+    if (!index || index->data_addr != a->addr)
+    {
+        return TLV_ERROR_NOT_FOUND;
+    }
+
+    tlv_core_block_info_set(index, a->header.length, a->header.write_count);
+    tlv_core_block_info_mark_verified(index);
+
+    const tlv_meta_const_t *meta = tlv_core_get_meta(a->tag);
+#if (TLV_ENABLE_MIGRATION && TLV_LAZY_MIGRATE_ON_READ)
+    if (meta && index->version < meta->version)
+    {
+        // 旧版本数据按同步读取路径迁移并写回（需先结束异步状态）
+        a->op = TLV_ASYNC_OP_NONE;
+        a->len = a->buf_size;
+        return tlv_core_read_unlocked(a->tag, a->buf, &a->len, true);
+    }
+#endif
+
+    if (meta && index->version >= meta->version)
+    {
+        tlv_core_ram_cache_store(meta, a->buf, a->len);
+    }
+
+    return TLV_OK;
+}
+#endif
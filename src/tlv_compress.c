@@ -0,0 +1,234 @@
+/**
+ * @file tlv_compress.c
+ * @brief TLV FRAM存储系统数据块压缩实现（LZSS）
+ */
+
+#include "tlv_compress.h"
+#include <string.h>
+
+#define TLV_LZ_WINDOW_MASK (TLV_LZ_WINDOW_SIZE - 1)
+
+/* ============================ 压缩实现 ============================ */
+
+uint16_t tlv_lz_encode(const void *src, uint16_t src_len, void *dst, uint16_t dst_cap)
+{
+    const uint8_t *in = (const uint8_t *)src;
+    uint8_t *out = (uint8_t *)dst;
+
+    if (dst_cap < TLV_LZ_HEADER_SIZE)
+    {
+        return 0;
+    }
+
+    // 原始长度前缀
+    out[0] = (uint8_t)(src_len & 0xFF);
+    out[1] = (uint8_t)(src_len >> 8);
+
+    uint32_t op = TLV_LZ_HEADER_SIZE;
+    uint32_t flag_pos = 0;
+    uint8_t flag_bit = 8;
+    uint16_t ip = 0;
+
+    while (ip < src_len)
+    {
+        // 每8项开始新的标志字节
+        if (flag_bit == 8)
+        {
+            if (op >= dst_cap)
+            {
+                return 0;
+            }
+            flag_pos = op;
+            out[op++] = 0;
+            flag_bit = 0;
+        }
+
+        // 贪心查找窗口内最长匹配（距离近者优先,允许与当前位置重叠）
+        uint16_t best_len = 0;
+        uint16_t best_dist = 0;
+        uint16_t max_len = src_len - ip;
+        if (max_len > TLV_LZ_MAX_MATCH)
+        {
+            max_len = TLV_LZ_MAX_MATCH;
+        }
+
+        if (max_len >= TLV_LZ_MIN_MATCH)
+        {
+            uint16_t start = (ip > TLV_LZ_WINDOW_SIZE) ? (uint16_t)(ip - TLV_LZ_WINDOW_SIZE) : 0;
+            for (uint16_t cand = ip; cand-- > start;)
+            {
+                if (in[cand + best_len] != in[ip + best_len] || in[cand] != in[ip])
+                {
+                    continue;
+                }
+
+                uint16_t n = 0;
+                while (n < max_len && in[cand + n] == in[ip + n])
+                {
+                    n++;
+                }
+
+                if (n > best_len)
+                {
+                    best_len = n;
+                    best_dist = ip - cand;
+                    if (n == max_len)
+                    {
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (best_len >= TLV_LZ_MIN_MATCH)
+        {
+            if (op + 2 > dst_cap)
+            {
+                return 0;
+            }
+            out[flag_pos] |= (uint8_t)(1u << flag_bit);
+            out[op++] = (uint8_t)(best_dist - 1);
+            out[op++] = (uint8_t)(best_len - TLV_LZ_MIN_MATCH);
+            ip += best_len;
+        }
+        else
+        {
+            if (op >= dst_cap)
+            {
+                return 0;
+            }
+            out[op++] = in[ip++];
+        }
+
+        flag_bit++;
+    }
+
+    return (uint16_t)op;
+}
+
+/* ============================ 解压实现 ============================ */
+
+void tlv_lz_decoder_init(tlv_lz_decoder_t *dec, uint8_t *window)
+{
+    memset(dec, 0, sizeof(*dec));
+    dec->window = window;
+}
+
+int tlv_lz_decode(tlv_lz_decoder_t *dec, const void *in, uint16_t in_len, uint16_t *consumed,
+                  void *out, uint16_t out_len, uint16_t *produced)
+{
+    const uint8_t *src = (const uint8_t *)in;
+    uint8_t *base = (uint8_t *)out;
+    uint16_t ip = 0;
+    uint16_t k = 0;
+    int ret = TLV_OK;
+
+    // 原始长度前缀
+    while (dec->header_len < TLV_LZ_HEADER_SIZE && ip < in_len)
+    {
+        dec->raw_len |= (uint16_t)(src[ip++] << (8 * dec->header_len));
+        dec->header_len++;
+    }
+
+    if (dec->header_len == TLV_LZ_HEADER_SIZE)
+    {
+        // 无窗口时历史数据即输出缓冲区,从已输出位置续写
+        uint8_t *dst = base;
+        uint16_t avail = out_len;
+        if (!dec->window)
+        {
+            if (dec->raw_len > out_len)
+            {
+                ret = TLV_ERROR_NO_BUFFER_MEMORY;
+                goto out;
+            }
+            dst = base + dec->out_pos;
+            avail = out_len - dec->out_pos;
+        }
+
+        if (avail > dec->raw_len - dec->out_pos)
+        {
+            avail = dec->raw_len - dec->out_pos;
+        }
+
+        for (;;)
+        {
+            // 续完进行中的匹配
+            while (dec->match_left > 0 && k < avail)
+            {
+                uint8_t b = dec->window ? dec->window[(uint16_t)(dec->out_pos - dec->match_dist) & TLV_LZ_WINDOW_MASK]
+                                        : base[dec->out_pos - dec->match_dist];
+                if (dec->window)
+                {
+                    dec->window[dec->out_pos & TLV_LZ_WINDOW_MASK] = b;
+                }
+                dst[k++] = b;
+                dec->out_pos++;
+                dec->match_left--;
+            }
+
+            if (k == avail)
+            {
+                break;
+            }
+
+            if (dec->flag_bits == 0)
+            {
+                if (ip >= in_len)
+                {
+                    break;
+                }
+                dec->flags = src[ip++];
+                dec->flag_bits = 8;
+            }
+
+            if (dec->flags & 1)
+            {
+                if (ip + 2 > in_len)
+                {
+                    break;
+                }
+
+                uint16_t dist = (uint16_t)src[ip] + 1;
+                uint16_t len = (uint16_t)src[ip + 1] + TLV_LZ_MIN_MATCH;
+                if (dist > dec->out_pos || len > dec->raw_len - dec->out_pos)
+                {
+                    ret = TLV_ERROR_CORRUPTED;
+                    break;
+                }
+
+                ip += 2;
+                dec->match_dist = dist;
+                dec->match_left = len;
+            }
+            else
+            {
+                if (ip >= in_len)
+                {
+                    break;
+                }
+
+                uint8_t b = src[ip++];
+                if (dec->window)
+                {
+                    dec->window[dec->out_pos & TLV_LZ_WINDOW_MASK] = b;
+                }
+                dst[k++] = b;
+                dec->out_pos++;
+            }
+
+            dec->flags >>= 1;
+            dec->flag_bits--;
+        }
+    }
+
+out:
+    *consumed = ip;
+    *produced = k;
+    return ret;
+}
+
+bool tlv_lz_decode_done(const tlv_lz_decoder_t *dec)
+{
+    return dec->header_len == TLV_LZ_HEADER_SIZE && dec->match_left == 0 && dec->out_pos == dec->raw_len;
+}
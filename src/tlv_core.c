@@ -9,18 +9,101 @@
 #include "tlv_utils.h"
 #include "tlv_meta_table.h"
 #include "tlv_migration.h"
+#include "tlv_compress.h"
+#include "tlv_core_internal.h"
 
 /* ============================ 全局静态变量 ============================ */
 /* 存储系统上下文 */
-static tlv_context_t g_tlv_ctx = {0};
+/** 默认FRAM设备操作表（直接使用tlv_port_fram_*接口） */
+static const tlv_port_ops_t g_default_port_ops = {
+    tlv_port_fram_init,
+    tlv_port_fram_read,
+    tlv_port_fram_write,
+#if TLV_PORT_VECTOR_IO
+    tlv_port_fram_writev,
+    tlv_port_fram_readv,
+#endif
+#if TLV_ASYNC_ENABLE
+    tlv_port_fram_read_async,
+    tlv_port_fram_write_async,
+#endif
+};
+
+#if TLV_PERF_STATS
+static int perf_port_init(void);
+static int perf_port_read(uint32_t addr, void *data, uint32_t size);
+static int perf_port_write(uint32_t addr, const void *data, uint32_t size);
+#if TLV_PORT_VECTOR_IO
+static int perf_port_writev(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt);
+static int perf_port_readv(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt);
+#endif
+#if TLV_ASYNC_ENABLE
+static int perf_port_read_async(uint32_t addr, void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg);
+static int perf_port_write_async(uint32_t addr, const void *data, uint32_t size, tlv_port_async_cb_t cb,
+                                 void *arg);
+#endif
+
+/** 性能统计转发操作表：计时并统计字节数后调用绑定的操作表 */
+static const tlv_port_ops_t g_perf_port_ops = {
+    perf_port_init,
+    perf_port_read,
+    perf_port_write,
+#if TLV_PORT_VECTOR_IO
+    perf_port_writev,
+    perf_port_readv,
+#endif
+#if TLV_ASYNC_ENABLE
+    perf_port_read_async,
+    perf_port_write_async,
+#endif
+};
+
+// 转发的实际操作表（tlv_bind_port绑定）
+static const tlv_port_ops_t *g_perf_port = &g_default_port_ops;
+// 性能统计
+static tlv_perf_stats_t g_perf_stats = {0};
+
+tlv_context_t tlv_core_ctx = {TLV_STATE_UNINITIALIZED, &g_perf_port_ops};
+#else
+tlv_context_t tlv_core_ctx = {TLV_STATE_UNINITIALIZED, &g_default_port_ops};
+#endif
 
 /* 静态分配的内存（替代malloc） */
 static tlv_system_header_t g_static_header;
 static tlv_index_table_t g_static_index;
+static uint16_t g_static_index_hash[TLV_INDEX_HASH_SIZE];
+#if TLV_BLOCK_INFO_CACHE
+static tlv_block_info_t g_static_block_info[TLV_MAX_TAG_COUNT];
+#endif
 
 /* 流式操作上下文 */
 static tlv_stream_context_t g_stream_ctx = {0};
 
+// 事务上下文
+tlv_txn_context_t tlv_core_txn_ctx = {0};
+static bool g_txn_publish_pending = false; // 事务已过提交点但发布未完整落盘,事务日志保留待补齐
+
+// 增量批量迁移上下文
+tlv_migrate_context_t tlv_core_migrate_ctx = {0};
+
+// 后台巡检上下文
+static tlv_scrub_context_t g_scrub_ctx = {0};
+
+#if TLV_FREE_EXTENT_REUSE
+// 空闲区段表
+static tlv_free_list_t g_free_list = {0};
+#endif
+
+#if TLV_RAM_CACHE_ENABLE
+// 热点Tag的RAM缓存池
+static tlv_ram_cache_slot_t g_ram_cache[TLV_RAM_CACHE_SLOTS];
+static uint32_t g_ram_cache_tick = 0;
+#endif
+static uint32_t g_ram_cache_hits = 0;
+static uint32_t g_ram_cache_misses = 0;
+// 磨损均衡触发的迁移次数（仅RAM,初始化时清零）
+static uint32_t g_wear_relocations = 0;
+
 /* 错误上下文 */
 static tlv_error_context_t g_last_error = {0};
 static uint16_t g_chunk_tag[TLV_MAX_STREAM_HANDLES];
@@ -48,22 +131,122 @@ static uint16_t g_chunk_tag[TLV_MAX_STREAM_HANDLES];
     tlv_set_last_error((err), (tag), 0, NULL)
 #endif
 
+/** tlv_core_read_unlocked() 内部返回值：数据需要迁移,须持写锁重新读取 */
+#define TLV_READ_NEED_MIGRATE  1
+
+/** 备份页CRC表地址（随存储布局位于FRAM末尾） */
+#define TLV_BACKUP_CRC_ADDR    (tlv_core_ctx.backup_addr + TLV_BACKUP_CRC_OFFSET)
+
 /* ============================ 私有函数声明 ============================ */
 
-static int system_header_init(void);
+static tlv_init_result_t tlv_init_unlocked(void);
+static int tlv_deinit_unlocked(void);
+static int tlv_format_unlocked(uint32_t magic, const tlv_geometry_t *geometry);
+static int tlv_write_unlocked(uint16_t tag, const void *data, uint16_t len);
+static int tlv_read_range_unlocked(uint16_t tag, uint16_t offset, void *buf, uint16_t len);
+static int tlv_write_range_unlocked(uint16_t tag, uint16_t offset, const void *data, uint16_t len);
+static int tlv_delete_unlocked(uint16_t tag);
+static bool tlv_exists_unlocked(uint16_t tag);
+static int tlv_get_length_unlocked(uint16_t tag, uint16_t *len);
+static int tlv_write_batch_unlocked(const uint16_t *tags, uint16_t count, const void **datas, const uint16_t *lengths);
+static int tlv_txn_begin_unlocked(void);
+static int tlv_txn_write_unlocked(uint16_t tag, const void *data, uint16_t len);
+static int tlv_txn_commit_unlocked(void);
+static void tlv_txn_abort_unlocked(void);
+static int tlv_get_statistics_unlocked(tlv_statistics_t *stats);
+static int tlv_restore_from_backup_unlocked(void);
+static int tlv_mirror_sync_unlocked(void);
+static int tlv_export_image_unlocked(tlv_image_write_t write, void *user_data);
+static int tlv_import_image_unlocked(tlv_image_read_t read, void *user_data);
+static int tlv_calculate_fragmentation_unlocked(uint32_t *fragmentation_percent);
+static tlv_stream_handle_t tlv_write_begin_unlocked(uint16_t tag, uint16_t total_len);
+static int tlv_write_chunk_unlocked(tlv_stream_handle_t handle, const void *data, uint16_t len);
+static int tlv_write_end_unlocked(tlv_stream_handle_t handle);
+static void tlv_write_abort_unlocked(tlv_stream_handle_t handle);
+static tlv_stream_handle_t tlv_read_begin_unlocked(uint16_t tag, uint16_t *total_len);
+static int tlv_read_chunk_unlocked(tlv_stream_handle_t handle, void *buf, uint16_t *len);
+static int tlv_read_end_unlocked(tlv_stream_handle_t handle);
+static void tlv_read_abort_unlocked(tlv_stream_handle_t handle);
+
+static int layout_apply(const tlv_geometry_t *geometry);
+static void runtime_state_reset(void);
 static int system_header_load(void);
-static int system_header_save(void);
-static int system_header_verify(void);
-static uint32_t allocate_space(uint32_t size);
-static int write_data_block(uint16_t tag, const void *data, uint16_t len, uint32_t addr);
-static const tlv_meta_const_t *get_meta(uint16_t tag);
-static int tlv_backup_all_internal(void);
-static void transaction_snapshot_create(void);
+static int system_header_verify(const tlv_system_header_t *header);
+static int system_header_invalidate(void);
+static int system_header_commit(void);
+static int system_header_reconcile(void);
+static int index_commit_remove(const tlv_index_entry_t *entry, uint16_t tag);
+static uint32_t allocate_space_tail(uint32_t size);
+static uint32_t allocate_space_wear(uint32_t size);
+static bool wear_relocate_due(uint32_t write_count);
+static uint16_t write_encode(const tlv_meta_const_t *meta, const void *data, uint16_t len, const void **block_data,
+                             uint8_t *block_flags);
+static int write_data_block(const tlv_meta_const_t *meta, const void *data, uint16_t len, uint32_t addr,
+                            uint32_t write_count, uint8_t flags);
+static int read_block(uint32_t addr, uint16_t tag, uint16_t expect_len, void *buf, uint16_t *len,
+                      tlv_data_block_header_t *out_header);
+static int read_block_decode(uint32_t addr, const tlv_data_block_header_t *header, void *buf, uint16_t *len);
+int read_data_block(uint32_t addr, uint16_t tag, void *buf, uint16_t *len);
+static int block_writev(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt);
+static int block_readv(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt);
+static bool overlaps_static_buffer(const void *base, uint32_t size);
+static bool block_info_lookup(const tlv_index_entry_t *entry, bool need_verified, uint16_t *length);
+static void ram_cache_reset(void);
+static void ram_cache_invalidate(uint16_t tag);
+static void ram_cache_patch(uint16_t tag, uint16_t offset, const void *data, uint16_t len);
+static bool meta_compressible(const tlv_meta_const_t *meta);
+static int backup_crc_table_load(tlv_backup_crc_table_t *table);
+static bool backup_crc_table_valid(void);
+static int backup_page(uint32_t page, bool table_valid);
+static int backup_prepare(void);
+static int backup_invalidate(void);
+#if TLV_THREAD_SAFE
+static int backup_sections(void);
+#endif
 static void transaction_snapshot_rollback(void);
 static void transaction_snapshot_commit(void);
 static void increase_used_space(uint32_t size);
-static void reduce_used_space(uint32_t size);
 static int tlv_set_last_error(int error_code, uint16_t tag, uint32_t line, const char *function);
+static int txn_log_clear(void);
+static int txn_publish_settle(void);
+static int txn_log_replay(void);
+#if TLV_STREAM_BUFFER_SIZE > 0
+static int stream_flush(tlv_stream_context_internal_t *h);
+#endif
+#if TLV_COMPRESS_ENABLE
+static int stream_read_decode(tlv_stream_context_internal_t *h, uint8_t *dst, uint16_t len);
+#endif
+static void release_space(uint32_t addr, uint32_t size, bool was_committed);
+static bool free_list_usable(void);
+static void free_list_reclaim_held(void);
+static void free_list_unhold(void);
+static uint32_t free_list_alloc(uint32_t size);
+static void free_list_add(uint32_t addr, uint32_t size, bool held);
+static void free_list_remove(uint16_t pos);
+static void free_list_sync_stats(void);
+static uint16_t migrate_count_pending(void);
+static tlv_index_entry_t *migrate_next_entry(uint32_t from_tag);
+static tlv_index_entry_t *scrub_next_entry(uint32_t from_addr);
+static int scrub_run(tlv_index_entry_t *entry, uint32_t budget_bytes, uint32_t *spent);
+static int scrub_report(tlv_index_entry_t *entry);
+static int log_create(const tlv_meta_const_t *meta);
+static int log_open(uint16_t tag, bool repair, tlv_log_ring_t *ring);
+static int log_scan(tlv_log_ring_t *ring);
+static int log_ctrl_write(const tlv_log_ring_t *ring);
+static uint32_t log_slot_addr(const tlv_log_ring_t *ring, uint32_t seq);
+static bool mirror_usable(void);
+static uint32_t mirror_slot_addr(uint16_t tag);
+static int mirror_sync_tag(const tlv_meta_const_t *meta, uint32_t slot_addr);
+static int mirror_read(const tlv_data_block_header_t *main_header, void *buf, uint16_t *len);
+static int mirror_invalidate(uint32_t slot_addr);
+static bool stream_any_active(void);
+static int image_block_add(const tlv_data_block_header_t *header, uint32_t addr, uint32_t end);
+#if TLV_PERF_STATS
+static void perf_count_bytes(bool is_write, uint32_t size);
+#endif
+static int fast_boot_verify(uint32_t max_pages);
+static bool clean_marker_allowed(void);
+static int clean_marker_write(void);
 
 /* ============================ 版本API实现 ============================ */
 const char *tlv_get_version(void)
@@ -73,61 +256,228 @@ const char *tlv_get_version(void)
 
 const tlv_context_t *tlv_get_context(void)
 {
-    return &g_tlv_ctx;
+    return &tlv_core_ctx;
 }
 
 /* ============================ 系统管理API实现 ============================ */
 
-tlv_init_result_t tlv_init(void)
+int tlv_bind_port(const tlv_port_ops_t *ops)
+{
+    if (tlv_core_ctx.state == TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    if (!ops)
+    {
+        ops = &g_default_port_ops;
+    }
+
+    if (!ops->read || !ops->write)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+#if TLV_PORT_VECTOR_IO
+    if (!ops->writev || !ops->readv)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+#endif
+#if TLV_ASYNC_ENABLE
+    if (!ops->read_async || !ops->write_async)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+#endif
+
+#if TLV_PERF_STATS
+    // 上下文始终指向统计转发表,由其调用绑定的操作表
+    g_perf_port = ops;
+#else
+    tlv_core_ctx.ops = ops;
+#endif
+    return TLV_OK;
+}
+
+static tlv_init_result_t tlv_init_unlocked(void)
 {
     int ret;
     tlv_init_result_t result = TLV_INIT_ERROR;
 
     // 初始化硬件
-    ret = tlv_port_fram_init();
-    if (ret != TLV_OK)
+    if (tlv_core_ctx.ops->init)
     {
-        return TLV_INIT_ERROR;
+        ret = tlv_core_ctx.ops->init();
+        if (ret != TLV_OK)
+        {
+            return TLV_INIT_ERROR;
+        }
     }
 
     // 使用静态分配的内存
-    g_tlv_ctx.header = &g_static_header;
-    g_tlv_ctx.index_table = &g_static_index;
+    tlv_core_ctx.header = &g_static_header;
+    tlv_core_ctx.index_table = &g_static_index;
+    tlv_core_ctx.index_hash = g_static_index_hash;
+#if TLV_BLOCK_INFO_CACHE
+    tlv_core_ctx.block_info = g_static_block_info;
+#endif
 
     // 设置元数据表
-    g_tlv_ctx.meta_table = tlv_get_meta_table();
-    g_tlv_ctx.meta_table_size = tlv_get_meta_table_size();
+    tlv_core_ctx.meta_table = tlv_get_meta_table();
+    tlv_core_ctx.meta_table_size = tlv_get_meta_table_size();
+
+    // 构建元数据查找表（校验并排序,后续查找为二分查找）
+    ret = tlv_meta_lookup_build(tlv_core_ctx.meta_table, tlv_core_ctx.meta_table_size);
+    if (ret != TLV_OK)
+    {
+        tlv_printf("ERROR: Meta table invalid: %d\n", ret);
+        goto error_cleanup;
+    }
 
     // 初始化快照
-    memset(&g_tlv_ctx.snapshot, 0, sizeof(g_tlv_ctx.snapshot));
-    g_tlv_ctx.snapshot.is_active = false;
+    memset(&tlv_core_ctx.snapshot, 0, sizeof(tlv_core_ctx.snapshot));
+    tlv_core_ctx.snapshot.is_active = false;
+    tlv_core_ctx.header_dirty = false;
+    tlv_core_ctx.index_crc_dirty = false;
+
+    // 备份区与管理区是否一致未知,首次备份时逐页比较CRC
+    tlv_core_ctx.backup_dirty = TLV_BACKUP_DIRTY_ALL;
 
     // 清零数据
     memset(&g_static_header, 0, sizeof(g_static_header));
     memset(&g_static_index, 0, sizeof(g_static_index));
+    memset(g_static_index_hash, 0, sizeof(g_static_index_hash));
 
     // 清零其他数据
     memset(&g_last_error, 0, sizeof(g_last_error));
     memset(&g_chunk_tag, 0, sizeof(g_chunk_tag));
-
-    // 尝试加载系统Header
+    memset(&tlv_core_txn_ctx, 0, sizeof(tlv_core_txn_ctx));
+    g_txn_publish_pending = false;
+    memset(&tlv_core_migrate_ctx.progress, 0, sizeof(tlv_core_migrate_ctx.progress));
+    memset(&g_scrub_ctx, 0, sizeof(g_scrub_ctx));
+    tlv_core_async_reset();
+    tlv_core_free_list_reset(false);
+    tlv_core_block_info_invalidate_all();
+    ram_cache_reset();
+    g_wear_relocations = 0;
+    tlv_core_gc_reset();
+
+    // 尝试加载系统Header,其中记录的存储布局决定备份区与镜像区位置
     ret = system_header_load();
+    if (ret == TLV_OK && layout_apply(&tlv_core_ctx.header->geometry) != TLV_OK)
+    {
+        tlv_printf("ERROR: Storage geometry not supported by this build\n");
+        goto error_cleanup;
+    }
+
     if (ret == TLV_OK)
     {
+        // 正常关机标记只在FRAM中保留到首次修改,RAM中的Header始终不带标记
+        bool clean = (tlv_core_ctx.header->clean_marker == TLV_CLEAN_SHUTDOWN_MAGIC);
+        bool restore_pending = (tlv_core_ctx.header->clean_marker == TLV_RESTORE_PENDING_MAGIC);
+        tlv_core_ctx.header->clean_marker = 0;
+
+#if TLV_JOURNAL_ENABLE
+        // 打开提交日志：有记录说明上次检查点之后的修改只保存在日志中
+        ret = tlv_core_journal_open();
+        if (ret != TLV_OK)
+        {
+            goto error_cleanup;
+        }
+        clean = clean && tlv_core_journal_ctx.count == 0;
+#endif
+        tlv_core_ctx.clean_marked = clean;
+        tlv_core_ctx.index_unverified = 0;
+
         // 加载索引表
-        ret = tlv_index_load(&g_tlv_ctx);
+        if (restore_pending)
+        {
+            // 上次从备份恢复时掉电：管理区新旧页混杂,即使各页通过校验也要重新恢复
+            tlv_printf("WARNING: Interrupted restore detected, restoring from backup again\n");
+            ret = TLV_ERROR_CORRUPTED;
+        }
+        else
+#if TLV_FAST_BOOT
+        if (clean)
+        {
+            // 快速启动：整表CRC字段与关机时一致即可加载,各页留待后台或首次修改前校验
+            ret = tlv_index_load_unverified(&tlv_core_ctx);
+            if (ret == TLV_OK &&
+                tlv_core_ctx.index_table->index_crc16 == tlv_core_ctx.header->clean_index_crc)
+            {
+                tlv_core_ctx.index_unverified = (TLV_INDEX_PAGE_COUNT >= 32) ? UINT32_MAX
+                                                                          : ((1UL << TLV_INDEX_PAGE_COUNT) - 1);
+            }
+            else
+            {
+                // Header与索引表不属于同一次关机,按完整流程加载并清除失效的标记
+                ret = tlv_index_load(&tlv_core_ctx);
+                if (ret == TLV_OK)
+                {
+                    tlv_core_system_header_save();
+                }
+            }
+        }
+        else
+#endif
+        {
+            ret = tlv_index_load(&tlv_core_ctx);
+        }
+
+#if TLV_JOURNAL_ENABLE
+        if (ret == TLV_OK)
+        {
+            // 重放上次检查点之后提交的修改
+            ret = tlv_core_journal_replay();
+            if (ret != TLV_OK)
+            {
+                goto error_cleanup;
+            }
+        }
+        else if (ret == TLV_ERROR_CRC_FAILED && tlv_core_journal_ctx.count > 0)
+        {
+            // 检查点写索引页时掉电,先尝试以日志修补
+            ret = tlv_core_journal_repair_index();
+        }
+#endif
+
         if (ret == TLV_OK)
         {
-            g_tlv_ctx.state = TLV_STATE_INITIALIZED;
+            // 重放已提交但未发布完成的事务
+            ret = txn_log_replay();
+            if (ret != TLV_OK)
+            {
+                goto error_cleanup;
+            }
+
+            // 写回模式下Header可能落后于索引,先对齐
+            ret = system_header_reconcile();
+            if (ret != TLV_OK)
+            {
+                goto error_cleanup;
+            }
+
+            // 空间字段可能落后于数据块（提交日志检查点之间只更新RAM,Header保存中途掉电时按较旧的副本加载）,
+            // 非正常关机时按数据块重新统计（块信息缓存随后供空闲区段表重建使用）；
+            // 尾部不低于Header中的位置,最后一个块之后可能还有备份区引用的已释放块
+            if (!clean && tlv_core_space_stats_rebuild(tlv_core_ctx.header->next_free_addr) != TLV_OK)
+            {
+                tlv_printf("WARNING: Space statistics rebuild failed, keeping header values\n");
+            }
+
+            // 由索引重建空闲区段表；备份区可能仍引用上次备份以来释放的块,空洞待首次同步备份后复用
+            tlv_core_free_list_rebuild(true);
+
+            tlv_core_ctx.state = TLV_STATE_INITIALIZED;
             result = TLV_INIT_OK;
         }
         else
         {
-            // 索引表损坏,尝试从备份恢复
-            ret = tlv_restore_from_backup();
+            // 索引表损坏,尝试从备份恢复（提交日志随之作废）
+            ret = tlv_restore_from_backup_unlocked();
             if (ret == TLV_OK)
             {
-                g_tlv_ctx.state = TLV_STATE_INITIALIZED;
+                tlv_core_ctx.state = TLV_STATE_INITIALIZED;
                 result = TLV_INIT_RECOVERED;
             }
             else
@@ -140,64 +490,152 @@ tlv_init_result_t tlv_init(void)
     {
         // 首次启动或数据损坏
         result = TLV_INIT_FIRST_BOOT;
-        g_tlv_ctx.state = TLV_STATE_UNINITIALIZED;
+        tlv_core_ctx.state = TLV_STATE_UNINITIALIZED;
     }
 
     return result;
 
 error_cleanup:
-    g_tlv_ctx.state = TLV_STATE_ERROR;
+    tlv_core_ctx.state = TLV_STATE_ERROR;
     return TLV_INIT_ERROR;
 }
 
-int tlv_deinit(void)
+tlv_init_result_t tlv_init(void)
+{
+#if TLV_THREAD_SAFE
+    // 锁对象必须在首次加锁前就绪
+    if (tlv_port_lock_init() != TLV_OK)
+    {
+        return TLV_INIT_ERROR;
+    }
+#endif
+
+    TLV_WRITE_LOCK();
+    tlv_init_result_t ret = tlv_init_unlocked();
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+int tlv_init_verify_step(void)
+{
+    TLV_WRITE_LOCK();
+    int ret;
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        ret = TLV_ERROR;
+    }
+    else
+    {
+        ret = fast_boot_verify(1);
+        if (ret == TLV_OK && tlv_core_ctx.index_unverified != 0)
+        {
+            ret = 1;
+        }
+    }
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+static int tlv_deinit_unlocked(void)
 {
-    // 保存索引表
-    if (g_tlv_ctx.index_table)
+    // 未提交的事务直接丢弃
+    if (tlv_core_txn_ctx.is_active)
     {
-        tlv_index_save(&g_tlv_ctx);
+        tlv_txn_abort_unlocked();
     }
 
-    // 保存系统Header
-    if (g_tlv_ctx.header)
+    // 标记仍在说明启动或上次落盘后没有修改,无需保存
+    if (tlv_core_ctx.index_table && tlv_core_ctx.header && !tlv_core_ctx.clean_marked)
     {
-        system_header_save();
+        // 未校验的索引页不能随整表保存被重新计算CRC
+        if (fast_boot_verify(UINT32_MAX) == TLV_OK)
+        {
+            // 保存索引表
+#if TLV_JOURNAL_ENABLE
+            tlv_core_journal_checkpoint();
+#else
+            tlv_index_save(&tlv_core_ctx);
+#endif
+
+            // 保存系统Header（可行时带正常关机标记）
+            if (clean_marker_allowed())
+            {
+                clean_marker_write();
+            }
+            else
+            {
+                tlv_core_system_header_save();
+            }
+        }
     }
 
     // 反初始化索引系统
-    tlv_index_deinit(&g_tlv_ctx);
+    tlv_index_deinit(&tlv_core_ctx);
 
-    g_tlv_ctx.state = TLV_STATE_UNINITIALIZED;
+    tlv_core_ctx.state = TLV_STATE_UNINITIALIZED;
 
     return TLV_OK;
 }
 
-int tlv_format(uint32_t magic)
+int tlv_deinit(void)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_deinit_unlocked();
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+static int tlv_format_unlocked(uint32_t magic, const tlv_geometry_t *geometry)
 {
+    // 进行中的异步传输完成后仍会写入格式化前的地址
+    if (tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    // 存储布局不合法时不改动FRAM
+    int ret = layout_apply(geometry);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
     // 检查并设置格式化状态
-    if (g_tlv_ctx.state == TLV_STATE_ERROR)
+    if (tlv_core_ctx.state == TLV_STATE_ERROR)
     {
         // 允许格式化错误状态
     }
-    else if (g_tlv_ctx.state == TLV_STATE_INITIALIZED)
+    else if (tlv_core_ctx.state == TLV_STATE_INITIALIZED)
     {
         // 警告：会丢失所有数据
         tlv_printf("WARNING: Formatting initialized system - all data will be lost!\n");
     }
 
     // 保存格式化原来的状态
-    tlv_state_t old_state = g_tlv_ctx.state;
+    tlv_state_t old_state = tlv_core_ctx.state;
 
     // 确保指针已设置
-    if (!g_tlv_ctx.header || !g_tlv_ctx.index_table)
+    if (!tlv_core_ctx.header || !tlv_core_ctx.index_table)
     {
         // 如果还未初始化,先设置指针
-        g_tlv_ctx.header = &g_static_header;
-        g_tlv_ctx.index_table = &g_static_index;
+        tlv_core_ctx.header = &g_static_header;
+        tlv_core_ctx.index_table = &g_static_index;
+        tlv_core_ctx.index_hash = g_static_index_hash;
+#if TLV_BLOCK_INFO_CACHE
+        tlv_core_ctx.block_info = g_static_block_info;
+#endif
+    }
+    runtime_state_reset();
+
+    // 同步镜像区需要元数据表
+    if (!tlv_core_ctx.meta_table)
+    {
+        tlv_core_ctx.meta_table = tlv_get_meta_table();
+        tlv_core_ctx.meta_table_size = tlv_get_meta_table_size();
     }
 
     // 初始化系统Header
-    int ret = system_header_init();
+    ret = tlv_core_system_header_init(geometry);
     if (ret != TLV_OK)
     {
         goto error_exit;
@@ -205,51 +643,116 @@ int tlv_format(uint32_t magic)
 
     if (magic != 0)
     {
-        g_tlv_ctx.header->magic = magic;
+        tlv_core_ctx.header->magic = magic;
     }
 
     // 初始化索引系统
-    ret = tlv_index_init(&g_tlv_ctx);
+    ret = tlv_index_init(&tlv_core_ctx);
+    if (ret != TLV_OK)
+    {
+        goto error_exit;
+    }
+    tlv_core_ctx.index_unverified = 0;
+
+#if TLV_JOURNAL_ENABLE
+    // 先清空提交日志,否则格式化中途掉电时旧记录会被重放到新索引表上
+    ret = tlv_core_journal_format();
+    if (ret != TLV_OK)
+    {
+        goto error_exit;
+    }
+#endif
+
+    // 保存Header和索引表：两份Header副本都写入,之前格式化留下的副本不会因序号较新被选中
+    for (uint32_t copy = 0; copy < TLV_HEADER_COPIES; copy++)
+    {
+        ret = tlv_core_system_header_save();
+        if (ret != TLV_OK)
+        {
+            goto error_exit;
+        }
+    }
+
+    ret = tlv_index_save(&tlv_core_ctx);
     if (ret != TLV_OK)
     {
         goto error_exit;
     }
 
-    // 保存Header和索引表
-    ret = system_header_save();
+    // 清除残留的事务日志
+    ret = txn_log_clear();
     if (ret != TLV_OK)
     {
         goto error_exit;
     }
 
-    ret = tlv_index_save(&g_tlv_ctx);
+    // 索引已清空,同步镜像即作废全部槽位
+    ret = tlv_mirror_sync_unlocked();
     if (ret != TLV_OK)
     {
         goto error_exit;
     }
 
     // 备份管理区
-    ret = tlv_backup_all_internal();
+    ret = tlv_core_backup_all_internal();
     if (ret != TLV_OK)
     {
         goto error_exit;
     }
 
     // 设置状态为已格式化
-    g_tlv_ctx.state = TLV_STATE_FORMATTED;
+    tlv_core_ctx.state = TLV_STATE_FORMATTED;
     tlv_printf("Format completed. Please call tlv_init() before operations.\n");
     return TLV_OK;
 
 error_exit:
     // 设置状态为错误
-    g_tlv_ctx.state = TLV_STATE_ERROR;
+    tlv_core_ctx.state = TLV_STATE_ERROR;
     tlv_printf("Format failed. error: %d.\n", ret);
     return ret;
 }
 
+int tlv_format(uint32_t magic)
+{
+    tlv_geometry_t geometry = {TLV_FRAM_SIZE, TLV_MIRROR_SIZE};
+    return tlv_format_geometry(magic, &geometry);
+}
+
+int tlv_format_geometry(uint32_t magic, const tlv_geometry_t *geometry)
+{
+    if (!geometry)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    TLV_WRITE_LOCK();
+    int ret = tlv_format_unlocked(magic, geometry);
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+int tlv_get_geometry(tlv_geometry_t *geometry)
+{
+    if (!geometry)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    TLV_READ_LOCK();
+    int ret = TLV_ERROR;
+    if (tlv_core_ctx.state == TLV_STATE_INITIALIZED)
+    {
+        geometry->fram_size = tlv_core_ctx.backup_addr + TLV_DATA_REGION_SIZE;
+        geometry->mirror_size = tlv_core_ctx.backup_addr - tlv_core_ctx.mirror_addr;
+        ret = TLV_OK;
+    }
+    TLV_READ_UNLOCK();
+    return ret;
+}
+
 tlv_state_t tlv_get_state(void)
 {
-    return g_tlv_ctx.state;
+    return tlv_core_ctx.state;
 }
 
 /* ============================ 数据操作API实现 ============================ */
@@ -261,89 +764,157 @@ tlv_state_t tlv_get_state(void)
  * @return 0: 成功, 其他: 错误码
  * @note 数据的写入过程是数据先落盘,但索引是提交点,只有索引落盘了,数据才可见
  */
+static int tlv_write_unlocked(uint16_t tag, const void *data, uint16_t len)
+{
+    tlv_write_plan_t plan;
+    int ret = tlv_core_write_prepare(tag, data, len, true, true, &plan);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 写入数据块（元数据已解析,直接下传；压缩时数据位于static_buffer）
+    ret = write_data_block(plan.meta, plan.block_data, plan.len, plan.target_addr, plan.write_count,
+                           plan.block_flags);
+    if (ret != TLV_OK)
+    {
+        tlv_printf("write_data_block failed: %d\n", ret);
+        return tlv_core_write_rollback(&plan);
+    }
+
+    return tlv_core_write_commit(&plan, data);
+}
+
 int tlv_write(uint16_t tag, const void *data, uint16_t len)
+{
+    TLV_PERF_BEGIN();
+    TLV_WRITE_LOCK();
+    int ret = tlv_write_unlocked(tag, data, len);
+    tlv_core_gc_run_requested();
+    TLV_WRITE_UNLOCK();
+    TLV_PERF_END(TLV_PERF_OP_WRITE, ret);
+    return ret;
+}
+
+/**
+ * @brief 写入前的检查与空间规划（创建快照、分配空间,不写FRAM）
+ * @param allow_in_place 是否允许原地覆盖旧块（异步写入要求旧块在提交前保持完好）
+ * @param allow_compress 是否允许压缩到static_buffer（异步写入传输期间static_buffer不能被占用）
+ * @param plan 输出写入规划
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_core_write_prepare(uint16_t tag, const void *data, uint16_t len, bool allow_in_place, bool allow_compress,
+                         tlv_write_plan_t *plan)
 {
     if (!data || len == 0 || tag == 0)
     {
         return TLV_ERROR_INVALID_PARAM;
     }
 
-    if (!g_tlv_ctx.header || !g_tlv_ctx.index_table)
+    if (!tlv_core_ctx.header || !tlv_core_ctx.index_table)
     {
         return TLV_ERROR_INVALID_PARAM;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
     {
         return TLV_ERROR;
     }
 
-    int ret = TLV_ERROR;
+    // 事务进行中,应使用tlv_txn_write；异步操作进行中,快照被占用
+    if (tlv_core_txn_ctx.is_active || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    // 快速启动后的首次修改：完成索引校验并清除正常关机标记
+    int settle_ret = tlv_core_fast_boot_settle();
+    if (settle_ret != TLV_OK)
+    {
+        return settle_ret;
+    }
 
     // 查找元数据
-    const tlv_meta_const_t *meta = get_meta(tag);
+    const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
     if (!meta)
     {
         return TLV_ERROR_NOT_FOUND;
     }
 
-    // 检查长度
-    if (len > meta->max_length)
+    // 写入失败时FRAM中的内容不确定,先使缓存失效,提交后再更新
+    ram_cache_invalidate(tag);
+
+    // 检查长度,日志Tag只能追加
+    if (len > meta->max_length || meta->log_record_size != 0)
     {
         return TLV_ERROR_INVALID_PARAM;
     }
 
     // 创建事务快照
-    transaction_snapshot_create();
+    tlv_core_transaction_snapshot_create();
     // 查找现有索引
-    tlv_index_entry_t *index = tlv_index_find(&g_tlv_ctx, tag);
-    uint32_t target_addr;
-    uint32_t old_block_size = 0;
-    uint32_t new_block_size = TLV_BLOCK_SIZE(len);
-    bool is_update = false;                                               // 是否是更新操作
-    bool need_add_index = false;                                          // 是否需要新增索引
-    bool has_free_slot = g_tlv_ctx.header->tag_count < TLV_MAX_TAG_COUNT; // 判断索引表是否有空闲的槽位
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
+    bool has_free_slot = tlv_core_ctx.header->tag_count < TLV_MAX_TAG_COUNT; // 判断索引表是否有空闲的槽位
+
+    memset(plan, 0, sizeof(*plan));
+    plan->meta = meta;
+    plan->index = index;
+    plan->raw_len = len;
+    plan->block_data = data;
+    plan->len = allow_compress ? write_encode(meta, data, len, &plan->block_data, &plan->block_flags) : len;
+    plan->new_block_size = TLV_BLOCK_SIZE(plan->len);
+    plan->write_count = 1;
+    uint32_t compactions = tlv_core_sync_compactions;
 
     if (index && (index->flags & TLV_FLAG_VALID))
     {
-        // 读取旧Header
-        tlv_data_block_header_t old_header;
-        ret = tlv_port_fram_read(index->data_addr, &old_header, sizeof(old_header));
+        // 获取旧块信息（优先使用缓存）
+        uint16_t old_length;
+        uint32_t old_write_count;
+        int ret = tlv_core_get_block_info(index, &old_length, &old_write_count);
         if (ret != TLV_OK)
         {
             return ret;
         }
 
-        old_block_size = TLV_BLOCK_SIZE(old_header.length);
-        if (new_block_size <= old_block_size)
+        plan->old_addr = index->data_addr;
+        plan->old_block_size = TLV_BLOCK_SIZE(old_length);
+        plan->write_count = old_write_count + 1;
+
+        // 累计写入次数达到迁移间隔时换址写入,分散热点Tag的磨损；
+        // 提交日志模式下日志记录是唯一的提交点,记录落盘前旧块必须保持完好,总是换址写入,
+        // 到达迁移间隔时改为优先从尾部分配,避免热点块在相邻空洞之间往返
+        bool in_place = allow_in_place && !TLV_JOURNAL_ENABLE && plan->new_block_size <= plan->old_block_size;
+        uint32_t wear_addr = 0;
+        if ((in_place || TLV_JOURNAL_ENABLE) && wear_relocate_due(plan->write_count))
+        {
+            wear_addr = allocate_space_wear(plan->new_block_size);
+            in_place = in_place && (wear_addr == 0);
+        }
+
+        if (in_place)
         {
             // 数据需要更新
-            is_update = true;
+            plan->is_update = true;
 
             // 原地更新,新数据更小或相等
-            target_addr = index->data_addr;
+            plan->target_addr = index->data_addr;
 
             // 更新 used_space：减少旧的,增加新的
-            reduce_used_space(old_block_size);
-            increase_used_space(new_block_size);
+            tlv_core_reduce_used_space(plan->old_block_size);
+            increase_used_space(plan->new_block_size);
         }
-        else // 数据大小变大,需要重新分配新的槽位
+        else // 数据大小变大或磨损均衡换址,需要重新分配数据空间（沿用原索引槽位）
         {
-            // 索引表满,不分配空间
-            if (!has_free_slot)
-            {
-                return TLV_ERROR_NO_INDEX_SPACE;
-            }
-
             // 分配新空间
-            target_addr = allocate_space(new_block_size);
-            if (target_addr == 0)
+            plan->target_addr = wear_addr ? wear_addr : tlv_core_allocate_space_or_compact(plan->new_block_size);
+            if (plan->target_addr == 0)
             {
                 return TLV_ERROR_NO_MEMORY_SPACE;
             }
 
-            // 需要新增索引
-            need_add_index = true;
+            // 需要迁移数据块
+            plan->need_relocate = true;
         }
     }
     else // Tag不存在,新写入操作
@@ -355,51 +926,94 @@ int tlv_write(uint16_t tag, const void *data, uint16_t len)
         }
 
         // 新Tag,分配空间
-        target_addr = allocate_space(new_block_size);
-        if (target_addr == 0)
+        plan->target_addr = tlv_core_allocate_space_or_compact(plan->new_block_size);
+        if (plan->target_addr == 0)
         {
             return TLV_ERROR_NO_MEMORY_SPACE;
         }
 
         // 需要新增索引
-        need_add_index = true;
+        plan->need_add_index = true;
     }
 
-    // 写入数据块
-    ret = write_data_block(tag, data, len, target_addr);
-    if (ret != TLV_OK)
+    // 分配空间时同步整理过,static_buffer中的压缩数据已被覆盖（压缩结果确定,重新生成即可）
+    if ((plan->block_flags & TLV_BLOCK_FLAG_COMPRESSED) && compactions != tlv_core_sync_compactions)
     {
-        // ========== 写入失败,回滚 ==========
-        tlv_printf("write_data_block failed: %d\n", ret);
+        write_encode(meta, data, len, &plan->block_data, &plan->block_flags);
+    }
 
-        // 写入失败,回滚所有状态,包括nextfree,避免未写入成功的内存成为碎片
-        transaction_snapshot_rollback();
-        // 保存回滚后的header
-        ret = system_header_save();
+    return TLV_OK;
+}
 
-        return ret;
-    }
+/**
+ * @brief 按元数据将待写入数据压缩到static_buffer
+ * @param block_data 输出写入数据块的数据（压缩后指向static_buffer,否则为data）
+ * @param block_flags 输出数据块标志
+ * @return 数据块数据长度
+ * @note 数据已位于static_buffer（迁移场景）或压缩后不更小时按原始数据存储
+ */
+static uint16_t write_encode(const tlv_meta_const_t *meta, const void *data, uint16_t len, const void **block_data,
+                             uint8_t *block_flags)
+{
+    *block_data = data;
+    *block_flags = 0;
 
-    // 新增索引
-    if (need_add_index)
+#if TLV_COMPRESS_ENABLE
+    if (!meta_compressible(meta) || len < TLV_COMPRESS_MIN_SIZE || overlaps_static_buffer(data, len))
     {
-        // ---------- 需要新增索引 ----------
-        if (index && (index->flags & TLV_FLAG_VALID)) // 原有的索引块废弃
-        {
-            // 标记旧块为脏,旧块失效,旧块索引不使用
-            index->flags = TLV_FLAG_DIRTY;
-            index = NULL;
+        return len;
+    }
+
+    uint16_t cap = (len - 1 > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : (uint16_t)(len - 1);
+    uint16_t stored_len = tlv_lz_encode(data, len, tlv_core_ctx.static_buffer, cap);
+    if (stored_len != 0)
+    {
+        *block_data = tlv_core_ctx.static_buffer;
+        *block_flags = TLV_BLOCK_FLAG_COMPRESSED;
+        return stored_len;
+    }
+#else
+    (void)meta;
+#endif
 
-            // 旧块不再有效,减少 used_space
-            reduce_used_space(old_block_size);
+    return len;
+}
 
-            // 统计碎片数量及碎片大小
-            g_tlv_ctx.header->fragment_count++;
-            g_tlv_ctx.header->fragment_size += old_block_size;
-        }
+/**
+ * @brief 数据块写入失败,回滚写入规划
+ * @return 保存回滚后Header的结果
+ */
+int tlv_core_write_rollback(const tlv_write_plan_t *plan)
+{
+    // 原地写入失败时旧块可能已被破坏,缓存失效
+    if (plan->is_update)
+    {
+        tlv_core_block_info_invalidate(plan->index);
+    }
+
+    // 写入失败,回滚所有状态,包括nextfree,避免未写入成功的内存成为碎片
+    transaction_snapshot_rollback();
+    // 保存回滚后的header
+    return tlv_core_system_header_save();
+}
+
+/**
+ * @brief 数据块已落盘,提交索引（提交点）并更新统计
+ * @param data 已写入的数据（用于更新RAM缓存）
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_core_write_commit(const tlv_write_plan_t *plan, const void *data)
+{
+    uint16_t tag = plan->meta->tag;
+    tlv_index_entry_t *index = plan->index;
+    int ret;
 
-        tlv_index_entry_t *new_index = tlv_index_add(&g_tlv_ctx, tag, target_addr);
-        if (!new_index)
+    // 新增索引
+    if (plan->need_add_index)
+    {
+        // ---------- 需要新增索引 ----------
+        index = tlv_index_add(&tlv_core_ctx, tag, plan->target_addr);
+        if (!index)
         {
             // 这不应该发生（我们已经检查过）,且可以分配脏块给新索引使用
             tlv_printf("CRITICAL: Index add failed unexpectedly!\n");
@@ -409,46 +1023,58 @@ int tlv_write(uint16_t tag, const void *data, uint16_t len)
     }
     else // 更新索引
     {
-        tlv_index_update(&g_tlv_ctx, tag, target_addr);
+        tlv_index_entry_t old_entry = *index;
+        tlv_index_update(&tlv_core_ctx, tag, plan->target_addr);
+
+        // 原地更新且索引未变化时无需落盘索引
+        if (memcmp(&old_entry, index, sizeof(old_entry)) == 0)
+        {
+            tlv_core_block_info_set(index, plan->len, plan->write_count);
+            index = NULL;
+        }
+    }
+
+    // 立即保存索引到FRAM (索引是提交点,单条目8字节写入)
+    if (index)
+    {
+        tlv_core_block_info_set(index, plan->len, plan->write_count);
+        ret = tlv_core_index_commit_entry(index, plan->len);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
     }
 
-    // 立即保存索引表到FRAM (保证一致性)
-    ret = tlv_index_save(&g_tlv_ctx);
-    if (ret != TLV_OK)
+    // 索引提交后旧块才不再被引用,此时归还空闲空间
+    if (plan->need_relocate)
     {
-        return ret;
+        release_space(plan->old_addr, plan->old_block_size, true);
+    }
+    else if (plan->is_update && plan->new_block_size < plan->old_block_size && free_list_usable())
+    {
+        // 原地缩小,尾部多余空间（已不计入used_space,块Header已记录新长度）归还空闲区段表
+        free_list_add(plan->old_addr + plan->new_block_size, plan->old_block_size - plan->new_block_size, false);
+        free_list_sync_stats();
     }
 
+    // 写穿透更新RAM缓存
+    tlv_core_ram_cache_store(plan->meta, data, plan->raw_len);
+
     // ========== 提交事务 ==========
     transaction_snapshot_commit();
 
     // 更新统计
-    g_tlv_ctx.header->total_writes++;
-    g_tlv_ctx.header->last_update_time = tlv_port_get_timestamp_s();
+    tlv_core_ctx.header->total_writes++;
+    tlv_core_ctx.header->last_update_time = tlv_port_get_timestamp_s();
 
-    ret = system_header_save();
+    ret = system_header_commit();
     if (ret != TLV_OK)
     {
         return ret;
     }
 
-    // 检查是否自动整理碎片
-#if TLV_AUTO_CLEAN_FRAGEMENT
-    uint32_t fragUsagePercent = 0;
-    ret = tlv_calculate_fragmentation(&fragUsagePercent);
-    if (ret == TLV_OK)
-    {
-        if (fragUsagePercent >= TLV_AUTO_DEFRAG_THRESHOLD)
-        {
-            ret = tlv_defragment();
-            if (ret != TLV_OK)
-            {
-                tlv_printf("CRITICAL: auto defragment failed unexpectedly!\n");
-                return ret;
-            }
-        }
-    }
-#endif
+    // 按GC策略检查是否需要整理
+    tlv_core_gc_check();
 
     return TLV_OK;
 }
@@ -461,41 +1087,74 @@ int tlv_write(uint16_t tag, const void *data, uint16_t len)
  * @return 0: 成功, 其他: 错误码
  * @note tlv_read 读取时不检查meta表,因为如果固件升级导致meta表变化也可以从内存中读取出遗留数据,便于向后兼容
  */
-int tlv_read(uint16_t tag, void *buf, uint16_t *len)
+int tlv_core_read_unlocked(uint16_t tag, void *buf, uint16_t *len, bool allow_migrate)
 {
     if (!buf || !len || tag == 0 || *len == 0)
     {
         return TLV_ERROR_INVALID_PARAM;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
     {
         return TLV_ERROR;
     }
 
     uint16_t output_size = *len; // 保存输出缓冲区大小
 
+    // RAM缓存命中时不访问FRAM
+    int ret = tlv_core_ram_cache_read(tag, buf, len);
+    if (ret != TLV_ERROR_NOT_FOUND)
+    {
+        return ret;
+    }
+
     // 查找索引
-    tlv_index_entry_t *index = tlv_index_find(&g_tlv_ctx, tag);
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
     if (!index || !(index->flags & TLV_FLAG_VALID))
     {
         return TLV_ERROR_NOT_FOUND;
     }
 
-    // 读取数据块
+    // 读取数据块（缓存命中时已知长度,一次传输；缓存的是存储长度,可压缩Tag不使用）
     uint16_t read_len = output_size;
-    int ret = read_data_block(index->data_addr, buf, &read_len);
+    uint16_t expect_len = 0;
+    if (!meta_compressible(tlv_core_get_meta(tag)))
+    {
+        block_info_lookup(index, false, &expect_len);
+    }
+    tlv_data_block_header_t header;
+    ret = read_block(index->data_addr, tag, expect_len, buf, &read_len, &header);
+    if (ret == TLV_ERROR_CRC_FAILED)
+    {
+        // 主块损坏：返回同一次写入的镜像副本,不迁移也不缓存（主块由下次写入或巡检修复）
+        read_len = output_size;
+        if (mirror_read(&header, buf, &read_len) == TLV_OK)
+        {
+            *len = read_len;
+            return TLV_OK;
+        }
+    }
     if (ret != TLV_OK)
     {
         return ret;
     }
 
+    // 整块CRC与Tag已在read_block中校验
+    tlv_core_block_info_set(index, header.length, header.write_count);
+    tlv_core_block_info_mark_verified(index);
+
     // 读取时惰性迁移
 #if (TLV_ENABLE_MIGRATION && TLV_LAZY_MIGRATE_ON_READ)
     // 查找元数据获取期望版本
-    const tlv_meta_const_t *meta = get_meta(tag);
+    const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
     if (meta && index->version < meta->version)
     {
+        // 迁移需要写回,持读锁时交由调用者升级为写锁
+        if (!allow_migrate)
+        {
+            return TLV_READ_NEED_MIGRATE;
+        }
+
         // 执行到这里,输出缓冲区一定能承载旧数据,否则之前的read_data_block就会报错 TLV_ERROR_NO_BUFFER_MEMORY
         // 需要升级
         tlv_printf("Migrating tag 0x%04X on read: v%u -> v%u\n",
@@ -504,12 +1163,14 @@ int tlv_read(uint16_t tag, void *buf, uint16_t *len)
         // output_size传递给tlv_migrate_tag,由迁移函数判断缓冲区是否足够迁移
         uint16_t old_len = read_len; // 旧数据长度
         uint16_t new_len = 0;
-        ret = tlv_migrate_tag(&g_tlv_ctx, tag, buf, old_len, &new_len, output_size,
+        TLV_PERF_BEGIN();
+        ret = tlv_migrate_tag(&tlv_core_ctx, tag, buf, old_len, &new_len, output_size,
                               index->version);
         if (ret == TLV_OK)
         {
             // 迁移成功,写回FRAM
-            int write_ret = tlv_write(tag, buf, new_len);
+            int write_ret = tlv_write_unlocked(tag, buf, new_len);
+            TLV_PERF_END(TLV_PERF_OP_MIGRATE, write_ret);
             if (write_ret < 0)
             {
                 // 写回失败,警告但仍返回迁移后的数据
@@ -523,6 +1184,7 @@ int tlv_read(uint16_t tag, void *buf, uint16_t *len)
         }
         else if (ret == TLV_ERROR_NO_BUFFER_MEMORY)
         {
+            TLV_PERF_END(TLV_PERF_OP_MIGRATE, ret);
             // 缓冲区不够,告知用户需要的大小
             *len = new_len; // 迁移函数应设置需要的大小
             tlv_printf("ERROR: Buffer too small for migration\n");
@@ -531,11 +1193,12 @@ int tlv_read(uint16_t tag, void *buf, uint16_t *len)
         }
         else
         {
+            TLV_PERF_END(TLV_PERF_OP_MIGRATE, ret);
             // 其他迁移错误,降级返回旧数据
             tlv_printf("WARNING: Migration failed (err: %d), returning old data\n", ret);
 
             read_len = output_size;
-            int reread_ret = read_data_block(index->data_addr, buf, &read_len);
+            int reread_ret = read_data_block(index->data_addr, tag, buf, &read_len);
             if (reread_ret != TLV_OK)
             {
                 // 重新读取失败
@@ -546,1135 +1209,5287 @@ int tlv_read(uint16_t tag, void *buf, uint16_t *len)
     }
 #endif
 
+    // 当前版本的数据放入RAM缓存
+    const tlv_meta_const_t *cache_meta = tlv_core_get_meta(tag);
+    if (cache_meta && index->version >= cache_meta->version)
+    {
+        tlv_core_ram_cache_store(cache_meta, buf, read_len);
+    }
+
     *len = read_len;
     return TLV_OK;
 }
 
+int tlv_read(uint16_t tag, void *buf, uint16_t *len)
+{
+    uint16_t output_size = len ? *len : 0;
+
+    TLV_PERF_BEGIN();
+    TLV_READ_LOCK();
+    int ret = tlv_core_read_unlocked(tag, buf, len, !TLV_THREAD_SAFE);
+    TLV_READ_UNLOCK();
+
+    if (ret == TLV_READ_NEED_MIGRATE)
+    {
+        // 释放读锁后数据可能已被其他任务迁移或改写,持写锁完整重读
+        *len = output_size;
+        TLV_WRITE_LOCK();
+        ret = tlv_core_read_unlocked(tag, buf, len, true);
+        TLV_WRITE_UNLOCK();
+    }
+
+    TLV_PERF_END(TLV_PERF_OP_READ, ret);
+    return ret;
+}
+
 /**
- * @brief 删除TLV数据
+ * @brief 按范围读取TLV数据
  * @param tag Tag值
+ * @param offset payload内偏移
+ * @param buf 输出缓冲区
+ * @param len 读取长度
  * @return 0: 成功, 其他: 错误码
  */
-int tlv_delete(uint16_t tag)
+static int tlv_read_range_unlocked(uint16_t tag, uint16_t offset, void *buf, uint16_t len)
 {
-    if (tag == 0)
+    if (!buf || tag == 0 || len == 0)
     {
         return TLV_ERROR_INVALID_PARAM;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
     {
         return TLV_ERROR;
     }
 
-    // 先获取索引信息,计算块大小
-    tlv_index_entry_t *index = tlv_index_find(&g_tlv_ctx, tag);
+    // 查找索引
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
     if (!index || !(index->flags & TLV_FLAG_VALID))
     {
         return TLV_ERROR_NOT_FOUND;
     }
 
-    // 读取数据块大小
-    tlv_data_block_header_t header;
-    int ret = tlv_port_fram_read(index->data_addr, &header, sizeof(header));
-    if (ret == TLV_OK)
+    const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
+#if TLV_ENABLE_MIGRATION
+    // 旧版本布局不同,偏移没有意义
+    if (meta && index->version < meta->version)
     {
-        uint32_t block_size = sizeof(header) + header.length + sizeof(uint16_t);
-
-        // 更新统计
-        reduce_used_space(block_size);
-        g_tlv_ctx.header->fragment_count++;
-        g_tlv_ctx.header->fragment_size += block_size;
+        return TLV_ERROR_VERSION;
     }
+#endif
 
-    // 删除索引
-    ret = tlv_index_remove(&g_tlv_ctx, tag);
-    if (ret == TLV_OK)
+    // 压缩数据块的偏移同样没有意义
+    if (meta_compressible(meta))
     {
-        // 更新统计
-        g_tlv_ctx.header->last_update_time = tlv_port_get_timestamp_s();
+        uint8_t flags;
+        int ret = tlv_core_ctx.ops->read(index->data_addr + offsetof(tlv_data_block_header_t, flags), &flags,
+                                      sizeof(flags));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
 
-        // 删除操作必须保存索引和Header (避免幽灵数据)
-        tlv_index_save(&g_tlv_ctx);
-        system_header_save();
+        if (flags & TLV_BLOCK_FLAG_COMPRESSED)
+        {
+            return TLV_ERROR_INVALID_PARAM;
+        }
     }
 
-    return ret;
-}
+    // 获取块长度（缓存命中且满足校验要求时不访问FRAM）
+    uint16_t length = 0;
+    if (!block_info_lookup(index, TLV_READ_RANGE_VERIFY_CRC, &length))
+    {
+        int ret = tlv_core_check_block(index, TLV_READ_RANGE_VERIFY_CRC, &length);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+    }
 
-/**
- * @brief 强制保存所有挂起的更改
- * @return 0: 成功, 其他: 错误码
- */
-int tlv_flush(void)
-{
-    int ret = tlv_index_save(&g_tlv_ctx);
-    if (ret != TLV_OK)
+    if ((uint32_t)offset + len > length)
     {
-        return ret;
+        return TLV_ERROR_INVALID_PARAM;
     }
 
-    return system_header_save();
+    return tlv_core_ctx.ops->read(index->data_addr + sizeof(tlv_data_block_header_t) + offset, buf, len);
 }
 
-/**
- * @brief 检查Tag是否存在
- * @param tag Tag值
- * @return true: 存在, false: 不存在
- */
-bool tlv_exists(uint16_t tag)
+int tlv_read_range(uint16_t tag, uint16_t offset, void *buf, uint16_t len)
 {
-    if (tag == 0 || g_tlv_ctx.state != TLV_STATE_INITIALIZED)
-    {
-        return false;
-    }
-
-    tlv_index_entry_t *entry = tlv_index_find(&g_tlv_ctx, tag);
-    return (entry != NULL && (entry->flags & TLV_FLAG_VALID));
+    TLV_READ_LOCK();
+    int ret = tlv_read_range_unlocked(tag, offset, buf, len);
+    TLV_READ_UNLOCK();
+    return ret;
 }
 
 /**
- * @brief 获取Tag数据长度
+ * @brief 按范围原地改写TLV数据（长度不变,只写payload中[offset, offset+len)部分）
  * @param tag Tag值
- * @param len 输出长度
+ * @param offset payload内偏移
+ * @param data 新数据
+ * @param len 改写长度
  * @return 0: 成功, 其他: 错误码
+ * @note CRC16对固定长度的消息是线性的：新CRC = 旧CRC ^ CRC(新旧内容的差值),差值只在Header与改写范围内非零,
+ *       其间的零字节由tlv_crc16_shift跨过,因此只回读Header、旧范围数据与旧CRC,不触及其余payload；
+ *       块地址与长度不变,索引条目不变,不落盘索引。旧块本身已损坏时新CRC仍然不匹配,损坏不会被掩盖。
+ *       到达磨损均衡换址周期时退回整块改写
  */
-int tlv_get_length(uint16_t tag, uint16_t *len)
+static int tlv_write_range_unlocked(uint16_t tag, uint16_t offset, const void *data, uint16_t len)
 {
-    if (!len || tag == 0)
+    if (!data || tag == 0 || len == 0 || overlaps_static_buffer(data, len))
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (!tlv_core_ctx.header || !tlv_core_ctx.index_table)
     {
         return TLV_ERROR_INVALID_PARAM;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
     {
         return TLV_ERROR;
     }
 
-    tlv_index_entry_t *index = tlv_index_find(&g_tlv_ctx, tag);
+    if (tlv_core_txn_ctx.is_active || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    // 日志Tag只能追加
+    const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
+    if (!meta)
+    {
+        return TLV_ERROR_NOT_FOUND;
+    }
+
+    if (meta->log_record_size != 0)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
     if (!index || !(index->flags & TLV_FLAG_VALID))
     {
         return TLV_ERROR_NOT_FOUND;
     }
 
-    // 读取数据块Header获取长度
-    tlv_data_block_header_t header;
-    int ret = tlv_port_fram_read(index->data_addr, &header, sizeof(header));
+#if TLV_ENABLE_MIGRATION
+    // 旧版本布局不同,偏移没有意义
+    if (index->version < meta->version)
+    {
+        return TLV_ERROR_VERSION;
+    }
+#endif
+
+    int ret = tlv_core_fast_boot_settle();
     if (ret != TLV_OK)
     {
         return ret;
     }
 
-    *len = header.length;
-    return TLV_OK;
-}
+    uint16_t length = 0;
+    bool was_verified = block_info_lookup(index, true, &length);
 
-/* ============================ 批量操作API实现 ============================ */
-/**
- * @brief 批量读取
- * @param tags Tag数组
- * @param count Tag数量
- * @param buffers 缓冲区数组
- * @param lengths 长度数组
- * @return 成功读取的数量
- */
-int tlv_read_batch(const uint16_t *tags, uint16_t count,
-                   void **buffers, uint16_t *lengths)
-{
-    if (!tags || !buffers || !lengths || count == 0)
+    tlv_data_block_header_t header;
+    ret = tlv_core_ctx.ops->read(index->data_addr, &header, sizeof(header));
+    if (ret != TLV_OK)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        return ret;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (header.tag != tag || !TLV_IS_SIZE_SAFE(&tlv_core_ctx, index->data_addr, TLV_BLOCK_SIZE(header.length)))
     {
-        return TLV_ERROR;
+        return TLV_ERROR_CORRUPTED;
     }
 
-    int success_count = 0;
+    // 压缩数据块不能按原始偏移改写
+    length = header.length;
+    if ((uint32_t)offset + len > length || (header.flags & TLV_BLOCK_FLAG_COMPRESSED))
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
 
-    for (uint16_t i = 0; i < count; i++)
+    // 磨损均衡换址周期：读出整块修改后经普通写入路径换址（写入路径此时不会触发整理,static_buffer不被占用）
+    if (wear_relocate_due(header.write_count + 1) && length <= TLV_BUFFER_SIZE)
     {
-        if (tlv_read(tags[i], buffers[i], &lengths[i]) == TLV_OK)
+        uint16_t buf_len = TLV_BUFFER_SIZE;
+        ret = read_block(index->data_addr, tag, length, tlv_core_ctx.static_buffer, &buf_len, NULL);
+        if (ret != TLV_OK)
         {
-            success_count++;
+            return ret;
         }
+
+        memcpy(tlv_core_ctx.static_buffer + offset, data, len);
+        return tlv_write_unlocked(tag, tlv_core_ctx.static_buffer, length);
     }
 
-    return success_count;
-}
-/**
- * @brief 批量写入
- * @param tags Tag数组
- * @param count Tag数量
- * @param datas 数据数组
- * @param lengths 长度数组
- * @return 成功写入的数量
- */
-int tlv_write_batch(const uint16_t *tags, uint16_t count,
-                    const void **datas, const uint16_t *lengths)
-{
-    if (!tags || !datas || !lengths || count == 0)
+    // Header差值：只有timestamp与write_count变化
+    tlv_data_block_header_t delta_header = {0};
+    uint32_t timestamp = tlv_port_get_timestamp_s();
+    delta_header.timestamp = header.timestamp ^ timestamp;
+    delta_header.write_count = header.write_count ^ (header.write_count + 1);
+    header.timestamp = timestamp;
+    header.write_count++;
+
+    uint16_t delta = tlv_crc16_update(0, &delta_header, sizeof(delta_header));
+    delta = tlv_crc16_shift(delta, offset);
+
+    // 数据差值：经static_buffer分批回读旧数据
+    uint32_t addr = index->data_addr + sizeof(header) + offset;
+    const uint8_t *src = (const uint8_t *)data;
+    uint16_t remain = len;
+    while (remain > 0)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        uint16_t chunk_size = (remain > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : remain;
+        ret = tlv_core_ctx.ops->read(addr, tlv_core_ctx.static_buffer, chunk_size);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        for (uint16_t i = 0; i < chunk_size; i++)
+        {
+            tlv_core_ctx.static_buffer[i] ^= src[i];
+        }
+
+        delta = tlv_crc16_update(delta, tlv_core_ctx.static_buffer, chunk_size);
+        addr += chunk_size;
+        src += chunk_size;
+        remain -= chunk_size;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    delta = tlv_crc16_shift(delta, length - offset - len);
+
+    uint16_t stored_crc;
+    uint32_t crc_addr = index->data_addr + sizeof(header) + length;
+    ret = tlv_core_ctx.ops->read(crc_addr, &stored_crc, sizeof(stored_crc));
+    if (ret != TLV_OK)
     {
-        return TLV_ERROR;
+        return ret;
     }
 
-    int success_count = 0;
+    stored_crc ^= tlv_crc16_final(delta);
 
-    for (uint16_t i = 0; i < count; i++)
+    tlv_core_block_info_invalidate(index);
+
+    // Header、数据、CRC16三段地址相邻时合并传输；中途掉电时整块CRC不匹配
+    tlv_iovec_t iov[3] = {
+        {&header, sizeof(header)},
+        {(void *)data, len},
+        {&stored_crc, sizeof(stored_crc)},
+    };
+    bool header_adjacent = (offset == 0);
+    bool crc_adjacent = ((uint32_t)offset + len == length);
+    if (header_adjacent)
+    {
+        ret = block_writev(index->data_addr, iov, crc_adjacent ? 3 : 2);
+    }
+    else
     {
-        if (tlv_write(tags[i], datas[i], lengths[i]) >= 0)
+        ret = block_writev(index->data_addr + sizeof(header) + offset, &iov[1], crc_adjacent ? 2 : 1);
+        if (ret == TLV_OK)
         {
-            success_count++;
+            ret = tlv_core_ctx.ops->write(index->data_addr, &header, sizeof(header));
         }
     }
+    if (ret == TLV_OK && !crc_adjacent)
+    {
+        ret = tlv_core_ctx.ops->write(crc_addr, &stored_crc, sizeof(stored_crc));
+    }
+    if (ret != TLV_OK)
+    {
+        // FRAM中的内容不确定
+        ram_cache_invalidate(tag);
+        return ret;
+    }
 
-    return success_count;
+    ram_cache_patch(tag, offset, data, len);
+
+    // 增量CRC保持旧块的校验状态
+    tlv_core_block_info_set(index, length, header.write_count);
+    if (was_verified)
+    {
+        tlv_core_block_info_mark_verified(index);
+    }
+
+    // 空间统计不变,Header在写回模式下只标记为脏
+    tlv_core_transaction_snapshot_create();
+    transaction_snapshot_commit();
+    tlv_core_ctx.header->total_writes++;
+    tlv_core_ctx.header->last_update_time = timestamp;
+
+    return system_header_commit();
+}
+
+int tlv_write_range(uint16_t tag, uint16_t offset, const void *data, uint16_t len)
+{
+    TLV_PERF_BEGIN();
+    TLV_WRITE_LOCK();
+    int ret = tlv_write_range_unlocked(tag, offset, data, len);
+    tlv_core_gc_run_requested();
+    TLV_WRITE_UNLOCK();
+    TLV_PERF_END(TLV_PERF_OP_WRITE, ret);
+    return ret;
 }
 
-/* ============================ 查询与统计API实现 ============================ */
 /**
- * @brief 获取统计信息
- * @param stats 统计信息输出
+ * @brief 删除TLV数据
+ * @param tag Tag值
  * @return 0: 成功, 其他: 错误码
  */
-int tlv_get_statistics(tlv_statistics_t *stats)
+static int tlv_delete_unlocked(uint16_t tag)
 {
-    if (!stats)
+    if (tag == 0)
     {
         return TLV_ERROR_INVALID_PARAM;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
     {
         return TLV_ERROR;
     }
 
-    memset(stats, 0, sizeof(tlv_statistics_t));
+    if (tlv_core_txn_ctx.is_active || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
 
-    stats->total_tags = TLV_MAX_TAG_COUNT;
-    stats->valid_tags = g_tlv_ctx.header->tag_count;
-    stats->free_space = g_tlv_ctx.header->free_space;
-    stats->used_space = g_tlv_ctx.header->used_space;
+    int ret = tlv_core_fast_boot_settle();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 先获取索引信息,计算块大小
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
+    if (!index || !(index->flags & TLV_FLAG_VALID))
+    {
+        return TLV_ERROR_NOT_FOUND;
+    }
+
+    // 读取数据块大小（索引删除提交后归还）
+    uint16_t length;
+    uint32_t write_count;
+    uint32_t old_addr = index->data_addr;
+    uint32_t block_size = (tlv_core_get_block_info(index, &length, &write_count) == TLV_OK) ? TLV_BLOCK_SIZE(length) : 0;
+
+    // 删除索引,镜像随之失效（避免重新创建的Tag与旧镜像的写入计数重合）
+    tlv_core_block_info_invalidate(index);
+    ram_cache_invalidate(tag);
+    uint32_t slot_addr = mirror_slot_addr(tag);
+    if (slot_addr != 0)
+    {
+        mirror_invalidate(slot_addr);
+    }
+    ret = tlv_index_remove(&tlv_core_ctx, tag);
+    if (ret == TLV_OK)
+    {
+        // 更新统计
+        tlv_core_ctx.header->last_update_time = tlv_port_get_timestamp_s();
+
+        // 删除操作必须提交索引和Header (避免幽灵数据),index已被清零
+        ret = index_commit_remove(index, tag);
+        if (ret == TLV_OK && block_size != 0)
+        {
+            release_space(old_addr, block_size, true);
+        }
+#if TLV_JOURNAL_ENABLE
+        tlv_core_ctx.header_dirty = true;
+#else
+        if (ret == TLV_OK)
+        {
+            ret = tlv_core_system_header_save();
+        }
+#endif
+    }
+
+    return ret;
+}
+
+int tlv_delete(uint16_t tag)
+{
+    TLV_PERF_BEGIN();
+    TLV_WRITE_LOCK();
+    int ret = tlv_delete_unlocked(tag);
+    TLV_WRITE_UNLOCK();
+    TLV_PERF_END(TLV_PERF_OP_DELETE, ret);
+    return ret;
+}
+
+/**
+ * @brief 强制保存所有挂起的更改
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_core_flush_unlocked(void)
+{
+    if (!tlv_core_ctx.header || !tlv_core_ctx.index_table)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 标记仍在说明上次落盘后没有修改
+    if (tlv_core_ctx.clean_marked)
+    {
+        return TLV_OK;
+    }
+
+    // 未校验的索引页不能随整表CRC一起重新计算
+    int ret = fast_boot_verify(UINT32_MAX);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+#if TLV_JOURNAL_ENABLE
+    // 提交日志：检查点批量保存日志覆盖的索引页与Header
+    ret = tlv_core_journal_checkpoint();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+#elif TLV_WRITE_BACK_MODE
+    // 写回模式：只补写过期的整表CRC与合并的Header统计字段
+    if (tlv_core_ctx.index_crc_dirty)
+    {
+        ret = tlv_index_save_crc(&tlv_core_ctx);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+    }
+#else
+    ret = tlv_index_save(&tlv_core_ctx);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+#endif
+
+    // 可行时连同正常关机标记一起保存Header
+    if (clean_marker_allowed())
+    {
+        return clean_marker_write();
+    }
+
+#if TLV_JOURNAL_ENABLE
+    return TLV_OK;
+#elif TLV_WRITE_BACK_MODE
+    if (tlv_core_ctx.header_dirty)
+    {
+        ret = tlv_core_system_header_save();
+    }
+
+    return ret;
+#else
+    return tlv_core_system_header_save();
+#endif
+}
+
+int tlv_flush(void)
+{
+    TLV_PERF_BEGIN();
+    TLV_WRITE_LOCK();
+    int ret = tlv_core_flush_unlocked();
+    TLV_WRITE_UNLOCK();
+    TLV_PERF_END(TLV_PERF_OP_FLUSH, ret);
+    return ret;
+}
+
+/**
+ * @brief 检查Tag是否存在
+ * @param tag Tag值
+ * @return true: 存在, false: 不存在
+ */
+static bool tlv_exists_unlocked(uint16_t tag)
+{
+    if (tag == 0 || tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return false;
+    }
+
+    tlv_index_entry_t *entry = tlv_index_find(&tlv_core_ctx, tag);
+    return (entry != NULL && (entry->flags & TLV_FLAG_VALID));
+}
+
+bool tlv_exists(uint16_t tag)
+{
+    TLV_READ_LOCK();
+    bool ret = tlv_exists_unlocked(tag);
+    TLV_READ_UNLOCK();
+    return ret;
+}
+
+/**
+ * @brief 获取Tag数据长度
+ * @param tag Tag值
+ * @param len 输出长度
+ * @return 0: 成功, 其他: 错误码
+ */
+static int tlv_get_length_unlocked(uint16_t tag, uint16_t *len)
+{
+    if (!len || tag == 0)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
+    if (!index || !(index->flags & TLV_FLAG_VALID))
+    {
+        return TLV_ERROR_NOT_FOUND;
+    }
+
+    // 可压缩Tag需要原始长度,读出Header与压缩数据的长度前缀
+    if (meta_compressible(tlv_core_get_meta(tag)))
+    {
+        uint8_t block[sizeof(tlv_data_block_header_t) + TLV_LZ_HEADER_SIZE];
+        int ret = tlv_core_ctx.ops->read(index->data_addr, block, sizeof(block));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        tlv_data_block_header_t header;
+        memcpy(&header, block, sizeof(header));
+        if (header.tag != tag)
+        {
+            return TLV_ERROR_CORRUPTED;
+        }
+
+        const uint8_t *prefix = block + sizeof(header);
+        *len = (header.flags & TLV_BLOCK_FLAG_COMPRESSED) ? (uint16_t)(prefix[0] | (prefix[1] << 8)) : header.length;
+        return TLV_OK;
+    }
+
+    // 读取数据块长度（优先使用缓存）
+    uint32_t write_count;
+    return tlv_core_get_block_info(index, len, &write_count);
+}
+
+int tlv_get_length(uint16_t tag, uint16_t *len)
+{
+    TLV_READ_LOCK();
+    int ret = tlv_get_length_unlocked(tag, len);
+    TLV_READ_UNLOCK();
+    return ret;
+}
+
+/* ============================ 批量操作API实现 ============================ */
+/**
+ * @brief 批量读取
+ * @param tags Tag数组
+ * @param count Tag数量
+ * @param buffers 缓冲区数组
+ * @param lengths 长度数组
+ * @return 成功读取的数量
+ */
+int tlv_read_batch(const uint16_t *tags, uint16_t count,
+                   void **buffers, uint16_t *lengths)
+{
+    if (!tags || !buffers || !lengths || count == 0)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    int success_count = 0;
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        if (tlv_read(tags[i], buffers[i], &lengths[i]) == TLV_OK)
+        {
+            success_count++;
+        }
+    }
+
+    return success_count;
+}
+/**
+ * @brief 批量写入（基于事务,全部成功或全部不生效）
+ * @param tags Tag数组
+ * @param count Tag数量
+ * @param datas 数据数组
+ * @param lengths 长度数组
+ * @return 成功写入的数量, <0: 错误码
+ */
+static int tlv_write_batch_unlocked(const uint16_t *tags, uint16_t count,
+                    const void **datas, const uint16_t *lengths)
+{
+    if (!tags || !datas || !lengths || count == 0 || count > TLV_MAX_TXN_ENTRIES)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    int ret = tlv_txn_begin_unlocked();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    for (uint16_t i = 0; i < count; i++)
+    {
+        ret = tlv_txn_write_unlocked(tags[i], datas[i], lengths[i]);
+        if (ret != TLV_OK)
+        {
+            tlv_txn_abort_unlocked();
+            return ret;
+        }
+    }
+
+    ret = tlv_txn_commit_unlocked();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    return count;
+}
+
+int tlv_write_batch(const uint16_t *tags, uint16_t count,
+                    const void **datas, const uint16_t *lengths)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_write_batch_unlocked(tags, count, datas, lengths);
+    tlv_core_gc_run_requested();
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+/* ============================ 事务API实现 ============================ */
+/**
+ * @brief 开始事务
+ * @return 0: 成功, 其他: 错误码
+ */
+static int tlv_txn_begin_unlocked(void)
+{
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    // 事务不可嵌套,且与分段写入、异步写入共用快照
+    if (tlv_core_txn_ctx.is_active || tlv_core_has_active_write_stream() || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    int ret = tlv_core_fast_boot_settle();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    memset(&tlv_core_txn_ctx, 0, sizeof(tlv_core_txn_ctx));
+    tlv_core_transaction_snapshot_create();
+    tlv_core_txn_ctx.is_active = true;
+
+    return TLV_OK;
+}
+
+int tlv_txn_begin(void)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_txn_begin_unlocked();
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+/**
+ * @brief 事务内写入
+ *
+ * 数据总是异地写入新分配的空间,提交前索引不变,旧数据保持可读。
+ * 同一事务内重复写入同一Tag时以最后一次为准,之前的块计入碎片。
+ *
+ * @param tag Tag值
+ * @param data 数据指针
+ * @param len 数据长度
+ * @return 0: 成功, 其他: 错误码
+ */
+static int tlv_txn_write_unlocked(uint16_t tag, const void *data, uint16_t len)
+{
+    if (!data || len == 0 || tag == 0)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (!tlv_core_txn_ctx.is_active)
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
+    if (!meta)
+    {
+        return TLV_ERROR_NOT_FOUND;
+    }
+
+    if (len > meta->max_length || meta->log_record_size != 0)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 查找同一事务内的挂起条目
+    tlv_txn_pending_t *pending = NULL;
+    uint32_t write_count = 1;
+    for (uint16_t i = 0; i < tlv_core_txn_ctx.count; i++)
+    {
+        if (tlv_core_txn_ctx.pending[i].tag == tag)
+        {
+            pending = &tlv_core_txn_ctx.pending[i];
+            break;
+        }
+    }
+
+    bool is_new_tag = false;
+    if (pending)
+    {
+        write_count = pending->write_count + 1;
+    }
+    else
+    {
+        if (tlv_core_txn_ctx.count >= TLV_MAX_TXN_ENTRIES)
+        {
+            return TLV_ERROR_NO_BUFFER_MEMORY;
+        }
+
+        // 新Tag需要在提交时占用索引槽位
+        const tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
+        if (!index)
+        {
+            if (tlv_core_ctx.header->tag_count + tlv_core_txn_ctx.new_tag_count >= TLV_MAX_TAG_COUNT)
+            {
+                return TLV_ERROR_NO_INDEX_SPACE;
+            }
+            is_new_tag = true;
+        }
+        else
+        {
+            uint16_t old_length;
+            uint32_t old_write_count;
+            if (tlv_core_get_block_info(index, &old_length, &old_write_count) == TLV_OK)
+            {
+                write_count = old_write_count + 1;
+            }
+        }
+    }
+
+    // 事务期间不会同步整理,压缩数据在写入前保持有效
+    const void *block_data;
+    uint8_t block_flags;
+    uint16_t block_len = write_encode(meta, data, len, &block_data, &block_flags);
+
+    uint32_t block_size = TLV_BLOCK_SIZE(block_len);
+    uint32_t addr = tlv_core_allocate_space_or_compact(block_size);
+    if (addr == 0)
+    {
+        return TLV_ERROR_NO_MEMORY_SPACE;
+    }
+
+    int ret = write_data_block(meta, block_data, block_len, addr, write_count, block_flags);
+    if (ret != TLV_OK)
+    {
+        // 写失败的块不会被引用
+        release_space(addr, block_size, false);
+        return ret;
+    }
+
+    if (pending)
+    {
+        // 覆盖同一事务内的前一次写入
+        release_space(pending->data_addr, pending->block_size, false);
+    }
+    else
+    {
+        pending = &tlv_core_txn_ctx.pending[tlv_core_txn_ctx.count++];
+        pending->tag = tag;
+        if (is_new_tag)
+        {
+            tlv_core_txn_ctx.new_tag_count++;
+        }
+    }
+
+    pending->version = meta->version;
+    pending->data_addr = addr;
+    pending->block_size = block_size;
+    pending->write_count = write_count;
+
+    return TLV_OK;
+}
+
+int tlv_txn_write(uint16_t tag, const void *data, uint16_t len)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_txn_write_unlocked(tag, data, len);
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+/**
+ * @brief 提交事务
+ *
+ * 提交顺序：日志记录与CRC -> 日志魔数（提交点） -> 索引条目 -> Header -> 清除日志。
+ * 日志落盘后掉电,下次tlv_init()时重放日志完成发布；日志落盘前掉电,事务整体不生效。
+ *
+ * @return 0: 成功（到达提交点,之后的落盘错误不再返回）, 其他: 错误码（事务未生效）
+ */
+static int tlv_txn_commit_unlocked(void)
+{
+    if (!tlv_core_txn_ctx.is_active)
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    tlv_core_txn_ctx.is_active = false;
+
+    if (tlv_core_txn_ctx.count == 0)
+    {
+        transaction_snapshot_commit();
+        return TLV_OK;
+    }
+
+    // 写入提交日志（提交点）
+    tlv_txn_log_t *log = (tlv_txn_log_t *)tlv_core_ctx.static_buffer;
+    memset(log, 0, sizeof(tlv_txn_log_t));
+    log->magic = TLV_TXN_LOG_MAGIC;
+    log->count = tlv_core_txn_ctx.count;
+    for (uint16_t i = 0; i < tlv_core_txn_ctx.count; i++)
+    {
+        log->records[i].tag = tlv_core_txn_ctx.pending[i].tag;
+        log->records[i].flags = TLV_FLAG_VALID;
+        log->records[i].version = tlv_core_txn_ctx.pending[i].version;
+        log->records[i].data_addr = tlv_core_txn_ctx.pending[i].data_addr;
+    }
+    log->crc16 = tlv_crc16(log, offsetof(tlv_txn_log_t, crc16));
+
+    // 先写记录与CRC,最后写魔数。清除日志只清魔数,整体写入只落下前缀时掉电,新魔数会与上一个
+    // 事务残留的记录和CRC拼成有效日志
+    const uint32_t body = offsetof(tlv_txn_log_t, count);
+    tlv_index_mark_backup_dirty(&tlv_core_ctx, TLV_TXN_LOG_ADDR, sizeof(tlv_txn_log_t));
+    int ret = tlv_core_ctx.ops->write(TLV_TXN_LOG_ADDR + body, (const uint8_t *)log + body,
+                                   sizeof(tlv_txn_log_t) - body);
+    if (ret == TLV_OK)
+    {
+        ret = tlv_core_ctx.ops->write(TLV_TXN_LOG_ADDR + offsetof(tlv_txn_log_t, magic),
+                                   &log->magic, sizeof(log->magic));
+    }
+    if (ret != TLV_OK)
+    {
+        // 提交点未到达,回滚
+        transaction_snapshot_rollback();
+        return ret;
+    }
+
+    transaction_snapshot_commit();
+
+    // 提交点之后事务已生效：落盘失败不再中止,RAM中的索引全部发布,事务日志保留,
+    // 由下次修改前（tlv_core_fast_boot_settle）或下次启动时的重放补齐
+    int publish_ret = TLV_OK;
+
+    // 发布索引
+    for (uint16_t i = 0; i < tlv_core_txn_ctx.count; i++)
+    {
+        const tlv_txn_pending_t *pending = &tlv_core_txn_ctx.pending[i];
+        tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, pending->tag);
+        ram_cache_invalidate(pending->tag);
+
+        uint32_t old_addr = 0;
+        uint32_t old_block_size = 0;
+        if (index)
+        {
+            // 旧块失效,索引条目提交后归还空闲空间
+            uint16_t old_length;
+            uint32_t old_write_count;
+            if (tlv_core_get_block_info(index, &old_length, &old_write_count) == TLV_OK)
+            {
+                old_addr = index->data_addr;
+                old_block_size = TLV_BLOCK_SIZE(old_length);
+            }
+
+            tlv_index_update(&tlv_core_ctx, pending->tag, pending->data_addr);
+        }
+        else
+        {
+            index = tlv_index_add(&tlv_core_ctx, pending->tag, pending->data_addr);
+            if (!index)
+            {
+                // 已在tlv_txn_write中检查过,日志仍有效,下次启动时重放
+                tlv_printf("CRITICAL: Txn index add failed unexpectedly!\n");
+                publish_ret = TLV_ERROR_NO_INDEX_SPACE;
+                continue;
+            }
+        }
+
+        uint16_t length = (uint16_t)(pending->block_size - TLV_BLOCK_SIZE(0));
+        tlv_core_block_info_set(index, length, pending->write_count);
+
+#if TLV_WRITE_BACK_MODE || TLV_JOURNAL_ENABLE
+        ret = tlv_core_index_commit_entry(index, length);
+        if (ret != TLV_OK && publish_ret == TLV_OK)
+        {
+            publish_ret = ret;
+        }
+#else
+        (void)length;
+#endif
+        // 旧块此后只被仍有效的事务日志之前的状态引用,计为已提交后释放（下次备份前不复用）
+        if (old_block_size != 0)
+        {
+            release_space(old_addr, old_block_size, true);
+        }
+    }
+
+#if !TLV_WRITE_BACK_MODE && !TLV_JOURNAL_ENABLE
+    ret = tlv_index_save(&tlv_core_ctx);
+    if (ret != TLV_OK && publish_ret == TLV_OK)
+    {
+        publish_ret = ret;
+    }
+#endif
+
+    // 更新统计并保存Header（提交日志模式下与单次写入一样由检查点保存）
+    tlv_core_ctx.header->total_writes += tlv_core_txn_ctx.count;
+    tlv_core_ctx.header->last_update_time = tlv_port_get_timestamp_s();
+
+#if TLV_JOURNAL_ENABLE
+    tlv_core_ctx.header_dirty = true;
+#else
+    ret = tlv_core_system_header_save();
+    if (ret != TLV_OK && publish_ret == TLV_OK)
+    {
+        publish_ret = ret;
+    }
+#endif
+
+    // 发布完成,清除日志
+    if (publish_ret == TLV_OK)
+    {
+        publish_ret = txn_log_clear();
+    }
+
+    if (publish_ret != TLV_OK)
+    {
+        tlv_printf("WARNING: Txn committed, publish incomplete (err: %d), kept in txn log\n", publish_ret);
+        g_txn_publish_pending = true;
+    }
+
+    // 按GC策略检查是否需要整理
+    tlv_core_gc_check();
+
+    return TLV_OK;
+}
+
+int tlv_txn_commit(void)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_txn_commit_unlocked();
+    tlv_core_gc_run_requested();
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+/**
+ * @brief 取消事务
+ *
+ * 提交前索引与Header均未落盘,回滚RAM中的空间分配即可回收已写入的数据块。
+ */
+static void tlv_txn_abort_unlocked(void)
+{
+    if (!tlv_core_txn_ctx.is_active)
+    {
+        return;
+    }
+
+    transaction_snapshot_rollback();
+    memset(&tlv_core_txn_ctx, 0, sizeof(tlv_core_txn_ctx));
+}
+
+void tlv_txn_abort(void)
+{
+    TLV_WRITE_LOCK();
+    tlv_txn_abort_unlocked();
+    TLV_WRITE_UNLOCK();
+}
+
+/* ============================ 查询与统计API实现 ============================ */
+/**
+ * @brief 获取统计信息
+ * @param stats 统计信息输出
+ * @return 0: 成功, 其他: 错误码
+ */
+static int tlv_get_statistics_unlocked(tlv_statistics_t *stats)
+{
+    if (!stats)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    memset(stats, 0, sizeof(tlv_statistics_t));
+
+    stats->total_tags = TLV_MAX_TAG_COUNT;
+    stats->valid_tags = tlv_core_ctx.header->tag_count;
+    stats->free_space = tlv_core_ctx.header->free_space;
+    stats->used_space = tlv_core_ctx.header->used_space;
+
+    // 计算脏数据Tag数
+    uint32_t dirty_count = 0;
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        if (tlv_core_ctx.index_table->entries[i].tag != 0 &&
+            (tlv_core_ctx.index_table->entries[i].flags & TLV_FLAG_DIRTY))
+        {
+            dirty_count++;
+        }
+    }
+    stats->dirty_tags = dirty_count;
+
+    // 热点分类：只读块信息缓存（未命中时读取块Header并回填）
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        const tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        uint16_t length;
+        uint32_t write_count;
+        if (entry->tag == 0 || !(entry->flags & TLV_FLAG_VALID) ||
+            tlv_core_get_block_info(entry, &length, &write_count) != TLV_OK)
+        {
+            continue;
+        }
+
+        if (write_count >= TLV_WEAR_RELOCATE_WRITES)
+        {
+            stats->hot_tags++;
+        }
+        if (write_count > stats->max_write_count)
+        {
+            stats->max_write_count = write_count;
+        }
+    }
+    stats->wear_relocations = g_wear_relocations;
+
+    // 计算碎片化程度
+    if (tlv_core_ctx.header->data_region_size > 0)
+    {
+        uint32_t wasted = (tlv_core_ctx.header->next_free_addr - TLV_DATA_ADDR) -
+                          tlv_core_ctx.header->used_space;
+        stats->fragmentation = (wasted * 100) / tlv_core_ctx.header->data_region_size;
+    }
+
+    // RAM缓存命中率
+    stats->cache_hits = g_ram_cache_hits;
+    stats->cache_misses = g_ram_cache_misses;
+    uint32_t lookups = g_ram_cache_hits + g_ram_cache_misses;
+    if (lookups > 0)
+    {
+        stats->cache_hit_rate = (uint32_t)(((uint64_t)g_ram_cache_hits * 100) / lookups);
+    }
+
+    return TLV_OK;
+}
+
+int tlv_get_statistics(tlv_statistics_t *stats)
+{
+    TLV_READ_LOCK();
+    int ret = tlv_get_statistics_unlocked(stats);
+    TLV_READ_UNLOCK();
+    return ret;
+}
+/**
+ * @brief 遍历所有Tag
+ * @param callback 回调函数
+ * @param user_data 用户数据
+ * @return 遍历的Tag数量
+ */
+int tlv_foreach(tlv_foreach_callback_t callback, void *user_data)
+{
+    if (!callback)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    int count = 0;
+
+    // 回调在锁外执行,回调中可以调用任意读写接口
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        TLV_READ_LOCK();
+        if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+        {
+            TLV_READ_UNLOCK();
+            return (count > 0) ? count : TLV_ERROR;
+        }
+
+        uint16_t tag = 0;
+        if (tlv_core_ctx.index_table->entries[i].tag != 0 &&
+            (tlv_core_ctx.index_table->entries[i].flags & TLV_FLAG_VALID))
+        {
+            tag = tlv_core_ctx.index_table->entries[i].tag;
+        }
+        TLV_READ_UNLOCK();
+
+        if (tag != 0)
+        {
+            callback(tag, user_data);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/* ============================ 维护管理API实现 ============================ */
+/**
+ * @brief 校验所有数据
+ * @param corrupted_count 输出损坏数量
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_verify_all(uint32_t *corrupted_count)
+{
+    if (!corrupted_count)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    *corrupted_count = 0;
+
+    TLV_PERF_BEGIN();
+    // 遍历索引表验证每个数据块,每块一个加锁段,段间写操作可以进行
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        TLV_READ_LOCK();
+        if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+        {
+            TLV_READ_UNLOCK();
+            TLV_PERF_END(TLV_PERF_OP_VERIFY, TLV_ERROR);
+            return TLV_ERROR;
+        }
+
+        const tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        if (entry->tag != 0 && (entry->flags & TLV_FLAG_VALID))
+        {
+            // 读取Header、检查Tag匹配并分批校验整块CRC
+            uint16_t length;
+            if (tlv_core_check_block(entry, true, &length) != TLV_OK)
+            {
+                (*corrupted_count)++;
+            }
+        }
+        TLV_READ_UNLOCK();
+    }
+
+    int ret = (*corrupted_count > 0) ? TLV_ERROR_CORRUPTED : TLV_OK;
+    TLV_PERF_END(TLV_PERF_OP_VERIFY, ret);
+    return ret;
+}
+
+/* ============================ 公开函数：环形日志 ============================ */
+/**
+ * @brief 追加日志记录：写入记录槽位后重写控制头（控制头是提交点）
+ */
+static int tlv_append_unlocked(uint16_t tag, const void *record, uint16_t len)
+{
+    if (!record || len == 0 || tag == 0)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    if (tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
+    if (!meta)
+    {
+        return TLV_ERROR_NOT_FOUND;
+    }
+
+    if (meta->log_record_size == 0 || len > meta->log_record_size)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 写入前确认索引可信
+    int ret = tlv_core_fast_boot_settle();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    tlv_log_ring_t ring;
+    ret = log_open(tag, true, &ring);
+    if (ret == TLV_ERROR_NOT_FOUND)
+    {
+        ret = log_create(meta);
+        if (ret == TLV_OK)
+        {
+            ret = log_open(tag, true, &ring);
+        }
+    }
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    if (len > ring.record_size)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    tlv_log_record_t head;
+    head.seq = ring.next_seq;
+    head.length = len;
+    uint16_t crc = tlv_crc16_update(tlv_crc16_init(), &head, offsetof(tlv_log_record_t, crc16));
+    head.crc16 = tlv_crc16_final(tlv_crc16_update(crc, record, len));
+
+    tlv_iovec_t iov[2] = {
+        {&head, sizeof(head)},
+        {(void *)record, len},
+    };
+
+    ret = block_writev(log_slot_addr(&ring, ring.next_seq), iov, 2);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    ring.next_seq++;
+    return log_ctrl_write(&ring);
+}
+
+int tlv_append(uint16_t tag, const void *record, uint16_t len)
+{
+    TLV_PERF_BEGIN();
+    TLV_WRITE_LOCK();
+    int ret = tlv_append_unlocked(tag, record, len);
+    tlv_core_gc_run_requested();
+    TLV_WRITE_UNLOCK();
+    TLV_PERF_END(TLV_PERF_OP_WRITE, ret);
+    return ret;
+}
+
+int tlv_log_read(uint16_t tag, uint32_t from_seq, void *buf, uint16_t *len, uint32_t *seq)
+{
+    if (!buf || !len || !seq || tag == 0)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    TLV_PERF_BEGIN();
+    TLV_READ_LOCK();
+    tlv_log_ring_t ring;
+    int ret = (tlv_core_ctx.state == TLV_STATE_INITIALIZED) ? log_open(tag, false, &ring) : TLV_ERROR;
+    if (ret == TLV_OK)
+    {
+        // 早于最旧记录的序号已被覆盖,从最旧记录开始
+        uint32_t first_seq = (ring.next_seq > ring.slot_count) ? ring.next_seq - ring.slot_count : 0;
+        if (from_seq < first_seq)
+        {
+            from_seq = first_seq;
+        }
+
+        ret = (from_seq < ring.next_seq) ? TLV_OK : TLV_ERROR_NOT_FOUND;
+    }
+
+    tlv_log_record_t head;
+    if (ret == TLV_OK)
+    {
+        *seq = from_seq;
+        ret = tlv_core_ctx.ops->read(log_slot_addr(&ring, from_seq), &head, sizeof(head));
+    }
+
+    if (ret == TLV_OK)
+    {
+        if (head.seq != from_seq || head.length > ring.record_size)
+        {
+            ret = TLV_ERROR_CRC_FAILED;
+        }
+        else if (head.length > *len)
+        {
+            ret = TLV_ERROR_NO_BUFFER_MEMORY;
+        }
+        else
+        {
+            ret = tlv_core_ctx.ops->read(log_slot_addr(&ring, from_seq) + sizeof(head), buf, head.length);
+        }
+    }
+
+    if (ret == TLV_OK)
+    {
+        uint16_t crc = tlv_crc16_update(tlv_crc16_init(), &head, offsetof(tlv_log_record_t, crc16));
+        if (tlv_crc16_final(tlv_crc16_update(crc, buf, head.length)) != head.crc16)
+        {
+            ret = TLV_ERROR_CRC_FAILED;
+        }
+        else
+        {
+            *len = head.length;
+        }
+    }
+    TLV_READ_UNLOCK();
+    TLV_PERF_END(TLV_PERF_OP_READ, ret);
+    return ret;
+}
+
+int tlv_log_info(uint16_t tag, uint32_t *first_seq, uint32_t *next_seq)
+{
+    if (!first_seq || !next_seq || tag == 0)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    TLV_READ_LOCK();
+    tlv_log_ring_t ring;
+    int ret = (tlv_core_ctx.state == TLV_STATE_INITIALIZED) ? log_open(tag, false, &ring) : TLV_ERROR;
+    if (ret == TLV_OK)
+    {
+        *next_seq = ring.next_seq;
+        *first_seq = (ring.next_seq > ring.slot_count) ? ring.next_seq - ring.slot_count : 0;
+    }
+    TLV_READ_UNLOCK();
+    return ret;
+}
+
+/* ============================ 公开函数：批量迁移 ============================ */
+/**
+ * @brief 增量批量迁移（单步）：读取旧数据、原地迁移后写入事务,本步结束时一次提交
+ * @param budget_bytes 本步最多迁移的数据字节数（至少迁移一个Tag）
+ * @return 1: 仍有工作, 0: 已完成, <0: 错误码
+ */
+static int tlv_migrate_step_unlocked(uint32_t budget_bytes)
+{
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    if (tlv_core_txn_ctx.is_active || tlv_core_has_active_write_stream() || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    tlv_migrate_progress_t *progress = &tlv_core_migrate_ctx.progress;
+    if (!progress->active)
+    {
+        // 开始新一轮
+        memset(progress, 0, sizeof(*progress));
+        uint16_t total = migrate_count_pending();
+        if (total == 0)
+        {
+            return 0;
+        }
+
+        progress->active = true;
+        progress->total = total;
+        tlv_core_migrate_ctx.next_tag = 0;
+    }
+
+    int ret = tlv_txn_begin_unlocked();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    uint32_t batch_first_tag = tlv_core_migrate_ctx.next_tag;
+    uint32_t migrated_bytes = 0;
+    uint16_t batch = 0;
+    bool compacted = false;
+    tlv_index_entry_t *entry;
+
+    while (tlv_core_txn_ctx.count < TLV_MAX_TXN_ENTRIES && (batch == 0 || migrated_bytes < budget_bytes) &&
+           (entry = migrate_next_entry(tlv_core_migrate_ctx.next_tag)) != NULL)
+    {
+        uint16_t tag = entry->tag;
+        const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
+
+        // 大Tag使用调用者提供的工作缓冲区
+        uint8_t *buf = tlv_core_ctx.static_buffer;
+        uint16_t buf_size = TLV_BUFFER_SIZE;
+        if (meta->max_length > TLV_BUFFER_SIZE)
+        {
+            buf = tlv_core_migrate_ctx.work_buf;
+            buf_size = tlv_core_migrate_ctx.work_size;
+        }
+
+        uint16_t len = buf_size;
+        uint16_t new_len = 0;
+        ret = (buf && meta->max_length <= buf_size) ? read_data_block(entry->data_addr, tag, buf, &len)
+                                                    : TLV_ERROR_NO_BUFFER_MEMORY;
+        if (ret == TLV_OK)
+        {
+            ret = tlv_migrate_tag(&tlv_core_ctx, tag, buf, len, &new_len, buf_size, entry->version);
+        }
+        if (ret == TLV_OK)
+        {
+            ret = tlv_txn_write_unlocked(tag, buf, new_len);
+            if (ret == TLV_ERROR_NO_MEMORY_SPACE && batch > 0)
+            {
+                // 先提交本批释放旧块,下一步再迁移该Tag
+                break;
+            }
+            if (ret == TLV_ERROR_NO_MEMORY_SPACE && !compacted)
+            {
+                // 本批为空：退出事务同步整理一次后重试
+                compacted = true;
+                tlv_txn_abort_unlocked();
+                do
+                {
+                    ret = tlv_core_defrag_step_unlocked(UINT32_MAX);
+                } while (ret > 0);
+                if (ret == TLV_OK)
+                {
+                    ret = tlv_txn_begin_unlocked();
+                }
+                if (ret != TLV_OK)
+                {
+                    return ret;
+                }
+                continue;
+            }
+        }
+
+        tlv_core_migrate_ctx.next_tag = (uint32_t)tag + 1;
+        if (ret != TLV_OK)
+        {
+            tlv_printf("WARNING: Tag 0x%04X migration skipped (err: %d)\n", tag, ret);
+            progress->failed++;
+            continue;
+        }
+
+        batch++;
+        migrated_bytes += new_len;
+    }
+
+    // 本批一次提交：一次日志写入、一次索引与Header保存
+    ret = tlv_txn_commit_unlocked();
+    if (ret != TLV_OK)
+    {
+        // 未发布的Tag由下一步重新迁移
+        tlv_core_migrate_ctx.next_tag = batch_first_tag;
+        return ret;
+    }
+    progress->migrated += batch;
+
+    if (migrate_next_entry(tlv_core_migrate_ctx.next_tag) == NULL)
+    {
+        progress->active = false;
+        tlv_core_gc_check();
+        return 0;
+    }
+
+    return 1;
+}
+
+int tlv_migrate_step(uint32_t budget_bytes)
+{
+    TLV_PERF_BEGIN();
+    TLV_WRITE_LOCK();
+    int ret = tlv_migrate_step_unlocked(budget_bytes);
+    TLV_WRITE_UNLOCK();
+    TLV_PERF_END(TLV_PERF_OP_MIGRATE, ret);
+    return ret;
+}
+
+int tlv_migrate_set_buffer(void *buf, uint16_t size)
+{
+    TLV_WRITE_LOCK();
+    tlv_core_migrate_ctx.work_buf = (uint8_t *)buf;
+    tlv_core_migrate_ctx.work_size = buf ? size : 0;
+    TLV_WRITE_UNLOCK();
+    return TLV_OK;
+}
+
+int tlv_get_migration_progress(tlv_migrate_progress_t *progress)
+{
+    if (!progress)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    TLV_READ_LOCK();
+    *progress = tlv_core_migrate_ctx.progress;
+    TLV_READ_UNLOCK();
+    return TLV_OK;
+}
+
+/* ============================ 公开函数：后台巡检 ============================ */
+/**
+ * @brief 增量后台巡检（单步）：从游标处按地址顺序成段读取并校验数据块
+ * @param budget_bytes 本步最多校验的块字节数（至少校验一个块）
+ * @return 1: 本轮仍有工作, 0: 本轮已完成, <0: 错误码
+ */
+static int tlv_scrub_step_unlocked(uint32_t budget_bytes)
+{
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    if (tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    tlv_scrub_result_t *result = &g_scrub_ctx.result;
+    if (!result->active)
+    {
+        // 开始新一轮
+        memset(result, 0, sizeof(*result));
+        result->active = true;
+        g_scrub_ctx.cursor = TLV_DATA_ADDR;
+    }
+
+    uint32_t spent = 0;
+    tlv_index_entry_t *entry;
+    while ((spent == 0 || spent < budget_bytes) && (entry = scrub_next_entry(g_scrub_ctx.cursor)) != NULL)
+    {
+        int ret = scrub_run(entry, budget_bytes, &spent);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+    }
+
+    if (scrub_next_entry(g_scrub_ctx.cursor) == NULL)
+    {
+        result->active = false;
+        return 0;
+    }
+
+    return 1;
+}
+
+int tlv_scrub_step(uint32_t budget_bytes)
+{
+    TLV_PERF_BEGIN();
+    TLV_WRITE_LOCK();
+    int ret = tlv_scrub_step_unlocked(budget_bytes);
+    TLV_WRITE_UNLOCK();
+    TLV_PERF_END(TLV_PERF_OP_VERIFY, ret);
+    return ret;
+}
+
+int tlv_get_scrub_result(tlv_scrub_result_t *result)
+{
+    if (!result)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    TLV_READ_LOCK();
+    *result = g_scrub_ctx.result;
+    TLV_READ_UNLOCK();
+    return TLV_OK;
+}
+
+/* ============================ 公开函数：对外备份接口（带状态检查）============================ */
+/**
+ * @brief 备份所有数据到备份区
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_backup_all(void)
+{
+    int ret = TLV_OK;
+    TLV_PERF_BEGIN();
+
+#if TLV_THREAD_SAFE
+    // 分段备份：在启用读写锁时逐页加锁复制,段间其他任务可以读写
+    ret = backup_sections();
+#endif
+
+    // 收尾段：落盘写回缓存并复制剩余脏页,结束时备份区与管理区一致
+    TLV_WRITE_LOCK();
+    if (ret == TLV_OK)
+    {
+        ret = backup_prepare();
+    }
+
+    if (ret == TLV_OK)
+    {
+        // 调用内部函数
+        ret = tlv_core_backup_all_internal();
+    }
+
+    if (ret == TLV_OK)
+    {
+        // 镜像区与管理区备份一起批量同步
+        ret = tlv_mirror_sync_unlocked();
+    }
+
+    if (ret == TLV_OK)
+    {
+        // 更新备份时间
+        tlv_core_ctx.header->last_update_time = tlv_port_get_timestamp_s();
+        tlv_core_system_header_save();
+    }
+    TLV_WRITE_UNLOCK();
+
+    TLV_PERF_END(TLV_PERF_OP_BACKUP, ret);
+    return ret;
+}
+
+/**
+ * @brief 同步Tag镜像区（按元数据表顺序逐个槽位比较块Header,不一致时复制）
+ * @return 0: 成功, 其他: 错误码
+ */
+static int tlv_mirror_sync_unlocked(void)
+{
+    if (!mirror_usable())
+    {
+        return TLV_OK;
+    }
+
+    uint32_t slot_addr = tlv_core_ctx.mirror_addr;
+    for (uint16_t i = 0; i < tlv_core_ctx.meta_table_size; i++)
+    {
+        const tlv_meta_const_t *meta = &tlv_core_ctx.meta_table[i];
+        if (!meta->backup_enable || meta->log_record_size != 0)
+        {
+            continue;
+        }
+
+        uint32_t slot_size = TLV_BLOCK_SIZE(meta->max_length);
+        if (slot_addr + slot_size > tlv_core_ctx.backup_addr)
+        {
+            break;
+        }
+
+        int ret = mirror_sync_tag(meta, slot_addr);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+        slot_addr += slot_size;
+    }
+
+    return TLV_OK;
+}
+
+int tlv_mirror_sync(void)
+{
+    TLV_WRITE_LOCK();
+    int ret = (tlv_core_ctx.state == TLV_STATE_INITIALIZED) ? tlv_mirror_sync_unlocked() : TLV_ERROR;
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+/**
+ * @brief 对外备份前的状态检查,并落盘写回缓存,保证备份中的索引与Header完整
+ * @return 0: 成功, 其他: 错误码
+ */
+static int backup_prepare(void)
+{
+    // 对外接口：严格的状态检查
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED &&
+        tlv_core_ctx.state != TLV_STATE_FORMATTED)
+    {
+        return TLV_ERROR;
+    }
+
+    // 备份前完成快速启动后的索引校验,避免把损坏的页写入备份区
+    int ret = fast_boot_verify(UINT32_MAX);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    return tlv_core_flush_unlocked();
+}
+
+#if TLV_THREAD_SAFE
+/**
+ * @brief 分段复制脏页（每页一个加锁段）
+ *
+ * 已复制的页在段间被修改时重新置脏,由下一轮或收尾段复制；
+ * 页CRC表无效时不分段,由收尾段整体完成首次备份。
+ * @return 0: 成功, 其他: 错误码
+ */
+static int backup_sections(void)
+{
+    TLV_WRITE_LOCK();
+    int ret = backup_prepare();
+    bool table_valid = (ret == TLV_OK) && backup_crc_table_valid();
+    TLV_WRITE_UNLOCK();
+
+    for (uint32_t pass = 0; table_valid && pass < TLV_BACKUP_SECTION_PASSES; pass++)
+    {
+        for (uint32_t page = 0; page < TLV_BACKUP_COVER_PAGES; page++)
+        {
+            TLV_WRITE_LOCK();
+            if (tlv_core_ctx.state != TLV_STATE_INITIALIZED &&
+                tlv_core_ctx.state != TLV_STATE_FORMATTED)
+            {
+                ret = TLV_ERROR;
+            }
+            else
+            {
+                ret = backup_page(page, true);
+            }
+            TLV_WRITE_UNLOCK();
+
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+        }
+    }
+
+    return ret;
+}
+#endif
+/**
+ * @brief 从备份区恢复数据
+ * @return 0: 成功, 其他: 错误码
+ */
+static int tlv_restore_from_backup_unlocked(void)
+{
+    if (!tlv_core_ctx.header || !tlv_core_ctx.index_table)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 事务、流与异步操作持有按当前索引分配或定位的数据块,恢复后会写入或读取失效的地址
+    if (tlv_core_txn_ctx.is_active || stream_any_active() || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    int ret;
+    tlv_system_header_t backup_header;
+    // 读取备份Header的两份副本,第1份暂存在static_buffer
+    tlv_system_header_t *other = (tlv_system_header_t *)tlv_core_ctx.static_buffer;
+    ret = tlv_core_ctx.ops->read(tlv_core_ctx.backup_addr, &backup_header,
+                             sizeof(backup_header));
+    if (ret == TLV_OK)
+    {
+        ret = tlv_core_ctx.ops->read(tlv_core_ctx.backup_addr + TLV_HEADER_COPY_ADDR(1) - TLV_HEADER_ADDR,
+                                 other, sizeof(tlv_system_header_t));
+    }
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 验证备份Header：与加载时一样取序号较新的有效副本（备份时第0份副本可能正处于撕裂的保存中）
+    bool valid = (system_header_verify(&backup_header) == TLV_OK);
+    if (system_header_verify(other) == TLV_OK &&
+        (!valid || (int32_t)(other->header_seq - backup_header.header_seq) > 0))
+    {
+        memcpy(&backup_header, other, sizeof(backup_header));
+        valid = true;
+    }
+    if (!valid)
+    {
+        tlv_printf("ERROR: Backup header invalid (magic 0x%08lX)\n",
+                   (unsigned long)backup_header.magic);
+        return TLV_ERROR_CORRUPTED;
+    }
+
+    // 验证数据合理性（备份必须与当前存储布局一致）
+    if ((backup_header.data_region_size != (tlv_core_ctx.mirror_addr - TLV_DATA_ADDR) &&
+         backup_header.data_region_size != (tlv_core_ctx.backup_addr - TLV_DATA_ADDR)) ||
+        memcmp(&backup_header.geometry, &tlv_core_ctx.header->geometry, sizeof(tlv_geometry_t)) != 0)
+    {
+        tlv_printf("ERROR: Backup header data size mismatch\n");
+        return TLV_ERROR_CORRUPTED;
+    }
+
+#if TLV_JOURNAL_ENABLE
+    // 运行中恢复时先做检查点,恢复中途掉电时未改写的页仍是已提交的最新内容
+    if (tlv_core_ctx.state == TLV_STATE_INITIALIZED)
+    {
+        ret = tlv_core_journal_checkpoint();
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+    }
+
+    // 备份在检查点之后生成,日志中的记录属于之后的检查点,不能重放到备份的索引上；
+    // 先于管理区改写作废,恢复中途掉电时下次启动不会把它们重放到已恢复的页上
+    ret = tlv_core_journal_reset();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+#endif
+
+    // 管理区逐页改写,中途掉电时新旧页混杂且可能各自通过索引页校验；先在Header中留下标记,
+    // 下次启动见到标记即重新恢复。Header副本不整页复制,全部页改写后以交替保存写入备份中的Header
+    const uint32_t header_end = TLV_HEADER_COPY_ADDR(TLV_HEADER_COPIES) - TLV_HEADER_ADDR;
+    tlv_core_ctx.header->clean_marker = TLV_RESTORE_PENDING_MAGIC;
+    ret = tlv_core_system_header_save();
+    tlv_core_ctx.header->clean_marker = 0;
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    tlv_backup_crc_table_t table;
+    ret = backup_crc_table_load(&table);
+    if (ret == TLV_OK)
+    {
+        // 逐页恢复：跳过撕裂页与内容一致的页
+        uint8_t *backup_page = tlv_core_ctx.static_buffer;
+        uint8_t *main_page = tlv_core_ctx.static_buffer + TLV_BACKUP_PAGE_SIZE;
+        tlv_core_ctx.backup_dirty = 0;
+
+        for (uint32_t page = 0; page < TLV_BACKUP_COVER_PAGES; page++)
+        {
+            uint32_t offset = page * TLV_BACKUP_PAGE_SIZE;
+            uint32_t skip = (offset < header_end) ? header_end - offset : 0;
+            if (skip >= TLV_BACKUP_PAGE_SIZE)
+            {
+                continue;
+            }
+
+            ret = tlv_core_ctx.ops->read(tlv_core_ctx.backup_addr + offset, backup_page, TLV_BACKUP_PAGE_SIZE);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+
+            if (tlv_crc16(backup_page, TLV_BACKUP_PAGE_SIZE) != table.page_crc16[page])
+            {
+                // 备份时掉电,保留管理区中的该页,由索引页CRC校验决定能否加载
+                tlv_printf("WARNING: Backup page %lu torn, skipped\n", (unsigned long)page);
+                tlv_core_ctx.backup_dirty |= (1UL << page);
+                continue;
+            }
+
+            ret = tlv_core_ctx.ops->read(TLV_HEADER_ADDR + offset, main_page, TLV_BACKUP_PAGE_SIZE);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+
+            if (memcmp(backup_page + skip, main_page + skip, TLV_BACKUP_PAGE_SIZE - skip) == 0)
+            {
+                continue;
+            }
+
+            ret = tlv_core_ctx.ops->write(TLV_HEADER_ADDR + offset + skip, backup_page + skip,
+                                      TLV_BACKUP_PAGE_SIZE - skip);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+        }
+    }
+    else if (ret == TLV_ERROR_CORRUPTED)
+    {
+        // 旧格式整区备份,分批恢复
+        uint32_t backup_size = TLV_DATA_REGION_SIZE;
+        uint32_t offset = header_end;
+        while (offset < backup_size)
+        {
+            uint32_t chunk_size = (backup_size - offset > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : (backup_size - offset);
+
+            // 读取备份区
+            ret = tlv_core_ctx.ops->read(tlv_core_ctx.backup_addr + offset,
+                                     tlv_core_ctx.static_buffer, chunk_size);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+
+            // 写入管理区
+            ret = tlv_core_ctx.ops->write(TLV_HEADER_ADDR + offset,
+                                      tlv_core_ctx.static_buffer, chunk_size);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+
+            offset += chunk_size;
+        }
+
+        // 下次备份时转换为分页格式
+        tlv_core_ctx.backup_dirty = TLV_BACKUP_DIRTY_ALL;
+    }
+    else
+    {
+        return ret;
+    }
+
+    // 重新加载
+    tlv_core_block_info_invalidate_all();
+    ram_cache_reset();
+    memset(&tlv_core_defrag_ctx, 0, sizeof(tlv_core_defrag_ctx));
+
+    // 写入备份中的Header：序号接续带恢复标记的副本,保存后取代它（备份中的正常关机标记随之清除）
+    backup_header.header_seq = tlv_core_ctx.header->header_seq;
+    backup_header.clean_marker = 0;
+    memcpy(tlv_core_ctx.header, &backup_header, sizeof(tlv_system_header_t));
+    ret = tlv_core_system_header_save();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+    tlv_core_ctx.index_unverified = 0;
+
+    ret = tlv_index_load(&tlv_core_ctx);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 备份中Header的空间字段与Tag计数可能落后于其中的索引（Header晚于索引落盘）,
+    // 与非正常关机后启动一样以索引为准修正,避免新分配覆盖已恢复的数据块
+    ret = tlv_core_space_stats_rebuild(tlv_core_ctx.header->next_free_addr);
+    if (ret == TLV_OK)
+    {
+        tlv_core_ctx.header_dirty = true;
+        ret = system_header_reconcile();
+    }
+    if (ret == TLV_OK && tlv_core_ctx.header_dirty)
+    {
+        ret = tlv_core_system_header_save();
+    }
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    tlv_core_free_list_rebuild(false);
+    return TLV_OK;
+}
+
+int tlv_restore_from_backup(void)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_restore_from_backup_unlocked();
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+/* ============================ 公开函数：数据镜像 ============================ */
+/**
+ * @brief 导出数据镜像
+ * @note 第一遍校验全部数据块并统计镜像大小,第二遍经静态缓冲区分批输出；
+ *       任一数据块CRC校验失败时中止导出,不生成含损坏数据的镜像
+ */
+static int tlv_export_image_unlocked(tlv_image_write_t write, void *user_data)
+{
+    if (!write)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    // 事务与异步写入的数据块尚未进入索引,导出后内容会与索引不一致
+    if (tlv_core_txn_ctx.is_active || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    // 第一遍：校验数据块,统计数量与总大小
+    tlv_image_header_t image;
+    memset(&image, 0, sizeof(image));
+    image.magic = TLV_IMAGE_MAGIC;
+    image.version = TLV_IMAGE_VERSION;
+
+    int ret;
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        if (entry->tag == 0 || !(entry->flags & TLV_FLAG_VALID))
+        {
+            continue;
+        }
+
+        uint16_t length;
+        ret = tlv_core_check_block(entry, true, &length);
+        if (ret != TLV_OK)
+        {
+            tlv_printf("ERROR: Tag 0x%04X corrupted, image export aborted\n", entry->tag);
+            return TLV_SET_ERROR(ret, entry->tag);
+        }
+
+        image.tag_count++;
+        image.data_size += TLV_BLOCK_SIZE(length);
+    }
+    image.header_crc16 = tlv_crc16(&image, offsetof(tlv_image_header_t, header_crc16));
+
+    if (write(&image, sizeof(image), user_data) != 0)
+    {
+        return TLV_ERROR;
+    }
+
+    // 第二遍：按相同顺序输出数据块（长度已由块信息缓存或重新读取Header得到）
+    uint8_t *buffer = tlv_core_ctx.static_buffer;
+    uint16_t crc = tlv_crc16_init();
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        if (entry->tag == 0 || !(entry->flags & TLV_FLAG_VALID))
+        {
+            continue;
+        }
+
+        uint16_t length;
+        uint32_t write_count;
+        ret = tlv_core_get_block_info(entry, &length, &write_count);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        uint32_t addr = entry->data_addr;
+        uint32_t remain = TLV_BLOCK_SIZE(length);
+        while (remain > 0)
+        {
+            uint16_t chunk_size = (remain > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : (uint16_t)remain;
+            ret = tlv_core_ctx.ops->read(addr, buffer, chunk_size);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+
+            crc = tlv_crc16_update(crc, buffer, chunk_size);
+            if (write(buffer, chunk_size, user_data) != 0)
+            {
+                return TLV_ERROR;
+            }
+
+            addr += chunk_size;
+            remain -= chunk_size;
+        }
+    }
+
+    crc = tlv_crc16_final(crc);
+    return (write(&crc, sizeof(crc), user_data) != 0) ? TLV_ERROR : TLV_OK;
+}
+
+int tlv_export_image(tlv_image_write_t write, void *user_data)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_export_image_unlocked(write, user_data);
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+/**
+ * @brief 导入数据镜像
+ * @note 先作废FRAM中的Header,再把数据块按镜像顺序大块顺序写入数据区并随流重建索引,
+ *       校验通过后一次性提交索引表与Header。提交前任何失败（输入中止、CRC不符、块不合法）
+ *       都格式化为空的一致状态
+ */
+static int tlv_import_image_unlocked(tlv_image_read_t read, void *user_data)
+{
+    if (!read)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    // 事务、流与异步操作持有的索引条目会随清空失效
+    if (tlv_core_txn_ctx.is_active || stream_any_active() || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    // 读取并校验镜像Header（此时尚未改动FRAM）
+    tlv_image_header_t image;
+    if (read(&image, sizeof(image), user_data) != 0)
+    {
+        return TLV_ERROR;
+    }
+
+    if (image.magic != TLV_IMAGE_MAGIC || image.version != TLV_IMAGE_VERSION ||
+        image.header_crc16 != tlv_crc16(&image, offsetof(tlv_image_header_t, header_crc16)))
+    {
+        return TLV_ERROR_CORRUPTED;
+    }
+
+    if (image.tag_count > TLV_MAX_TAG_COUNT)
+    {
+        return TLV_ERROR_NO_INDEX_SPACE;
+    }
+
+    if (image.data_size > tlv_core_ctx.mirror_addr - TLV_DATA_ADDR)
+    {
+        return TLV_ERROR_NO_MEMORY_SPACE;
+    }
+
+#if TLV_JOURNAL_ENABLE
+    // 导入直接重写索引页：先做检查点使FRAM中的索引与RAM一致,日志中的旧记录不会重放到导入结果上
+    int ret = tlv_core_journal_checkpoint();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+#else
+    int ret;
+#endif
+
+    // 未启用提交日志时索引条目总是直写FRAM；记录原索引占用的页数,提交时只重写这些页与新索引的页
+    uint32_t index_pages = 0;
+    for (uint32_t i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        if (tlv_core_ctx.index_table->entries[i].tag != 0)
+        {
+            index_pages = i / TLV_INDEX_ENTRIES_PER_PAGE + 1;
+        }
+    }
+
+    // 先作废FRAM中的Header：数据区随后被覆盖,导入完成前掉电时上电看到的是首次启动
+    uint32_t magic = tlv_core_ctx.header->magic;
+    tlv_geometry_t geometry = tlv_core_ctx.header->geometry;
+    ret = system_header_invalidate();
+    if (ret != TLV_OK)
+    {
+        tlv_core_ctx.state = TLV_STATE_ERROR;
+        return ret;
+    }
+
+    runtime_state_reset();
+    tlv_core_system_header_init(&geometry);
+    tlv_core_ctx.header->magic = magic;
+    tlv_index_init(&tlv_core_ctx);
+    tlv_core_ctx.index_unverified = 0;
+
+    // 数据块依次写到数据区起始处,同时解析块Header重建索引（块Header可能跨越分批边界）
+    uint8_t *buffer = tlv_core_ctx.static_buffer;
+    uint16_t crc = tlv_crc16_init();
+    uint32_t end = TLV_DATA_ADDR + image.data_size;
+    uint32_t addr = TLV_DATA_ADDR;
+    uint32_t block_addr = TLV_DATA_ADDR;
+    tlv_data_block_header_t header;
+    uint32_t header_got = 0;
+    while (addr < end)
+    {
+        uint16_t chunk_size = (end - addr > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : (uint16_t)(end - addr);
+        if (read(buffer, chunk_size, user_data) != 0)
+        {
+            ret = TLV_ERROR;
+            goto discard;
+        }
+
+        crc = tlv_crc16_update(crc, buffer, chunk_size);
+        ret = tlv_core_ctx.ops->write(addr, buffer, chunk_size);
+        if (ret != TLV_OK)
+        {
+            goto discard;
+        }
+
+        // 本批内的块Header字节
+        while (block_addr + header_got < addr + chunk_size)
+        {
+            uint32_t from = block_addr + header_got;
+            uint32_t take = sizeof(header) - header_got;
+            if (take > addr + chunk_size - from)
+            {
+                take = addr + chunk_size - from;
+            }
+            memcpy((uint8_t *)&header + header_got, buffer + (from - addr), take);
+            header_got += take;
+            if (header_got < sizeof(header))
+            {
+                break;
+            }
+
+            ret = image_block_add(&header, block_addr, end);
+            if (ret != TLV_OK)
+            {
+                goto discard;
+            }
+            block_addr += TLV_BLOCK_SIZE(header.length);
+            header_got = 0;
+        }
+
+        addr += chunk_size;
+    }
+
+    uint16_t stored_crc;
+    if (read(&stored_crc, sizeof(stored_crc), user_data) != 0)
+    {
+        ret = TLV_ERROR;
+        goto discard;
+    }
+
+    if (tlv_crc16_final(crc) != stored_crc)
+    {
+        ret = TLV_ERROR_CRC_FAILED;
+        goto discard;
+    }
+
+    // 最后一个块须恰好结束于数据末尾,块数与Header一致
+    if (block_addr != end || header_got != 0 || tlv_core_ctx.header->tag_count != image.tag_count)
+    {
+        ret = TLV_ERROR_CORRUPTED;
+        goto discard;
+    }
+
+    tlv_core_ctx.header->next_free_addr = end;
+    tlv_core_ctx.header->used_space = image.data_size;
+    tlv_core_ctx.header->free_space = tlv_core_ctx.header->data_region_size - image.data_size;
+
+    // 一次性提交：索引表与事务日志先落盘,Header最后写入使存储重新生效
+    uint32_t image_pages = (image.tag_count + TLV_INDEX_ENTRIES_PER_PAGE - 1) / TLV_INDEX_ENTRIES_PER_PAGE;
+    ret = tlv_index_save_pages(&tlv_core_ctx, (image_pages > index_pages) ? image_pages : index_pages);
+    if (ret == TLV_OK)
+    {
+        ret = txn_log_clear();
+    }
+    if (ret == TLV_OK)
+    {
+        ret = tlv_core_system_header_save();
+    }
+    if (ret != TLV_OK)
+    {
+        tlv_core_ctx.state = TLV_STATE_ERROR;
+        return ret;
+    }
+
+    // 镜像槽位中的旧块可能与导入块的长度与写入计数相同,须立即同步；备份区与普通写入一样由tlv_backup_all()更新
+    ret = tlv_mirror_sync_unlocked();
+
+    tlv_printf("Image imported: %u tags, %lu bytes\n", image.tag_count, (unsigned long)image.data_size);
+    return ret;
+
+discard:
+    // 原数据已被部分覆盖,格式化为空的一致状态
+    {
+        int format_ret = tlv_format_unlocked(magic, &geometry);
+        if (format_ret == TLV_OK)
+        {
+            tlv_core_ctx.state = TLV_STATE_INITIALIZED;
+        }
+    }
+    return ret;
+}
+
+int tlv_import_image(tlv_image_read_t read, void *user_data)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_import_image_unlocked(read, user_data);
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+/* ============================ 空间管理API实现 ============================ */
+/**
+ * @brief 获取可用空间
+ * @param free_space 输出可用空间
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_get_free_space(uint32_t *free_space)
+{
+    if (!free_space)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    *free_space = tlv_core_ctx.header->free_space;
+    return TLV_OK;
+}
+/**
+ * @brief 获取已用空间
+ * @param used_space 输出已用空间
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_get_used_space(uint32_t *used_space)
+{
+    if (!used_space)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    *used_space = tlv_core_ctx.header->used_space;
+    return TLV_OK;
+}
+/**
+ * @brief 计算碎片化程度
+ * @param fragmentation_percent 输出碎片化百分比
+ * @return 0: 成功, 其他: 错误码
+ */
+static int tlv_calculate_fragmentation_unlocked(uint32_t *fragmentation_percent)
+{
+    if (!fragmentation_percent)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    uint32_t allocated = tlv_core_ctx.header->next_free_addr - TLV_DATA_ADDR;
+    uint32_t used = tlv_core_ctx.header->used_space;
+    uint32_t wasted = allocated - used;
+
+    if (tlv_core_ctx.header->data_region_size > 0)
+    {
+        *fragmentation_percent = (wasted * 100) / tlv_core_ctx.header->data_region_size;
+    }
+    else
+    {
+        *fragmentation_percent = 0;
+    }
+
+    return TLV_OK;
+}
+
+int tlv_calculate_fragmentation(uint32_t *fragmentation_percent)
+{
+    TLV_READ_LOCK();
+    int ret = tlv_calculate_fragmentation_unlocked(fragmentation_percent);
+    TLV_READ_UNLOCK();
+    return ret;
+}
+
+/* ============================ 私有函数实现 ============================ */
+/**
+ * @brief 校验存储布局并确定备份区与镜像区地址
+ * @param geometry 存储布局（全0表示旧版本格式化,按默认布局）
+ * @return 0: 成功, TLV_ERROR_INVALID_PARAM: 布局不合法或超出本构建支持的容量
+ */
+static int layout_apply(const tlv_geometry_t *geometry)
+{
+    uint32_t fram_size = geometry->fram_size;
+    uint32_t mirror_size = geometry->mirror_size;
+    if (fram_size == 0 && mirror_size == 0)
+    {
+        fram_size = TLV_FRAM_SIZE;
+        mirror_size = TLV_MIRROR_SIZE;
+    }
+
+    if (fram_size < TLV_FRAM_MIN_SIZE || fram_size > TLV_FRAM_MAX_SIZE)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 镜像区最多占数据区一半
+    uint32_t backup_addr = fram_size - TLV_DATA_REGION_SIZE;
+    if (mirror_size > (backup_addr - TLV_DATA_ADDR) / 2)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+#if TLV_PORT_DUAL_FRAM
+    // 备份区须位于片1
+    if (backup_addr < TLV_FRAM_CHIP0_SIZE)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+#endif
+
+    tlv_core_ctx.backup_addr = backup_addr;
+    tlv_core_ctx.mirror_addr = backup_addr - mirror_size;
+    return TLV_OK;
+}
+
+/**
+ * @brief 清空依赖数据区内容的运行时状态（缓存、空闲区段表、事务与各增量任务进度）
+ */
+static void runtime_state_reset(void)
+{
+    tlv_core_block_info_invalidate_all();
+    tlv_core_free_list_reset(true);
+    ram_cache_reset();
+    memset(&tlv_core_txn_ctx, 0, sizeof(tlv_core_txn_ctx));
+    g_txn_publish_pending = false;
+    memset(&tlv_core_defrag_ctx, 0, sizeof(tlv_core_defrag_ctx));
+    memset(&tlv_core_migrate_ctx.progress, 0, sizeof(tlv_core_migrate_ctx.progress));
+    memset(&g_scrub_ctx, 0, sizeof(g_scrub_ctx));
+    tlv_core_async_reset();
+}
+
+int tlv_core_system_header_init(const tlv_geometry_t *geometry)
+{
+    if (!tlv_core_ctx.header)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    memset(tlv_core_ctx.header, 0, sizeof(tlv_system_header_t));
+
+    tlv_core_ctx.header->magic = TLV_SYSTEM_MAGIC;
+    tlv_core_ctx.header->version = TLV_SYSTEM_VERSION;
+    tlv_core_ctx.header->tag_count = 0;
+    tlv_core_ctx.header->data_region_start = TLV_DATA_ADDR;
+    tlv_core_ctx.header->data_region_size = tlv_core_ctx.mirror_addr - TLV_DATA_ADDR;
+    tlv_core_ctx.header->next_free_addr = TLV_DATA_ADDR;
+    tlv_core_ctx.header->total_writes = 0;
+    tlv_core_ctx.header->last_update_time = tlv_port_get_timestamp_s();
+    tlv_core_ctx.header->free_space = tlv_core_ctx.header->data_region_size;
+    tlv_core_ctx.header->used_space = 0;
+    tlv_core_ctx.header->fragment_count = 0;
+    tlv_core_ctx.header->geometry = *geometry;
+
+    // 计算Header CRC16
+    tlv_core_ctx.header->header_crc16 = tlv_crc16(tlv_core_ctx.header,
+                                               sizeof(tlv_system_header_t) - sizeof(uint16_t));
+
+    return TLV_OK;
+}
+
+/**
+ * @brief 加载系统Header：读取两份副本,取保存序号较新的有效副本
+ *
+ * 旧版本格式化的存储区只有第0份副本有效,按其加载。
+ * @return 0: 成功, 其他: 错误码（两份副本均无效时为第0份的校验结果）
+ */
+static int system_header_load(void)
+{
+    if (!tlv_core_ctx.header)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 从FRAM读取两份Header,第1份暂存在static_buffer
+    tlv_system_header_t *other = (tlv_system_header_t *)tlv_core_ctx.static_buffer;
+    int ret = tlv_core_ctx.ops->read(TLV_HEADER_COPY_ADDR(0), tlv_core_ctx.header,
+                                 sizeof(tlv_system_header_t));
+    if (ret == TLV_OK)
+    {
+        ret = tlv_core_ctx.ops->read(TLV_HEADER_COPY_ADDR(1), other, sizeof(tlv_system_header_t));
+    }
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 校验Header,两份均有效时按序号（允许回绕）取较新的一份
+    ret = system_header_verify(tlv_core_ctx.header);
+    bool use_other = (system_header_verify(other) == TLV_OK) &&
+                     (ret != TLV_OK || (int32_t)(other->header_seq - tlv_core_ctx.header->header_seq) > 0);
+    if (use_other)
+    {
+        memcpy(tlv_core_ctx.header, other, sizeof(tlv_system_header_t));
+        ret = TLV_OK;
+    }
+
+    tlv_core_ctx.header_copy = use_other ? 1 : 0;
+    return ret;
+}
+
+/**
+ * @brief 保存系统Header：序号加1后写入较旧的一份副本
+ *
+ * 写入中途掉电时最新的副本不受影响,启动时仍按其加载。
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_core_system_header_save(void)
+{
+    if (!tlv_core_ctx.header)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 重新计算CRC
+    uint8_t copy = tlv_core_ctx.header_copy ^ 1;
+    tlv_core_ctx.header->header_seq++;
+    tlv_core_ctx.header->header_crc16 = tlv_crc16(tlv_core_ctx.header,
+                                               sizeof(tlv_system_header_t) - sizeof(uint16_t));
+
+    // 写入FRAM
+    tlv_index_mark_backup_dirty(&tlv_core_ctx, TLV_HEADER_COPY_ADDR(copy), sizeof(tlv_system_header_t));
+    int ret = tlv_core_ctx.ops->write(TLV_HEADER_COPY_ADDR(copy), tlv_core_ctx.header,
+                                  sizeof(tlv_system_header_t));
+    if (ret == TLV_OK)
+    {
+        tlv_core_ctx.header_copy = copy;
+        tlv_core_ctx.header_dirty = false;
+        tlv_core_ctx.clean_marked = false;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 作废FRAM中的两份Header（只改写魔数）,之后上电为首次启动
+ * @return 0: 成功, 其他: 错误码
+ */
+static int system_header_invalidate(void)
+{
+    uint32_t invalid_magic = 0;
+    int ret = TLV_OK;
+    for (uint32_t copy = 0; copy < TLV_HEADER_COPIES && ret == TLV_OK; copy++)
+    {
+        uint32_t addr = TLV_HEADER_COPY_ADDR(copy) + offsetof(tlv_system_header_t, magic);
+        tlv_index_mark_backup_dirty(&tlv_core_ctx, addr, sizeof(invalid_magic));
+        ret = tlv_core_ctx.ops->write(addr, &invalid_magic, sizeof(invalid_magic));
+    }
+
+    return ret;
+}
+
+static int system_header_verify(const tlv_system_header_t *header)
+{
+    // 检查魔数
+    if (header->magic != TLV_SYSTEM_MAGIC)
+    {
+        return TLV_ERROR_CORRUPTED;
+    }
+
+    // 检查版本兼容性,主版本必须相同,当前子版本大于文件系统版本
+    if (!tlv_version_compatible(TLV_SYSTEM_VERSION, header->version))
+    {
+        return TLV_ERROR_VERSION;
+    }
+
+    // 校验CRC16
+    uint16_t calc_crc = tlv_crc16(header, sizeof(tlv_system_header_t) - sizeof(uint16_t));
+
+    if (calc_crc != header->header_crc16)
+    {
+        return TLV_ERROR_CRC_FAILED;
+    }
+
+    return TLV_OK;
+}
+
+uint32_t tlv_core_allocate_space(uint32_t size)
+{
+    if (!tlv_core_ctx.header)
+    {
+        return 0;
+    }
+
+    // 优先复用空洞（最佳适配）
+    if (free_list_usable())
+    {
+        uint32_t hole = free_list_alloc(size);
+        if (hole != 0)
+        {
+            tlv_core_ctx.header->used_space += size;
+            free_list_sync_stats();
+            return hole;
+        }
+    }
+
+    return allocate_space_tail(size);
+}
+
+/**
+ * @brief 从尾部未分配区域分配空间（不复用空洞）
+ * @return 分配的地址, 0表示尾部空间不足
+ */
+static uint32_t allocate_space_tail(uint32_t size)
+{
+    uint32_t addr = tlv_core_ctx.header->next_free_addr;
+    uint32_t end_addr = TLV_DATA_ADDR + tlv_core_ctx.header->data_region_size;
+
+    if (addr + size > end_addr)
+    {
+        return 0;
+    }
+
+    tlv_core_ctx.header->next_free_addr += size;
+    tlv_core_ctx.header->used_space += size;
+    tlv_core_ctx.header->free_space -= size;
+
+    return addr;
+}
+
+/**
+ * @brief 判断本次写入是否应为磨损均衡换址（仅用缓存中的write_count,无FRAM访问）
+ * @param write_count 本次写入后的累计写入次数
+ */
+static bool wear_relocate_due(uint32_t write_count)
+{
+#if TLV_WEAR_LEVELING
+    return (write_count & (TLV_WEAR_RELOCATE_WRITES - 1)) == 0;
+#else
+    (void)write_count;
+    return false;
+#endif
+}
+
+/**
+ * @brief 为磨损均衡换址分配空间
+ * @return 分配的地址, 0表示无可用空间（调用者退回原地更新,不触发同步整理）
+ * @note 优先使用尾部空间,使热点块沿数据区推进,而不是在刚释放的两个空洞之间往返
+ */
+static uint32_t allocate_space_wear(uint32_t size)
+{
+    uint32_t addr = allocate_space_tail(size);
+    if (addr == 0)
+    {
+        addr = tlv_core_allocate_space(size);
+    }
+
+    if (addr != 0)
+    {
+        g_wear_relocations++;
+    }
+
+    return addr;
+}
+
+/**
+ * @brief 写入数据块：Header + Data + CRC16 合并为一次传输
+ * @param write_count 新块的写入次数（由调用者根据旧块信息计算,不再回读旧Header）
+ * @param flags 数据块标志（TLV_BLOCK_FLAG_*）
+ * @note data允许位于static_buffer中（迁移或压缩场景）,合并时按从后向前的顺序搬移
+ */
+static int write_data_block(const tlv_meta_const_t *meta, const void *data, uint16_t len, uint32_t addr,
+                            uint32_t write_count, uint8_t flags)
+{
+    tlv_data_block_header_t header;
+    uint16_t crc = tlv_core_block_header_build(meta, data, len, write_count, flags, &header);
+
+    // 写入FRAM：Header -> Data -> CRC16
+    tlv_iovec_t iov[3] = {
+        {&header, sizeof(header)},
+        {(void *)data, len},
+        {&crc, sizeof(crc)},
+    };
+
+    return block_writev(addr, iov, 3);
+}
+
+/**
+ * @brief 构建数据块Header并计算整块CRC16（Header + Data）
+ * @return CRC16
+ */
+uint16_t tlv_core_block_header_build(const tlv_meta_const_t *meta, const void *data, uint16_t len,
+                                   uint32_t write_count, uint8_t flags, tlv_data_block_header_t *header)
+{
+    memset(header, 0, sizeof(*header));
+    header->tag = meta->tag;
+    header->length = len;
+    header->version = meta->version;
+    header->flags = flags;
+    header->timestamp = tlv_port_get_timestamp_s();
+    header->write_count = write_count;
+
+    uint16_t crc = tlv_crc16_init();
+    crc = tlv_crc16_update(crc, header, sizeof(*header));
+    crc = tlv_crc16_update(crc, data, len);
+    return tlv_crc16_final(crc);
+}
+
+/**
+ * @brief 读取数据块并校验CRC
+ * @param addr 数据块地址
+ * @param tag 索引中的Tag（块Header中的Tag不符时返回TLV_ERROR_CORRUPTED,例如恢复的索引指向已被复用的空间）
+ * @param expect_len 预期数据长度（来自缓存,0表示未知）
+ * @param buf 输出缓冲区
+ * @param len 缓冲区大小（输入）,数据长度（输出）
+ * @param out_header 输出数据块Header
+ * @return 0: 成功, 其他: 错误码
+ * @note 长度已知时 Header + Data + CRC16 一次读出；未知时先读Header,再一次读出 Data + CRC16
+ */
+static int read_block(uint32_t addr, uint16_t tag, uint16_t expect_len, void *buf, uint16_t *len,
+                      tlv_data_block_header_t *out_header)
+{
+    tlv_data_block_header_t header;
+    uint16_t stored_crc;
+    int ret;
+
+    if (expect_len != 0 && expect_len <= *len)
+    {
+        tlv_iovec_t iov[3] = {
+            {&header, sizeof(header)},
+            {buf, expect_len},
+            {&stored_crc, sizeof(stored_crc)},
+        };
+
+        ret = block_readv(addr, iov, 3);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        if (header.tag != tag)
+        {
+            if (out_header)
+            {
+                *out_header = header;
+            }
+            return TLV_ERROR_CORRUPTED;
+        }
+
+        // 缓存长度与实际不符或数据已压缩时按未知长度重读
+        if (header.length != expect_len || (header.flags & TLV_BLOCK_FLAG_COMPRESSED))
+        {
+            expect_len = 0;
+        }
+    }
+    else
+    {
+        expect_len = 0;
+    }
+
+    if (expect_len == 0)
+    {
+        // 读取Header
+        ret = tlv_core_ctx.ops->read(addr, &header, sizeof(header));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        if (header.tag != tag)
+        {
+            if (out_header)
+            {
+                *out_header = header;
+            }
+            return TLV_ERROR_CORRUPTED;
+        }
+
+        // 压缩数据边读边解压
+        if (header.flags & TLV_BLOCK_FLAG_COMPRESSED)
+        {
+            if (out_header)
+            {
+                *out_header = header;
+            }
+            return read_block_decode(addr, &header, buf, len);
+        }
+
+        // 检查长度
+        if (header.length > *len)
+        {
+            return TLV_ERROR_NO_BUFFER_MEMORY;
+        }
+
+        // 读取数据与CRC16
+        tlv_iovec_t iov[2] = {
+            {buf, header.length},
+            {&stored_crc, sizeof(stored_crc)},
+        };
+
+        ret = block_readv(addr + sizeof(header), iov, 2);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+    }
+
+    // CRC失败时也输出Header,供调用者判断镜像副本是否属于同一次写入
+    if (out_header)
+    {
+        *out_header = header;
+    }
+
+    // 校验CRC16
+    uint16_t calc_crc = tlv_crc16_init();
+    calc_crc = tlv_crc16_update(calc_crc, &header, sizeof(header));
+    calc_crc = tlv_crc16_update(calc_crc, buf, tlv_core_block_crc_length(&header));
+    calc_crc = tlv_crc16_final(calc_crc);
+
+    if (calc_crc != stored_crc)
+    {
+        return TLV_ERROR_CRC_FAILED;
+    }
+
+    *len = header.length;
+    return TLV_OK;
+}
+
+/**
+ * @brief 分段读取压缩数据块,边校验CRC边解压到输出缓冲区
+ * @param header 已读出的数据块Header
+ * @param len 缓冲区大小（输入）,原始数据长度（输出）
+ * @return 0: 成功, 其他: 错误码（CRC错误优先于解压错误）
+ * @note 输出缓冲区允许位于static_buffer中（迁移场景）,此时经栈上临时缓冲区读取
+ */
+static int read_block_decode(uint32_t addr, const tlv_data_block_header_t *header, void *buf, uint16_t *len)
+{
+    uint8_t stack_chunk[TLV_READ_SCRATCH_SIZE];
+    uint8_t *chunk = stack_chunk;
+    uint32_t chunk_cap = sizeof(stack_chunk);
+#if !TLV_THREAD_SAFE
+    if (!overlaps_static_buffer(buf, *len))
+    {
+        chunk = tlv_core_ctx.static_buffer;
+        chunk_cap = TLV_BUFFER_SIZE;
+    }
+#endif
+
+    tlv_lz_decoder_t dec;
+    tlv_lz_decoder_init(&dec, NULL);
+
+    uint16_t calc_crc = tlv_crc16_update(tlv_crc16_init(), header, sizeof(*header));
+    uint32_t pos = addr + sizeof(*header);
+    uint32_t remain = header->length;
+    int decode_ret = TLV_OK;
+    int ret;
+
+    while (remain > 0)
+    {
+        uint32_t chunk_size = (remain > chunk_cap) ? chunk_cap : remain;
+        ret = tlv_core_ctx.ops->read(pos, chunk, chunk_size);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        // 解压出错后只继续计算CRC,以便区分块损坏与数据非法
+        uint16_t consumed = (uint16_t)chunk_size;
+        if (decode_ret == TLV_OK)
+        {
+            uint16_t produced;
+            decode_ret = tlv_lz_decode(&dec, chunk, (uint16_t)chunk_size, &consumed, buf, *len, &produced);
+            if (decode_ret != TLV_OK || consumed == 0)
+            {
+                // 末尾匹配项不完整或解压完成后仍有多余数据
+                decode_ret = (decode_ret != TLV_OK) ? decode_ret : TLV_ERROR_CORRUPTED;
+                consumed = (uint16_t)chunk_size;
+            }
+        }
+
+        calc_crc = tlv_crc16_update(calc_crc, chunk, consumed);
+        pos += consumed;
+        remain -= consumed;
+    }
+
+    uint16_t stored_crc;
+    ret = tlv_core_ctx.ops->read(pos, &stored_crc, sizeof(stored_crc));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    if (tlv_crc16_final(calc_crc) != stored_crc)
+    {
+        return TLV_ERROR_CRC_FAILED;
+    }
+
+    if (decode_ret != TLV_OK)
+    {
+        return decode_ret;
+    }
+
+    if (!tlv_lz_decode_done(&dec))
+    {
+        return TLV_ERROR_CORRUPTED;
+    }
+
+    *len = dec.raw_len;
+    return TLV_OK;
+}
+
+int read_data_block(uint32_t addr, uint16_t tag, void *buf, uint16_t *len)
+{
+    return read_block(addr, tag, 0, buf, len, NULL);
+}
+
+/* ============================ 私有函数：块传输 ============================ */
+/**
+ * @brief 判断缓冲区是否与静态缓冲区重叠
+ */
+static bool overlaps_static_buffer(const void *base, uint32_t size)
+{
+    const uint8_t *p = (const uint8_t *)base;
+    const uint8_t *sb = tlv_core_ctx.static_buffer;
+    return (size != 0) && (p < sb + TLV_BUFFER_SIZE) && (p + size > sb);
+}
+
+/**
+ * @brief 聚集写入连续地址
+ *
+ * 移植层支持分散/聚集时直接下传；否则总长度不超过TLV_BUFFER_SIZE时经static_buffer合并为一次写入,
+ * 再否则逐段写入。源段位于static_buffer中时,只有目标位置不在其之前才能安全合并。
+ */
+static int block_writev(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+#if TLV_PORT_VECTOR_IO
+    return tlv_core_ctx.ops->writev(addr, iov, iovcnt);
+#else
+    uint32_t total = 0;
+    bool can_stage = true;
+    for (uint32_t i = 0; i < iovcnt; i++)
+    {
+        if (overlaps_static_buffer(iov[i].base, iov[i].size) &&
+            (uint8_t *)iov[i].base > tlv_core_ctx.static_buffer + total)
+        {
+            can_stage = false;
+        }
+        total += iov[i].size;
+    }
+
+    if (can_stage && total <= TLV_BUFFER_SIZE)
+    {
+        // 从后向前搬移,保证源段位于static_buffer中时不被覆盖
+        uint32_t offset = total;
+        for (uint32_t i = iovcnt; i > 0; i--)
+        {
+            offset -= iov[i - 1].size;
+            memmove(tlv_core_ctx.static_buffer + offset, iov[i - 1].base, iov[i - 1].size);
+        }
+
+        return tlv_core_ctx.ops->write(addr, tlv_core_ctx.static_buffer, total);
+    }
+
+    for (uint32_t i = 0; i < iovcnt; i++)
+    {
+        if (iov[i].size == 0)
+        {
+            continue;
+        }
+
+        int ret = tlv_core_ctx.ops->write(addr, iov[i].base, iov[i].size);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+        addr += iov[i].size;
+    }
+
+    return TLV_OK;
+#endif
+}
+
+/**
+ * @brief 分散读取连续地址
+ *
+ * 移植层支持分散/聚集时直接下传；否则总长度不超过读路径临时缓冲区且目标不在其中时,
+ * 一次读入临时缓冲区再分发,否则逐段读取。
+ */
+static int block_readv(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+#if TLV_PORT_VECTOR_IO
+    return tlv_core_ctx.ops->readv(addr, iov, iovcnt);
+#else
+    TLV_READ_SCRATCH(scratch);
+    uint32_t total = 0;
+    bool can_stage = true;
+    for (uint32_t i = 0; i < iovcnt; i++)
+    {
+        if (overlaps_static_buffer(iov[i].base, iov[i].size))
+        {
+            can_stage = false;
+        }
+        total += iov[i].size;
+    }
+
+    if (can_stage && total <= scratch_size)
+    {
+        int ret = tlv_core_ctx.ops->read(addr, scratch, total);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < iovcnt; i++)
+        {
+            memcpy(iov[i].base, scratch + offset, iov[i].size);
+            offset += iov[i].size;
+        }
+
+        return TLV_OK;
+    }
+
+    for (uint32_t i = 0; i < iovcnt; i++)
+    {
+        if (iov[i].size == 0)
+        {
+            continue;
+        }
+
+        int ret = tlv_core_ctx.ops->read(addr, iov[i].base, iov[i].size);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+        addr += iov[i].size;
+    }
+
+    return TLV_OK;
+#endif
+}
+
+/**
+ * @brief 经静态缓冲区分批复制数据块（目标在源之前时允许重叠）
+ */
+int tlv_core_copy_block(uint32_t src, uint32_t dst, uint32_t size)
+{
+    uint32_t offset = 0;
+    while (offset < size)
+    {
+        uint32_t chunk_size = (size - offset > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : (size - offset);
+
+        int ret = tlv_core_ctx.ops->read(src + offset, tlv_core_ctx.static_buffer, chunk_size);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        ret = tlv_core_ctx.ops->write(dst + offset, tlv_core_ctx.static_buffer, chunk_size);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        offset += chunk_size;
+    }
+
+    return TLV_OK;
+}
+
+/**
+ * @brief 查找地址不小于from的最低地址有效块
+ */
+const tlv_index_entry_t *tlv_core_find_next_block(uint32_t from)
+{
+    const tlv_index_entry_t *best = NULL;
+    for (uint32_t i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        const tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        if ((entry->flags & TLV_FLAG_VALID) && entry->data_addr >= from &&
+            (!best || entry->data_addr < best->data_addr))
+        {
+            best = entry;
+        }
+    }
+
+    return best;
+}
+
+/* ============================ 私有函数：块信息缓存 ============================ */
+/**
+ * @brief 获取数据块长度与写入次数,缓存未命中时读取块Header并填充缓存
+ * @note 块Header中的Tag与索引不一致时write_count按0返回
+ */
+int tlv_core_get_block_info(const tlv_index_entry_t *entry, uint16_t *length, uint32_t *write_count)
+{
+#if TLV_BLOCK_INFO_CACHE
+    const tlv_block_info_t *info = &tlv_core_ctx.block_info[entry - tlv_core_ctx.index_table->entries];
+    bool hit = false;
+    TLV_CRITICAL_ENTER();
+    if (info->data_addr == entry->data_addr)
+    {
+        *length = info->length;
+        *write_count = info->write_count;
+        hit = true;
+    }
+    TLV_CRITICAL_EXIT();
+
+    if (hit)
+    {
+        return TLV_OK;
+    }
+#endif
+
+    tlv_data_block_header_t header;
+    int ret = tlv_core_ctx.ops->read(entry->data_addr, &header, sizeof(header));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    *length = header.length;
+    *write_count = (header.tag == entry->tag) ? header.write_count : 0;
+
+    if (header.tag == entry->tag)
+    {
+        tlv_core_block_info_set(entry, header.length, header.write_count);
+    }
+
+    return TLV_OK;
+}
+
+/**
+ * @brief 更新索引条目对应的块信息缓存
+ */
+void tlv_core_block_info_set(const tlv_index_entry_t *entry, uint16_t length, uint32_t write_count)
+{
+#if TLV_BLOCK_INFO_CACHE
+    tlv_block_info_t *info = &tlv_core_ctx.block_info[entry - tlv_core_ctx.index_table->entries];
+    TLV_CRITICAL_ENTER();
+    info->data_addr = entry->data_addr;
+    info->length = length;
+    info->write_count = write_count;
+    info->crc_verified = false;
+    TLV_CRITICAL_EXIT();
+#else
+    (void)entry;
+    (void)length;
+    (void)write_count;
+#endif
+}
+
+/**
+ * @brief 使索引条目对应的块信息缓存失效
+ */
+void tlv_core_block_info_invalidate(const tlv_index_entry_t *entry)
+{
+#if TLV_BLOCK_INFO_CACHE
+    tlv_core_ctx.block_info[entry - tlv_core_ctx.index_table->entries].data_addr = 0;
+#else
+    (void)entry;
+#endif
+}
+
+/**
+ * @brief 使全部块信息缓存失效（索引表重新加载或重排后调用）
+ */
+void tlv_core_block_info_invalidate_all(void)
+{
+#if TLV_BLOCK_INFO_CACHE
+    memset(g_static_block_info, 0, sizeof(g_static_block_info));
+#endif
+}
+
+/**
+ * @brief 查询块信息缓存
+ * @param need_verified 是否要求整块CRC已校验
+ * @return true: 命中, false: 需要读取块
+ */
+static bool block_info_lookup(const tlv_index_entry_t *entry, bool need_verified, uint16_t *length)
+{
+#if TLV_BLOCK_INFO_CACHE
+    const tlv_block_info_t *info = &tlv_core_ctx.block_info[entry - tlv_core_ctx.index_table->entries];
+    bool hit = false;
+    TLV_CRITICAL_ENTER();
+    if (info->data_addr == entry->data_addr && (!need_verified || info->crc_verified))
+    {
+        *length = info->length;
+        hit = true;
+    }
+    TLV_CRITICAL_EXIT();
+    return hit;
+#else
+    (void)entry;
+    (void)need_verified;
+    (void)length;
+    return false;
+#endif
+}
+
+/**
+ * @brief 标记块信息缓存中的数据块已通过整块CRC校验（下次写入前有效）
+ */
+void tlv_core_block_info_mark_verified(const tlv_index_entry_t *entry)
+{
+#if TLV_BLOCK_INFO_CACHE
+    tlv_block_info_t *info = &tlv_core_ctx.block_info[entry - tlv_core_ctx.index_table->entries];
+    TLV_CRITICAL_ENTER();
+    if (info->data_addr == entry->data_addr)
+    {
+        info->crc_verified = true;
+    }
+    TLV_CRITICAL_EXIT();
+#else
+    (void)entry;
+#endif
+}
+
+/**
+ * @brief 读取块Header并校验Tag,可选经读路径临时缓冲区分批校验整块CRC,结果写入块信息缓存
+ * @param length 输出数据长度
+ */
+int tlv_core_check_block(const tlv_index_entry_t *entry, bool verify_crc, uint16_t *length)
+{
+    tlv_data_block_header_t header;
+    int ret = tlv_core_ctx.ops->read(entry->data_addr, &header, sizeof(header));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    if (header.tag != entry->tag || !TLV_IS_SIZE_SAFE(&tlv_core_ctx, entry->data_addr, TLV_BLOCK_SIZE(header.length)))
+    {
+        return TLV_ERROR_CORRUPTED;
+    }
+
+    tlv_core_block_info_set(entry, header.length, header.write_count);
+
+    if (verify_crc)
+    {
+        TLV_READ_SCRATCH(scratch);
+        uint16_t calc_crc = tlv_crc16_update(tlv_crc16_init(), &header, sizeof(header));
+        uint32_t addr = entry->data_addr + sizeof(header);
+        uint32_t remain = tlv_core_block_crc_length(&header);
+        while (remain > 0)
+        {
+            uint32_t chunk_size = (remain > scratch_size) ? scratch_size : remain;
+            ret = tlv_core_ctx.ops->read(addr, scratch, chunk_size);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+
+            calc_crc = tlv_crc16_update(calc_crc, scratch, chunk_size);
+            addr += chunk_size;
+            remain -= chunk_size;
+        }
+
+        uint16_t stored_crc;
+        addr = entry->data_addr + sizeof(header) + header.length;
+        ret = tlv_core_ctx.ops->read(addr, &stored_crc, sizeof(stored_crc));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        if (tlv_crc16_final(calc_crc) != stored_crc)
+        {
+            return TLV_ERROR_CRC_FAILED;
+        }
+
+        tlv_core_block_info_mark_verified(entry);
+    }
+
+    *length = header.length;
+    return TLV_OK;
+}
+
+/**
+ * @brief 块CRC覆盖的数据长度（日志块的数据区由记录CRC各自保护,块CRC只覆盖Header）
+ */
+uint16_t tlv_core_block_crc_length(const tlv_data_block_header_t *header)
+{
+    return (header->flags & TLV_BLOCK_FLAG_LOG) ? 0 : header->length;
+}
+
+const tlv_meta_const_t *tlv_core_get_meta(uint16_t tag)
+{
+    return tlv_meta_find(tlv_core_ctx.meta_table, tag);
+}
+
+/**
+ * @brief 判断Tag的数据块是否可能以压缩形式存储
+ */
+static bool meta_compressible(const tlv_meta_const_t *meta)
+{
+#if TLV_COMPRESS_ENABLE
+    return meta && meta->compress_enable;
+#else
+    (void)meta;
+    return false;
+#endif
+}
+
+/* ============================ 私有函数：RAM缓存============================ */
+
+/**
+ * @brief 清空RAM缓存（FRAM内容被整体替换时调用）
+ */
+static void ram_cache_reset(void)
+{
+#if TLV_RAM_CACHE_ENABLE
+    memset(g_ram_cache, 0, sizeof(g_ram_cache));
+    g_ram_cache_tick = 0;
+#endif
+    g_ram_cache_hits = 0;
+    g_ram_cache_misses = 0;
+}
+
+/**
+ * @brief 从RAM缓存读取
+ * @return TLV_OK: 命中, TLV_ERROR_NOT_FOUND: 未命中, 其他: 错误码
+ */
+int tlv_core_ram_cache_read(uint16_t tag, void *buf, uint16_t *len)
+{
+#if TLV_RAM_CACHE_ENABLE
+    int ret = TLV_ERROR_NOT_FOUND;
+    TLV_CRITICAL_ENTER();
+    for (uint16_t i = 0; i < TLV_RAM_CACHE_SLOTS; i++)
+    {
+        tlv_ram_cache_slot_t *slot = &g_ram_cache[i];
+        if (slot->tag != tag)
+        {
+            continue;
+        }
+
+        if (slot->length > *len)
+        {
+            ret = TLV_ERROR_NO_BUFFER_MEMORY;
+            break;
+        }
+
+        memcpy(buf, slot->data, slot->length);
+        *len = slot->length;
+        slot->last_use = ++g_ram_cache_tick;
+        g_ram_cache_hits++;
+        ret = TLV_OK;
+        break;
+    }
+
+    if (ret == TLV_ERROR_NOT_FOUND)
+    {
+        const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
+        if (meta && meta->cache_enable)
+        {
+            g_ram_cache_misses++;
+        }
+    }
+    TLV_CRITICAL_EXIT();
+    return ret;
+#else
+    (void)tag;
+    (void)buf;
+    (void)len;
+    return TLV_ERROR_NOT_FOUND;
+#endif
+}
 
-    // 计算脏数据Tag数
-    uint32_t dirty_count = 0;
-    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+/**
+ * @brief 写入RAM缓存（仅cache_enable的Tag,数据须已提交到FRAM）
+ */
+void tlv_core_ram_cache_store(const tlv_meta_const_t *meta, const void *data, uint16_t len)
+{
+#if TLV_RAM_CACHE_ENABLE
+    if (!meta || !meta->cache_enable || len > TLV_RAM_CACHE_SLOT_SIZE)
+    {
+        return;
+    }
+
+    // 已缓存则覆盖,否则取空闲槽或最久未使用的槽
+    TLV_CRITICAL_ENTER();
+    tlv_ram_cache_slot_t *victim = &g_ram_cache[0];
+    for (uint16_t i = 0; i < TLV_RAM_CACHE_SLOTS; i++)
+    {
+        tlv_ram_cache_slot_t *slot = &g_ram_cache[i];
+        if (slot->tag == meta->tag)
+        {
+            victim = slot;
+            break;
+        }
+
+        if (victim->tag != 0 && (slot->tag == 0 || slot->last_use < victim->last_use))
+        {
+            victim = slot;
+        }
+    }
+
+    victim->tag = meta->tag;
+    victim->length = len;
+    victim->last_use = ++g_ram_cache_tick;
+    memcpy(victim->data, data, len);
+    TLV_CRITICAL_EXIT();
+#else
+    (void)meta;
+    (void)data;
+    (void)len;
+#endif
+}
+
+/**
+ * @brief 使Tag的RAM缓存失效
+ */
+static void ram_cache_invalidate(uint16_t tag)
+{
+#if TLV_RAM_CACHE_ENABLE
+    for (uint16_t i = 0; i < TLV_RAM_CACHE_SLOTS; i++)
+    {
+        if (g_ram_cache[i].tag == tag)
+        {
+            g_ram_cache[i].tag = 0;
+            return;
+        }
+    }
+#else
+    (void)tag;
+#endif
+}
+
+/**
+ * @brief 按范围更新已缓存的Tag数据（未缓存时不做任何事）
+ */
+static void ram_cache_patch(uint16_t tag, uint16_t offset, const void *data, uint16_t len)
+{
+#if TLV_RAM_CACHE_ENABLE
+    TLV_CRITICAL_ENTER();
+    for (uint16_t i = 0; i < TLV_RAM_CACHE_SLOTS; i++)
+    {
+        tlv_ram_cache_slot_t *slot = &g_ram_cache[i];
+        if (slot->tag != tag)
+        {
+            continue;
+        }
+
+        if ((uint32_t)offset + len <= slot->length)
+        {
+            memcpy(slot->data + offset, data, len);
+        }
+        else
+        {
+            slot->tag = 0;
+        }
+        break;
+    }
+    TLV_CRITICAL_EXIT();
+#else
+    (void)tag;
+    (void)offset;
+    (void)data;
+    (void)len;
+#endif
+}
+
+/* ============================ 私有函数：内部备份（无状态检查）============================ */
+int tlv_core_backup_all_internal(void)
+{
+    if (!tlv_core_ctx.header || !tlv_core_ctx.index_table)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+#if TLV_JOURNAL_ENABLE
+    // 提交日志不参与备份：先做检查点,使备份包含已提交的全部修改
+    int ret = tlv_core_journal_checkpoint();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+#else
+    int ret;
+#endif
+
+    if (tlv_core_ctx.backup_dirty == 0)
+    {
+        free_list_reclaim_held();
+        return TLV_OK;
+    }
+
+    // 页CRC表无效（首次备份或旧格式整区备份）时所有页重新备份
+    bool table_valid = backup_crc_table_valid();
+    if (!table_valid)
+    {
+        tlv_core_ctx.backup_dirty = TLV_BACKUP_DIRTY_ALL;
+    }
+
+    ret = TLV_OK;
+    for (uint32_t page = 0; page < TLV_BACKUP_COVER_PAGES; page++)
+    {
+        ret = backup_page(page, table_valid);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+    }
+
+    // 全部页CRC写入后再写魔数,之前掉电仍按旧格式处理
+    if (!table_valid)
+    {
+        uint16_t magic = TLV_BACKUP_CRC_MAGIC;
+        ret = tlv_core_ctx.ops->write(TLV_BACKUP_CRC_ADDR + offsetof(tlv_backup_crc_table_t, magic),
+                                  &magic, sizeof(magic));
+    }
+
+    if (ret == TLV_OK)
+    {
+        free_list_reclaim_held();
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 备份单个脏页：页数据 -> 页CRC,掉电发生在两者之间时该页可被检测
+ * @param page 页号
+ * @param table_valid 页CRC表是否有效（有效时内容未变化的页只清除脏标记）
+ * @return 0: 成功, 其他: 错误码
+ */
+static int backup_page(uint32_t page, bool table_valid)
+{
+    if (!(tlv_core_ctx.backup_dirty & (1UL << page)))
+    {
+        return TLV_OK;
+    }
+
+    uint32_t offset = page * TLV_BACKUP_PAGE_SIZE;
+    uint32_t crc_addr = TLV_BACKUP_CRC_ADDR + offsetof(tlv_backup_crc_table_t, page_crc16) +
+                        page * sizeof(uint16_t);
+    int ret = tlv_core_ctx.ops->read(TLV_HEADER_ADDR + offset, tlv_core_ctx.static_buffer, TLV_BACKUP_PAGE_SIZE);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 内容未变化（例如启动后首次备份）时跳过
+    uint16_t crc = tlv_crc16(tlv_core_ctx.static_buffer, TLV_BACKUP_PAGE_SIZE);
+    if (table_valid)
+    {
+        uint16_t stored_crc;
+        ret = tlv_core_ctx.ops->read(crc_addr, &stored_crc, sizeof(stored_crc));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        if (crc == stored_crc)
+        {
+            tlv_core_ctx.backup_dirty &= ~(1UL << page);
+            return TLV_OK;
+        }
+    }
+
+    ret = tlv_core_ctx.ops->write(tlv_core_ctx.backup_addr + offset, tlv_core_ctx.static_buffer, TLV_BACKUP_PAGE_SIZE);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    ret = tlv_core_ctx.ops->write(crc_addr, &crc, sizeof(crc));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    tlv_core_ctx.backup_dirty &= ~(1UL << page);
+    return TLV_OK;
+}
+
+/**
+ * @brief 使备份区失效：作废两份备份Header的魔数（之后从备份恢复直接失败）与所在页的CRC（下次备份必定重写这些页）
+ * @return 0: 成功, 其他: 错误码
+ */
+static int backup_invalidate(void)
+{
+    int ret = TLV_OK;
+    for (uint32_t copy = 0; copy < TLV_HEADER_COPIES && ret == TLV_OK; copy++)
+    {
+        uint32_t offset = TLV_HEADER_COPY_ADDR(copy) - TLV_HEADER_ADDR;
+        uint32_t page = offset / TLV_BACKUP_PAGE_SIZE;
+        uint32_t crc_addr = TLV_BACKUP_CRC_ADDR + offsetof(tlv_backup_crc_table_t, page_crc16) +
+                            page * sizeof(uint16_t);
+        uint16_t stored_crc;
+        ret = tlv_core_ctx.ops->read(crc_addr, &stored_crc, sizeof(stored_crc));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        uint32_t invalid_magic = 0;
+        ret = tlv_core_ctx.ops->write(tlv_core_ctx.backup_addr + offset + offsetof(tlv_system_header_t, magic),
+                                  &invalid_magic, sizeof(invalid_magic));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        stored_crc = (uint16_t)~stored_crc;
+        ret = tlv_core_ctx.ops->write(crc_addr, &stored_crc, sizeof(stored_crc));
+        if (ret == TLV_OK)
+        {
+            tlv_core_ctx.backup_dirty |= (1UL << page);
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 检查备份页CRC表魔数
+ * @return true: 表有效, false: 首次备份或旧格式整区备份
+ */
+static bool backup_crc_table_valid(void)
+{
+    uint16_t magic = 0;
+    int ret = tlv_core_ctx.ops->read(TLV_BACKUP_CRC_ADDR + offsetof(tlv_backup_crc_table_t, magic),
+                                 &magic, sizeof(magic));
+    return (ret == TLV_OK) && (magic == TLV_BACKUP_CRC_MAGIC);
+}
+
+/**
+ * @brief 读取备份页CRC表
+ * @return TLV_OK: 表有效, TLV_ERROR_CORRUPTED: 魔数不匹配（旧格式整区备份）
+ */
+static int backup_crc_table_load(tlv_backup_crc_table_t *table)
+{
+    int ret = tlv_core_ctx.ops->read(TLV_BACKUP_CRC_ADDR, table, sizeof(tlv_backup_crc_table_t));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    return (table->magic == TLV_BACKUP_CRC_MAGIC) ? TLV_OK : TLV_ERROR_CORRUPTED;
+}
+
+/**
+ * @brief 按需保存Header（写回模式下合并统计字段）
+ *
+ * 与本次操作开始时的快照比较：空间布局字段（next_free_addr、used_space、free_space、
+ * fragment_count、fragment_size、tag_count）未变化时只标记header_dirty,
+ * 由tlv_flush()/tlv_deinit()落盘；否则立即保存。调用前必须已创建快照。
+ * 启用提交日志时总是只标记header_dirty。
+ */
+static int system_header_commit(void)
+{
+#if TLV_JOURNAL_ENABLE
+    // 日志非空时启动会按数据块重新统计空间字段,Header统一在检查点保存
+    tlv_core_ctx.header_dirty = true;
+    return TLV_OK;
+#elif TLV_WRITE_BACK_MODE
+    const tlv_transaction_snapshot_t *snap = &tlv_core_ctx.snapshot;
+    const tlv_system_header_t *hdr = tlv_core_ctx.header;
+
+    if (hdr->next_free_addr == snap->next_free_addr &&
+        hdr->used_space == snap->used_space &&
+        hdr->free_space == snap->free_space &&
+        hdr->fragment_count == snap->fragment_count &&
+        hdr->fragment_size == snap->fragment_size &&
+        hdr->tag_count == snap->tag_count)
+    {
+        tlv_core_ctx.header_dirty = true;
+        return TLV_OK;
+    }
+#endif
+
+    return tlv_core_system_header_save();
+}
+
+/**
+ * @brief 启动时对齐Header与索引表
+ *
+ * 写入顺序为 数据 -> 索引条目 -> Header,掉电发生在索引与Header之间时,
+ * Header中的next_free_addr/tag_count可能落后于索引。此处以索引为准修正,
+ * 避免新分配覆盖已提交的数据块。
+ */
+static int system_header_reconcile(void)
+{
+    tlv_system_header_t *hdr = tlv_core_ctx.header;
+    uint32_t tag_count = 0;
+    bool changed = false;
+
+    for (uint32_t i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        const tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        if (!(entry->flags & TLV_FLAG_VALID))
+        {
+            continue;
+        }
+
+        tag_count++;
+
+        if (entry->data_addr < hdr->next_free_addr)
+        {
+            continue;
+        }
+
+        // 数据块位于next_free_addr之后：分配记录丢失,按块头补齐
+        tlv_data_block_header_t block;
+        int ret = tlv_core_ctx.ops->read(entry->data_addr, &block, sizeof(block));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        uint32_t block_end = entry->data_addr + TLV_BLOCK_SIZE(block.length);
+        if (block.tag != entry->tag || block_end > tlv_core_ctx.backup_addr)
+        {
+            continue;
+        }
+
+        uint32_t grow = block_end - hdr->next_free_addr;
+        hdr->next_free_addr = block_end;
+        hdr->free_space = (hdr->free_space > grow) ? hdr->free_space - grow : 0;
+        hdr->used_space += TLV_BLOCK_SIZE(block.length);
+        changed = true;
+    }
+
+    if (tag_count != hdr->tag_count)
+    {
+        hdr->tag_count = tag_count;
+        changed = true;
+    }
+
+    return changed ? tlv_core_system_header_save() : TLV_OK;
+}
+
+/**
+ * @brief 提交单个索引条目
+ *
+ * 启用提交日志时只追加一条日志记录；否则写回模式下只写入该条目及其页CRC,写穿透模式保存整个索引表
+ * @param entry 已更新的索引条目
+ * @param length 条目指向的数据块长度（块Header中的length）
+ */
+int tlv_core_index_commit_entry(const tlv_index_entry_t *entry, uint16_t length)
+{
+#if TLV_JOURNAL_ENABLE
+    return tlv_core_journal_append(entry, entry, length);
+#elif TLV_WRITE_BACK_MODE
+    (void)length;
+    return tlv_index_save_entry(&tlv_core_ctx, entry);
+#else
+    (void)entry;
+    (void)length;
+    return tlv_index_save(&tlv_core_ctx);
+#endif
+}
+
+/**
+ * @brief 提交索引条目的删除
+ * @param entry 已被清零的索引条目
+ * @param tag 被删除的Tag（日志记录需要,条目中已不再保存）
+ */
+static int index_commit_remove(const tlv_index_entry_t *entry, uint16_t tag)
+{
+#if TLV_JOURNAL_ENABLE
+    tlv_index_entry_t removed = {0};
+    removed.tag = tag;
+    return tlv_core_journal_append(entry, &removed, 0);
+#else
+    (void)tag;
+    return tlv_core_index_commit_entry(entry, 0);
+#endif
+}
+
+/* ============================ 私有函数：快速启动============================ */
+/**
+ * @brief 校验快速启动时跳过的索引页
+ *
+ * 按页号顺序校验,发现损坏页时从备份恢复（恢复会重新加载并完整校验索引表）。
+ * @param max_pages 本次最多校验的页数
+ * @return 0: 成功, 其他: 错误码
+ */
+static int fast_boot_verify(uint32_t max_pages)
+{
+    while (tlv_core_ctx.index_unverified != 0 && max_pages > 0)
+    {
+        uint32_t page = 0;
+        while (!(tlv_core_ctx.index_unverified & (1UL << page)))
+        {
+            page++;
+        }
+
+        int ret = tlv_index_verify_page(&tlv_core_ctx, page);
+        if (ret == TLV_ERROR_CRC_FAILED)
+        {
+            tlv_printf("ERROR: Index page %lu corrupted, restoring from backup\n", (unsigned long)page);
+            ret = tlv_restore_from_backup_unlocked();
+            if (ret != TLV_OK)
+            {
+                tlv_core_ctx.state = TLV_STATE_ERROR;
+            }
+            return ret;
+        }
+
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        tlv_core_ctx.index_unverified &= ~(1UL << page);
+        max_pages--;
+    }
+
+    return TLV_OK;
+}
+
+/**
+ * @brief 修改管理区之前调用：完成剩余的索引页校验,清除FRAM中的正常关机标记,
+ *        并补齐上次未完整落盘的事务发布
+ *
+ * RAM中的Header不带标记,保存Header即清除标记。调用时尚未改动任何状态,
+ * 此时RAM中的Header与FRAM一致。
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_core_fast_boot_settle(void)
+{
+    int ret = fast_boot_verify(UINT32_MAX);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    if (tlv_core_ctx.clean_marked)
     {
-        if (g_tlv_ctx.index_table->entries[i].tag != 0 &&
-            (g_tlv_ctx.index_table->entries[i].flags & TLV_FLAG_DIRTY))
+        ret = tlv_core_system_header_save();
+        if (ret != TLV_OK)
         {
-            dirty_count++;
+            return ret;
         }
     }
-    stats->dirty_tags = dirty_count;
 
-    // 计算碎片化程度
-    if (g_tlv_ctx.header->data_region_size > 0)
+    return txn_publish_settle();
+}
+
+/**
+ * @brief 当前是否可以写入正常关机标记
+ *
+ * 进行中的事务、分段写入与异步写入会在之后直接提交索引,期间不能留下标记。
+ */
+static bool clean_marker_allowed(void)
+{
+#if TLV_FAST_BOOT
+    return tlv_core_ctx.state == TLV_STATE_INITIALIZED &&
+           tlv_core_ctx.index_unverified == 0 &&
+           !tlv_core_ctx.index_crc_dirty &&
+           !tlv_core_txn_ctx.is_active &&
+           !tlv_core_has_active_write_stream() &&
+           !tlv_core_async_busy();
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 保存带正常关机标记的Header
+ *
+ * 索引表与Header均已落盘后调用。标记记录当时的索引整表CRC,下次启动时据此确认
+ * Header与索引表属于同一次关机。
+ * @return 0: 成功, 其他: 错误码
+ */
+static int clean_marker_write(void)
+{
+    tlv_core_ctx.header->clean_marker = TLV_CLEAN_SHUTDOWN_MAGIC;
+    tlv_core_ctx.header->clean_generation++;
+    tlv_core_ctx.header->clean_index_crc = tlv_core_ctx.index_table->index_crc16;
+
+    int ret = tlv_core_system_header_save();
+    tlv_core_ctx.header->clean_marker = 0;
+    if (ret == TLV_OK)
     {
-        uint32_t wasted = (g_tlv_ctx.header->next_free_addr - TLV_DATA_ADDR) -
-                          g_tlv_ctx.header->used_space;
-        stats->fragmentation = (wasted * 100) / g_tlv_ctx.header->data_region_size;
+        tlv_core_ctx.clean_marked = true;
     }
 
-    return TLV_OK;
+    return ret;
 }
+
+/* ============================ 私有函数：环形日志============================ */
 /**
- * @brief 遍历所有Tag
- * @param callback 回调函数
- * @param user_data 用户数据
- * @return 遍历的Tag数量
+ * @brief 创建日志块：按max_length分配固定大小的块,只写入Header、空控制头与块CRC
+ * @note 槽位中的旧内容不在[next_seq - 槽位数, next_seq)范围内,不会被读到,无需清零
  */
-int tlv_foreach(tlv_foreach_callback_t callback, void *user_data)
+static int log_create(const tlv_meta_const_t *meta)
 {
-    if (!callback)
+    if (tlv_core_txn_ctx.is_active)
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    uint32_t slot_size = sizeof(tlv_log_record_t) + meta->log_record_size;
+    if (meta->max_length < sizeof(tlv_log_ctrl_t) + 2 * slot_size)
     {
+        tlv_printf("ERROR: Log tag 0x%04X max_length holds less than 2 records\n", meta->tag);
         return TLV_ERROR_INVALID_PARAM;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (tlv_core_ctx.header->tag_count >= TLV_MAX_TAG_COUNT)
     {
-        return TLV_ERROR;
+        return TLV_ERROR_NO_INDEX_SPACE;
     }
 
-    int count = 0;
+    tlv_core_transaction_snapshot_create();
+    uint32_t addr = tlv_core_allocate_space_or_compact(TLV_BLOCK_SIZE(meta->max_length));
+    if (addr == 0)
+    {
+        return TLV_ERROR_NO_MEMORY_SPACE;
+    }
 
-    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    tlv_data_block_header_t header;
+    memset(&header, 0, sizeof(header));
+    header.tag = meta->tag;
+    header.length = meta->max_length;
+    header.version = meta->version;
+    header.flags = TLV_BLOCK_FLAG_LOG;
+    header.timestamp = tlv_port_get_timestamp_s();
+    header.write_count = 1;
+    uint16_t block_crc = tlv_crc16(&header, sizeof(header));
+
+    tlv_log_ctrl_t ctrl;
+    ctrl.next_seq = 0;
+    ctrl.record_size = meta->log_record_size;
+    ctrl.crc16 = tlv_crc16(&ctrl, offsetof(tlv_log_ctrl_t, crc16));
+
+    tlv_iovec_t iov[2] = {
+        {&header, sizeof(header)},
+        {&ctrl, sizeof(ctrl)},
+    };
+
+    int ret = block_writev(addr, iov, 2);
+    if (ret == TLV_OK)
     {
-        if (g_tlv_ctx.index_table->entries[i].tag != 0 &&
-            (g_tlv_ctx.index_table->entries[i].flags & TLV_FLAG_VALID))
-        {
-            callback(g_tlv_ctx.index_table->entries[i].tag, user_data);
-            count++;
-        }
+        ret = tlv_core_ctx.ops->write(addr + sizeof(header) + header.length, &block_crc, sizeof(block_crc));
     }
 
-    return count;
+    tlv_index_entry_t *index = NULL;
+    if (ret == TLV_OK)
+    {
+        index = tlv_index_add(&tlv_core_ctx, meta->tag, addr);
+        ret = index ? TLV_OK : TLV_ERROR_NO_INDEX_SPACE;
+    }
+
+    if (ret != TLV_OK)
+    {
+        transaction_snapshot_rollback();
+        tlv_core_system_header_save();
+        return ret;
+    }
+
+    // 索引是提交点
+    tlv_core_block_info_set(index, header.length, header.write_count);
+    ret = tlv_core_index_commit_entry(index, header.length);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    transaction_snapshot_commit();
+    tlv_core_ctx.header->total_writes++;
+    tlv_core_ctx.header->last_update_time = tlv_port_get_timestamp_s();
+    return system_header_commit();
 }
 
-/* ============================ 私有函数实现 ============================ */
 /**
- * @brief 原地排序索引表（按地址）
+ * @brief 打开日志：一次读出块Header与控制头并解析槽位布局
+ * @param repair 控制头损坏时扫描槽位恢复后是否重写控制头（需持写锁）
+ * @return 0: 成功, TLV_ERROR_NOT_FOUND: 日志尚未创建, 其他: 错误码
  */
-static void sort_index_table_inplace(void)
+static int log_open(uint16_t tag, bool repair, tlv_log_ring_t *ring)
 {
-    // 1. 压缩：移动所有有效项到前面
-    int write_idx = 0;
-    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
+    if (!index || !(index->flags & TLV_FLAG_VALID))
     {
-        if (write_idx >= TLV_MAX_TAG_COUNT)
-            break;
-        tlv_index_entry_t *entry = &g_tlv_ctx.index_table->entries[i];
+        return TLV_ERROR_NOT_FOUND;
+    }
 
-        if (entry->tag != 0 && (entry->flags & TLV_FLAG_VALID))
-        {
-            if (i != write_idx)
-            {
-                g_tlv_ctx.index_table->entries[write_idx] = *entry;
-            }
-            write_idx++;
-        }
+    tlv_data_block_header_t header;
+    tlv_log_ctrl_t ctrl;
+    tlv_iovec_t iov[2] = {
+        {&header, sizeof(header)},
+        {&ctrl, sizeof(ctrl)},
+    };
+
+    int ret = block_readv(index->data_addr, iov, 2);
+    if (ret != TLV_OK)
+    {
+        return ret;
     }
 
-    int total_valid = write_idx;
+    if (header.tag != tag || !(header.flags & TLV_BLOCK_FLAG_LOG) ||
+        !TLV_IS_SIZE_SAFE(&tlv_core_ctx, index->data_addr, TLV_BLOCK_SIZE(header.length)))
+    {
+        return TLV_ERROR_CORRUPTED;
+    }
 
-    if (total_valid <= 0 || total_valid >= TLV_MAX_TAG_COUNT)
+    ring->data_addr = index->data_addr;
+    bool ctrl_valid = ctrl.crc16 == tlv_crc16(&ctrl, offsetof(tlv_log_ctrl_t, crc16)) && ctrl.record_size != 0;
+    if (ctrl_valid)
     {
-        return;
+        ring->next_seq = ctrl.next_seq;
+        ring->record_size = ctrl.record_size;
+    }
+    else
+    {
+        // 控制头撕裂：槽位布局取自元数据,扫描记录恢复序号
+        const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
+        if (!meta || meta->log_record_size == 0)
+        {
+            return TLV_ERROR_CORRUPTED;
+        }
+        ring->next_seq = 0;
+        ring->record_size = meta->log_record_size;
     }
 
-// 2. 对压缩后的有效项排序
-// 插入排序,原有的排序是按地址排列基本有序的,对于近乎有序的排列接近O(n),逆序最差是O(n^2)
-#if 1
-    for (int i = 1; i < total_valid; i++)
+    uint32_t slot_size = sizeof(tlv_log_record_t) + ring->record_size;
+    uint32_t slot_count = (header.length - sizeof(tlv_log_ctrl_t)) / slot_size;
+    if (header.length < sizeof(tlv_log_ctrl_t) || slot_count == 0 || slot_count > UINT16_MAX)
     {
-        tlv_index_entry_t entry = g_tlv_ctx.index_table->entries[i];
-        int j = i - 1;
+        return TLV_ERROR_CORRUPTED;
+    }
+    ring->slot_count = (uint16_t)slot_count;
 
-        // 和有序区最后一个元素比较,如果比有序区最后一个元素小,则插入有序区中,否则就在当前位置
-        while (j >= 0 && g_tlv_ctx.index_table->entries[j].data_addr > entry.data_addr)
+    if (!ctrl_valid)
+    {
+        tlv_printf("WARNING: Log tag 0x%04X control corrupted, scanning records\n", tag);
+        ret = log_scan(ring);
+        if (ret == TLV_OK && repair)
         {
-            g_tlv_ctx.index_table->entries[j + 1] = g_tlv_ctx.index_table->entries[j];
-            j--;
+            ret = log_ctrl_write(ring);
         }
-        g_tlv_ctx.index_table->entries[j + 1] = entry;
+        return ret;
     }
-#else
-    // 选择排序 O(n^2)
-    for (int i = 0; i < total_valid - 1; i++)
+
+    return TLV_OK;
+}
+
+/**
+ * @brief 扫描全部槽位,以CRC有效且位于本槽位的最大序号恢复next_seq
+ */
+static int log_scan(tlv_log_ring_t *ring)
+{
+    TLV_READ_SCRATCH(scratch);
+    bool found = false;
+    uint32_t last_seq = 0;
+
+    for (uint16_t slot = 0; slot < ring->slot_count; slot++)
     {
-        int min_idx = i;
+        uint32_t addr = log_slot_addr(ring, slot);
+        tlv_log_record_t head;
+        int ret = tlv_core_ctx.ops->read(addr, &head, sizeof(head));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        if (head.length > ring->record_size || head.seq % ring->slot_count != slot ||
+            (found && head.seq <= last_seq))
+        {
+            continue;
+        }
 
-        // 找到剩余最小地址
-        for (int j = i + 1; j < total_valid; j++)
+        // 分批校验记录CRC
+        uint16_t crc = tlv_crc16_update(tlv_crc16_init(), &head, offsetof(tlv_log_record_t, crc16));
+        uint32_t offset = 0;
+        while (offset < head.length)
         {
-            if (g_tlv_ctx.index_table->entries[j].data_addr <
-                g_tlv_ctx.index_table->entries[min_idx].data_addr)
+            uint32_t chunk_size = (head.length - offset > scratch_size) ? scratch_size : (head.length - offset);
+            ret = tlv_core_ctx.ops->read(addr + sizeof(head) + offset, scratch, chunk_size);
+            if (ret != TLV_OK)
             {
-                min_idx = j;
+                return ret;
             }
+            crc = tlv_crc16_update(crc, scratch, chunk_size);
+            offset += chunk_size;
         }
 
-        // 交换
-        if (min_idx != i)
+        if (tlv_crc16_final(crc) == head.crc16)
         {
-            tlv_index_entry_t temp = g_tlv_ctx.index_table->entries[i];
-            g_tlv_ctx.index_table->entries[i] = g_tlv_ctx.index_table->entries[min_idx];
-            g_tlv_ctx.index_table->entries[min_idx] = temp;
+            found = true;
+            last_seq = head.seq;
         }
     }
-#endif
-    // 3. 清空剩余槽位
-    for (int i = total_valid; i < TLV_MAX_TAG_COUNT; i++)
-    {
-        memset(&g_tlv_ctx.index_table->entries[i], 0, sizeof(tlv_index_entry_t));
-    }
+
+    ring->next_seq = found ? last_seq + 1 : 0;
+    return TLV_OK;
 }
 
-/* ============================ 维护管理API实现 ============================ */
 /**
- * @brief 碎片整理
- * @return 0: 成功, 其他: 错误码
- * @note 清除无效的tag,按地址排序整理内存及索引
+ * @brief 重写日志控制头（8字节,一次写入）
+ */
+static int log_ctrl_write(const tlv_log_ring_t *ring)
+{
+    tlv_log_ctrl_t ctrl;
+    ctrl.next_seq = ring->next_seq;
+    ctrl.record_size = ring->record_size;
+    ctrl.crc16 = tlv_crc16(&ctrl, offsetof(tlv_log_ctrl_t, crc16));
+    return tlv_core_ctx.ops->write(ring->data_addr + sizeof(tlv_data_block_header_t), &ctrl, sizeof(ctrl));
+}
+
+/**
+ * @brief 序号为seq的记录所在槽位地址
  */
+static uint32_t log_slot_addr(const tlv_log_ring_t *ring, uint32_t seq)
+{
+    uint32_t slot = seq % ring->slot_count;
+    return ring->data_addr + sizeof(tlv_data_block_header_t) + sizeof(tlv_log_ctrl_t) +
+           slot * (sizeof(tlv_log_record_t) + ring->record_size);
+}
 
-int tlv_defragment(void)
+/* ============================ 私有函数：批量迁移============================ */
+/**
+ * @brief 判断索引条目是否需要版本迁移
+ */
+static bool migrate_needed(const tlv_index_entry_t *entry)
 {
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (entry->tag == 0 || !(entry->flags & TLV_FLAG_VALID))
     {
-        return TLV_ERROR;
+        return false;
     }
 
-    int ret = TLV_OK;
-    uint32_t write_pos = TLV_DATA_ADDR;
-    uint32_t total_used = 0;
-    uint32_t processed = 0;
-    uint32_t total_tags = 0;
+    // 日志Tag的记录格式由应用解释,不做整块迁移
+    const tlv_meta_const_t *meta = tlv_core_get_meta(entry->tag);
+    return meta && meta->log_record_size == 0 && entry->version != meta->version;
+}
 
-    // 统计有效tag数量
+/**
+ * @brief 统计需要迁移的Tag数
+ */
+static uint16_t migrate_count_pending(void)
+{
+    uint16_t count = 0;
     for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
     {
-        tlv_index_entry_t *entry = &g_tlv_ctx.index_table->entries[i];
-        if (entry->tag != 0 && (entry->flags & TLV_FLAG_VALID))
+        if (migrate_needed(&tlv_core_ctx.index_table->entries[i]))
         {
-            total_tags++;
+            count++;
         }
     }
+    return count;
+}
 
-    tlv_printf("Valid tags: %lu\n", (unsigned long)total_tags);
-
-    if (total_tags == 0)
+/**
+ * @brief 查找Tag值不小于from_tag、需要迁移的最小Tag
+ * @return 索引条目, NULL表示本轮已无待迁移的Tag
+ */
+static tlv_index_entry_t *migrate_next_entry(uint32_t from_tag)
+{
+    tlv_index_entry_t *best = NULL;
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
     {
-        // 没有有效数据,清空
-        ret = system_header_init();
-        if (ret != TLV_OK)
-        {
-            return ret;
-        }
-        ret = tlv_index_init(&g_tlv_ctx);
-        if (ret != TLV_OK)
+        tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        if (entry->tag >= from_tag && (!best || entry->tag < best->tag) && migrate_needed(entry))
         {
-            return ret;
+            best = entry;
         }
+    }
+    return best;
+}
 
-        // 保存Header和索引表
-        ret = system_header_save();
-        if (ret != TLV_OK)
+/* ============================ 私有函数：后台巡检============================ */
+/**
+ * @brief 查找地址不小于from_addr的最低地址有效块
+ * @return 索引条目, NULL表示本轮已无待校验的块
+ */
+static tlv_index_entry_t *scrub_next_entry(uint32_t from_addr)
+{
+    tlv_index_entry_t *best = NULL;
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        if (entry->tag != 0 && (entry->flags & TLV_FLAG_VALID) && entry->data_addr >= from_addr &&
+            (!best || entry->data_addr < best->data_addr))
         {
-            return ret;
+            best = entry;
         }
+    }
+    return best;
+}
 
-        ret = tlv_index_save(&g_tlv_ctx);
-        if (ret != TLV_OK)
-        {
-            return ret;
-        }
+/**
+ * @brief 校验从entry起物理相邻的一段块：一次读入静态缓冲区后逐块校验CRC
+ * @param budget_bytes 本步预算,段内累计达到后停止
+ * @param spent 累加已校验的块字节数
+ * @note 段内遇到非索引指向的区域（空闲块或旧块）、放不下的块或损坏块时结束,游标停在下一个待校验处
+ */
+static int scrub_run(tlv_index_entry_t *entry, uint32_t budget_bytes, uint32_t *spent)
+{
+    tlv_scrub_result_t *result = &g_scrub_ctx.result;
+    uint32_t run_addr = entry->data_addr;
+    if (!TLV_IS_SIZE_SAFE(&tlv_core_ctx, run_addr, sizeof(tlv_data_block_header_t)))
+    {
+        // 索引地址越界,无法读取Header
+        g_scrub_ctx.cursor = run_addr + 1;
+        *spent += sizeof(tlv_data_block_header_t);
+        return scrub_report(entry);
+    }
 
-        // 备份管理区
-        ret = tlv_backup_all_internal();
-        return ret;
+    uint32_t run_size = tlv_core_ctx.backup_addr - run_addr;
+    if (run_size > TLV_BUFFER_SIZE)
+    {
+        run_size = TLV_BUFFER_SIZE;
     }
 
-    // 1. 先备份当前管理区到备份区
-    ret = tlv_backup_all_internal();
+    uint8_t *buf = tlv_core_ctx.static_buffer;
+    int ret = tlv_core_ctx.ops->read(run_addr, buf, run_size);
     if (ret != TLV_OK)
     {
         return ret;
     }
 
-    // 原地排序索引表
-    sort_index_table_inplace();
-
-    total_tags = 0;
-    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    uint32_t offset = 0;
+    while (offset + sizeof(tlv_data_block_header_t) <= run_size)
     {
-        if (g_tlv_ctx.index_table->entries[i].tag != 0 &&
-            (g_tlv_ctx.index_table->entries[i].flags & TLV_FLAG_VALID))
+        uint32_t addr = run_addr + offset;
+        tlv_data_block_header_t header;
+        memcpy(&header, buf + offset, sizeof(header));
+
+        if (offset > 0)
         {
-            total_tags++;
+            // 后续块必须是索引当前指向的块,否则本段结束
+            entry = tlv_index_find(&tlv_core_ctx, header.tag);
+            if (!entry || entry->data_addr != addr)
+            {
+                break;
+            }
         }
-        else
+
+        uint32_t block_size = TLV_BLOCK_SIZE(header.length);
+        if (header.tag != entry->tag || !TLV_IS_SIZE_SAFE(&tlv_core_ctx, addr, block_size))
         {
-            break; // 已压缩,后面都是空的
+            // Header损坏,长度不可信,从下一个地址继续查找
+            g_scrub_ctx.cursor = addr + 1;
+            *spent += sizeof(header);
+            return scrub_report(entry);
         }
-    }
-
-    // 遍历所有有效Tag,移动数据块
-    for (int i = 0; i < total_tags; i++)
-    {
-        tlv_index_entry_t *entry = &g_tlv_ctx.index_table->entries[i];
 
-        if (entry->tag == 0 || !(entry->flags & TLV_FLAG_VALID))
+        if (offset + block_size > run_size)
         {
-            continue;
+            if (offset > 0)
+            {
+                // 由下一段从该块起始处重新读取
+                break;
+            }
+
+            // 单块超过静态缓冲区：分批校验
+            uint16_t length;
+            g_scrub_ctx.cursor = addr + block_size;
+            *spent += block_size;
+            result->scanned++;
+            ret = tlv_core_check_block(entry, true, &length);
+            if (ret == TLV_ERROR_CRC_FAILED || ret == TLV_ERROR_CORRUPTED)
+            {
+                return scrub_report(entry);
+            }
+            return ret;
         }
 
-        // 读取数据块Header
-        tlv_data_block_header_t header;
-        ret = tlv_port_fram_read(entry->data_addr, &header, sizeof(header));
-        if (ret != TLV_OK)
+        const uint8_t *block = buf + offset;
+        uint16_t stored_crc;
+        memcpy(&stored_crc, block + sizeof(header) + header.length, sizeof(stored_crc));
+        uint16_t calc_crc = tlv_crc16_update(tlv_crc16_init(), block, sizeof(header) + tlv_core_block_crc_length(&header));
+
+        g_scrub_ctx.cursor = addr + block_size;
+        *spent += block_size;
+        result->scanned++;
+        if (tlv_crc16_final(calc_crc) != stored_crc)
         {
-            continue;
+            // 修复会改写静态缓冲区,本段到此结束
+            return scrub_report(entry);
         }
 
-        uint32_t block_size = sizeof(header) + header.length + sizeof(uint16_t);
+        tlv_core_block_info_set(entry, header.length, header.write_count);
+        tlv_core_block_info_mark_verified(entry);
 
-        // 如果不在紧凑位置,移动它
-        if (entry->data_addr != write_pos)
+        offset += block_size;
+        if (*spent >= budget_bytes)
         {
-            // 使用静态缓冲区分批读写
-            uint32_t remaining = block_size;
-            uint32_t src_offset = 0;
+            break;
+        }
+    }
 
-            while (remaining > 0)
-            {
-                uint32_t chunk_size = (remaining > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : remaining;
+    return TLV_OK;
+}
 
-                // 读取
-                ret = tlv_port_fram_read(entry->data_addr + src_offset,
-                                         g_tlv_ctx.static_buffer, chunk_size);
-                if (ret != TLV_OK)
-                {
-                    return ret;
-                }
+/**
+ * @brief 记录损坏块,backup_enable的Tag用RAM缓存中的最新数据或同一次写入的镜像副本重写
+ * @note 只在块Header完好且长度一致时修复,此时重写必定原地进行,不会触发整理改写静态缓冲区；
+ *       压缩块直接复制镜像副本
+ */
+static int scrub_report(tlv_index_entry_t *entry)
+{
+    tlv_scrub_result_t *result = &g_scrub_ctx.result;
+    uint16_t tag = entry->tag;
 
-                // 写入新位置
-                ret = tlv_port_fram_write(write_pos + src_offset,
-                                          g_tlv_ctx.static_buffer, chunk_size);
-                if (ret != TLV_OK)
-                {
-                    return ret;
-                }
+    tlv_core_block_info_invalidate(entry);
+    if (result->corrupted < TLV_SCRUB_MAX_REPORT)
+    {
+        result->corrupted_tags[result->corrupted] = tag;
+    }
+    result->corrupted++;
+    TLV_SET_ERROR(TLV_ERROR_CRC_FAILED, tag);
 
-                src_offset += chunk_size;
-                remaining -= chunk_size;
-            }
+#if TLV_SCRUB_AUTO_REPAIR
+    const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
+    if (!meta || !meta->backup_enable || tlv_core_txn_ctx.is_active ||
+        !TLV_IS_SIZE_SAFE(&tlv_core_ctx, entry->data_addr, sizeof(tlv_data_block_header_t)))
+    {
+        return TLV_OK;
+    }
+
+    tlv_data_block_header_t header;
+    int ret = tlv_core_ctx.ops->read(entry->data_addr, &header, sizeof(header));
+    if (ret != TLV_OK || header.tag != tag)
+    {
+        return ret;
+    }
+
+    // 本段已结束,静态缓冲区可用于暂存修复数据
+    uint8_t *data = tlv_core_ctx.static_buffer;
+    uint16_t len = TLV_BUFFER_SIZE;
+
+    // 压缩块按原始数据重写会变长,校验镜像副本后原样复制回主块
+    if (header.flags & TLV_BLOCK_FLAG_COMPRESSED)
+    {
+        ret = mirror_read(&header, data, &len);
+        if (ret == TLV_OK)
+        {
+            ret = tlv_core_copy_block(mirror_slot_addr(tag), entry->data_addr, TLV_BLOCK_SIZE(header.length));
+        }
+        if (ret == TLV_OK)
+        {
+            result->repaired++;
+        }
+        return TLV_OK;
+    }
+
+    ret = tlv_core_ram_cache_read(tag, data, &len);
+    if (ret != TLV_OK)
+    {
+        len = TLV_BUFFER_SIZE;
+        ret = mirror_read(&header, data, &len);
+    }
+    if (ret != TLV_OK || len != header.length)
+    {
+        return TLV_OK;
+    }
+
+    ret = tlv_write_unlocked(tag, data, len);
+    if (ret != TLV_OK)
+    {
+        tlv_printf("WARNING: Tag 0x%04X scrub repair failed (err: %d)\n", tag, ret);
+        return TLV_OK;
+    }
+    result->repaired++;
+#endif
+
+    return TLV_OK;
+}
 
-            // 更新索引
-            entry->data_addr = write_pos;
-            entry->flags &= ~TLV_FLAG_DIRTY;
-        }
-        else if (entry->flags & TLV_FLAG_DIRTY)
+/* ============================ 私有函数：数据镜像============================ */
+/**
+ * @brief 是否有进行中的流式读写
+ */
+static bool stream_any_active(void)
+{
+    for (int i = 0; i < TLV_MAX_STREAM_HANDLES; i++)
+    {
+        if (g_stream_ctx.handles[i].state != TLV_STREAM_STATE_IDLE)
         {
-            entry->flags &= ~TLV_FLAG_DIRTY;
+            return true;
         }
-
-        write_pos += block_size;
-        total_used += block_size;
     }
 
-    // 更新系统Header
-    uint32_t region_size = TLV_BACKUP_ADDR - TLV_DATA_ADDR;
-    uint32_t new_allocated = total_used;
-    uint32_t new_free_space = (region_size > new_allocated) ? (region_size - new_allocated) : 0;
-
-    g_tlv_ctx.header->data_region_start = TLV_DATA_ADDR;
-    g_tlv_ctx.header->data_region_size = region_size;
-    g_tlv_ctx.header->tag_count = total_tags;
-    g_tlv_ctx.header->next_free_addr = write_pos;
-    g_tlv_ctx.header->free_space = new_free_space;
-    g_tlv_ctx.header->used_space = new_allocated;
-    g_tlv_ctx.header->fragment_count = 0;
-    g_tlv_ctx.header->fragment_size = 0;
+    return false;
+}
 
-    // 保存更新
-    ret = tlv_index_save(&g_tlv_ctx);
-    if (ret != TLV_OK)
-    {
-        return ret;
+/**
+ * @brief 把导入镜像中的一个数据块加入索引
+ * @param header 块Header
+ * @param addr 块在FRAM中的地址
+ * @param end 镜像数据在FRAM中的结束地址
+ * @return 0: 成功, TLV_ERROR_CORRUPTED: 块与元数据表不符、越界或Tag重复, 其他: 错误码
+ */
+static int image_block_add(const tlv_data_block_header_t *header, uint32_t addr, uint32_t end)
+{
+    // 块须属于本固件的元数据表,且存储形式可被本构建读取
+    const tlv_meta_const_t *meta = tlv_core_get_meta(header->tag);
+    bool is_log = (header->flags & TLV_BLOCK_FLAG_LOG) != 0;
+    if (!meta || header->length > meta->max_length || TLV_BLOCK_SIZE(header->length) > end - addr ||
+        is_log != (meta->log_record_size != 0) ||
+        ((header->flags & TLV_BLOCK_FLAG_COMPRESSED) && !meta_compressible(meta)) ||
+        tlv_index_find(&tlv_core_ctx, header->tag))
+    {
+        tlv_printf("ERROR: Image block 0x%04X at 0x%08lX rejected\n", header->tag, (unsigned long)addr);
+        return TLV_ERROR_CORRUPTED;
     }
-    ret = system_header_save();
-    if (ret != TLV_OK)
+
+    tlv_index_entry_t *entry = tlv_index_add(&tlv_core_ctx, header->tag, addr);
+    if (!entry)
     {
-        return ret;
+        return TLV_ERROR_NO_INDEX_SPACE;
     }
-    // 整理完成后备份区域同步
-    ret = tlv_backup_all_internal();
-    return ret;
+
+    // 保留块的数据版本,旧版本数据按正常流程迁移
+    entry->version = header->version;
+    tlv_core_block_info_set(entry, header->length, header->write_count);
+    return TLV_OK;
 }
 
+/* ============================ 私有函数：Tag镜像============================ */
 /**
- * @brief 校验所有数据
- * @param corrupted_count 输出损坏数量
- * @return 0: 成功, 其他: 错误码
+ * @brief 镜像区是否可用（已配置且存储区按含镜像区的布局格式化）
  */
-int tlv_verify_all(uint32_t *corrupted_count)
+static bool mirror_usable(void)
 {
-    if (!corrupted_count)
-    {
-        return TLV_ERROR_INVALID_PARAM;
-    }
+    return TLV_MIRROR_SIZE > 0 && tlv_core_ctx.header &&
+           tlv_core_ctx.header->data_region_size <= tlv_core_ctx.mirror_addr - TLV_DATA_ADDR;
+}
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+/**
+ * @brief 查找Tag的镜像槽位地址
+ * @return 槽位地址, 0表示该Tag不镜像
+ */
+static uint32_t mirror_slot_addr(uint16_t tag)
+{
+    if (!mirror_usable())
     {
-        return TLV_ERROR;
+        return 0;
     }
 
-    *corrupted_count = 0;
-
-    // 遍历索引表验证每个数据块
-    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    uint32_t slot_addr = tlv_core_ctx.mirror_addr;
+    for (uint16_t i = 0; i < tlv_core_ctx.meta_table_size; i++)
     {
-        tlv_index_entry_t *entry = &g_tlv_ctx.index_table->entries[i];
-
-        if (entry->tag == 0 || !(entry->flags & TLV_FLAG_VALID))
+        const tlv_meta_const_t *meta = &tlv_core_ctx.meta_table[i];
+        if (!meta->backup_enable || meta->log_record_size != 0)
         {
             continue;
         }
 
-        // 读取Header
-        tlv_data_block_header_t header;
-        int ret = tlv_port_fram_read(entry->data_addr, &header, sizeof(header));
-        if (ret != TLV_OK)
+        uint32_t slot_size = TLV_BLOCK_SIZE(meta->max_length);
+        if (slot_addr + slot_size > tlv_core_ctx.backup_addr)
         {
-            (*corrupted_count)++;
-            continue;
+            return 0;
         }
 
-        // 检查Tag匹配
-        if (header.tag != entry->tag)
+        if (meta->tag == tag)
         {
-            (*corrupted_count)++;
-            continue;
+            return slot_addr;
         }
+        slot_addr += slot_size;
+    }
 
-        // 读取数据并验证CRC（分批读取）
-        uint16_t crc = tlv_crc16_init();
-        crc = tlv_crc16_update(crc, &header, sizeof(header));
+    return 0;
+}
 
-        uint32_t remaining = header.length;
-        uint32_t offset = 0;
+/**
+ * @brief 同步单个镜像槽位：Tag已删除时作废槽位,块Header与镜像不一致时校验后复制整块
+ * @note 主块CRC校验失败时保留旧镜像
+ */
+static int mirror_sync_tag(const tlv_meta_const_t *meta, uint32_t slot_addr)
+{
+    tlv_data_block_header_t mirror_header;
+    int ret = tlv_core_ctx.ops->read(slot_addr, &mirror_header, sizeof(mirror_header));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
 
-        while (remaining > 0)
-        {
-            uint32_t chunk_size = (remaining > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : remaining;
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, meta->tag);
+    if (!index || !(index->flags & TLV_FLAG_VALID))
+    {
+        return (mirror_header.tag != 0) ? mirror_invalidate(slot_addr) : TLV_OK;
+    }
 
-            ret = tlv_port_fram_read(entry->data_addr + sizeof(header) + offset,
-                                     g_tlv_ctx.static_buffer, chunk_size);
-            if (ret != TLV_OK)
-            {
-                (*corrupted_count)++;
-                break;
-            }
+    // 块信息缓存命中时不访问主块
+    uint16_t length;
+    uint32_t write_count;
+    ret = tlv_core_get_block_info(index, &length, &write_count);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
 
-            crc = tlv_crc16_update(crc, g_tlv_ctx.static_buffer, chunk_size);
-            offset += chunk_size;
-            remaining -= chunk_size;
-        }
+    if (mirror_header.tag == meta->tag && mirror_header.length == length &&
+        mirror_header.write_count == write_count)
+    {
+        return TLV_OK;
+    }
+
+    uint32_t block_size = TLV_BLOCK_SIZE(length);
+    if (length > meta->max_length || !TLV_IS_SIZE_SAFE(&tlv_core_ctx, index->data_addr, block_size))
+    {
+        return TLV_OK;
+    }
 
+    if (block_size <= TLV_BUFFER_SIZE)
+    {
+        // 整块读入静态缓冲区,校验通过后一次写入
+        uint8_t *block = tlv_core_ctx.static_buffer;
+        ret = tlv_core_ctx.ops->read(index->data_addr, block, block_size);
         if (ret != TLV_OK)
         {
-            continue;
+            return ret;
         }
 
-        crc = tlv_crc16_final(crc);
-
-        // 读取存储的CRC
+        tlv_data_block_header_t header;
         uint16_t stored_crc;
-        ret = tlv_port_fram_read(entry->data_addr + sizeof(header) + header.length,
-                                 &stored_crc, sizeof(stored_crc));
-        if (ret != TLV_OK || crc != stored_crc)
+        memcpy(&header, block, sizeof(header));
+        memcpy(&stored_crc, block + block_size - sizeof(stored_crc), sizeof(stored_crc));
+        uint16_t calc_crc = tlv_crc16(block, block_size - sizeof(stored_crc));
+        if (header.tag != meta->tag || header.length != length || calc_crc != stored_crc)
         {
-            (*corrupted_count)++;
+            tlv_printf("WARNING: Tag 0x%04X corrupted, mirror kept\n", meta->tag);
+            return TLV_OK;
         }
+
+        return tlv_core_ctx.ops->write(slot_addr, block, block_size);
+    }
+
+    // 大块先分批校验再分批复制
+    uint16_t checked_length;
+    ret = tlv_core_check_block(index, true, &checked_length);
+    if (ret == TLV_ERROR_CRC_FAILED || ret == TLV_ERROR_CORRUPTED)
+    {
+        tlv_printf("WARNING: Tag 0x%04X corrupted, mirror kept\n", meta->tag);
+        return TLV_OK;
+    }
+    if (ret != TLV_OK)
+    {
+        return ret;
     }
 
-    return (*corrupted_count > 0) ? TLV_ERROR_CORRUPTED : TLV_OK;
+    return tlv_core_copy_block(index->data_addr, slot_addr, block_size);
 }
 
-/* ============================ 公开函数：对外备份接口（带状态检查）============================ */
 /**
- * @brief 备份所有数据到备份区
- * @return 0: 成功, 其他: 错误码
+ * @brief 读取与主块同一次写入的镜像副本
+ * @param main_header 主块Header（Tag已与索引一致）
+ * @param len 缓冲区大小（输入）,实际读取大小（输出）
+ * @return 0: 成功, 其他: 无可用镜像
  */
-int tlv_backup_all(void)
+static int mirror_read(const tlv_data_block_header_t *main_header, void *buf, uint16_t *len)
 {
-    // 对外接口：严格的状态检查
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED &&
-        g_tlv_ctx.state != TLV_STATE_FORMATTED)
+    uint32_t slot_addr = mirror_slot_addr(main_header->tag);
+    if (slot_addr == 0)
     {
-        return TLV_ERROR;
+        return TLV_ERROR_NOT_FOUND;
     }
 
-    // 调用内部函数
-    int ret = tlv_backup_all_internal();
+    tlv_data_block_header_t mirror_header;
+    int ret = read_block(slot_addr, main_header->tag, main_header->length, buf, len, &mirror_header);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
 
-    if (ret == TLV_OK)
+    if (mirror_header.tag != main_header->tag || mirror_header.length != main_header->length ||
+        mirror_header.write_count != main_header->write_count)
     {
-        // 更新备份时间
-        g_tlv_ctx.header->last_update_time = tlv_port_get_timestamp_s();
-        system_header_save();
+        return TLV_ERROR_NOT_FOUND;
     }
 
-    return ret;
+    return TLV_OK;
 }
+
 /**
- * @brief 从备份区恢复数据
- * @return 0: 成功, 其他: 错误码
+ * @brief 作废镜像槽位（清零块Header中的Tag）
  */
-int tlv_restore_from_backup(void)
+static int mirror_invalidate(uint32_t slot_addr)
+{
+    uint16_t tag = 0;
+    return tlv_core_ctx.ops->write(slot_addr + offsetof(tlv_data_block_header_t, tag), &tag, sizeof(tag));
+}
+
+/* ============================ 私有函数：事务日志============================ */
+/**
+ * @brief 清除事务日志（只写魔数）
+ */
+static int txn_log_clear(void)
+{
+    uint16_t magic = 0;
+    tlv_index_mark_backup_dirty(&tlv_core_ctx, TLV_TXN_LOG_ADDR + offsetof(tlv_txn_log_t, magic), sizeof(magic));
+    return tlv_core_ctx.ops->write(TLV_TXN_LOG_ADDR + offsetof(tlv_txn_log_t, magic),
+                               &magic, sizeof(magic));
+}
+
+/**
+ * @brief 补齐上次事务的发布：RAM中的索引与Header整体落盘后清除保留的事务日志
+ * @note 必须在任何新的修改之前完成,否则下次启动重放的旧日志会覆盖之后的修改
+ */
+static int txn_publish_settle(void)
 {
-    if (!g_tlv_ctx.header || !g_tlv_ctx.index_table)
+    if (!g_txn_publish_pending)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        return TLV_OK;
     }
 
-    int ret;
-    tlv_system_header_t backup_header;
-    // 读取备份Header
-    ret = tlv_port_fram_read(TLV_BACKUP_ADDR, &backup_header,
-                             sizeof(backup_header));
-    if (ret != TLV_OK)
+#if TLV_JOURNAL_ENABLE
+    tlv_core_journal_ctx.dirty_pages = UINT32_MAX;
+    int ret = tlv_core_journal_checkpoint();
+#else
+    int ret = tlv_index_save(&tlv_core_ctx);
+    if (ret == TLV_OK)
     {
-        return ret;
+        ret = tlv_core_system_header_save();
     }
-
-    // 验证备份Header
-    if (backup_header.magic != TLV_SYSTEM_MAGIC)
+#endif
+    if (ret == TLV_OK)
     {
-        tlv_printf("ERROR: Backup header magic invalid (0x%08lX)\n",
-                   (unsigned long)backup_header.magic);
-        return TLV_ERROR_CORRUPTED;
+        ret = txn_log_clear();
+    }
+    if (ret == TLV_OK)
+    {
+        g_txn_publish_pending = false;
     }
 
-    // 验证CRC
-    uint16_t calc_crc = tlv_crc16(&backup_header,
-                                  sizeof(backup_header) - sizeof(uint16_t));
-    if (calc_crc != backup_header.header_crc16)
+    return ret;
+}
+
+/**
+ * @brief 重放事务日志
+ *
+ * 日志有效说明事务已到达提交点但索引/Header可能未发布完成,重新发布日志中的索引条目。
+ * 重放是幂等的；next_free_addr与tag_count随后由system_header_reconcile()修正。
+ */
+static int txn_log_replay(void)
+{
+    tlv_txn_log_t *log = (tlv_txn_log_t *)tlv_core_ctx.static_buffer;
+    int ret = tlv_core_ctx.ops->read(TLV_TXN_LOG_ADDR, log, sizeof(tlv_txn_log_t));
+    if (ret != TLV_OK)
     {
-        tlv_printf("ERROR: Backup header CRC mismatch\n");
-        return TLV_ERROR_CORRUPTED;
+        return ret;
     }
 
-    // 验证数据合理性
-    if (backup_header.data_region_size !=
-        (TLV_BACKUP_ADDR - TLV_DATA_ADDR))
+    if (log->magic != TLV_TXN_LOG_MAGIC || log->count == 0 || log->count > TLV_MAX_TXN_ENTRIES ||
+        log->crc16 != tlv_crc16(log, offsetof(tlv_txn_log_t, crc16)))
     {
-        tlv_printf("ERROR: Backup header data size mismatch\n");
-        return TLV_ERROR_CORRUPTED;
+        return TLV_OK;
     }
 
-    // 计算备份区大小
-    uint32_t backup_size = TLV_DATA_REGION_SIZE;
+    tlv_printf("Replaying committed transaction (%u tags)\n", log->count);
+    tlv_core_block_info_invalidate_all();
 
-    // 分批恢复
-    uint32_t offset = 0;
-    while (offset < backup_size)
+    for (uint16_t i = 0; i < log->count; i++)
     {
-        uint32_t chunk_size = (backup_size - offset > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : (backup_size - offset);
-
-        // 读取备份区
-        ret = tlv_port_fram_read(TLV_BACKUP_ADDR + offset,
-                                 g_tlv_ctx.static_buffer, chunk_size);
-        if (ret != TLV_OK)
+        const tlv_index_entry_t *record = &log->records[i];
+        tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, record->tag);
+        if (index)
         {
-            return ret;
-        }
+            if (index->data_addr == record->data_addr)
+            {
+                continue;
+            }
 
-        // 写入管理区
-        ret = tlv_port_fram_write(TLV_HEADER_ADDR + offset,
-                                  g_tlv_ctx.static_buffer, chunk_size);
-        if (ret != TLV_OK)
+            tlv_index_update(&tlv_core_ctx, record->tag, record->data_addr);
+        }
+        else if (!tlv_index_add(&tlv_core_ctx, record->tag, record->data_addr))
         {
-            return ret;
+            return TLV_ERROR_CORRUPTED;
         }
-
-        offset += chunk_size;
     }
 
-    // 重新加载
-    ret = system_header_load();
+#if TLV_JOURNAL_ENABLE
+    // 重放结果随检查点落盘,提交日志中更早的记录随之失效,不会在下次启动时覆盖重放结果
+    tlv_core_journal_ctx.dirty_pages = UINT32_MAX;
+    ret = tlv_core_journal_checkpoint();
+#else
+    ret = tlv_index_save(&tlv_core_ctx);
+#endif
     if (ret != TLV_OK)
     {
         return ret;
     }
 
-    ret = tlv_index_load(&g_tlv_ctx);
-    return ret;
+    return txn_log_clear();
 }
 
-/* ============================ 空间管理API实现 ============================ */
+/* ============================ 私有函数：快照管理============================ */
 /**
- * @brief 获取可用空间
- * @param free_space 输出可用空间
- * @return 0: 成功, 其他: 错误码
+ * @brief 创建快照
  */
-int tlv_get_free_space(uint32_t *free_space)
+void tlv_core_transaction_snapshot_create(void)
 {
-    if (!free_space)
+    tlv_core_ctx.snapshot.next_free_addr = tlv_core_ctx.header->next_free_addr;
+    tlv_core_ctx.snapshot.used_space = tlv_core_ctx.header->used_space;
+    tlv_core_ctx.snapshot.free_space = tlv_core_ctx.header->free_space;
+    tlv_core_ctx.snapshot.fragment_count = tlv_core_ctx.header->fragment_count;
+    tlv_core_ctx.snapshot.fragment_size = tlv_core_ctx.header->fragment_size;
+    tlv_core_ctx.snapshot.tag_count = tlv_core_ctx.header->tag_count;
+#if TLV_FREE_EXTENT_REUSE
+    tlv_core_ctx.snapshot.free_list = g_free_list;
+#endif
+    tlv_core_ctx.snapshot.is_active = true;
+}
+
+/**
+ * @brief 回滚快照
+ */
+static void transaction_snapshot_rollback(void)
+{
+    if (tlv_core_ctx.snapshot.is_active)
+    {
+        tlv_core_ctx.header->next_free_addr = tlv_core_ctx.snapshot.next_free_addr;
+        tlv_core_ctx.header->used_space = tlv_core_ctx.snapshot.used_space;
+        tlv_core_ctx.header->free_space = tlv_core_ctx.snapshot.free_space;
+        tlv_core_ctx.header->fragment_count = tlv_core_ctx.snapshot.fragment_count;
+        tlv_core_ctx.header->fragment_size = tlv_core_ctx.snapshot.fragment_size;
+        tlv_core_ctx.header->tag_count = tlv_core_ctx.snapshot.tag_count;
+#if TLV_FREE_EXTENT_REUSE
+        g_free_list = tlv_core_ctx.snapshot.free_list;
+#endif
+        tlv_core_ctx.snapshot.is_active = false;
+    }
+}
+
+/**
+ * @brief 提交快照（清除快照标记）
+ */
+static void transaction_snapshot_commit(void)
+{
+    tlv_core_ctx.snapshot.is_active = false;
+}
+
+/**
+ * @brief 增加已使用空间
+ */
+static void increase_used_space(uint32_t size)
+{
+    tlv_core_ctx.header->used_space += size;
+}
+/**
+ * @brief 减少已使用空间
+ */
+void tlv_core_reduce_used_space(uint32_t size)
+{
+    tlv_core_ctx.header->used_space -= size;
+}
+
+/**
+ * @brief 释放不再被引用的数据块（调用者须保证索引已提交且不再指向该块）
+ * @param was_committed 块是否曾被已提交的索引引用。备份区的索引可能仍指向这样的块,
+ *        复用后从备份恢复会读到其他Tag的数据,因此在下次备份与管理区一致前不复用
+ */
+static void release_space(uint32_t addr, uint32_t size, bool was_committed)
+{
+    tlv_core_reduce_used_space(size);
+
+    // 增量整理期间释放的块不能作为搬移目标,直到备份区不再引用
+    if (tlv_core_defrag_ctx.is_active && was_committed)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        tlv_core_defrag_mark_vacated(addr, size);
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+#if TLV_FREE_EXTENT_REUSE
+    if (free_list_usable())
     {
-        return TLV_ERROR;
+        free_list_add(addr, size, was_committed && !g_free_list.backup_revoked);
+        free_list_sync_stats();
+        return;
     }
+#else
+    (void)addr;
+    (void)was_committed;
+#endif
 
-    *free_space = g_tlv_ctx.header->free_space;
-    return TLV_OK;
+    tlv_core_ctx.header->fragment_count++;
+    tlv_core_ctx.header->fragment_size += size;
 }
+
+/* ============================ 私有函数：空闲区段表============================ */
+
 /**
- * @brief 获取已用空间
- * @param used_space 输出已用空间
- * @return 0: 成功, 其他: 错误码
+ * @brief 空闲区段表是否可用于分配与回收
  */
-int tlv_get_used_space(uint32_t *used_space)
+static bool free_list_usable(void)
 {
-    if (!used_space)
+#if TLV_FREE_EXTENT_REUSE
+    return g_free_list.is_valid && !tlv_core_defrag_ctx.is_active;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 清空空闲区段表
+ * @param is_valid 清空后是否可用（格式化、整理完成后数据区无空洞）
+ */
+void tlv_core_free_list_reset(bool is_valid)
+{
+#if TLV_FREE_EXTENT_REUSE
+    memset(&g_free_list, 0, sizeof(g_free_list));
+    g_free_list.is_valid = is_valid;
+#else
+    (void)is_valid;
+#endif
+}
+
+/**
+ * @brief 由索引重建空闲区段表（按地址遍历有效块,块间空隙即为空洞）
+ * @param held 空洞暂不复用（备份区与索引是否一致未知,例如初始化时）
+ * @note 任一块信息无法读取时放弃重建,只从尾部分配
+ */
+void tlv_core_free_list_rebuild(bool held)
+{
+#if TLV_FREE_EXTENT_REUSE
+    tlv_core_free_list_reset(false);
+
+    uint32_t pos = TLV_DATA_ADDR;
+    const tlv_index_entry_t *entry;
+    while ((entry = tlv_core_find_next_block(pos)) != NULL)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        uint16_t length;
+        uint32_t write_count;
+        if (tlv_core_get_block_info(entry, &length, &write_count) != TLV_OK ||
+            entry->data_addr + TLV_BLOCK_SIZE(length) > tlv_core_ctx.header->next_free_addr)
+        {
+            tlv_core_free_list_reset(false);
+            return;
+        }
+
+        if (entry->data_addr > pos)
+        {
+            free_list_add(pos, entry->data_addr - pos, held);
+        }
+
+        pos = entry->data_addr + TLV_BLOCK_SIZE(length);
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    // 最后一个块之后的空隙直接退回尾部
+    if (tlv_core_ctx.header->next_free_addr > pos)
     {
-        return TLV_ERROR;
+        free_list_add(pos, tlv_core_ctx.header->next_free_addr - pos, held);
     }
 
-    *used_space = g_tlv_ctx.header->used_space;
-    return TLV_OK;
+    g_free_list.is_valid = true;
+    free_list_sync_stats();
+#else
+    (void)held;
+#endif
 }
-/**
- * @brief 计算碎片化程度
- * @param fragmentation_percent 输出碎片化百分比
- * @return 0: 成功, 其他: 错误码
+
+/**
+ * @brief 备份区与管理区一致后,放开上次备份以来释放的区段
+ * @note 表无效时由索引重建；事务、分段写入、异步写入与增量整理持有尚未进入索引的块,期间不重建
  */
-int tlv_calculate_fragmentation(uint32_t *fragmentation_percent)
+static void free_list_reclaim_held(void)
 {
-    if (!fragmentation_percent)
+#if TLV_FREE_EXTENT_REUSE
+    if (tlv_core_ctx.backup_dirty != 0)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        return;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (!g_free_list.is_valid &&
+        !(tlv_core_txn_ctx.is_active || tlv_core_has_active_write_stream() || tlv_core_async_busy() || tlv_core_defrag_ctx.is_active))
     {
-        return TLV_ERROR;
+        tlv_core_free_list_rebuild(false);
+        return;
     }
 
-    uint32_t allocated = g_tlv_ctx.header->next_free_addr - TLV_DATA_ADDR;
-    uint32_t used = g_tlv_ctx.header->used_space;
-    uint32_t wasted = allocated - used;
+    // 备份中的索引与当前索引一致,表中区段都不再被引用
+    g_free_list.backup_revoked = false;
+    free_list_unhold();
+#endif
+}
 
-    if (g_tlv_ctx.header->data_region_size > 0)
+/**
+ * @brief 尾部空间不足且不能整理时,使备份失效并放开暂不复用的区段
+ * @return true: 有区段被放开,可重新分配
+ */
+bool tlv_core_free_list_release_held(void)
+{
+#if TLV_FREE_EXTENT_REUSE
+    bool has_held = false;
+    for (uint16_t i = 0; i < g_free_list.count && !has_held; i++)
     {
-        *fragmentation_percent = (wasted * 100) / g_tlv_ctx.header->data_region_size;
+        has_held = g_free_list.extents[i].held;
     }
-    else
+
+    if (!has_held || backup_invalidate() != TLV_OK)
     {
-        *fragmentation_percent = 0;
+        return false;
     }
 
-    return TLV_OK;
+    tlv_printf("WARNING: Out of space, backup invalidated to reuse freed blocks\n");
+    g_free_list.backup_revoked = true;
+    free_list_unhold();
+    return true;
+#else
+    return false;
+#endif
 }
 
-/* ============================ 私有函数实现 ============================ */
-static int system_header_init(void)
+/**
+ * @brief 清除全部区段的暂不复用标记,合并相邻区段并退回紧邻尾部的区段
+ */
+static void free_list_unhold(void)
 {
-    if (!g_tlv_ctx.header)
+#if TLV_FREE_EXTENT_REUSE
+    uint16_t pos = 0;
+    while (pos < g_free_list.count)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        tlv_free_extent_t *ext = &g_free_list.extents[pos];
+        ext->held = false;
+        if (pos > 0 && g_free_list.extents[pos - 1].addr + g_free_list.extents[pos - 1].size == ext->addr)
+        {
+            g_free_list.extents[pos - 1].size += ext->size;
+            free_list_remove(pos);
+            continue;
+        }
+        pos++;
     }
 
-    memset(g_tlv_ctx.header, 0, sizeof(tlv_system_header_t));
-
-    g_tlv_ctx.header->magic = TLV_SYSTEM_MAGIC;
-    g_tlv_ctx.header->version = TLV_SYSTEM_VERSION;
-    g_tlv_ctx.header->tag_count = 0;
-    g_tlv_ctx.header->data_region_start = TLV_DATA_ADDR;
-    g_tlv_ctx.header->data_region_size = TLV_BACKUP_ADDR - TLV_DATA_ADDR;
-    g_tlv_ctx.header->next_free_addr = TLV_DATA_ADDR;
-    g_tlv_ctx.header->total_writes = 0;
-    g_tlv_ctx.header->last_update_time = tlv_port_get_timestamp_s();
-    g_tlv_ctx.header->free_space = g_tlv_ctx.header->data_region_size;
-    g_tlv_ctx.header->used_space = 0;
-    g_tlv_ctx.header->fragment_count = 0;
-
-    // 计算Header CRC16
-    g_tlv_ctx.header->header_crc16 = tlv_crc16(g_tlv_ctx.header,
-                                               sizeof(tlv_system_header_t) - sizeof(uint16_t));
+    if (g_free_list.count > 0)
+    {
+        tlv_free_extent_t *last = &g_free_list.extents[g_free_list.count - 1];
+        if (last->addr + last->size == tlv_core_ctx.header->next_free_addr)
+        {
+            tlv_core_ctx.header->next_free_addr = last->addr;
+            tlv_core_ctx.header->free_space += last->size;
+            free_list_remove(g_free_list.count - 1);
+        }
+    }
 
-    return TLV_OK;
+    free_list_sync_stats();
+#endif
 }
 
-static int system_header_load(void)
+/**
+ * @brief 从空闲区段表分配空间（最佳适配,从区段起始处切分）
+ * @return 分配的地址,0表示没有足够大的空洞
+ */
+static uint32_t free_list_alloc(uint32_t size)
 {
-    if (!g_tlv_ctx.header)
+#if TLV_FREE_EXTENT_REUSE
+    int best = -1;
+    for (uint16_t i = 0; i < g_free_list.count; i++)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        const tlv_free_extent_t *ext = &g_free_list.extents[i];
+        if (!ext->held && ext->size >= size && (best < 0 || ext->size < g_free_list.extents[best].size))
+        {
+            best = i;
+            if (ext->size == size)
+            {
+                break;
+            }
+        }
     }
 
-    // 从FRAM读取Header
-    int ret = tlv_port_fram_read(TLV_HEADER_ADDR, g_tlv_ctx.header,
-                                 sizeof(tlv_system_header_t));
-    if (ret != TLV_OK)
+    if (best < 0)
     {
-        return ret;
+        return 0;
     }
 
-    // 校验Header
-    return system_header_verify();
-}
-
-static int system_header_save(void)
-{
-    if (!g_tlv_ctx.header)
+    tlv_free_extent_t *ext = &g_free_list.extents[best];
+    uint32_t addr = ext->addr;
+    ext->addr += size;
+    ext->size -= size;
+    if (ext->size == 0)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        free_list_remove((uint16_t)best);
     }
 
-    // 重新计算CRC
-    g_tlv_ctx.header->header_crc16 = tlv_crc16(g_tlv_ctx.header,
-                                               sizeof(tlv_system_header_t) - sizeof(uint16_t));
-
-    // 写入FRAM
-    return tlv_port_fram_write(TLV_HEADER_ADDR, g_tlv_ctx.header,
-                               sizeof(tlv_system_header_t));
+    return addr;
+#else
+    (void)size;
+    return 0;
+#endif
 }
 
-static int system_header_verify(void)
+/**
+ * @brief 向空闲区段表加入区段,与相邻的同类区段合并；紧邻尾部时退回next_free_addr
+ * @param held 暂不复用（备份区的索引可能仍引用,不退回尾部）
+ * @note 表满时丢弃最小区段,被丢弃的空间仍计入fragment_size,由碎片整理回收
+ */
+static void free_list_add(uint32_t addr, uint32_t size, bool held)
 {
-    if (!g_tlv_ctx.header)
+#if TLV_FREE_EXTENT_REUSE
+    if (size == 0)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        return;
     }
 
-    // 检查魔数
-    if (g_tlv_ctx.header->magic != TLV_SYSTEM_MAGIC)
+    // 按地址查找插入位置
+    uint16_t pos = 0;
+    while (pos < g_free_list.count && g_free_list.extents[pos].addr < addr)
     {
-        return TLV_ERROR_CORRUPTED;
+        pos++;
     }
 
-    // 检查版本兼容性,主版本必须相同,当前子版本大于文件系统版本
-    if (!tlv_version_compatible(TLV_SYSTEM_VERSION, g_tlv_ctx.header->version))
+    tlv_free_extent_t *prev = (pos > 0) ? &g_free_list.extents[pos - 1] : NULL;
+    tlv_free_extent_t *next = (pos < g_free_list.count) ? &g_free_list.extents[pos] : NULL;
+
+    if (prev && prev->held == held && prev->addr + prev->size == addr)
     {
-        return TLV_ERROR_VERSION;
+        // 与前一区段合并,可能同时与后一区段相接
+        prev->size += size;
+        if (next && next->held == held && prev->addr + prev->size == next->addr)
+        {
+            prev->size += next->size;
+            free_list_remove(pos);
+        }
+        pos--;
     }
-
-    // 校验CRC16
-    uint16_t calc_crc = tlv_crc16(g_tlv_ctx.header,
-                                  sizeof(tlv_system_header_t) - sizeof(uint16_t));
-
-    if (calc_crc != g_tlv_ctx.header->header_crc16)
+    else if (next && next->held == held && addr + size == next->addr)
     {
-        return TLV_ERROR_CRC_FAILED;
+        next->addr = addr;
+        next->size += size;
     }
+    else
+    {
+        if (g_free_list.count >= TLV_MAX_FREE_EXTENTS)
+        {
+            // 表满,丢弃最小区段（可能就是新区段本身）
+            uint16_t smallest = 0;
+            for (uint16_t i = 1; i < g_free_list.count; i++)
+            {
+                if (g_free_list.extents[i].size < g_free_list.extents[smallest].size)
+                {
+                    smallest = i;
+                }
+            }
 
-    return TLV_OK;
-}
+            if (g_free_list.extents[smallest].size >= size &&
+                (held || addr + size != tlv_core_ctx.header->next_free_addr))
+            {
+                return;
+            }
 
-static uint32_t allocate_space(uint32_t size)
-{
-    if (!g_tlv_ctx.header)
-    {
-        return 0;
-    }
+            free_list_remove(smallest);
+            if (smallest < pos)
+            {
+                pos--;
+            }
+        }
 
-    uint32_t addr = g_tlv_ctx.header->next_free_addr;
-    uint32_t end_addr = TLV_DATA_ADDR + g_tlv_ctx.header->data_region_size;
+        memmove(&g_free_list.extents[pos + 1], &g_free_list.extents[pos],
+                (g_free_list.count - pos) * sizeof(tlv_free_extent_t));
+        g_free_list.extents[pos].addr = addr;
+        g_free_list.extents[pos].size = size;
+        g_free_list.extents[pos].held = held;
+        g_free_list.count++;
+    }
 
-    if (addr + size > end_addr)
+    // 区段到达尾部：退回next_free_addr
+    tlv_free_extent_t *ext = &g_free_list.extents[pos];
+    if (!ext->held && ext->addr + ext->size == tlv_core_ctx.header->next_free_addr)
     {
-        return 0;
+        tlv_core_ctx.header->next_free_addr = ext->addr;
+        tlv_core_ctx.header->free_space += ext->size;
+        free_list_remove(pos);
     }
+#else
+    (void)addr;
+    (void)size;
+    (void)held;
+#endif
+}
 
-    g_tlv_ctx.header->next_free_addr += size;
-    g_tlv_ctx.header->used_space += size;
-    g_tlv_ctx.header->free_space -= size;
+/**
+ * @brief 移除指定位置的区段
+ */
+static void free_list_remove(uint16_t pos)
+{
+#if TLV_FREE_EXTENT_REUSE
+    g_free_list.count--;
+    memmove(&g_free_list.extents[pos], &g_free_list.extents[pos + 1],
+            (g_free_list.count - pos) * sizeof(tlv_free_extent_t));
+#else
+    (void)pos;
+#endif
+}
 
-    return addr;
+/**
+ * @brief 按空闲区段表刷新Header中的碎片统计
+ */
+static void free_list_sync_stats(void)
+{
+#if TLV_FREE_EXTENT_REUSE
+    tlv_system_header_t *hdr = tlv_core_ctx.header;
+    uint32_t allocated = hdr->next_free_addr - TLV_DATA_ADDR;
+    hdr->fragment_count = g_free_list.count;
+    hdr->fragment_size = (allocated > hdr->used_space) ? (allocated - hdr->used_space) : 0;
+#endif
 }
 
-static int write_data_block(uint16_t tag, const void *data, uint16_t len, uint32_t addr)
+#if TLV_PERF_STATS
+/* ============================ 私有函数：性能统计============================ */
+
+/**
+ * @brief 记录一次操作的耗时
+ * @param start 操作开始时的tick
+ * @param ret 操作返回值（<0计为错误）
+ */
+void tlv_core_perf_record(tlv_perf_op_t op, uint32_t start, int ret)
 {
-    const tlv_meta_const_t *meta = get_meta(tag);
+    uint32_t ticks = tlv_port_get_perf_tick() - start;
 
-    // 构建数据块Header
-    tlv_data_block_header_t header = {0};
-    header.tag = tag;
-    header.length = len;
-    header.version = meta ? meta->version : 1;
-    header.flags = 0;
-    header.timestamp = tlv_port_get_timestamp_s();
+    // 桶i覆盖[2^(i-1), 2^i)
+    uint32_t bucket = 0;
+    while (bucket < TLV_PERF_HIST_BUCKETS - 1 && (ticks >> bucket) != 0)
+    {
+        bucket++;
+    }
 
-    // 读取旧的write_count（如果存在）
-    tlv_data_block_header_t old_header;
-    if (tlv_port_fram_read(addr, &old_header, sizeof(old_header)) == TLV_OK &&
-        old_header.tag == tag)
+    TLV_CRITICAL_ENTER();
+    tlv_perf_op_stats_t *s = &g_perf_stats.ops[op];
+    if (s->count == 0 || ticks < s->min_ticks)
     {
-        header.write_count = old_header.write_count + 1;
+        s->min_ticks = ticks;
     }
-    else
+    if (ticks > s->max_ticks)
     {
-        header.write_count = 1;
+        s->max_ticks = ticks;
     }
-
-    // 计算CRC16（Header + Data）
-    uint16_t crc = tlv_crc16_init();
-    crc = tlv_crc16_update(crc, &header, sizeof(header));
-    crc = tlv_crc16_update(crc, data, len);
-    crc = tlv_crc16_final(crc);
-
-    // 写入FRAM：Header -> Data -> CRC16
-    int ret = tlv_port_fram_write(addr, &header, sizeof(header));
-    if (ret != TLV_OK)
+    s->count++;
+    s->total_ticks += ticks;
+    s->histogram[bucket]++;
+    if (ret < 0)
     {
-        return ret;
+        s->errors++;
     }
+    TLV_CRITICAL_EXIT();
+}
 
-    ret = tlv_port_fram_write(addr + sizeof(header), data, len);
-    if (ret != TLV_OK)
+/**
+ * @brief 累计端口传输字节数
+ */
+static void perf_count_bytes(bool is_write, uint32_t size)
+{
+    TLV_CRITICAL_ENTER();
+    if (is_write)
     {
-        return ret;
+        g_perf_stats.bytes_written += size;
+    }
+    else
+    {
+        g_perf_stats.bytes_read += size;
     }
+    TLV_CRITICAL_EXIT();
+}
 
-    ret = tlv_port_fram_write(addr + sizeof(header) + len, &crc, sizeof(crc));
-    return ret;
+static int perf_port_init(void)
+{
+    return g_perf_port->init ? g_perf_port->init() : TLV_OK;
 }
 
-int read_data_block(uint32_t addr, void *buf, uint16_t *len)
+static int perf_port_read(uint32_t addr, void *data, uint32_t size)
 {
-    // 读取Header
-    tlv_data_block_header_t header;
-    int ret = tlv_port_fram_read(addr, &header, sizeof(header));
-    if (ret != TLV_OK)
+    TLV_PERF_BEGIN();
+    int ret = g_perf_port->read(addr, data, size);
+    TLV_PERF_END(TLV_PERF_OP_PORT_READ, ret);
+    if (ret == TLV_OK)
     {
-        return ret;
+        perf_count_bytes(false, size);
     }
+    return ret;
+}
 
-    // 检查长度
-    if (header.length > *len)
+static int perf_port_write(uint32_t addr, const void *data, uint32_t size)
+{
+    TLV_PERF_BEGIN();
+    int ret = g_perf_port->write(addr, data, size);
+    TLV_PERF_END(TLV_PERF_OP_PORT_WRITE, ret);
+    if (ret == TLV_OK)
     {
-        return TLV_ERROR_NO_BUFFER_MEMORY;
+        perf_count_bytes(true, size);
     }
+    return ret;
+}
 
-    // 读取数据
-    ret = tlv_port_fram_read(addr + sizeof(header), buf, header.length);
-    if (ret != TLV_OK)
+#if TLV_PORT_VECTOR_IO
+/**
+ * @brief 计算分散/聚集传输的总字节数
+ */
+static uint32_t perf_iov_size(const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < iovcnt; i++)
     {
-        return ret;
+        size += iov[i].size;
     }
+    return size;
+}
 
-    // 读取CRC16
-    uint16_t stored_crc;
-    ret = tlv_port_fram_read(addr + sizeof(header) + header.length, &stored_crc, sizeof(stored_crc));
-    if (ret != TLV_OK)
+static int perf_port_writev(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+    TLV_PERF_BEGIN();
+    int ret = g_perf_port->writev(addr, iov, iovcnt);
+    TLV_PERF_END(TLV_PERF_OP_PORT_WRITE, ret);
+    if (ret == TLV_OK)
     {
-        return ret;
+        perf_count_bytes(true, perf_iov_size(iov, iovcnt));
     }
+    return ret;
+}
 
-    // 校验CRC16
-    uint16_t calc_crc = tlv_crc16_init();
-    calc_crc = tlv_crc16_update(calc_crc, &header, sizeof(header));
-    calc_crc = tlv_crc16_update(calc_crc, buf, header.length);
-    calc_crc = tlv_crc16_final(calc_crc);
-
-    if (calc_crc != stored_crc)
+static int perf_port_readv(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+    TLV_PERF_BEGIN();
+    int ret = g_perf_port->readv(addr, iov, iovcnt);
+    TLV_PERF_END(TLV_PERF_OP_PORT_READ, ret);
+    if (ret == TLV_OK)
     {
-        return TLV_ERROR_CRC_FAILED;
+        perf_count_bytes(false, perf_iov_size(iov, iovcnt));
     }
-
-    *len = header.length;
-    return TLV_OK;
+    return ret;
 }
+#endif
 
-static const tlv_meta_const_t *get_meta(uint16_t tag)
+#if TLV_ASYNC_ENABLE
+// 异步传输只统计字节数（启动成功即计入）,耗时由调用者的轮询周期决定,不计时
+static int perf_port_read_async(uint32_t addr, void *data, uint32_t size, tlv_port_async_cb_t cb, void *arg)
 {
-    for (uint32_t i = 0; i < g_tlv_ctx.meta_table_size; i++)
+    int ret = g_perf_port->read_async(addr, data, size, cb, arg);
+    if (ret == TLV_OK)
     {
-        if (g_tlv_ctx.meta_table[i].tag == tag)
-        {
-            return &g_tlv_ctx.meta_table[i];
-        }
-        if (g_tlv_ctx.meta_table[i].tag == 0xFFFF)
-        {
-            break;
-        }
+        perf_count_bytes(false, size);
     }
-    return NULL;
+    return ret;
 }
 
-/* ============================ 私有函数：内部备份（无状态检查）============================ */
-static int tlv_backup_all_internal(void)
+static int perf_port_write_async(uint32_t addr, const void *data, uint32_t size, tlv_port_async_cb_t cb,
+                                 void *arg)
 {
-    if (!g_tlv_ctx.header || !g_tlv_ctx.index_table)
+    int ret = g_perf_port->write_async(addr, data, size, cb, arg);
+    if (ret == TLV_OK)
     {
-        return TLV_ERROR_INVALID_PARAM;
+        perf_count_bytes(true, size);
     }
+    return ret;
+}
+#endif
 
-    uint32_t backup_size = TLV_DATA_REGION_SIZE;
-    uint32_t offset = 0;
-    int ret = TLV_OK;
+/* ============================ 公开函数：性能统计============================ */
 
-    // 分批备份
-    while (offset < backup_size)
+int tlv_get_perf_stats(tlv_perf_stats_t *stats)
+{
+    if (!stats)
     {
-        uint32_t chunk_size = (backup_size - offset > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : (backup_size - offset);
-
-        // 读取管理区
-        ret = tlv_port_fram_read(TLV_HEADER_ADDR + offset,
-                                 g_tlv_ctx.static_buffer,
-                                 chunk_size);
-        if (ret != TLV_OK)
-        {
-            return ret;
-        }
+        return TLV_ERROR_INVALID_PARAM;
+    }
 
-        // 写入备份区
-        ret = tlv_port_fram_write(TLV_BACKUP_ADDR + offset,
-                                  g_tlv_ctx.static_buffer,
-                                  chunk_size);
-        if (ret != TLV_OK)
-        {
-            return ret;
-        }
+    // 逐项复制,临界区保持短小
+    for (int i = 0; i < TLV_PERF_OP_COUNT; i++)
+    {
+        TLV_CRITICAL_ENTER();
+        stats->ops[i] = g_perf_stats.ops[i];
+        TLV_CRITICAL_EXIT();
 
-        offset += chunk_size;
+        tlv_perf_op_stats_t *s = &stats->ops[i];
+        s->avg_ticks = s->count ? (uint32_t)(s->total_ticks / s->count) : 0;
     }
 
-    return TLV_OK;
-}
+    TLV_CRITICAL_ENTER();
+    stats->bytes_read = g_perf_stats.bytes_read;
+    stats->bytes_written = g_perf_stats.bytes_written;
+    TLV_CRITICAL_EXIT();
 
-/* ============================ 私有函数：快照管理============================ */
-/**
- * @brief 创建快照
- */
-static void transaction_snapshot_create(void)
-{
-    g_tlv_ctx.snapshot.next_free_addr = g_tlv_ctx.header->next_free_addr;
-    g_tlv_ctx.snapshot.used_space = g_tlv_ctx.header->used_space;
-    g_tlv_ctx.snapshot.free_space = g_tlv_ctx.header->free_space;
-    g_tlv_ctx.snapshot.fragment_count = g_tlv_ctx.header->fragment_count;
-    g_tlv_ctx.snapshot.fragment_size = g_tlv_ctx.header->fragment_size;
-    g_tlv_ctx.snapshot.tag_count = g_tlv_ctx.header->tag_count;
-    g_tlv_ctx.snapshot.is_active = true;
+    return TLV_OK;
 }
 
-/**
- * @brief 回滚快照
- */
-static void transaction_snapshot_rollback(void)
+void tlv_reset_perf_stats(void)
 {
-    if (g_tlv_ctx.snapshot.is_active)
+    for (int i = 0; i < TLV_PERF_OP_COUNT; i++)
     {
-        g_tlv_ctx.header->next_free_addr = g_tlv_ctx.snapshot.next_free_addr;
-        g_tlv_ctx.header->used_space = g_tlv_ctx.snapshot.used_space;
-        g_tlv_ctx.header->free_space = g_tlv_ctx.snapshot.free_space;
-        g_tlv_ctx.header->fragment_count = g_tlv_ctx.snapshot.fragment_count;
-        g_tlv_ctx.header->fragment_size = g_tlv_ctx.snapshot.fragment_size;
-        g_tlv_ctx.header->tag_count = g_tlv_ctx.snapshot.tag_count;
-        g_tlv_ctx.snapshot.is_active = false;
+        TLV_CRITICAL_ENTER();
+        memset(&g_perf_stats.ops[i], 0, sizeof(g_perf_stats.ops[i]));
+        TLV_CRITICAL_EXIT();
     }
-}
 
-/**
- * @brief 提交快照（清除快照标记）
- */
-static void transaction_snapshot_commit(void)
-{
-    g_tlv_ctx.snapshot.is_active = false;
+    TLV_CRITICAL_ENTER();
+    g_perf_stats.bytes_read = 0;
+    g_perf_stats.bytes_written = 0;
+    TLV_CRITICAL_EXIT();
 }
+#endif
+
+/* ============================ 流式操作私有函数 ============================ */
 
 /**
- * @brief 增加已使用空间
- */
-static void increase_used_space(uint32_t size)
-{
-    g_tlv_ctx.header->used_space += size;
-}
-/**
- * @brief 减少已使用空间
+ * @brief 是否有进行中的分段写入
  */
-static void reduce_used_space(uint32_t size)
+bool tlv_core_has_active_write_stream(void)
 {
-    g_tlv_ctx.header->used_space -= size;
-}
+    for (int i = 0; i < TLV_MAX_STREAM_HANDLES; i++)
+    {
+        if (g_stream_ctx.handles[i].state == TLV_STREAM_STATE_WRITING)
+        {
+            return true;
+        }
+    }
 
-/* ============================ 流式操作私有函数 ============================ */
+    return false;
+}
 
 /**
  * @brief 句柄索引转换为句柄
@@ -1769,14 +6584,40 @@ static tlv_stream_context_internal_t *validate_and_get_handle(
  * @brief 释放流句柄
  * @param handle 句柄
  */
-static void release_stream_handle(tlv_stream_handle_t handle)
+static void release_stream_handle(tlv_stream_handle_t handle)
+{
+    int index = handle_to_index(handle);
+    if (index >= 0 && index < TLV_MAX_STREAM_HANDLES)
+    {
+        memset(&g_stream_ctx.handles[index], 0, sizeof(tlv_stream_context_internal_t));
+    }
+}
+
+#if TLV_STREAM_BUFFER_SIZE > 0
+/**
+ * @brief 将写入暂存区的数据写入FRAM
+ * @param h 句柄
+ * @return TLV_OK: 成功, 其他: 错误码（暂存数据保留,可重试）
+ * @note current_offset 包含已暂存的数据,暂存数据位于 current_offset 之前
+ */
+static int stream_flush(tlv_stream_context_internal_t *h)
 {
-    int index = handle_to_index(handle);
-    if (index >= 0 && index < TLV_MAX_STREAM_HANDLES)
+    if (h->buf_len == 0)
     {
-        memset(&g_stream_ctx.handles[index], 0, sizeof(tlv_stream_context_internal_t));
+        return TLV_OK;
+    }
+
+    int ret = tlv_core_ctx.ops->write(h->data_addr + h->current_offset - h->buf_len, h->buf, h->buf_len);
+    if (ret != TLV_OK)
+    {
+        return ret;
     }
+
+    h->buf_len = 0;
+    return TLV_OK;
 }
+#endif
+
 /* ============================ 流式写入API ============================ */
 
 /**
@@ -1785,7 +6626,7 @@ static void release_stream_handle(tlv_stream_handle_t handle)
  * @param total_len 总数据长度
  * @return 写入句柄（TLV_INVALID_HANDLE 表示失败，通过 tlv_get_last_error() 获取错误码）
  */
-tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
+static tlv_stream_handle_t tlv_write_begin_unlocked(uint16_t tag, uint16_t total_len)
 {
     if (tag == 0 || total_len == 0)
     {
@@ -1793,28 +6634,45 @@ tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
         return TLV_STREAM_INVALID_HANDLE;
     }
 
-    if (!g_tlv_ctx.header || !g_tlv_ctx.index_table)
+    if (!tlv_core_ctx.header || !tlv_core_ctx.index_table)
     {
         TLV_TAG_ERROR(TLV_ERROR_INVALID_PARAM);
         return TLV_STREAM_INVALID_HANDLE;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
     {
         TLV_TAG_ERROR(TLV_ERROR);
         return TLV_STREAM_INVALID_HANDLE;
     }
 
+    // 事务、异步写入与分段写入共用快照,不能同时进行
+    if (tlv_core_txn_ctx.is_active || tlv_core_async_busy())
+    {
+        TLV_TAG_ERROR(TLV_ERROR_INVALID_STATE);
+        return TLV_STREAM_INVALID_HANDLE;
+    }
+
+    int settle_ret = tlv_core_fast_boot_settle();
+    if (settle_ret != TLV_OK)
+    {
+        TLV_TAG_ERROR(settle_ret);
+        return TLV_STREAM_INVALID_HANDLE;
+    }
+
     // 查找元数据
-    const tlv_meta_const_t *meta = get_meta(tag);
+    const tlv_meta_const_t *meta = tlv_core_get_meta(tag);
     if (!meta)
     {
         TLV_TAG_ERROR(TLV_ERROR_NOT_FOUND);
         return TLV_STREAM_INVALID_HANDLE;
     }
 
-    // 检查长度
-    if (total_len > meta->max_length)
+    // 分段写入可能原地覆盖旧块,缓存在写入期间失效
+    ram_cache_invalidate(tag);
+
+    // 检查长度,日志Tag只能追加
+    if (total_len > meta->max_length || meta->log_record_size != 0)
     {
         TLV_TAG_ERROR(TLV_ERROR_INVALID_PARAM);
         return TLV_STREAM_INVALID_HANDLE;
@@ -1832,24 +6690,26 @@ tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
     tlv_stream_context_internal_t *h = &g_stream_ctx.handles[idx];
 
     // 创建事务快照
-    transaction_snapshot_create();
+    tlv_core_transaction_snapshot_create();
 
     // 查找现有索引
-    tlv_index_entry_t *index = tlv_index_find(&g_tlv_ctx, tag);
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
     uint32_t target_addr;
     uint32_t old_block_size = 0;
     uint32_t new_block_size = TLV_BLOCK_SIZE(total_len);
-    bool need_add_index = false;
-    bool has_free_slot = g_tlv_ctx.header->tag_count < TLV_MAX_TAG_COUNT;
+    bool has_free_slot = tlv_core_ctx.header->tag_count < TLV_MAX_TAG_COUNT;
+
+    uint32_t write_count = 1;
 
     h->old_index = NULL;
     h->old_block_size = 0;
 
     if (index && (index->flags & TLV_FLAG_VALID))
     {
-        // 读取旧Header
-        tlv_data_block_header_t old_header;
-        int ret = tlv_port_fram_read(index->data_addr, &old_header, sizeof(old_header));
+        // 获取旧块信息（优先使用缓存）
+        uint16_t old_length;
+        uint32_t old_write_count;
+        int ret = tlv_core_get_block_info(index, &old_length, &old_write_count);
         if (ret != TLV_OK)
         {
             transaction_snapshot_rollback();
@@ -1858,28 +6718,31 @@ tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
             return TLV_STREAM_INVALID_HANDLE;
         }
 
-        old_block_size = TLV_BLOCK_SIZE(old_header.length);
-        h->old_version = old_header.version;
+        old_block_size = TLV_BLOCK_SIZE(old_length);
+        h->old_version = index->version;
+        write_count = old_write_count + 1;
+
+        // 累计写入次数达到迁移间隔时换址写入；提交日志模式下总是换址写入（同tlv_write）
+        bool in_place = !TLV_JOURNAL_ENABLE && new_block_size <= old_block_size;
+        uint32_t wear_addr = 0;
+        if ((in_place || TLV_JOURNAL_ENABLE) && wear_relocate_due(write_count))
+        {
+            wear_addr = allocate_space_wear(new_block_size);
+            in_place = in_place && (wear_addr == 0);
+        }
 
-        if (new_block_size <= old_block_size)
+        if (in_place)
         {
-            // 原地更新
+            // 原地更新,旧块即将被覆盖
             target_addr = index->data_addr;
-            reduce_used_space(old_block_size);
+            tlv_core_block_info_invalidate(index);
+            tlv_core_reduce_used_space(old_block_size);
             increase_used_space(new_block_size);
         }
         else
         {
-            // 需要重新分配
-            if (!has_free_slot)
-            {
-                transaction_snapshot_rollback();
-                release_stream_handle(handle);
-                TLV_TAG_ERROR(TLV_ERROR_NO_INDEX_SPACE);
-                return TLV_STREAM_INVALID_HANDLE;
-            }
-
-            target_addr = allocate_space(new_block_size);
+            // 需要重新分配数据空间（沿用原索引槽位）
+            target_addr = wear_addr ? wear_addr : tlv_core_allocate_space_or_compact(new_block_size);
             if (target_addr == 0)
             {
                 transaction_snapshot_rollback();
@@ -1888,7 +6751,6 @@ tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
                 return TLV_STREAM_INVALID_HANDLE;
             }
 
-            need_add_index = true;
             h->old_index = index;
             h->old_block_size = old_block_size;
         }
@@ -1904,7 +6766,7 @@ tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
             return TLV_STREAM_INVALID_HANDLE;
         }
 
-        target_addr = allocate_space(new_block_size);
+        target_addr = tlv_core_allocate_space_or_compact(new_block_size);
         if (target_addr == 0)
         {
             transaction_snapshot_rollback();
@@ -1912,8 +6774,6 @@ tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
             TLV_TAG_ERROR(TLV_ERROR_NO_MEMORY_SPACE);
             return TLV_STREAM_INVALID_HANDLE;
         }
-
-        need_add_index = true;
     }
 
     // 初始化句柄
@@ -1935,31 +6795,13 @@ tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
     header.version = meta->version;
     header.flags = 0;
     header.timestamp = tlv_port_get_timestamp_s();
-
-    // 读取旧的 write_count
-    if (!need_add_index && index)
-    {
-        tlv_data_block_header_t old_hdr;
-        if (tlv_port_fram_read(target_addr, &old_hdr, sizeof(old_hdr)) == TLV_OK &&
-            old_hdr.tag == tag)
-        {
-            header.write_count = old_hdr.write_count + 1;
-        }
-        else
-        {
-            header.write_count = 1;
-        }
-    }
-    else
-    {
-        header.write_count = 1;
-    }
+    header.write_count = write_count;
 
     // 更新 CRC
     h->crc16 = tlv_crc16_update(h->crc16, &header, sizeof(header));
 
     // 写入 Header
-    int ret = tlv_port_fram_write(target_addr, &header, sizeof(header));
+    int ret = tlv_core_ctx.ops->write(target_addr, &header, sizeof(header));
     if (ret != TLV_OK)
     {
         transaction_snapshot_rollback();
@@ -1976,6 +6818,14 @@ tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
     return handle;
 }
 
+tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
+{
+    TLV_WRITE_LOCK();
+    tlv_stream_handle_t ret = tlv_write_begin_unlocked(tag, total_len);
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
 /**
  * @brief 写入数据段
  * @param handle 写入句柄
@@ -1983,7 +6833,7 @@ tlv_stream_handle_t tlv_write_begin(uint16_t tag, uint16_t total_len)
  * @param len 数据长度
  * @return TLV_OK: 成功, 其他: 错误码
  */
-int tlv_write_chunk(tlv_stream_handle_t handle, const void *data, uint16_t len)
+static int tlv_write_chunk_unlocked(tlv_stream_handle_t handle, const void *data, uint16_t len)
 {
     tlv_stream_context_internal_t *h = validate_and_get_handle(handle, TLV_STREAM_STATE_WRITING);
     if (!h)
@@ -2007,8 +6857,64 @@ int tlv_write_chunk(tlv_stream_handle_t handle, const void *data, uint16_t len)
         return TLV_SET_ERROR(TLV_ERROR_INVALID_PARAM, tag);
     }
 
+#if TLV_STREAM_BUFFER_SIZE > 0
+    // 小数据段先合并到暂存区,攒满一整段再写入FRAM
+    const uint8_t *src = (const uint8_t *)data;
+    uint16_t remain = len;
+
+    while (remain > 0)
+    {
+        uint16_t n;
+        int ret;
+
+        if (h->buf_len == 0 && remain >= TLV_STREAM_BUFFER_SIZE)
+        {
+            // 暂存区为空且剩余数据足够大,直接写入
+            n = remain;
+            ret = tlv_core_ctx.ops->write(h->data_addr + h->current_offset, src, n);
+            if (ret == TLV_OK)
+            {
+                h->current_offset += n;
+            }
+        }
+        else
+        {
+            // 追加到暂存区,攒满一整段时写入（失败则撤销本次追加）
+            n = TLV_STREAM_BUFFER_SIZE - h->buf_len;
+            if (n > remain)
+            {
+                n = remain;
+            }
+            memcpy(&h->buf[h->buf_len], src, n);
+            h->buf_len += n;
+            h->current_offset += n;
+
+            ret = TLV_OK;
+            if (h->buf_len == TLV_STREAM_BUFFER_SIZE)
+            {
+                ret = stream_flush(h);
+                if (ret != TLV_OK)
+                {
+                    h->buf_len -= n;
+                    h->current_offset -= n;
+                }
+            }
+        }
+
+        if (ret != TLV_OK)
+        {
+            tlv_printf("ERROR: FRAM write failed at offset %u\n", h->current_offset);
+            return TLV_SET_ERROR(ret, tag);
+        }
+
+        h->crc16 = tlv_crc16_update(h->crc16, src, n);
+        h->processed_len += n;
+        src += n;
+        remain -= n;
+    }
+#else
     // 写入数据
-    int ret = tlv_port_fram_write(h->data_addr + h->current_offset, data, len);
+    int ret = tlv_core_ctx.ops->write(h->data_addr + h->current_offset, data, len);
     if (ret != TLV_OK)
     {
         tlv_printf("ERROR: FRAM write failed at offset %u\n", h->current_offset);
@@ -2021,6 +6927,7 @@ int tlv_write_chunk(tlv_stream_handle_t handle, const void *data, uint16_t len)
     // 更新状态
     h->current_offset += len;
     h->processed_len += len;
+#endif
 
 #if TLV_DEBUG
     tlv_printf("Write chunk: handle=0x%08X, len=%u, progress=%u/%u\n",
@@ -2030,12 +6937,20 @@ int tlv_write_chunk(tlv_stream_handle_t handle, const void *data, uint16_t len)
     return TLV_OK;
 }
 
+int tlv_write_chunk(tlv_stream_handle_t handle, const void *data, uint16_t len)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_write_chunk_unlocked(handle, data, len);
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
 /**
  * @brief 完成分段写入
  * @param handle 写入句柄
  * @return TLV_OK: 成功, 其他: 错误码
  */
-int tlv_write_end(tlv_stream_handle_t handle)
+static int tlv_write_end_unlocked(tlv_stream_handle_t handle)
 {
     tlv_stream_context_internal_t *h = validate_and_get_handle(handle, TLV_STREAM_STATE_WRITING);
     if (!h)
@@ -2057,51 +6972,64 @@ int tlv_write_end(tlv_stream_handle_t handle)
     // 完成 CRC 计算
     uint16_t crc = tlv_crc16_final(h->crc16);
 
+#if TLV_STREAM_BUFFER_SIZE > 0
+    // CRC 尽量与最后一段暂存数据一并写入
+    int ret = TLV_OK;
+    if (h->buf_len + sizeof(crc) <= TLV_STREAM_BUFFER_SIZE)
+    {
+        memcpy(&h->buf[h->buf_len], &crc, sizeof(crc));
+        h->buf_len += sizeof(crc);
+        h->current_offset += sizeof(crc);
+        ret = stream_flush(h);
+    }
+    else
+    {
+        ret = stream_flush(h);
+        if (ret == TLV_OK)
+        {
+            ret = tlv_core_ctx.ops->write(h->data_addr + h->current_offset, &crc, sizeof(crc));
+        }
+    }
+#else
     // 写入 CRC
-    int ret = tlv_port_fram_write(h->data_addr + h->current_offset, &crc, sizeof(crc));
+    int ret = tlv_core_ctx.ops->write(h->data_addr + h->current_offset, &crc, sizeof(crc));
+#endif
     if (ret != TLV_OK)
     {
         tlv_printf("ERROR: CRC write failed\n");
         transaction_snapshot_rollback();
-        system_header_save();
+        tlv_core_system_header_save();
         release_stream_handle(handle);
         return TLV_SET_ERROR(ret, tag);
     }
 
     // 更新索引
-    tlv_index_entry_t *index = tlv_index_find(&g_tlv_ctx, h->tag);
-    bool need_add_index = (h->old_index != NULL);
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, h->tag);
 
-    if (need_add_index)
+    uint32_t old_addr = 0;
+    if (index)
     {
-        // 标记旧索引为脏
-        if (h->old_index && (h->old_index->flags & TLV_FLAG_VALID))
-        {
-            h->old_index->flags = TLV_FLAG_DIRTY;
-            reduce_used_space(h->old_block_size);
-            g_tlv_ctx.header->fragment_count++;
-            g_tlv_ctx.header->fragment_size += h->old_block_size;
-        }
+        old_addr = index->data_addr;
 
+        // 更新现有索引（沿用原槽位）
+        tlv_index_update(&tlv_core_ctx, h->tag, h->data_addr);
+    }
+    else
+    {
         // 添加新索引
-        tlv_index_entry_t *new_index = tlv_index_add(&g_tlv_ctx, h->tag, h->data_addr);
-        if (!new_index)
+        index = tlv_index_add(&tlv_core_ctx, h->tag, h->data_addr);
+        if (!index)
         {
             tlv_printf("CRITICAL: Index add failed\n");
             transaction_snapshot_rollback();
-            system_header_save();
+            tlv_core_system_header_save();
             release_stream_handle(handle);
             return TLV_SET_ERROR(TLV_ERROR_NO_INDEX_SPACE, tag);
         }
     }
-    else
-    {
-        // 更新现有索引
-        tlv_index_update(&g_tlv_ctx, h->tag, h->data_addr);
-    }
 
     // 保存索引
-    ret = tlv_index_save(&g_tlv_ctx);
+    ret = tlv_core_index_commit_entry(index, h->total_len);
     if (ret != TLV_OK)
     {
         tlv_printf("ERROR: Index save failed\n");
@@ -2109,14 +7037,20 @@ int tlv_write_end(tlv_stream_handle_t handle)
         return TLV_SET_ERROR(ret, tag);
     }
 
+    // 索引提交后旧块不再被引用,归还空闲空间
+    if (h->old_index && old_addr != 0)
+    {
+        release_space(old_addr, h->old_block_size, true);
+    }
+
     // 提交事务
     transaction_snapshot_commit();
 
     // 更新统计
-    g_tlv_ctx.header->total_writes++;
-    g_tlv_ctx.header->last_update_time = tlv_port_get_timestamp_s();
+    tlv_core_ctx.header->total_writes++;
+    tlv_core_ctx.header->last_update_time = tlv_port_get_timestamp_s();
 
-    ret = system_header_save();
+    ret = system_header_commit();
     if (ret != TLV_OK)
     {
         release_stream_handle(handle);
@@ -2131,29 +7065,26 @@ int tlv_write_end(tlv_stream_handle_t handle)
     // 释放句柄
     release_stream_handle(handle);
 
-    // 检查是否自动整理碎片
-#if TLV_AUTO_CLEAN_FRAGEMENT
-    uint32_t fragUsagePercent = 0;
-    ret = tlv_calculate_fragmentation(&fragUsagePercent);
-    if (ret == TLV_OK && fragUsagePercent >= TLV_AUTO_DEFRAG_THRESHOLD)
-    {
-        ret = tlv_defragment();
-        if (ret != TLV_OK)
-        {
-            tlv_printf("WARNING: Auto defragment failed: %d\n", ret);
-            TLV_SET_ERROR(ret, tag);
-        }
-    }
-#endif
+    // 按GC策略检查是否需要整理
+    tlv_core_gc_check();
 
     return TLV_OK;
 }
 
+int tlv_write_end(tlv_stream_handle_t handle)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_write_end_unlocked(handle);
+    tlv_core_gc_run_requested();
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
 /**
  * @brief 取消分段写入
  * @param handle 写入句柄
  */
-void tlv_write_abort(tlv_stream_handle_t handle)
+static void tlv_write_abort_unlocked(tlv_stream_handle_t handle)
 {
     tlv_stream_context_internal_t *h = validate_and_get_handle(handle, TLV_STREAM_STATE_WRITING);
     if (!h)
@@ -2166,17 +7097,24 @@ void tlv_write_abort(tlv_stream_handle_t handle)
 
     // 回滚事务
     transaction_snapshot_rollback();
-    system_header_save();
+    tlv_core_system_header_save();
 
     // 统计碎片
     uint32_t wasted_size = TLV_BLOCK_SIZE(h->total_len);
-    g_tlv_ctx.header->fragment_count++;
-    g_tlv_ctx.header->fragment_size += wasted_size;
+    tlv_core_ctx.header->fragment_count++;
+    tlv_core_ctx.header->fragment_size += wasted_size;
 
     // 释放句柄
     release_stream_handle(handle);
 }
 
+void tlv_write_abort(tlv_stream_handle_t handle)
+{
+    TLV_WRITE_LOCK();
+    tlv_write_abort_unlocked(handle);
+    TLV_WRITE_UNLOCK();
+}
+
 /* ============================ 流式读取API ============================ */
 
 /**
@@ -2185,7 +7123,7 @@ void tlv_write_abort(tlv_stream_handle_t handle)
  * @param total_len 输出总数据长度
  * @return 读取句柄（TLV_INVALID_HANDLE 表示失败）
  */
-tlv_stream_handle_t tlv_read_begin(uint16_t tag, uint16_t *total_len)
+static tlv_stream_handle_t tlv_read_begin_unlocked(uint16_t tag, uint16_t *total_len)
 {
     if (tag == 0 || !total_len)
     {
@@ -2193,14 +7131,14 @@ tlv_stream_handle_t tlv_read_begin(uint16_t tag, uint16_t *total_len)
         return TLV_STREAM_INVALID_HANDLE;
     }
 
-    if (g_tlv_ctx.state != TLV_STATE_INITIALIZED)
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
     {
         TLV_TAG_ERROR(TLV_ERROR);
         return TLV_STREAM_INVALID_HANDLE;
     }
 
     // 查找索引
-    tlv_index_entry_t *index = tlv_index_find(&g_tlv_ctx, tag);
+    tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, tag);
     if (!index || !(index->flags & TLV_FLAG_VALID))
     {
         TLV_TAG_ERROR(TLV_ERROR_NOT_FOUND);
@@ -2220,7 +7158,7 @@ tlv_stream_handle_t tlv_read_begin(uint16_t tag, uint16_t *total_len)
 
     // 读取 Header
     tlv_data_block_header_t header;
-    int ret = tlv_port_fram_read(index->data_addr, &header, sizeof(header));
+    int ret = tlv_core_ctx.ops->read(index->data_addr, &header, sizeof(header));
     if (ret != TLV_OK)
     {
         release_stream_handle(handle);
@@ -2238,6 +7176,14 @@ tlv_stream_handle_t tlv_read_begin(uint16_t tag, uint16_t *total_len)
         return TLV_STREAM_INVALID_HANDLE;
     }
 
+    // 日志块由tlv_log_read按记录读取
+    if (header.flags & TLV_BLOCK_FLAG_LOG)
+    {
+        release_stream_handle(handle);
+        TLV_TAG_ERROR(TLV_ERROR_INVALID_PARAM);
+        return TLV_STREAM_INVALID_HANDLE;
+    }
+
     // 初始化句柄
     h->tag = tag;
     h->data_addr = index->data_addr;
@@ -2246,21 +7192,62 @@ tlv_stream_handle_t tlv_read_begin(uint16_t tag, uint16_t *total_len)
     h->processed_len = 0;
     h->crc16 = tlv_crc16_init();
     h->crc16 = tlv_crc16_update(h->crc16, &header, sizeof(header));
+
+    // 压缩块按原始数据分段输出,句柄内保留解压窗口
+    if (header.flags & TLV_BLOCK_FLAG_COMPRESSED)
+    {
+#if TLV_COMPRESS_ENABLE
+        uint8_t prefix[TLV_LZ_HEADER_SIZE];
+        uint16_t consumed;
+        uint16_t produced;
+        ret = tlv_core_ctx.ops->read(index->data_addr + sizeof(header), prefix, sizeof(prefix));
+        if (ret == TLV_OK)
+        {
+            tlv_lz_decoder_init(&h->lz, h->lz_window);
+            ret = tlv_lz_decode(&h->lz, prefix, sizeof(prefix), &consumed, NULL, 0, &produced);
+        }
+        if (ret != TLV_OK || header.length < sizeof(prefix))
+        {
+            release_stream_handle(handle);
+            TLV_TAG_ERROR(ret != TLV_OK ? ret : TLV_ERROR_CORRUPTED);
+            return TLV_STREAM_INVALID_HANDLE;
+        }
+
+        h->compressed = true;
+        h->stored_len = header.length;
+        h->total_len = h->lz.raw_len;
+        h->current_offset += sizeof(prefix);
+        h->crc16 = tlv_crc16_update(h->crc16, prefix, sizeof(prefix));
+#else
+        release_stream_handle(handle);
+        TLV_TAG_ERROR(TLV_ERROR_INVALID_PARAM);
+        return TLV_STREAM_INVALID_HANDLE;
+#endif
+    }
+
     h->state = TLV_STREAM_STATE_READING;
 
     // 暂存chunk_tag
     g_chunk_tag[idx] = tag;
 
-    *total_len = header.length;
+    *total_len = h->total_len;
 
 #if TLV_DEBUG
     tlv_printf("Stream read begin: handle=0x%08X, tag=0x%04X, len=%u\n",
-               handle, tag, header.length);
+               handle, tag, h->total_len);
 #endif
 
     return handle;
 }
 
+tlv_stream_handle_t tlv_read_begin(uint16_t tag, uint16_t *total_len)
+{
+    TLV_WRITE_LOCK();
+    tlv_stream_handle_t ret = tlv_read_begin_unlocked(tag, total_len);
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
 /**
  * @brief 读取数据段
  * @param handle 读取句柄
@@ -2268,7 +7255,7 @@ tlv_stream_handle_t tlv_read_begin(uint16_t tag, uint16_t *total_len)
  * @param len 请求读取长度
  * @return 实际读取长度（>=0 成功，<0 错误码）
  */
-int tlv_read_chunk(tlv_stream_handle_t handle, void *buf, uint16_t *len)
+static int tlv_read_chunk_unlocked(tlv_stream_handle_t handle, void *buf, uint16_t *len)
 {
     tlv_stream_context_internal_t *h = validate_and_get_handle(handle, TLV_STREAM_STATE_READING);
     if (!h)
@@ -2296,12 +7283,74 @@ int tlv_read_chunk(tlv_stream_handle_t handle, void *buf, uint16_t *len)
         return TLV_OK;
     }
 
+#if TLV_COMPRESS_ENABLE
+    if (h->compressed)
+    {
+        int ret = stream_read_decode(h, (uint8_t *)buf, actual_len);
+        if (ret != TLV_OK)
+        {
+            return TLV_SET_ERROR(ret, tag);
+        }
+
+        h->processed_len += actual_len;
+        *len = actual_len;
+        return TLV_OK;
+    }
+#endif
+
+#if TLV_STREAM_BUFFER_SIZE > 0
+    // 优先从预读区取数据,预读区空时整段预读（最后一段连同CRC一起读入）
+    uint8_t *dst = (uint8_t *)buf;
+    uint16_t copied = 0;
+
+    while (copied < actual_len)
+    {
+        uint16_t want = actual_len - copied;
+        uint16_t avail = h->buf_len - h->buf_pos;
+
+        if (avail > 0)
+        {
+            uint16_t n = (want > avail) ? avail : want;
+            memcpy(&dst[copied], &h->buf[h->buf_pos], n);
+            h->buf_pos += n;
+            copied += n;
+            continue;
+        }
+
+        int ret;
+        if (want >= TLV_STREAM_BUFFER_SIZE)
+        {
+            // 请求足够大,直接读入用户缓冲区
+            ret = tlv_core_ctx.ops->read(h->data_addr + h->current_offset + copied, &dst[copied], want);
+            if (ret != TLV_OK)
+            {
+                return TLV_SET_ERROR(ret, tag);
+            }
+            copied += want;
+            continue;
+        }
+
+        uint32_t fetch = (uint32_t)(h->total_len - h->processed_len - copied) + sizeof(uint16_t);
+        if (fetch > TLV_STREAM_BUFFER_SIZE)
+        {
+            fetch = TLV_STREAM_BUFFER_SIZE;
+        }
+        ret = tlv_core_ctx.ops->read(h->data_addr + h->current_offset + copied, h->buf, fetch);
+        if (ret != TLV_OK)
+        {
+            return TLV_SET_ERROR(ret, tag);
+        }
+        h->buf_len = (uint16_t)fetch;
+        h->buf_pos = 0;
+    }
+#else
     // 读取数据
-    int ret = tlv_port_fram_read(h->data_addr + h->current_offset, buf, actual_len);
+    int ret = tlv_core_ctx.ops->read(h->data_addr + h->current_offset, buf, actual_len);
     if (ret != TLV_OK)
     {
         return TLV_SET_ERROR(ret, tag);
     }
+#endif
 
     h->crc16 = tlv_crc16_update(h->crc16, buf, actual_len);
     h->current_offset += actual_len;
@@ -2316,12 +7365,82 @@ int tlv_read_chunk(tlv_stream_handle_t handle, void *buf, uint16_t *len)
     return TLV_OK;
 }
 
+int tlv_read_chunk(tlv_stream_handle_t handle, void *buf, uint16_t *len)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_read_chunk_unlocked(handle, buf, len);
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
+#if TLV_COMPRESS_ENABLE
+/**
+ * @brief 从压缩块中解压出指定长度的原始数据
+ * @param dst 输出缓冲区
+ * @param len 需要输出的字节数（不超过剩余原始长度）
+ * @return 0: 成功, 其他: 错误码
+ * @note 压缩数据经static_buffer读入（流式读取持写锁）,只读入足够解压出len字节的量,
+ *       末尾不完整的匹配项留到下一次读取
+ */
+static int stream_read_decode(tlv_stream_context_internal_t *h, uint8_t *dst, uint16_t len)
+{
+    uint16_t done = 0;
+    uint32_t stored_end = sizeof(tlv_data_block_header_t) + h->stored_len;
+
+    while (done < len)
+    {
+        // 最坏情况每8字节字面量多1字节标志,匹配项总是比输出短
+        uint16_t need = len - done;
+        uint32_t in_len = stored_end - h->current_offset;
+        uint32_t bound = (uint32_t)need + need / 8 + 3;
+        if (in_len > bound)
+        {
+            in_len = bound;
+        }
+        if (in_len > TLV_BUFFER_SIZE)
+        {
+            in_len = TLV_BUFFER_SIZE;
+        }
+
+        if (in_len != 0)
+        {
+            int ret = tlv_core_ctx.ops->read(h->data_addr + h->current_offset, tlv_core_ctx.static_buffer, in_len);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+        }
+
+        uint16_t consumed;
+        uint16_t produced;
+        int ret = tlv_lz_decode(&h->lz, tlv_core_ctx.static_buffer, (uint16_t)in_len, &consumed, dst + done, need,
+                                &produced);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        // 压缩数据已耗尽仍无输出
+        if (consumed == 0 && produced == 0)
+        {
+            return TLV_ERROR_CORRUPTED;
+        }
+
+        h->crc16 = tlv_crc16_update(h->crc16, tlv_core_ctx.static_buffer, consumed);
+        h->current_offset += consumed;
+        done += produced;
+    }
+
+    return TLV_OK;
+}
+#endif
+
 /**
  * @brief 完成分段读取
  * @param handle 读取句柄
  * @return TLV_OK: 成功, 其他: 错误码
  */
-int tlv_read_end(tlv_stream_handle_t handle)
+static int tlv_read_end_unlocked(tlv_stream_handle_t handle)
 {
     tlv_stream_context_internal_t *h = validate_and_get_handle(handle, TLV_STREAM_STATE_READING);
     if (!h)
@@ -2340,9 +7459,31 @@ int tlv_read_end(tlv_stream_handle_t handle)
         return TLV_SET_ERROR(TLV_ERROR_INVALID_STATE, tag);
     }
 
+#if TLV_COMPRESS_ENABLE
+    // 压缩数据必须恰好耗尽
+    if (h->compressed && (h->current_offset != sizeof(tlv_data_block_header_t) + h->stored_len ||
+                          !tlv_lz_decode_done(&h->lz)))
+    {
+        release_stream_handle(handle);
+        return TLV_SET_ERROR(TLV_ERROR_CORRUPTED, tag);
+    }
+#endif
+
     // 读取存储的 CRC
     uint16_t stored_crc;
-    int ret = tlv_port_fram_read(h->data_addr + h->current_offset, &stored_crc, sizeof(stored_crc));
+    int ret = TLV_OK;
+#if TLV_STREAM_BUFFER_SIZE > 0
+    uint16_t avail = h->buf_len - h->buf_pos;
+    if (avail >= sizeof(stored_crc))
+    {
+        // 已随最后一段数据预读
+        memcpy(&stored_crc, &h->buf[h->buf_pos], sizeof(stored_crc));
+    }
+    else
+#endif
+    {
+        ret = tlv_core_ctx.ops->read(h->data_addr + h->current_offset, &stored_crc, sizeof(stored_crc));
+    }
     if (ret != TLV_OK)
     {
         tlv_printf("ERROR: CRC read failed\n");
@@ -2371,11 +7512,19 @@ int tlv_read_end(tlv_stream_handle_t handle)
     return TLV_OK;
 }
 
+int tlv_read_end(tlv_stream_handle_t handle)
+{
+    TLV_WRITE_LOCK();
+    int ret = tlv_read_end_unlocked(handle);
+    TLV_WRITE_UNLOCK();
+    return ret;
+}
+
 /**
  * @brief 取消分段读取
  * @param handle 读取句柄
  */
-void tlv_read_abort(tlv_stream_handle_t handle)
+static void tlv_read_abort_unlocked(tlv_stream_handle_t handle)
 {
     tlv_stream_context_internal_t *h = validate_and_get_handle(handle, TLV_STREAM_STATE_READING);
     if (!h)
@@ -2390,6 +7539,13 @@ void tlv_read_abort(tlv_stream_handle_t handle)
     release_stream_handle(handle);
 }
 
+void tlv_read_abort(tlv_stream_handle_t handle)
+{
+    TLV_WRITE_LOCK();
+    tlv_read_abort_unlocked(handle);
+    TLV_WRITE_UNLOCK();
+}
+
 /* ============================ 错误处理内部函数 ============================ */
 
 /**
@@ -2402,16 +7558,17 @@ void tlv_read_abort(tlv_stream_handle_t handle)
 static int tlv_set_last_error(int error_code, uint16_t tag,
                               uint32_t line, const char *function)
 {
+    uint32_t timestamp = tlv_port_get_timestamp_s();
+
+    // 读接口可能并发记录错误
+    TLV_CRITICAL_ENTER();
     g_last_error.error_code = error_code;
     g_last_error.tag = tag;
-    g_last_error.timestamp = tlv_port_get_timestamp_s();
+    g_last_error.timestamp = timestamp;
 
 #if TLV_DEBUG
     g_last_error.line = line;
     g_last_error.function = function;
-
-    tlv_printf("ERROR: code=%d, tag=0x%04X, at %s:%u\n",
-               error_code, tag, function ? function : "unknown", line);
 #else
     g_last_error.line = 0;
     g_last_error.function = NULL;
@@ -2421,6 +7578,15 @@ static int tlv_set_last_error(int error_code, uint16_t tag,
     // 保存到历史记录
     g_error_history[g_error_history_index] = g_last_error;
     g_error_history_index = (g_error_history_index + 1) % TLV_ERROR_HISTORY_SIZE;
+#endif
+    TLV_CRITICAL_EXIT();
+
+#if TLV_DEBUG
+    tlv_printf("ERROR: code=%d, tag=0x%04X, at %s:%u\n",
+               error_code, tag, function ? function : "unknown", line);
+#else
+    (void)line;
+    (void)function;
 #endif
     return error_code;
 }
@@ -2443,11 +7609,14 @@ int tlv_get_last_error(void)
  */
 int tlv_get_last_error_ex(tlv_error_context_t *error_ctx)
 {
+    TLV_CRITICAL_ENTER();
+    int error_code = g_last_error.error_code;
     if (error_ctx)
     {
         *error_ctx = g_last_error;
     }
-    return g_last_error.error_code;
+    TLV_CRITICAL_EXIT();
+    return error_code;
 }
 
 /**
@@ -2455,7 +7624,9 @@ int tlv_get_last_error_ex(tlv_error_context_t *error_ctx)
  */
 void tlv_clear_error(void)
 {
+    TLV_CRITICAL_ENTER();
     memset(&g_last_error, 0, sizeof(tlv_error_context_t));
+    TLV_CRITICAL_EXIT();
 }
 
 /**
@@ -2512,6 +7683,7 @@ int tlv_get_error_history(tlv_error_context_t *history, uint8_t *count)
     uint8_t actual_count = 0;
 
     // 从最新的错误开始复制
+    TLV_CRITICAL_ENTER();
     for (int i = 0; i < TLV_ERROR_HISTORY_SIZE && actual_count < max_count; i++)
     {
         int idx = (g_error_history_index - 1 - i + TLV_ERROR_HISTORY_SIZE) % TLV_ERROR_HISTORY_SIZE;
@@ -2521,6 +7693,7 @@ int tlv_get_error_history(tlv_error_context_t *history, uint8_t *count)
             history[actual_count++] = g_error_history[idx];
         }
     }
+    TLV_CRITICAL_EXIT();
 
     *count = actual_count;
     return TLV_OK;
@@ -2531,7 +7704,9 @@ int tlv_get_error_history(tlv_error_context_t *history, uint8_t *count)
  */
 void tlv_clear_error_history(void)
 {
+    TLV_CRITICAL_ENTER();
     memset(g_error_history, 0, sizeof(g_error_history));
     g_error_history_index = 0;
+    TLV_CRITICAL_EXIT();
 }
 #endif
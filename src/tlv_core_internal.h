@@ -0,0 +1,151 @@
+/**
+ * @file tlv_core_internal.h
+ * @brief TLV核心模块内部接口（tlv_core.c与拆分出的tlv_gc.c、tlv_journal.c、tlv_async.c共享,应用不应包含）
+ *
+ * 跨文件共享的函数与全局变量统一使用tlv_core_前缀,只在单个文件内使用的保持static。
+ */
+
+#ifndef TLV_CORE_INTERNAL_H
+#define TLV_CORE_INTERNAL_H
+
+#include "tlv_fram.h"
+#include "tlv_index.h"
+#include "tlv_port.h"
+#include "tlv_utils.h"
+#include "tlv_meta_table.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================ 共享上下文 ============================ */
+
+// 存储系统上下文（tlv_core.c）
+extern tlv_context_t tlv_core_ctx;
+// 事务上下文（tlv_core.c）
+extern tlv_txn_context_t tlv_core_txn_ctx;
+// 增量批量迁移上下文（tlv_core.c）
+extern tlv_migrate_context_t tlv_core_migrate_ctx;
+
+// 增量碎片整理上下文（tlv_gc.c）
+extern tlv_defrag_context_t tlv_core_defrag_ctx;
+// 同步整理次数（tlv_gc.c；整理占用static_buffer,写入路径据此判断其中的压缩数据是否需要重新生成）
+extern uint32_t tlv_core_sync_compactions;
+
+#if TLV_JOURNAL_ENABLE
+// 提交日志运行时状态（tlv_journal.c）
+extern tlv_journal_context_t tlv_core_journal_ctx;
+#endif
+
+/* ============================ 并发保护宏 ============================ */
+
+#if TLV_THREAD_SAFE
+/*
+ * 加锁规则：
+ * - 对外接口只在入口加一次锁,内部调用一律使用 *_unlocked 实现,不嵌套加锁
+ * - 读接口持共享锁,只允许修改块信息缓存、RAM缓存与错误记录,且必须位于临界区内
+ * - 读接口不能使用static_buffer,改用TLV_READ_SCRATCH声明的栈上临时缓冲区
+ */
+#define TLV_READ_LOCK()       tlv_port_read_lock()
+#define TLV_READ_UNLOCK()     tlv_port_read_unlock()
+#define TLV_WRITE_LOCK()      tlv_port_write_lock()
+#define TLV_WRITE_UNLOCK()    tlv_port_write_unlock()
+#define TLV_CRITICAL_ENTER()  tlv_port_enter_critical()
+#define TLV_CRITICAL_EXIT()   tlv_port_exit_critical()
+
+#define TLV_READ_SCRATCH(name) \
+    uint8_t name[TLV_READ_SCRATCH_SIZE]; \
+    const uint32_t name##_size = TLV_READ_SCRATCH_SIZE
+#else
+#define TLV_READ_LOCK()       ((void)0)
+#define TLV_READ_UNLOCK()     ((void)0)
+#define TLV_WRITE_LOCK()      ((void)0)
+#define TLV_WRITE_UNLOCK()    ((void)0)
+#define TLV_CRITICAL_ENTER()  ((void)0)
+#define TLV_CRITICAL_EXIT()   ((void)0)
+
+#define TLV_READ_SCRATCH(name) \
+    uint8_t *name = tlv_core_ctx.static_buffer; \
+    const uint32_t name##_size = TLV_BUFFER_SIZE
+#endif
+
+/* ============================ 性能统计宏 ============================ */
+
+#if TLV_PERF_STATS
+#define TLV_PERF_BEGIN()       uint32_t perf_start = tlv_port_get_perf_tick()
+#define TLV_PERF_END(op, ret)  tlv_core_perf_record((op), perf_start, (ret))
+#else
+#define TLV_PERF_BEGIN()       ((void)0)
+#define TLV_PERF_END(op, ret)  ((void)0)
+#endif
+
+/* ============================ 核心读写（tlv_core.c） ============================ */
+
+int tlv_core_flush_unlocked(void);
+int tlv_core_system_header_init(const tlv_geometry_t *geometry);
+int tlv_core_system_header_save(void);
+int tlv_core_index_commit_entry(const tlv_index_entry_t *entry, uint16_t length);
+uint32_t tlv_core_allocate_space(uint32_t size);
+void tlv_core_reduce_used_space(uint32_t size);
+int tlv_core_copy_block(uint32_t src, uint32_t dst, uint32_t size);
+const tlv_index_entry_t *tlv_core_find_next_block(uint32_t from);
+int tlv_core_get_block_info(const tlv_index_entry_t *entry, uint16_t *length, uint32_t *write_count);
+void tlv_core_block_info_set(const tlv_index_entry_t *entry, uint16_t length, uint32_t write_count);
+void tlv_core_block_info_invalidate(const tlv_index_entry_t *entry);
+void tlv_core_block_info_invalidate_all(void);
+int tlv_core_check_block(const tlv_index_entry_t *entry, bool verify_crc, uint16_t *length);
+int tlv_core_backup_all_internal(void);
+void tlv_core_transaction_snapshot_create(void);
+void tlv_core_free_list_reset(bool is_valid);
+void tlv_core_free_list_rebuild(bool held);
+bool tlv_core_free_list_release_held(void);
+bool tlv_core_has_active_write_stream(void);
+int tlv_core_fast_boot_settle(void);
+int tlv_core_read_unlocked(uint16_t tag, void *buf, uint16_t *len, bool allow_migrate);
+const tlv_meta_const_t *tlv_core_get_meta(uint16_t tag);
+int tlv_core_write_prepare(uint16_t tag, const void *data, uint16_t len, bool allow_in_place, bool allow_compress,
+                           tlv_write_plan_t *plan);
+int tlv_core_write_rollback(const tlv_write_plan_t *plan);
+int tlv_core_write_commit(const tlv_write_plan_t *plan, const void *data);
+uint16_t tlv_core_block_header_build(const tlv_meta_const_t *meta, const void *data, uint16_t len,
+                                     uint32_t write_count, uint8_t flags, tlv_data_block_header_t *header);
+uint16_t tlv_core_block_crc_length(const tlv_data_block_header_t *header);
+void tlv_core_block_info_mark_verified(const tlv_index_entry_t *entry);
+int tlv_core_ram_cache_read(uint16_t tag, void *buf, uint16_t *len);
+void tlv_core_ram_cache_store(const tlv_meta_const_t *meta, const void *data, uint16_t len);
+#if TLV_PERF_STATS
+void tlv_core_perf_record(tlv_perf_op_t op, uint32_t start, int ret);
+#endif
+
+/* ============================ GC与碎片整理（tlv_gc.c） ============================ */
+
+void tlv_core_gc_reset(void);
+void tlv_core_gc_check(void);
+void tlv_core_gc_run_requested(void);
+uint32_t tlv_core_allocate_space_or_compact(uint32_t size);
+int tlv_core_defrag_step_unlocked(uint32_t budget_bytes);
+void tlv_core_defrag_mark_vacated(uint32_t addr, uint32_t size);
+int tlv_core_space_stats_rebuild(uint32_t end);
+
+/* ============================ 提交日志（tlv_journal.c） ============================ */
+
+#if TLV_JOURNAL_ENABLE
+int tlv_core_journal_format(void);
+int tlv_core_journal_open(void);
+int tlv_core_journal_reset(void);
+int tlv_core_journal_append(const tlv_index_entry_t *slot, const tlv_index_entry_t *value, uint16_t length);
+int tlv_core_journal_replay(void);
+int tlv_core_journal_repair_index(void);
+int tlv_core_journal_checkpoint(void);
+#endif
+
+/* ============================ 异步操作（tlv_async.c） ============================ */
+
+bool tlv_core_async_busy(void);
+void tlv_core_async_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TLV_CORE_INTERNAL_H */
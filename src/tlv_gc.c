@@ -0,0 +1,806 @@
+/**
+ * @file tlv_gc.c
+ * @brief TLV FRAM存储系统GC策略与碎片整理（一次性整理、增量整理与分配失败时的同步整理）
+ */
+
+#include "tlv_core_internal.h"
+
+/* ============================ 全局静态变量 ============================ */
+// 增量碎片整理上下文
+tlv_defrag_context_t tlv_core_defrag_ctx = {0};
+// 同步整理次数（整理占用static_buffer,写入路径据此判断其中的压缩数据是否需要重新生成）
+uint32_t tlv_core_sync_compactions = 0;
+// GC策略触发次数（仅RAM,初始化时清零）与应用注册的GC回调
+static uint32_t g_gc_triggers = 0;
+static tlv_gc_callback_t g_gc_callback = NULL;
+static void *g_gc_user_data = NULL;
+
+/* ============================ 私有函数声明 ============================ */
+
+#if !TLV_THREAD_SAFE && !TLV_JOURNAL_ENABLE
+static int tlv_defragment_unlocked(void);
+static void sort_index_table_inplace(void);
+#endif
+static tlv_gc_action_t gc_decide(tlv_gc_reason_t reason, uint32_t required);
+static void gc_stats_fill(tlv_gc_stats_t *stats);
+static int defrag_move_block(tlv_index_entry_t *entry, uint32_t dst, uint16_t length, uint32_t write_count);
+static int defrag_finish(void);
+
+/* ============================ 维护管理API实现 ============================ */
+/**
+ * @brief 碎片整理
+ * @return 0: 成功, 其他: 错误码
+ * @note 清除无效的tag,按地址排序整理内存及索引。数据块原地搬移,中途掉电不安全,
+ *       线程安全模式与提交日志模式下改由增量整理分段完成
+ */
+#if !TLV_THREAD_SAFE && !TLV_JOURNAL_ENABLE
+static int tlv_defragment_unlocked(void)
+{
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    // 事务与异步操作中的数据块尚未进入索引,整理会覆盖它们
+    if (tlv_core_txn_ctx.is_active || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    int ret = tlv_core_fast_boot_settle();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 整理会重排索引槽位并移动数据块,进行中的增量整理作废
+    tlv_core_block_info_invalidate_all();
+    memset(&tlv_core_defrag_ctx, 0, sizeof(tlv_core_defrag_ctx));
+
+    uint32_t write_pos = TLV_DATA_ADDR;
+    uint32_t total_used = 0;
+    uint32_t total_tags = 0;
+
+    // 统计有效tag数量
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        if (entry->tag != 0 && (entry->flags & TLV_FLAG_VALID))
+        {
+            total_tags++;
+        }
+    }
+
+    tlv_printf("Valid tags: %lu\n", (unsigned long)total_tags);
+
+    if (total_tags == 0)
+    {
+        // 没有有效数据,清空（保留存储布局）
+        tlv_geometry_t geometry = tlv_core_ctx.header->geometry;
+        ret = tlv_core_system_header_init(&geometry);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+        ret = tlv_index_init(&tlv_core_ctx);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        // 保存Header和索引表
+        ret = tlv_core_system_header_save();
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        ret = tlv_index_save(&tlv_core_ctx);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        // 备份管理区
+        ret = tlv_core_backup_all_internal();
+        return ret;
+    }
+
+    // 1. 先备份当前管理区到备份区
+    ret = tlv_core_backup_all_internal();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 原地排序索引表
+    sort_index_table_inplace();
+
+    total_tags = 0;
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        if (tlv_core_ctx.index_table->entries[i].tag != 0 &&
+            (tlv_core_ctx.index_table->entries[i].flags & TLV_FLAG_VALID))
+        {
+            total_tags++;
+        }
+        else
+        {
+            break; // 已压缩,后面都是空的
+        }
+    }
+
+    // 遍历所有有效Tag,移动数据块
+    for (int i = 0; i < total_tags; i++)
+    {
+        tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+
+        if (entry->tag == 0 || !(entry->flags & TLV_FLAG_VALID))
+        {
+            continue;
+        }
+
+        // 读取数据块Header
+        tlv_data_block_header_t header;
+        ret = tlv_core_ctx.ops->read(entry->data_addr, &header, sizeof(header));
+        if (ret != TLV_OK)
+        {
+            continue;
+        }
+
+        uint32_t block_size = sizeof(header) + header.length + sizeof(uint16_t);
+
+        // 如果不在紧凑位置,移动它
+        if (entry->data_addr != write_pos)
+        {
+            // 使用静态缓冲区分批读写
+            ret = tlv_core_copy_block(entry->data_addr, write_pos, block_size);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+
+            // 更新索引
+            entry->data_addr = write_pos;
+            entry->flags &= ~TLV_FLAG_DIRTY;
+        }
+        else if (entry->flags & TLV_FLAG_DIRTY)
+        {
+            entry->flags &= ~TLV_FLAG_DIRTY;
+        }
+
+        write_pos += block_size;
+        total_used += block_size;
+    }
+
+    // 更新系统Header
+    uint32_t region_size = tlv_core_ctx.header->data_region_size;
+    uint32_t new_allocated = total_used;
+    uint32_t new_free_space = (region_size > new_allocated) ? (region_size - new_allocated) : 0;
+
+    tlv_core_ctx.header->data_region_start = TLV_DATA_ADDR;
+    tlv_core_ctx.header->data_region_size = region_size;
+    tlv_core_ctx.header->tag_count = total_tags;
+    tlv_core_ctx.header->next_free_addr = write_pos;
+    tlv_core_ctx.header->free_space = new_free_space;
+    tlv_core_ctx.header->used_space = new_allocated;
+    tlv_core_ctx.header->fragment_count = 0;
+    tlv_core_ctx.header->fragment_size = 0;
+    tlv_core_free_list_reset(true);
+
+    // 保存更新
+    ret = tlv_index_save(&tlv_core_ctx);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+    ret = tlv_core_system_header_save();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+    // 整理完成后备份区域同步
+    ret = tlv_core_backup_all_internal();
+    return ret;
+}
+#endif
+
+int tlv_defragment(void)
+{
+    int ret;
+    TLV_PERF_BEGIN();
+#if TLV_THREAD_SAFE || TLV_JOURNAL_ENABLE
+    // 分段执行增量整理：每段持写锁搬移有限字节,段间其他任务可以读写；
+    // 每步只提交单个索引条目,提交日志模式下借此保证整理中途掉电安全
+    do
+    {
+        TLV_WRITE_LOCK();
+        ret = tlv_core_defrag_step_unlocked(TLV_DEFRAG_SECTION_BYTES);
+        TLV_WRITE_UNLOCK();
+    } while (ret > 0);
+#else
+    ret = tlv_defragment_unlocked();
+#endif
+    TLV_PERF_END(TLV_PERF_OP_DEFRAG, ret);
+    return ret;
+}
+
+/**
+ * @brief 增量碎片整理（单步）
+ *
+ * 以游标为界,游标之前为已压缩区域。每步把游标之后地址最小的有效块搬到游标处：
+ * 先复制数据,再提交单个索引条目,旧块在索引提交前始终完好,任意时刻掉电都安全。
+ * 目标与源重叠时先经尾部空闲区中转；尾部空间不足时跳过该块（保留空洞）。
+ * 步与步之间可正常读写,整轮结束后收回尾部空间并重算空间统计。
+ *
+ * @param budget_bytes 本步最多搬移的字节数（至少搬移一个块）
+ * @return 1: 仍有工作, 0: 已完成, <0: 错误码
+ */
+int tlv_core_defrag_step_unlocked(uint32_t budget_bytes)
+{
+    if (tlv_core_ctx.state != TLV_STATE_INITIALIZED)
+    {
+        return TLV_ERROR;
+    }
+
+    // 事务、分段写入与异步操作的数据块尚未进入索引,搬移会覆盖它们
+    if (tlv_core_txn_ctx.is_active || tlv_core_has_active_write_stream() || tlv_core_async_busy())
+    {
+        return TLV_ERROR_INVALID_STATE;
+    }
+
+    if (!tlv_core_defrag_ctx.is_active)
+    {
+        // 没有浪费空间,无需整理
+        uint32_t allocated = tlv_core_ctx.header->next_free_addr - TLV_DATA_ADDR;
+        if (allocated <= tlv_core_ctx.header->used_space)
+        {
+            tlv_core_defrag_ctx.is_scheduled = false;
+            return 0;
+        }
+
+        int ret = tlv_core_fast_boot_settle();
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        // 空洞中可能有上次备份以来释放的块,先同步备份再覆盖
+        ret = tlv_core_backup_all_internal();
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        tlv_core_defrag_ctx.is_active = true;
+        tlv_core_defrag_ctx.cursor = TLV_DATA_ADDR;
+
+        // 整理期间空洞逐步被填充,只从尾部分配,结束时重建
+        tlv_core_free_list_reset(false);
+    }
+
+    uint32_t moved = 0;
+    do
+    {
+        const tlv_index_entry_t *next = tlv_core_find_next_block(tlv_core_defrag_ctx.cursor);
+        if (!next)
+        {
+            // 本轮完成
+            int ret = defrag_finish();
+            return (ret == TLV_OK) ? 0 : ret;
+        }
+
+        tlv_index_entry_t *entry = (tlv_index_entry_t *)next;
+        uint16_t length;
+        uint32_t write_count;
+        int ret = tlv_core_get_block_info(entry, &length, &write_count);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        uint32_t block_size = TLV_BLOCK_SIZE(length);
+        if (entry->data_addr + block_size > tlv_core_ctx.backup_addr)
+        {
+            tlv_core_defrag_ctx.is_active = false;
+            return TLV_ERROR_CORRUPTED;
+        }
+
+        if (entry->data_addr != tlv_core_defrag_ctx.cursor)
+        {
+            if (entry->data_addr >= tlv_core_defrag_ctx.cursor + block_size)
+            {
+                // 不重叠,直接搬移
+                ret = defrag_move_block(entry, tlv_core_defrag_ctx.cursor, length, write_count);
+            }
+            else
+            {
+                // 重叠,经尾部中转
+                uint32_t tail = tlv_core_allocate_space(block_size);
+                if (tail == 0)
+                {
+                    // 尾部空间不足,保留该块原位
+                    tlv_core_defrag_ctx.cursor = entry->data_addr + block_size;
+                    continue;
+                }
+
+                ret = defrag_move_block(entry, tail, length, write_count);
+                if (ret == TLV_OK)
+                {
+                    ret = defrag_move_block(entry, tlv_core_defrag_ctx.cursor, length, write_count);
+                }
+
+                // 中转空间可能已被备份区中的索引引用,留在尾部之内,整轮结束时回收
+                tlv_core_reduce_used_space(block_size);
+            }
+
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
+
+            moved += block_size;
+        }
+
+        tlv_core_defrag_ctx.cursor += block_size;
+    } while (moved < budget_bytes);
+
+    return 1;
+}
+
+int tlv_defrag_step(uint32_t budget_bytes)
+{
+    TLV_PERF_BEGIN();
+    TLV_WRITE_LOCK();
+    int ret = tlv_core_defrag_step_unlocked(budget_bytes);
+    TLV_WRITE_UNLOCK();
+    TLV_PERF_END(TLV_PERF_OP_DEFRAG, ret);
+    return ret;
+}
+
+/**
+ * @brief 是否有待执行的碎片整理（自动整理已调度或增量整理进行中）
+ * @return true: 应调用tlv_defrag_step, false: 无需整理
+ */
+bool tlv_defrag_pending(void)
+{
+    return tlv_core_defrag_ctx.is_active || tlv_core_defrag_ctx.is_scheduled;
+}
+
+/**
+ * @brief 获取GC统计
+ * @param stats 统计输出
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_get_gc_stats(tlv_gc_stats_t *stats)
+{
+    if (!stats)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    TLV_READ_LOCK();
+    int ret = TLV_ERROR;
+    if (tlv_core_ctx.state == TLV_STATE_INITIALIZED)
+    {
+        gc_stats_fill(stats);
+        ret = TLV_OK;
+    }
+    TLV_READ_UNLOCK();
+    return ret;
+}
+
+/**
+ * @brief 注册GC回调
+ * @param callback 回调函数（NULL恢复默认策略）
+ * @param user_data 用户数据
+ * @return 0: 成功
+ */
+int tlv_set_gc_callback(tlv_gc_callback_t callback, void *user_data)
+{
+    TLV_WRITE_LOCK();
+    g_gc_callback = callback;
+    g_gc_user_data = user_data;
+    TLV_WRITE_UNLOCK();
+    return TLV_OK;
+}
+/* ============================ 私有函数：GC策略============================ */
+/**
+ * @brief 清零整理上下文与GC计数（初始化时调用）
+ */
+void tlv_core_gc_reset(void)
+{
+    memset(&tlv_core_defrag_ctx, 0, sizeof(tlv_core_defrag_ctx));
+    tlv_core_sync_compactions = 0;
+    g_gc_triggers = 0;
+}
+
+/**
+ * @brief 写入提交后按GC策略检查是否需要整理
+ *
+ * 只比较Header中维护的空间字段：尾部余量低于数据区的TLV_GC_HEADROOM_PERCENT且可回收空间不少于
+ * TLV_GC_MIN_RECLAIM时触发,由GC回调决定调度、立即整理或跳过。已调度或进行中的整理不重复触发。
+ */
+void tlv_core_gc_check(void)
+{
+#if TLV_AUTO_CLEAN_FRAGEMENT
+    // 批量迁移期间暂不调度,本轮结束时统一检查
+    if (tlv_core_migrate_ctx.progress.active || tlv_core_defrag_ctx.is_scheduled || tlv_core_defrag_ctx.is_active)
+    {
+        return;
+    }
+
+    const tlv_system_header_t *hdr = tlv_core_ctx.header;
+    uint32_t reclaimable = (hdr->next_free_addr - TLV_DATA_ADDR) - hdr->used_space;
+    tlv_gc_reason_t reason;
+    if (reclaimable >= TLV_GC_MIN_RECLAIM &&
+        hdr->free_space * 100 < hdr->data_region_size * TLV_GC_HEADROOM_PERCENT)
+    {
+        reason = TLV_GC_REASON_HEADROOM;
+    }
+#ifdef TLV_AUTO_DEFRAG_THRESHOLD
+    else if (reclaimable * 100 >= hdr->data_region_size * TLV_AUTO_DEFRAG_THRESHOLD && reclaimable > 0)
+    {
+        reason = TLV_GC_REASON_FRAGMENTATION;
+    }
+#endif
+    else
+    {
+        return;
+    }
+
+    tlv_gc_action_t action = gc_decide(reason, 0);
+    if (action != TLV_GC_SKIP)
+    {
+        tlv_core_defrag_ctx.is_scheduled = true;
+        tlv_core_defrag_ctx.compact_now = (action == TLV_GC_NOW);
+    }
+#endif
+}
+
+/**
+ * @brief 统计一次触发并取得整理动作（未注册回调时：分配失败立即整理,其余调度）
+ */
+static tlv_gc_action_t gc_decide(tlv_gc_reason_t reason, uint32_t required)
+{
+    g_gc_triggers++;
+    if (!g_gc_callback)
+    {
+        return (reason == TLV_GC_REASON_ALLOC) ? TLV_GC_NOW : TLV_GC_DEFER;
+    }
+
+    tlv_gc_stats_t stats;
+    gc_stats_fill(&stats);
+    return g_gc_callback(reason, required, &stats, g_gc_user_data);
+}
+
+/**
+ * @brief 由Header空间字段与计数器填充GC统计
+ */
+static void gc_stats_fill(tlv_gc_stats_t *stats)
+{
+    const tlv_system_header_t *hdr = tlv_core_ctx.header;
+    stats->region_size = hdr->data_region_size;
+    stats->used_space = hdr->used_space;
+    stats->reclaimable = (hdr->next_free_addr - TLV_DATA_ADDR) - hdr->used_space;
+    stats->headroom = hdr->free_space;
+    stats->fragment_count = hdr->fragment_count;
+    stats->gc_triggers = g_gc_triggers;
+    stats->sync_compactions = tlv_core_sync_compactions;
+    stats->pending = (tlv_core_defrag_ctx.is_active || tlv_core_defrag_ctx.is_scheduled) ? 1 : 0;
+}
+
+/**
+ * @brief 执行GC回调要求的立即整理（写接口在返回前持写锁调用）
+ * @note 写入已经提交,整理失败只记录日志,整理保持调度状态由tlv_defrag_step继续
+ */
+void tlv_core_gc_run_requested(void)
+{
+    if (!tlv_core_defrag_ctx.compact_now)
+    {
+        return;
+    }
+
+    // 流与事务持有尚未进入索引的数据块,推迟到它们结束后的写接口
+    if (tlv_core_txn_ctx.is_active || tlv_core_has_active_write_stream() || tlv_core_async_busy())
+    {
+        return;
+    }
+
+    tlv_core_defrag_ctx.compact_now = false;
+    tlv_core_sync_compactions++;
+
+    int ret;
+    TLV_PERF_BEGIN();
+    do
+    {
+        ret = tlv_core_defrag_step_unlocked(UINT32_MAX);
+    } while (ret > 0);
+    TLV_PERF_END(TLV_PERF_OP_DEFRAG, ret);
+
+    if (ret < 0)
+    {
+        tlv_printf("WARNING: GC compaction failed (err: %d)\n", ret);
+    }
+}
+
+/* ============================ 私有函数：碎片整理============================ */
+#if !TLV_THREAD_SAFE && !TLV_JOURNAL_ENABLE
+/**
+ * @brief 原地排序索引表（按地址）
+ */
+static void sort_index_table_inplace(void)
+{
+    // 1. 压缩：移动所有有效项到前面
+    int write_idx = 0;
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        if (write_idx >= TLV_MAX_TAG_COUNT)
+            break;
+        tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+
+        if (entry->tag != 0 && (entry->flags & TLV_FLAG_VALID))
+        {
+            if (i != write_idx)
+            {
+                tlv_core_ctx.index_table->entries[write_idx] = *entry;
+            }
+            write_idx++;
+        }
+    }
+
+    int total_valid = write_idx;
+
+    if (total_valid <= 0 || total_valid >= TLV_MAX_TAG_COUNT)
+    {
+        tlv_index_rebuild_hash(&tlv_core_ctx);
+        return;
+    }
+
+// 2. 对压缩后的有效项排序
+// 插入排序,原有的排序是按地址排列基本有序的,对于近乎有序的排列接近O(n),逆序最差是O(n^2)
+#if 1
+    for (int i = 1; i < total_valid; i++)
+    {
+        tlv_index_entry_t entry = tlv_core_ctx.index_table->entries[i];
+        int j = i - 1;
+
+        // 和有序区最后一个元素比较,如果比有序区最后一个元素小,则插入有序区中,否则就在当前位置
+        while (j >= 0 && tlv_core_ctx.index_table->entries[j].data_addr > entry.data_addr)
+        {
+            tlv_core_ctx.index_table->entries[j + 1] = tlv_core_ctx.index_table->entries[j];
+            j--;
+        }
+        tlv_core_ctx.index_table->entries[j + 1] = entry;
+    }
+#else
+    // 选择排序 O(n^2)
+    for (int i = 0; i < total_valid - 1; i++)
+    {
+        int min_idx = i;
+
+        // 找到剩余最小地址
+        for (int j = i + 1; j < total_valid; j++)
+        {
+            if (tlv_core_ctx.index_table->entries[j].data_addr <
+                tlv_core_ctx.index_table->entries[min_idx].data_addr)
+            {
+                min_idx = j;
+            }
+        }
+
+        // 交换
+        if (min_idx != i)
+        {
+            tlv_index_entry_t temp = tlv_core_ctx.index_table->entries[i];
+            tlv_core_ctx.index_table->entries[i] = tlv_core_ctx.index_table->entries[min_idx];
+            tlv_core_ctx.index_table->entries[min_idx] = temp;
+        }
+    }
+#endif
+    // 3. 清空剩余槽位
+    for (int i = total_valid; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        memset(&tlv_core_ctx.index_table->entries[i], 0, sizeof(tlv_index_entry_t));
+    }
+
+    // 4. 槽位已变化,重建哈希表
+    tlv_index_rebuild_hash(&tlv_core_ctx);
+}
+#endif
+
+/**
+ * @brief 分配空间,失败且存在可回收空间时同步完成一轮增量整理后重试（最后手段）
+ * @note 整理会提交空间布局变化,已激活的快照需要重新创建
+ */
+uint32_t tlv_core_allocate_space_or_compact(uint32_t size)
+{
+    uint32_t addr = tlv_core_allocate_space(size);
+    if (addr != 0)
+    {
+        return addr;
+    }
+
+    // 事务与分段写入持有尚未进入索引的块,不能整理：使备份失效后复用暂不复用的空洞
+    if (tlv_core_txn_ctx.is_active || tlv_core_has_active_write_stream())
+    {
+        return tlv_core_free_list_release_held() ? tlv_core_allocate_space(size) : 0;
+    }
+
+    uint32_t allocated = tlv_core_ctx.header->next_free_addr - TLV_DATA_ADDR;
+    if (allocated - tlv_core_ctx.header->used_space < size)
+    {
+        return 0;
+    }
+
+    // 由GC回调决定是否在本次写入中整理；延后时只调度,本次写入失败
+    tlv_gc_action_t action = gc_decide(TLV_GC_REASON_ALLOC, size);
+    if (action != TLV_GC_NOW)
+    {
+        if (action == TLV_GC_DEFER)
+        {
+            tlv_core_defrag_ctx.is_scheduled = true;
+        }
+        return 0;
+    }
+
+    tlv_printf("Out of tail space, compacting synchronously\n");
+    tlv_core_sync_compactions++;
+
+    int ret;
+    TLV_PERF_BEGIN();
+    do
+    {
+        ret = tlv_core_defrag_step_unlocked(UINT32_MAX);
+    } while (ret > 0);
+    TLV_PERF_END(TLV_PERF_OP_DEFRAG, ret);
+
+    if (ret < 0)
+    {
+        return 0;
+    }
+
+    if (tlv_core_ctx.snapshot.is_active)
+    {
+        tlv_core_transaction_snapshot_create();
+    }
+
+    return tlv_core_allocate_space(size);
+}
+
+/**
+ * @brief 搬移单个数据块并提交其索引条目（源与目标不得重叠）
+ * @note 目标落在上次备份以来腾出的区域时先同步备份,否则从备份恢复会读到被覆盖的块
+ */
+static int defrag_move_block(tlv_index_entry_t *entry, uint32_t dst, uint16_t length, uint32_t write_count)
+{
+    uint32_t src = entry->data_addr;
+    uint32_t size = TLV_BLOCK_SIZE(length);
+    int ret;
+    if (dst < tlv_core_defrag_ctx.vacated_end && dst + size > tlv_core_defrag_ctx.vacated_start)
+    {
+        ret = tlv_core_backup_all_internal();
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        tlv_core_defrag_ctx.vacated_start = 0;
+        tlv_core_defrag_ctx.vacated_end = 0;
+    }
+
+    ret = tlv_core_copy_block(src, dst, size);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 索引是提交点
+    entry->data_addr = dst;
+    tlv_core_block_info_set(entry, length, write_count);
+    ret = tlv_core_index_commit_entry(entry, length);
+    if (ret == TLV_OK)
+    {
+        tlv_core_defrag_mark_vacated(src, size);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 记录整理期间腾出的区域（搬走的旧块与段间写入释放的块）,合并为一个区间
+ */
+void tlv_core_defrag_mark_vacated(uint32_t addr, uint32_t size)
+{
+    if (tlv_core_defrag_ctx.vacated_end == 0)
+    {
+        tlv_core_defrag_ctx.vacated_start = addr;
+        tlv_core_defrag_ctx.vacated_end = addr + size;
+        return;
+    }
+
+    if (addr < tlv_core_defrag_ctx.vacated_start)
+    {
+        tlv_core_defrag_ctx.vacated_start = addr;
+    }
+    if (addr + size > tlv_core_defrag_ctx.vacated_end)
+    {
+        tlv_core_defrag_ctx.vacated_end = addr + size;
+    }
+}
+
+/**
+ * @brief 按地址顺序遍历有效块,重新统计Header中的空间字段
+ * @param end 尾部分配位置的下限（所有块之后仍被占用的位置,如整理游标）
+ * @return 0: 成功, 其他: 错误码
+ */
+int tlv_core_space_stats_rebuild(uint32_t end)
+{
+    tlv_system_header_t *hdr = tlv_core_ctx.header;
+    uint32_t used = 0;
+    uint32_t holes = 0;
+    uint32_t pos = TLV_DATA_ADDR;
+
+    // 统计已用空间与空洞数量
+    const tlv_index_entry_t *entry;
+    while ((entry = tlv_core_find_next_block(pos)) != NULL)
+    {
+        uint16_t length;
+        uint32_t write_count;
+        int ret = tlv_core_get_block_info(entry, &length, &write_count);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        if (entry->data_addr > pos)
+        {
+            holes++;
+        }
+
+        used += TLV_BLOCK_SIZE(length);
+        pos = entry->data_addr + TLV_BLOCK_SIZE(length);
+    }
+
+    if (pos > end)
+    {
+        end = pos;
+    }
+
+    hdr->next_free_addr = end;
+    hdr->used_space = used;
+    hdr->free_space = hdr->data_region_size - (end - TLV_DATA_ADDR);
+    hdr->fragment_size = (end - TLV_DATA_ADDR) - used;
+    hdr->fragment_count = holes;
+    return TLV_OK;
+}
+
+/**
+ * @brief 结束一轮增量整理：收回尾部空间,按索引重算空间统计并同步备份
+ */
+static int defrag_finish(void)
+{
+    int ret = tlv_core_space_stats_rebuild(tlv_core_defrag_ctx.cursor);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    memset(&tlv_core_defrag_ctx, 0, sizeof(tlv_core_defrag_ctx));
+    tlv_core_free_list_rebuild(false);
+
+    ret = tlv_core_flush_unlocked();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    ret = tlv_core_system_header_save();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 备份区中的索引指向整理前的地址,需要同步
+    return tlv_core_backup_all_internal();
+}
@@ -1,6 +1,6 @@
 /**
  * @file tlv_index.c
- * @brief TLV索引管理模块（简化版,数组查找）
+ * @brief TLV索引管理模块（简化版,数组存储+RAM哈希查找）
  */
 
 #include "tlv_index.h"
@@ -11,7 +11,18 @@
 /* ============================ 私有函数声明 ============================ */
 
 static const tlv_meta_const_t *find_meta_by_tag(const tlv_context_t *ctx, uint16_t tag);
-static bool is_tag_region_valid(uint16_t tag, uint32_t addr, uint32_t size);
+static bool is_tag_region_valid(const tlv_context_t *ctx, uint32_t addr, uint32_t size);
+static uint16_t calc_page_crc(const tlv_context_t *ctx, uint32_t page);
+static int save_page_crc_table(const tlv_context_t *ctx);
+static int verify_pages(const tlv_context_t *ctx);
+static int verify_page(const tlv_context_t *ctx, uint32_t page, uint16_t stored_crc);
+static bool verify_page_blocks(const tlv_context_t *ctx, uint32_t page);
+static int hash_find_pos(const tlv_context_t *ctx, uint16_t tag);
+static int hash_insert(const tlv_context_t *ctx, uint32_t slot);
+static void hash_remove_slot(const tlv_context_t *ctx, uint32_t slot);
+
+/** 哈希表掩码 */
+#define INDEX_HASH_MASK (TLV_INDEX_HASH_SIZE - 1)
 
 /* ============================ 索引表管理实现 ============================ */
 
@@ -36,6 +47,11 @@ int tlv_index_init(const tlv_context_t *ctx)
     // 清零
     memset(ctx->index_table, 0, sizeof(tlv_index_table_t));
 
+    if (ctx->index_hash)
+    {
+        memset(ctx->index_hash, 0, sizeof(uint16_t) * TLV_INDEX_HASH_SIZE);
+    }
+
     return TLV_OK;
 }
 
@@ -57,12 +73,14 @@ void tlv_index_deinit(const tlv_context_t *ctx)
     tlv_context_t *ctx_ = (tlv_context_t *)ctx;
     ctx_->header = NULL;
     ctx_->index_table = NULL;
+    ctx_->index_hash = NULL;
 }
 
 /**
  * @brief 从FRAM加载TLV索引表
  *
  * 该函数负责从FRAM中读取索引表数据,并进行CRC16校验以确保数据完整性。
+ * 整表CRC不匹配时（写回模式下尚未flush）,逐页校验索引页CRC,全部有效则仍视为索引有效。
  *
  * @param ctx 指向TLV上下文结构体的指针,必须包含有效的index_table成员
  *
@@ -79,20 +97,61 @@ int tlv_index_load(const tlv_context_t *ctx)
     }
 
     // 从FRAM读取索引表
-    int ret = tlv_port_fram_read(TLV_INDEX_ADDR, ctx->index_table, sizeof(tlv_index_table_t));
+    int ret = ctx->ops->read(TLV_INDEX_ADDR, ctx->index_table, sizeof(tlv_index_table_t));
     if (ret != TLV_OK)
     {
         return ret;
     }
 
+    tlv_context_t *ctx_ = (tlv_context_t *)ctx;
+    ctx_->index_crc_dirty = false;
+
     // 校验索引表CRC16
     uint16_t calc_crc = tlv_crc16(ctx->index_table->entries, sizeof(ctx->index_table->entries));
     if (calc_crc != ctx->index_table->index_crc16)
     {
-        return TLV_ERROR_CRC_FAILED;
+        // 整表CRC过期,按页校验
+        ret = verify_pages(ctx);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        // 各页有效,整表CRC待下次flush更新
+        ctx_->index_crc_dirty = true;
     }
 
-    return TLV_OK;
+    // 索引表整体替换,重建哈希
+    return tlv_index_rebuild_hash(ctx);
+}
+
+/**
+ * @brief 从FRAM加载TLV索引表,跳过CRC校验
+ *
+ * 快速启动时使用：Header中的正常关机标记表明索引表在关机时完整,
+ * 逐页校验由调用方推迟执行。
+ *
+ * @param ctx 指向TLV上下文结构体的指针
+ *
+ * @return TLV_OK - 加载成功
+ * @return TLV_ERROR_INVALID_PARAM - 参数无效
+ * @return 其他 - FRAM读取操作返回的错误码
+ */
+int tlv_index_load_unverified(const tlv_context_t *ctx)
+{
+    if (!ctx || !ctx->index_table)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    int ret = ctx->ops->read(TLV_INDEX_ADDR, ctx->index_table, sizeof(tlv_index_table_t));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    ((tlv_context_t *)ctx)->index_crc_dirty = false;
+    return tlv_index_rebuild_hash(ctx);
 }
 
 /**
@@ -104,11 +163,19 @@ int tlv_index_load(const tlv_context_t *ctx)
  * @param ctx TLV上下文指针,包含索引表等信息
  *
  * @return TLV_ERROR_INVALID_PARAM 参数无效
- * @return 其他 返回tlv_port_fram_write函数的执行结果
+ * @return 其他 返回FRAM写入的执行结果
  */
 int tlv_index_save(const tlv_context_t *ctx)
 {
-    if (!ctx || !ctx->index_table)
+    return tlv_index_save_pages(ctx, TLV_INDEX_PAGE_COUNT);
+}
+
+/**
+ * @brief 保存前page_count个索引页、整表CRC与索引页CRC表
+ */
+int tlv_index_save_pages(const tlv_context_t *ctx, uint32_t page_count)
+{
+    if (!ctx || !ctx->index_table || page_count > TLV_INDEX_PAGE_COUNT)
     {
         return TLV_ERROR_INVALID_PARAM;
     }
@@ -116,8 +183,195 @@ int tlv_index_save(const tlv_context_t *ctx)
     // 计算索引表CRC16校验码
     ctx->index_table->index_crc16 = tlv_crc16(ctx->index_table->entries, sizeof(ctx->index_table->entries));
 
-    // 将索引表写入FRAM存储器
-    return tlv_port_fram_write(TLV_INDEX_ADDR, ctx->index_table, sizeof(tlv_index_table_t));
+    uint32_t entry_count = page_count * TLV_INDEX_ENTRIES_PER_PAGE;
+    if (entry_count > TLV_MAX_TAG_COUNT)
+    {
+        entry_count = TLV_MAX_TAG_COUNT;
+    }
+
+    // 将索引表写入FRAM存储器（整表时与CRC一次写入）
+    int ret;
+    if (entry_count == TLV_MAX_TAG_COUNT)
+    {
+        tlv_index_mark_backup_dirty(ctx, TLV_INDEX_ADDR, sizeof(tlv_index_table_t) + sizeof(tlv_index_page_crc_t));
+        ret = ctx->ops->write(TLV_INDEX_ADDR, ctx->index_table, sizeof(tlv_index_table_t));
+    }
+    else
+    {
+        uint32_t crc_addr = TLV_INDEX_ADDR + offsetof(tlv_index_table_t, index_crc16);
+        tlv_index_mark_backup_dirty(ctx, TLV_INDEX_ADDR, entry_count * sizeof(tlv_index_entry_t));
+        tlv_index_mark_backup_dirty(ctx, crc_addr, sizeof(uint16_t) + sizeof(tlv_index_page_crc_t));
+        ret = (entry_count > 0)
+                  ? ctx->ops->write(TLV_INDEX_ADDR, ctx->index_table->entries, entry_count * sizeof(tlv_index_entry_t))
+                  : TLV_OK;
+        if (ret == TLV_OK)
+        {
+            ret = ctx->ops->write(crc_addr, &ctx->index_table->index_crc16, sizeof(uint16_t));
+        }
+    }
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    // 同步保存索引页CRC表
+    return save_page_crc_table(ctx);
+}
+
+/**
+ * @brief 只保存位图中的索引页、整表CRC与索引页CRC表
+ *
+ * 相邻的页合并为一次写入。写入顺序：索引页 -> 整表CRC -> 页CRC表,掉电发生在页写入之后时
+ * 页CRC不匹配,由加载时的逐页校验处理。
+ */
+int tlv_index_save_page_mask(const tlv_context_t *ctx, uint32_t page_mask)
+{
+    if (!ctx || !ctx->index_table)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t page = 0;
+    while (page < TLV_INDEX_PAGE_COUNT)
+    {
+        if (!(page_mask & (1UL << page)))
+        {
+            page++;
+            continue;
+        }
+
+        uint32_t last = page;
+        while (last + 1 < TLV_INDEX_PAGE_COUNT && (page_mask & (1UL << (last + 1))))
+        {
+            last++;
+        }
+
+        uint32_t first = page * TLV_INDEX_ENTRIES_PER_PAGE;
+        uint32_t end = (last + 1) * TLV_INDEX_ENTRIES_PER_PAGE;
+        if (end > TLV_MAX_TAG_COUNT)
+        {
+            end = TLV_MAX_TAG_COUNT;
+        }
+
+        uint32_t addr = TLV_INDEX_ADDR + first * sizeof(tlv_index_entry_t);
+        uint32_t size = (end - first) * sizeof(tlv_index_entry_t);
+        tlv_index_mark_backup_dirty(ctx, addr, size);
+        int ret = ctx->ops->write(addr, &ctx->index_table->entries[first], size);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        page = last + 1;
+    }
+
+    // 整表CRC与页CRC表
+    ctx->index_table->index_crc16 = tlv_crc16(ctx->index_table->entries, sizeof(ctx->index_table->entries));
+
+    uint32_t crc_addr = TLV_INDEX_ADDR + offsetof(tlv_index_table_t, index_crc16);
+    tlv_index_mark_backup_dirty(ctx, crc_addr, sizeof(uint16_t) + sizeof(tlv_index_page_crc_t));
+    int ret = ctx->ops->write(crc_addr, &ctx->index_table->index_crc16, sizeof(uint16_t));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    return save_page_crc_table(ctx);
+}
+
+/**
+ * @brief 只保存单个索引条目到FRAM
+ *
+ * 写入顺序：条目(8字节) -> 所在页CRC(2字节)。掉电发生在两者之间时该页CRC不匹配,
+ * 加载时逐条校验该页指向的数据块,全部通过则修复页CRC,否则按索引损坏处理（从备份恢复）。
+ *
+ * @param ctx TLV上下文指针
+ * @param entry 要保存的索引条目
+ *
+ * @return TLV_OK 成功
+ * @return TLV_ERROR_INVALID_PARAM 参数无效
+ * @return 其他 FRAM写入错误码
+ */
+int tlv_index_save_entry(const tlv_context_t *ctx, const tlv_index_entry_t *entry)
+{
+    if (!ctx || !ctx->index_table || !entry ||
+        entry < ctx->index_table->entries ||
+        entry >= ctx->index_table->entries + TLV_MAX_TAG_COUNT)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t slot = (uint32_t)(entry - ctx->index_table->entries);
+    uint32_t page = slot / TLV_INDEX_ENTRIES_PER_PAGE;
+
+    // 整表CRC在条目写入后即过期
+    ((tlv_context_t *)ctx)->index_crc_dirty = true;
+    tlv_index_mark_backup_dirty(ctx, TLV_INDEX_ADDR + slot * sizeof(tlv_index_entry_t), sizeof(tlv_index_entry_t));
+    tlv_index_mark_backup_dirty(ctx, TLV_INDEX_PAGE_CRC_ADDR + page * sizeof(uint16_t), sizeof(uint16_t));
+
+    int ret = ctx->ops->write(TLV_INDEX_ADDR + slot * sizeof(tlv_index_entry_t),
+                                  entry, sizeof(tlv_index_entry_t));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    uint16_t crc = calc_page_crc(ctx, page);
+    return ctx->ops->write(TLV_INDEX_PAGE_CRC_ADDR + page * sizeof(uint16_t),
+                               &crc, sizeof(crc));
+}
+
+/**
+ * @brief 重新计算整表CRC并只写入CRC字段
+ *
+ * @param ctx TLV上下文指针
+ *
+ * @return TLV_OK 成功
+ * @return TLV_ERROR_INVALID_PARAM 参数无效
+ * @return 其他 FRAM写入错误码
+ */
+int tlv_index_save_crc(const tlv_context_t *ctx)
+{
+    if (!ctx || !ctx->index_table)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    ctx->index_table->index_crc16 = tlv_crc16(ctx->index_table->entries, sizeof(ctx->index_table->entries));
+
+    tlv_index_mark_backup_dirty(ctx, TLV_INDEX_ADDR + offsetof(tlv_index_table_t, index_crc16), sizeof(uint16_t));
+    int ret = ctx->ops->write(TLV_INDEX_ADDR + offsetof(tlv_index_table_t, index_crc16),
+                                  &ctx->index_table->index_crc16, sizeof(uint16_t));
+    if (ret == TLV_OK)
+    {
+        ((tlv_context_t *)ctx)->index_crc_dirty = false;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 标记管理区写入范围所在的备份页为脏
+ *
+ * 备份时只复制位图中的页；超出备份覆盖范围的部分忽略。
+ *
+ * @param ctx TLV上下文指针
+ * @param addr 写入起始地址
+ * @param size 写入长度
+ */
+void tlv_index_mark_backup_dirty(const tlv_context_t *ctx, uint32_t addr, uint32_t size)
+{
+    if (!ctx || size == 0)
+    {
+        return;
+    }
+
+    uint32_t first = (addr - TLV_HEADER_ADDR) / TLV_BACKUP_PAGE_SIZE;
+    uint32_t last = (addr + size - 1 - TLV_HEADER_ADDR) / TLV_BACKUP_PAGE_SIZE;
+    for (uint32_t page = first; page <= last && page < TLV_BACKUP_COVER_PAGES; page++)
+    {
+        ((tlv_context_t *)ctx)->backup_dirty |= (1UL << page);
+    }
 }
 
 /**
@@ -150,79 +404,100 @@ int tlv_index_verify(const tlv_context_t *ctx)
     return TLV_OK;
 }
 
-/* ============================ 索引查找实现（数组查找） ============================ */
-
 /**
- * @brief 在TLV索引表中查找指定标签的条目
+ * @brief 根据索引表重建RAM哈希表
  *
- * @param ctx TLV上下文指针,包含索引表信息
- * @param tag 要查找的标签值
+ * 哈希表采用开放寻址（线性探测）,槽位保存"索引槽位号+1",0表示空。
+ * 只有有效（TLV_FLAG_VALID）的条目会被加入哈希表。
  *
- * @return 成功时返回指向找到的索引条目的指针,未找到或出错时返回NULL
+ * @param ctx TLV上下文指针
+ *
+ * @return TLV_OK 成功
+ * @return TLV_ERROR_INVALID_PARAM 参数无效
+ * @return TLV_ERROR_NO_INDEX_SPACE 哈希表已满（配置错误）
  */
-tlv_index_entry_t *tlv_index_find(const tlv_context_t *ctx, uint16_t tag)
+int tlv_index_rebuild_hash(const tlv_context_t *ctx)
 {
-    // 参数有效性检查：上下文、索引表是否存在,标签是否有效
-    if (!ctx || !ctx->index_table || tag == 0)
+    if (!ctx || !ctx->index_table)
     {
-        return NULL;
+        return TLV_ERROR_INVALID_PARAM;
     }
 
-    // 线性搜索（简单搜索）
-    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    // 未配置哈希表时退化为线性查找
+    if (!ctx->index_hash)
     {
-        // 查找标签匹配且有效的条目
-        if (ctx->index_table->entries[i].tag == tag &&
-            (ctx->index_table->entries[i].flags & TLV_FLAG_VALID))
+        return TLV_OK;
+    }
+
+    memset(ctx->index_hash, 0, sizeof(uint16_t) * TLV_INDEX_HASH_SIZE);
+
+    for (uint32_t i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        const tlv_index_entry_t *entry = &ctx->index_table->entries[i];
+        if (entry->tag != 0 && (entry->flags & TLV_FLAG_VALID))
         {
-            return &ctx->index_table->entries[i];
+            int ret = hash_insert(ctx, i);
+            if (ret != TLV_OK)
+            {
+                return ret;
+            }
         }
     }
 
-    return NULL;
+    return TLV_OK;
 }
 
+/* ============================ 索引查找实现（哈希查找） ============================ */
+
 /**
- * @brief 根据标签值查找在元数据映射表中的索引位置
+ * @brief 在TLV索引表中查找指定标签的条目
  *
+ * 优先使用RAM哈希表O(1)查找；上下文未配置哈希表时回退到线性搜索。
+ *
+ * @param ctx TLV上下文指针,包含索引表信息
  * @param tag 要查找的标签值
- * @return 如果找到匹配的标签,返回其在TLV_META_MAP数组中的索引；如果未找到,返回-1
  *
- * 该函数通过遍历TLV_META_MAP数组来查找指定标签的位置。
- * 当遇到标签值为0xFFFF的特殊标记时,表示已到达数组有效数据的末尾,停止查找。
+ * @return 成功时返回指向找到的索引条目的指针,未找到或出错时返回NULL
  */
-static inline int get_tag_index(const tlv_context_t *ctx, uint16_t tag)
+tlv_index_entry_t *tlv_index_find(const tlv_context_t *ctx, uint16_t tag)
 {
-    // 参数有效性检查
-    if (!ctx || !ctx->meta_table || ctx->meta_table_size == 0 || tag == 0)
+    // 参数有效性检查：上下文、索引表是否存在,标签是否有效
+    if (!ctx || !ctx->index_table || tag == 0)
     {
-        return -1;
+        return NULL;
     }
 
-    // 遍历元数据映射表查找匹配的标签
-    // 如果元数据表有序,可以使用二分查找来优化性能
-    for (int i = 0; i < ctx->meta_table_size; i++)
+    // 哈希查找
+    if (ctx->index_hash)
     {
-        // 找到匹配的标签,返回索引位置
-        if (ctx->meta_table[i].tag == tag)
+        int pos = hash_find_pos(ctx, tag);
+        if (pos < 0)
         {
-            return i;
+            return NULL;
         }
-        // 遇到结束标记,停止查找
-        if (ctx->meta_table[i].tag == 0xFFFF)
+
+        tlv_index_entry_t *entry = &ctx->index_table->entries[ctx->index_hash[pos] - 1];
+        return (entry->flags & TLV_FLAG_VALID) ? entry : NULL;
+    }
+
+    // 线性搜索（简单搜索）
+    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        // 查找标签匹配且有效的条目
+        if (ctx->index_table->entries[i].tag == tag &&
+            (ctx->index_table->entries[i].flags & TLV_FLAG_VALID))
         {
-            break;
+            return &ctx->index_table->entries[i];
         }
     }
-    // 未找到匹配的标签,返回错误码-1
-    return -1;
+
+    return NULL;
 }
 
 /**
  * @brief 快速查找TLV标签对应的索引条目
  *
- * 该函数首先尝试使用预计算的索引表进行O(1)时间复杂度的查找,
- * 如果预计算索引不可用或无效,则回退到线性搜索方式。
+ * tlv_index_find已经基于哈希表实现O(1)查找,该接口保留用于兼容旧代码。
  *
  * @param ctx TLV上下文指针,包含索引表信息
  * @param tag 要查找的标签值
@@ -230,24 +505,6 @@ static inline int get_tag_index(const tlv_context_t *ctx, uint16_t tag)
  */
 tlv_index_entry_t *tlv_index_find_fast(const tlv_context_t *ctx, uint16_t tag)
 {
-    // 参数有效性检查
-    if (!ctx || !ctx->index_table || tag == 0)
-    {
-        return NULL;
-    }
-
-    // 尝试使用预计算索引进行快速查找（要求元数据表有序）
-    int meta_index = get_tag_index(ctx, tag);
-    if (meta_index >= 0 && meta_index < TLV_MAX_TAG_COUNT)
-    {
-        tlv_index_entry_t *entry = &ctx->index_table->entries[meta_index];
-        if (entry->tag == tag && (entry->flags & TLV_FLAG_VALID))
-        {
-            return entry;
-        }
-    }
-
-    // 预计算索引查找失败,回退到线性搜索
     return tlv_index_find(ctx, tag);
 }
 
@@ -274,6 +531,7 @@ tlv_index_entry_t *tlv_index_find_free_slot(const tlv_context_t *ctx)
             !(ctx->index_table->entries[i].flags & TLV_FLAG_VALID))
         {
             // 清空脏块槽位,复用
+            hash_remove_slot(ctx, i);
             memset(&ctx->index_table->entries[i], 0, sizeof(tlv_index_entry_t));
             if (ctx->header->fragment_count > 0)
             {
@@ -299,7 +557,7 @@ tlv_index_entry_t *tlv_index_find_free_slot(const tlv_context_t *ctx)
  */
 tlv_index_entry_t *tlv_index_add(const tlv_context_t *ctx, uint16_t tag, uint32_t addr)
 {
-    if (!ctx || tag == 0 || !TLV_IS_VALID_ADDR(addr))
+    if (!ctx || tag == 0 || !TLV_IS_VALID_ADDR(ctx, addr))
     {
         return NULL;
     }
@@ -328,13 +586,20 @@ tlv_index_entry_t *tlv_index_add(const tlv_context_t *ctx, uint16_t tag, uint32_
     entry->version = meta ? meta->version : 1;
 
     // 检查区域有效性（编译时检查的运行时验证）
-    if (meta && !is_tag_region_valid(tag, addr, meta->max_length))
+    if (meta && !is_tag_region_valid(ctx, addr, meta->max_length))
     {
         // 区域无效时进行回滚操作：清空条目并减少标签计数
         memset(entry, 0, sizeof(tlv_index_entry_t));
         return NULL;
     }
 
+    // 加入哈希表
+    if (ctx->index_hash && hash_insert(ctx, (uint32_t)(entry - ctx->index_table->entries)) != TLV_OK)
+    {
+        memset(entry, 0, sizeof(tlv_index_entry_t));
+        return NULL;
+    }
+
     // 更新上下文中的标签计数器
     ctx->header->tag_count++;
 
@@ -355,7 +620,7 @@ tlv_index_entry_t *tlv_index_add(const tlv_context_t *ctx, uint16_t tag, uint32_
 int tlv_index_update(const tlv_context_t *ctx, uint16_t tag, uint32_t addr)
 {
     /* 参数合法性检查 */
-    if (!ctx || tag == 0 || !TLV_IS_VALID_ADDR(addr))
+    if (!ctx || tag == 0 || !TLV_IS_VALID_ADDR(ctx, addr))
     {
         return TLV_ERROR_INVALID_PARAM;
     }
@@ -398,7 +663,8 @@ int tlv_index_remove(const tlv_context_t *ctx, uint16_t tag)
         return TLV_ERROR_NOT_FOUND;
     }
 
-    // 清空索引项
+    // 移出哈希表并清空索引项
+    hash_remove_slot(ctx, (uint32_t)(index - ctx->index_table->entries));
     memset(index, 0, sizeof(tlv_index_entry_t));
 
     // 更新Tag计数
@@ -426,45 +692,315 @@ static const tlv_meta_const_t *find_meta_by_tag(const tlv_context_t *ctx, uint16
         return NULL;
     }
 
-    // 遍历元数据映射表查找匹配的标签
-    for (uint32_t i = 0; i < ctx->meta_table_size; i++)
-    {
-        // 找到匹配的标签,返回对应的元数据指针
-        if (ctx->meta_table[i].tag == tag)
-        {
-            return &ctx->meta_table[i];
-        }
-        // 遇到结束标记(0xFFFF),停止搜索
-        if (ctx->meta_table[i].tag == 0xFFFF)
-        {
-            break;
-        }
-    }
-    // 未找到匹配的标签,返回空指针
-    return NULL;
+    // 统一的元数据查找（二分查找）
+    return tlv_meta_find(ctx->meta_table, tag);
 }
 
 /**
  * @brief 检查指定的标签区域是否有效
  *
- * 该函数验证给定标签、地址和大小组成的区域是否满足以下条件：
+ * 该函数验证给定地址和大小组成的区域是否满足以下条件：
  * 1. 地址在有效范围内
  * 2. 大小在安全范围内
- * 3. 不与现有的其他标签区域发生重叠
  *
- * @param tag 标签值
+ * @param ctx 上下文指针
  * @param addr 起始地址
  * @param size 区域大小
  * @return true 区域有效
  * @return false 区域无效
  */
-static bool is_tag_region_valid(uint16_t tag, uint32_t addr, uint32_t size)
+static bool is_tag_region_valid(const tlv_context_t *ctx, uint32_t addr, uint32_t size)
 {
     // 验证地址和大小的基本有效性
-    if (!TLV_IS_VALID_ADDR(addr) || !TLV_IS_SIZE_SAFE(addr, size))
+    if (!TLV_IS_VALID_ADDR(ctx, addr) || !TLV_IS_SIZE_SAFE(ctx, addr, size))
     {
         return false;
     }
 
     return true;
 }
+
+/* ============================ 索引页CRC私有实现 ============================ */
+
+/**
+ * @brief 计算单个索引页的CRC16（基于RAM中的索引表）
+ */
+static uint16_t calc_page_crc(const tlv_context_t *ctx, uint32_t page)
+{
+    uint32_t first = page * TLV_INDEX_ENTRIES_PER_PAGE;
+    uint32_t count = TLV_MAX_TAG_COUNT - first;
+    if (count > TLV_INDEX_ENTRIES_PER_PAGE)
+    {
+        count = TLV_INDEX_ENTRIES_PER_PAGE;
+    }
+
+    return tlv_crc16(&ctx->index_table->entries[first], count * sizeof(tlv_index_entry_t));
+}
+
+/**
+ * @brief 按RAM中的索引表计算并写入整个索引页CRC表
+ */
+static int save_page_crc_table(const tlv_context_t *ctx)
+{
+    tlv_index_page_crc_t page_crc;
+    for (uint32_t page = 0; page < TLV_INDEX_PAGE_COUNT; page++)
+    {
+        page_crc.page_crc16[page] = calc_page_crc(ctx, page);
+    }
+
+    int ret = ctx->ops->write(TLV_INDEX_PAGE_CRC_ADDR, &page_crc, sizeof(page_crc));
+    if (ret == TLV_OK)
+    {
+        ((tlv_context_t *)ctx)->index_crc_dirty = false;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 逐条校验索引页指向的数据块（用于页CRC不匹配时的恢复）
+ *
+ * 条目写入后、页CRC写入前掉电时,页内条目本身是完整的（数据块先于索引落盘）。
+ * 页内所有有效条目指向的数据块Tag与CRC均正确时,认为该页可信。
+ *
+ * @return true 页内条目全部可信, false 存在无法验证的条目
+ */
+static bool verify_page_blocks(const tlv_context_t *ctx, uint32_t page)
+{
+    uint32_t first = page * TLV_INDEX_ENTRIES_PER_PAGE;
+    uint32_t last = first + TLV_INDEX_ENTRIES_PER_PAGE;
+    if (last > TLV_MAX_TAG_COUNT)
+    {
+        last = TLV_MAX_TAG_COUNT;
+    }
+
+    for (uint32_t i = first; i < last; i++)
+    {
+        const tlv_index_entry_t *entry = &ctx->index_table->entries[i];
+        if (!(entry->flags & TLV_FLAG_VALID))
+        {
+            // 无效槽位只可能是空槽（删除时清零）或待复用的脏槽,其他内容视为损坏
+            static const tlv_index_entry_t empty = {0};
+            if (memcmp(entry, &empty, sizeof(empty)) != 0 && entry->flags != TLV_FLAG_DIRTY)
+            {
+                return false;
+            }
+            continue;
+        }
+
+        tlv_data_block_header_t header;
+        if (!TLV_IS_VALID_ADDR(ctx, entry->data_addr) ||
+            ctx->ops->read(entry->data_addr, &header, sizeof(header)) != TLV_OK ||
+            header.tag != entry->tag ||
+            entry->data_addr + TLV_BLOCK_SIZE(header.length) > ctx->backup_addr)
+        {
+            return false;
+        }
+
+        // 分段计算数据块CRC（环形日志块的CRC只覆盖块头,记录各带CRC）
+        uint16_t crc = tlv_crc16_update(tlv_crc16_init(), &header, sizeof(header));
+        uint8_t chunk[32];
+        uint32_t addr = entry->data_addr + sizeof(header);
+        uint32_t remain = (header.flags & TLV_BLOCK_FLAG_LOG) ? 0 : header.length;
+        while (remain > 0)
+        {
+            uint32_t n = (remain > sizeof(chunk)) ? sizeof(chunk) : remain;
+            if (ctx->ops->read(addr, chunk, n) != TLV_OK)
+            {
+                return false;
+            }
+            crc = tlv_crc16_update(crc, chunk, n);
+            addr += n;
+            remain -= n;
+        }
+
+        uint16_t stored_crc;
+        addr = entry->data_addr + sizeof(header) + header.length;
+        if (ctx->ops->read(addr, &stored_crc, sizeof(stored_crc)) != TLV_OK ||
+            tlv_crc16_final(crc) != stored_crc)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief 读取FRAM中的索引页CRC表并逐页校验RAM中的索引表
+ *
+ * 页CRC不匹配时逐条校验该页指向的数据块,通过则修复该页CRC。
+ *
+ * @return TLV_OK 全部页有效, TLV_ERROR_CRC_FAILED 存在损坏页, 其他 FRAM读写错误码
+ */
+static int verify_pages(const tlv_context_t *ctx)
+{
+    tlv_index_page_crc_t page_crc;
+    int ret = ctx->ops->read(TLV_INDEX_PAGE_CRC_ADDR, &page_crc, sizeof(page_crc));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    for (uint32_t page = 0; page < TLV_INDEX_PAGE_COUNT; page++)
+    {
+        ret = verify_page(ctx, page, page_crc.page_crc16[page]);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+    }
+
+    return TLV_OK;
+}
+
+/**
+ * @brief 以FRAM中的页CRC校验RAM中的单个索引页
+ *
+ * 页CRC不匹配时逐条校验该页指向的数据块,通过则修复该页CRC。
+ */
+static int verify_page(const tlv_context_t *ctx, uint32_t page, uint16_t stored_crc)
+{
+    uint16_t crc = calc_page_crc(ctx, page);
+    if (crc == stored_crc)
+    {
+        return TLV_OK;
+    }
+
+    if (!verify_page_blocks(ctx, page))
+    {
+        return TLV_ERROR_CRC_FAILED;
+    }
+
+    // 修复页CRC
+    tlv_index_mark_backup_dirty(ctx, TLV_INDEX_PAGE_CRC_ADDR + page * sizeof(uint16_t), sizeof(crc));
+    return ctx->ops->write(TLV_INDEX_PAGE_CRC_ADDR + page * sizeof(uint16_t), &crc, sizeof(crc));
+}
+
+int tlv_index_verify_page(const tlv_context_t *ctx, uint32_t page)
+{
+    if (!ctx || !ctx->index_table || page >= TLV_INDEX_PAGE_COUNT)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    uint16_t stored_crc;
+    int ret = ctx->ops->read(TLV_INDEX_PAGE_CRC_ADDR + page * sizeof(uint16_t), &stored_crc, sizeof(stored_crc));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    return verify_page(ctx, page, stored_crc);
+}
+
+/* ============================ 哈希表私有实现 ============================ */
+
+/**
+ * @brief 计算Tag的哈希起始位置（乘法散列）
+ */
+static inline uint32_t hash_home(uint16_t tag)
+{
+    uint32_t h = (uint32_t)tag * 2654435761u;
+    return (h >> 16) & INDEX_HASH_MASK;
+}
+
+/**
+ * @brief 查找Tag在哈希表中的位置
+ *
+ * @param ctx TLV上下文指针
+ * @param tag 标签值
+ * @return 哈希表位置,-1表示不存在
+ */
+static int hash_find_pos(const tlv_context_t *ctx, uint16_t tag)
+{
+    uint32_t pos = hash_home(tag);
+
+    for (uint32_t n = 0; n < TLV_INDEX_HASH_SIZE; n++)
+    {
+        uint16_t value = ctx->index_hash[pos];
+        if (value == 0)
+        {
+            return -1;
+        }
+        if (ctx->index_table->entries[value - 1].tag == tag)
+        {
+            return (int)pos;
+        }
+        pos = (pos + 1) & INDEX_HASH_MASK;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief 将索引槽位加入哈希表（同Tag已存在时覆盖为新槽位）
+ *
+ * @param ctx TLV上下文指针
+ * @param slot 索引槽位号
+ * @return TLV_OK 成功, TLV_ERROR_NO_INDEX_SPACE 哈希表已满
+ */
+static int hash_insert(const tlv_context_t *ctx, uint32_t slot)
+{
+    uint16_t tag = ctx->index_table->entries[slot].tag;
+    uint32_t pos = hash_home(tag);
+
+    for (uint32_t n = 0; n < TLV_INDEX_HASH_SIZE; n++)
+    {
+        uint16_t value = ctx->index_hash[pos];
+        if (value == 0 || ctx->index_table->entries[value - 1].tag == tag)
+        {
+            ctx->index_hash[pos] = (uint16_t)(slot + 1);
+            return TLV_OK;
+        }
+        pos = (pos + 1) & INDEX_HASH_MASK;
+    }
+
+    return TLV_ERROR_NO_INDEX_SPACE;
+}
+
+/**
+ * @brief 将索引槽位移出哈希表（后移删除,不留墓碑）
+ *
+ * 仅当该槽位的Tag当前映射到该槽位时才删除,必须在修改槽位Tag之前调用。
+ *
+ * @param ctx TLV上下文指针
+ * @param slot 索引槽位号
+ */
+static void hash_remove_slot(const tlv_context_t *ctx, uint32_t slot)
+{
+    if (!ctx->index_hash || ctx->index_table->entries[slot].tag == 0)
+    {
+        return;
+    }
+
+    int pos = hash_find_pos(ctx, ctx->index_table->entries[slot].tag);
+    if (pos < 0 || ctx->index_hash[pos] != slot + 1)
+    {
+        return;
+    }
+
+    uint32_t i = (uint32_t)pos;
+    uint32_t j = i;
+    for (;;)
+    {
+        j = (j + 1) & INDEX_HASH_MASK;
+        uint16_t value = ctx->index_hash[j];
+        if (value == 0)
+        {
+            break;
+        }
+
+        // 起始位置落在(i, j]循环区间内的条目无需前移
+        uint32_t k = hash_home(ctx->index_table->entries[value - 1].tag);
+        bool in_range = (i <= j) ? (k > i && k <= j) : (k > i || k <= j);
+        if (in_range)
+        {
+            continue;
+        }
+
+        ctx->index_hash[i] = value;
+        i = j;
+    }
+    ctx->index_hash[i] = 0;
+}
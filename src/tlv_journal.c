@@ -0,0 +1,403 @@
+/**
+ * @file tlv_journal.c
+ * @brief TLV FRAM存储系统提交日志（索引变更追加记录、启动重放与检查点）
+ */
+
+#include "tlv_core_internal.h"
+
+#if TLV_JOURNAL_ENABLE
+
+/* ============================ 全局静态变量 ============================ */
+// 提交日志运行时状态
+tlv_journal_context_t tlv_core_journal_ctx = {0};
+
+/* ============================ 私有函数声明 ============================ */
+
+static uint16_t journal_record_crc(uint32_t epoch, const tlv_journal_record_t *record);
+static void journal_mark_dirty(const tlv_index_entry_t *entry);
+static int journal_check_tail(void);
+static void journal_drop_torn_entries(uint32_t page);
+
+/* ============================ 提交日志实现 ============================ */
+/**
+ * @brief 计算提交日志记录的CRC16（包含检查点代号,旧代号的记录校验不通过）
+ */
+static uint16_t journal_record_crc(uint32_t epoch, const tlv_journal_record_t *record)
+{
+    uint16_t crc = tlv_crc16_update(tlv_crc16_init(), &epoch, sizeof(epoch));
+    crc = tlv_crc16_update(crc, record, offsetof(tlv_journal_record_t, crc16));
+    return tlv_crc16_final(crc);
+}
+
+/**
+ * @brief 标记索引条目所在的页,由下次检查点保存
+ */
+static void journal_mark_dirty(const tlv_index_entry_t *entry)
+{
+    uint32_t slot = (uint32_t)(entry - tlv_core_ctx.index_table->entries);
+    tlv_core_journal_ctx.dirty_pages |= (1UL << (slot / TLV_INDEX_ENTRIES_PER_PAGE));
+}
+
+/**
+ * @brief 以新的检查点代号写入日志Header,已有记录随之失效（检查点的提交点）
+ */
+int tlv_core_journal_reset(void)
+{
+    tlv_journal_header_t header;
+    header.epoch = tlv_core_journal_ctx.epoch + 1;
+    header.magic = TLV_JOURNAL_MAGIC;
+    header.crc16 = tlv_crc16(&header, offsetof(tlv_journal_header_t, crc16));
+
+    int ret = tlv_core_ctx.ops->write(TLV_JOURNAL_ADDR, &header, sizeof(header));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    tlv_core_journal_ctx.epoch = header.epoch;
+    tlv_core_journal_ctx.count = 0;
+    tlv_core_journal_ctx.dirty_pages = 0;
+    return TLV_OK;
+}
+
+/**
+ * @brief 清零全部记录后写入日志Header
+ *
+ * 用于格式化与日志Header无效时：旧记录的代号无从得知,清零后才能从任意代号开始追加。
+ * 使用static_buffer,调用方必须持有写锁。
+ */
+int tlv_core_journal_format(void)
+{
+    memset(tlv_core_ctx.static_buffer, 0, TLV_BUFFER_SIZE);
+
+    uint32_t addr = TLV_JOURNAL_RECORD_ADDR(0);
+    uint32_t end = TLV_JOURNAL_RECORD_ADDR(TLV_JOURNAL_ENTRIES);
+    while (addr < end)
+    {
+        uint32_t chunk_size = (end - addr > TLV_BUFFER_SIZE) ? TLV_BUFFER_SIZE : (end - addr);
+        int ret = tlv_core_ctx.ops->write(addr, tlv_core_ctx.static_buffer, chunk_size);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+        addr += chunk_size;
+    }
+
+    return tlv_core_journal_reset();
+}
+
+/**
+ * @brief 启动时读取日志Header并确定有效记录数
+ *
+ * 从第0条开始顺序校验,第一条CRC不符（未写入、属于旧代号或追加时掉电撕裂）的记录即为日志尾部。
+ * Header无效（首次使用,或检查点写日志Header时掉电,此时索引与Header已落盘）时重新初始化日志。
+ * 使用static_buffer,调用方必须持有写锁。
+ */
+int tlv_core_journal_open(void)
+{
+    memset(&tlv_core_journal_ctx, 0, sizeof(tlv_core_journal_ctx));
+
+    tlv_journal_header_t header;
+    int ret = tlv_core_ctx.ops->read(TLV_JOURNAL_ADDR, &header, sizeof(header));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    if (header.magic != TLV_JOURNAL_MAGIC ||
+        header.crc16 != tlv_crc16(&header, offsetof(tlv_journal_header_t, crc16)))
+    {
+        return tlv_core_journal_format();
+    }
+
+    tlv_core_journal_ctx.epoch = header.epoch;
+
+    tlv_journal_record_t *records = (tlv_journal_record_t *)tlv_core_ctx.static_buffer;
+    const uint16_t per_read = TLV_BUFFER_SIZE / sizeof(tlv_journal_record_t);
+    uint16_t count = 0;
+    while (count < TLV_JOURNAL_ENTRIES)
+    {
+        uint16_t n = (TLV_JOURNAL_ENTRIES - count > per_read) ? per_read : (uint16_t)(TLV_JOURNAL_ENTRIES - count);
+        ret = tlv_core_ctx.ops->read(TLV_JOURNAL_RECORD_ADDR(count), records, n * sizeof(tlv_journal_record_t));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        for (uint16_t i = 0; i < n; i++)
+        {
+            if (records[i].entry.tag == 0 ||
+                records[i].crc16 != journal_record_crc(header.epoch, &records[i]))
+            {
+                tlv_core_journal_ctx.count = count + i;
+                return journal_check_tail();
+            }
+        }
+
+        count += n;
+    }
+
+    tlv_core_journal_ctx.count = count;
+    return journal_check_tail();
+}
+
+/**
+ * @brief 校验日志最后一条记录所指的数据块
+ *
+ * 追加记录时掉电,新记录的前缀与槽位中的旧内容拼成的记录仍有约1/65536的概率通过CRC16校验。
+ * 数据块总是先于记录写入,在下一条记录之前不会被覆盖,因此最后一条记录所指数据块的Tag或长度
+ * 不符时按撕裂的记录丢弃。删除记录不指向数据块,不做此项校验。
+ */
+static int journal_check_tail(void)
+{
+    if (tlv_core_journal_ctx.count == 0)
+    {
+        return TLV_OK;
+    }
+
+    tlv_journal_record_t record;
+    int ret = tlv_core_ctx.ops->read(TLV_JOURNAL_RECORD_ADDR(tlv_core_journal_ctx.count - 1), &record, sizeof(record));
+    if (ret != TLV_OK || !(record.entry.flags & TLV_FLAG_VALID))
+    {
+        return ret;
+    }
+
+    tlv_data_block_header_t header;
+    if (!TLV_IS_SIZE_SAFE(&tlv_core_ctx, record.entry.data_addr, TLV_BLOCK_SIZE(record.length)))
+    {
+        tlv_core_journal_ctx.count--;
+        return TLV_OK;
+    }
+
+    ret = tlv_core_ctx.ops->read(record.entry.data_addr, &header, sizeof(header));
+    if (ret == TLV_OK && (header.tag != record.entry.tag || header.length != record.length))
+    {
+        tlv_core_journal_ctx.count--;
+    }
+
+    return ret;
+}
+
+/**
+ * @brief 追加一条提交记录（提交点）
+ *
+ * 写满时立即检查点：此时RAM中索引的每处修改都已有记录,检查点中途掉电由记录重放补齐。
+ * @param slot 被修改的索引槽位（用于标记脏页）
+ * @param value 提交后的条目内容
+ * @param length 数据块长度
+ */
+int tlv_core_journal_append(const tlv_index_entry_t *slot, const tlv_index_entry_t *value, uint16_t length)
+{
+    tlv_journal_record_t record;
+    record.entry = *value;
+    record.length = length;
+    record.crc16 = journal_record_crc(tlv_core_journal_ctx.epoch, &record);
+
+    journal_mark_dirty(slot);
+    int ret = tlv_core_ctx.ops->write(TLV_JOURNAL_RECORD_ADDR(tlv_core_journal_ctx.count), &record, sizeof(record));
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    tlv_core_journal_ctx.count++;
+    return (tlv_core_journal_ctx.count >= TLV_JOURNAL_ENTRIES) ? tlv_core_journal_checkpoint() : TLV_OK;
+}
+
+/**
+ * @brief 把日志中的记录按顺序重放到RAM中的索引表
+ *
+ * 记录按Tag应用（更新、新增或删除）,重放到任何不早于上次检查点的索引表上结果相同,
+ * 因此检查点写索引页时掉电同样适用。重放过的页标记为脏页,由下次检查点落盘；
+ * Header中的空间字段由调用方随后按数据块重新统计。
+ * 使用static_buffer,调用方必须持有写锁。
+ */
+int tlv_core_journal_replay(void)
+{
+    if (tlv_core_journal_ctx.count == 0)
+    {
+        return TLV_OK;
+    }
+
+    tlv_printf("Replaying commit journal (%u records)\n", tlv_core_journal_ctx.count);
+    tlv_core_block_info_invalidate_all();
+
+    tlv_journal_record_t *records = (tlv_journal_record_t *)tlv_core_ctx.static_buffer;
+    const uint16_t per_read = TLV_BUFFER_SIZE / sizeof(tlv_journal_record_t);
+    uint16_t done = 0;
+    while (done < tlv_core_journal_ctx.count)
+    {
+        uint16_t n = (tlv_core_journal_ctx.count - done > per_read) ? per_read : (uint16_t)(tlv_core_journal_ctx.count - done);
+        int ret = tlv_core_ctx.ops->read(TLV_JOURNAL_RECORD_ADDR(done), records, n * sizeof(tlv_journal_record_t));
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+
+        for (uint16_t i = 0; i < n; i++)
+        {
+            const tlv_index_entry_t *value = &records[i].entry;
+            tlv_index_entry_t *index = tlv_index_find(&tlv_core_ctx, value->tag);
+
+            if (!(value->flags & TLV_FLAG_VALID))
+            {
+                if (index)
+                {
+                    journal_mark_dirty(index);
+                    tlv_index_remove(&tlv_core_ctx, value->tag);
+                }
+                continue;
+            }
+
+            if (!TLV_IS_SIZE_SAFE(&tlv_core_ctx, value->data_addr, TLV_BLOCK_SIZE(records[i].length)))
+            {
+                return TLV_ERROR_CORRUPTED;
+            }
+
+            if (!index)
+            {
+                index = tlv_index_add(&tlv_core_ctx, value->tag, value->data_addr);
+                if (!index)
+                {
+                    return TLV_ERROR_CORRUPTED;
+                }
+            }
+
+            *index = *value;
+            journal_mark_dirty(index);
+        }
+
+        done += n;
+    }
+
+    // 检查点写索引页时掉电,换过槽位的Tag可能新旧两个槽位同时留在页中（两者所指数据块都完好时
+    // 页校验会接受这样的页）。重放只更新哈希表指向的一个,另一个清除
+    for (uint32_t i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    {
+        tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        if ((entry->flags & TLV_FLAG_VALID) && tlv_index_find(&tlv_core_ctx, entry->tag) != entry)
+        {
+            journal_mark_dirty(entry);
+            memset(entry, 0, sizeof(tlv_index_entry_t));
+        }
+    }
+
+    // 日志已满（检查点中途掉电）时立即检查点,之后的记录才有位置追加
+    return (tlv_core_journal_ctx.count >= TLV_JOURNAL_ENTRIES) ? tlv_core_journal_checkpoint() : TLV_OK;
+}
+
+/**
+ * @brief 清除撕裂索引页中不属于任何已提交状态的条目
+ *
+ * 掉电位置所在的条目可能由检查点前后两份条目的字节拼成（Tag、标志或地址不属于任何一方）。
+ * 前后两份内容对应的Tag都有日志记录,已由重放建在哈希表指向的槽位；其余未修改的条目前后
+ * 两份相同,所指数据块完好,因此数据块无法校验的条目可以直接清除。
+ * @param page 页CRC不符的索引页
+ */
+static void journal_drop_torn_entries(uint32_t page)
+{
+    uint32_t first = page * TLV_INDEX_ENTRIES_PER_PAGE;
+    uint32_t last = first + TLV_INDEX_ENTRIES_PER_PAGE;
+    if (last > TLV_MAX_TAG_COUNT)
+    {
+        last = TLV_MAX_TAG_COUNT;
+    }
+
+    static const tlv_index_entry_t empty = {0};
+    for (uint32_t i = first; i < last; i++)
+    {
+        tlv_index_entry_t *entry = &tlv_core_ctx.index_table->entries[i];
+        uint16_t length;
+        if (!(entry->flags & TLV_FLAG_VALID))
+        {
+            if (memcmp(entry, &empty, sizeof(empty)) != 0 && entry->flags != TLV_FLAG_DIRTY)
+            {
+                memset(entry, 0, sizeof(tlv_index_entry_t));
+            }
+            continue;
+        }
+
+        if (tlv_core_check_block(entry, true, &length) == TLV_OK)
+        {
+            continue;
+        }
+
+        tlv_printf("WARNING: Dropping torn index slot %lu (tag 0x%04X)\n", (unsigned long)i, entry->tag);
+        tlv_core_block_info_invalidate(entry);
+        if (tlv_index_find(&tlv_core_ctx, entry->tag) == entry)
+        {
+            tlv_index_remove(&tlv_core_ctx, entry->tag);
+        }
+        else
+        {
+            memset(entry, 0, sizeof(tlv_index_entry_t));
+        }
+    }
+}
+
+/**
+ * @brief 索引页CRC校验失败时以日志修补索引表
+ *
+ * 检查点写索引页时掉电,FRAM中的页混有检查点前后的条目,而日志仍保留上次检查点以来的全部记录。
+ * 在加载的索引表上重放日志后逐页校验（页CRC不符时校验页内条目指向的数据块）,通过后立即
+ * 完成检查点,不必从备份区整区恢复。
+ * @return 0: 成功, TLV_ERROR_CRC_FAILED: 无法修补（由调用方从备份恢复）, 其他: 错误码
+ */
+int tlv_core_journal_repair_index(void)
+{
+    tlv_printf("WARNING: Index torn, repairing from commit journal\n");
+
+    int ret = tlv_index_rebuild_hash(&tlv_core_ctx);
+    if (ret == TLV_OK)
+    {
+        ret = tlv_core_journal_replay();
+    }
+
+    for (uint32_t page = 0; ret == TLV_OK && page < TLV_INDEX_PAGE_COUNT; page++)
+    {
+        ret = tlv_index_verify_page(&tlv_core_ctx, page);
+        if (ret == TLV_ERROR_CRC_FAILED)
+        {
+            journal_drop_torn_entries(page);
+            ret = tlv_index_verify_page(&tlv_core_ctx, page);
+        }
+    }
+
+    if (ret != TLV_OK)
+    {
+        return TLV_ERROR_CRC_FAILED;
+    }
+
+    tlv_core_journal_ctx.dirty_pages = UINT32_MAX;
+    return tlv_core_journal_checkpoint();
+}
+
+/**
+ * @brief 检查点：保存日志覆盖的索引页与Header,然后以新代号清空日志
+ *
+ * 写入顺序：索引页 -> 整表CRC与页CRC表 -> Header -> 日志Header。日志Header写入前掉电时,
+ * 启动时重放的记录与已写入的索引一致；写日志Header时掉电,其CRC不符,按空日志重新初始化。
+ */
+int tlv_core_journal_checkpoint(void)
+{
+    if (tlv_core_journal_ctx.count == 0 && tlv_core_journal_ctx.dirty_pages == 0 && !tlv_core_ctx.index_crc_dirty)
+    {
+        return tlv_core_ctx.header_dirty ? tlv_core_system_header_save() : TLV_OK;
+    }
+
+    int ret = tlv_index_save_page_mask(&tlv_core_ctx, tlv_core_journal_ctx.dirty_pages);
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    ret = tlv_core_system_header_save();
+    if (ret != TLV_OK)
+    {
+        return ret;
+    }
+
+    return tlv_core_journal_reset();
+}
+
+#endif /* TLV_JOURNAL_ENABLE */
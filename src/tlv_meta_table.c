@@ -7,46 +7,34 @@
  * 
  * @copyright Copyright (c) 2025
  * @note 需要维护一个TLV元数据表,元数据表是一个常量表,存储元数据信息,元数据信息包括Tag、MaxLen、Prior、Ver、Bkup、Name等信息。
- *       该文件实现了元数据表的定义和获取函数。可在其他文件中定义新的元数据表以覆盖默认实现。
+ *       元数据在tlv_meta_list.h的TLV_META_LIST中声明,该文件据此生成元数据表并实现获取函数。可在其他文件中定义新的元数据表以覆盖默认实现。
  */
  
 #include "tlv_meta_table.h"
-#include "tlv_tag.h"
-#include "system_config_versions.h"
+#include "tlv_meta_list.h"
+
+/* ============================ 查找表私有变量 ============================ */
+/* 已构建查找表的元数据表 */
+static const tlv_meta_const_t *g_lookup_table = NULL;
+static uint16_t g_lookup_count = 0;
+/* 原表是否已按Tag升序（可直接二分） */
+static bool g_lookup_sorted = false;
+/* 原表无序时,按Tag排序的下标表 */
+static uint16_t g_lookup_order[TLV_MAX_META_COUNT];
 
 /* ============================ 元数据表实现 ============================ */
 static const tlv_meta_const_t TLV_META_MAP[] = 
 {
-    // Tag                      MaxLen  Prior Ver  Bkup  Name
-    {TAG_SYSTEM_CONFIG,         64,     10,   1,   1,   "SystemConfig",     migrate_system_config},
-    {TAG_SYSTEM_CALIBRATION,    128,    10,   1,   1,   "SystemCalibration",     NULL},
-    {TAG_SYSTEM_SERIAL_NUMBER,  32,     10,   1,   1,   "SerialNumber",     NULL},
-    {TAG_SYSTEM_MAC_ADDRESS,    8,      10,   1,   1,   "MACAddress",     NULL},
-    {TAG_SYSTEM_BOOT_COUNT,     4,      5,    1,   0,   "BootCount",     NULL},
- 
-    {TAG_SENSOR_CALIB_TEMP,     16,     8,    1,   1,   "SensorCalibTemp",     NULL},
-    {TAG_SENSOR_CALIB_PRESSURE, 16,     8,    1,   1,   "SensorCalibPressure",     NULL},
-    {TAG_SENSOR_CALIB_HUMIDITY, 16,     8,    1,   1,   "SensorCalibHumidity",     NULL},
-    {TAG_SENSOR_OFFSET_X,       12,     6,    1,   0,   "SensorOffsetX",     NULL},
-    {TAG_SENSOR_OFFSET_Y,       12,     6,    1,   0,   "SensorOffsetY",     NULL},
-    {TAG_SENSOR_OFFSET_Z,       12,     6,    1,   0,   "SensorOffsetZ",     NULL},
- 
-    {TAG_NET_IP_ADDRESS,        16,     7,    1,   1,   "IPAddress",     NULL},
-    {TAG_NET_SUBNET_MASK,       16,     7,    1,   1,   "SubnetMask",     NULL},
-    {TAG_NET_GATEWAY,           16,     7,    1,   1,   "Gateway",     NULL},
-    {TAG_NET_DNS_SERVER,        16,     7,    1,   1,   "DNSServer",     NULL},
-    {TAG_NET_WIFI_SSID,         64,     7,    1,   1,   "WiFiSSID",     NULL},
-    {TAG_NET_WIFI_PASSWORD,     64,     7,    1,   1,   "WiFiPassword",     NULL},
- 
-    {TAG_USER_PROFILE,          256,    5,    1,   1,   "UserProfile",     NULL},
-    {TAG_USER_SETTINGS,         128,    5,    1,   1,   "UserSettings",     NULL},
-    {TAG_USER_PREFERENCES,      64,     5,    1,   0,   "UserPreferences",     NULL},
-    {TAG_USER_HISTORY,          512,    3,    1,   0,   "UserHistory",     NULL},
+    // 由tlv_meta_list.h中的TLV_META_LIST生成
+    TLV_META_LIST(TLV_META_ROW, TLV_META_ROW_RAW)
  
     // 终止符
-    {0xFFFF,                    0,      0,    0,   0,   NULL,     NULL}
+    {0xFFFF,                    0,      0,    0,   0,   NULL,     NULL, 0}
 };
 
+STATIC_ASSERT(sizeof(TLV_META_MAP) / sizeof(TLV_META_MAP[0]) == TLV_META_ROW_COUNT + 1,
+              "TLV_META_ROW_* must match TLV_META_MAP rows");
+
 /**
  * @brief 获取元数据表
  */
@@ -63,3 +51,121 @@ __weak int tlv_get_meta_table_size(void)
     return (sizeof(TLV_META_MAP) / sizeof(TLV_META_MAP[0])) - 1;
 }
 
+/* ============================ 元数据查找实现 ============================ */
+/**
+ * @brief 构建元数据查找表
+ * @note 查找表构建失败时tlv_meta_find回退为线性遍历
+ */
+int tlv_meta_lookup_build(const tlv_meta_const_t *meta_table, uint16_t size)
+{
+    g_lookup_table = NULL;
+    g_lookup_count = 0;
+    g_lookup_sorted = false;
+
+    if (!meta_table)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 校验Tag合法并检查是否已升序
+    bool sorted = true;
+    for (uint16_t i = 0; i < size; i++)
+    {
+        if (meta_table[i].tag == 0 || meta_table[i].tag == 0xFFFF)
+        {
+            tlv_printf("ERROR: Invalid tag 0x%04X in meta table (row %u)\n", meta_table[i].tag, i);
+            return TLV_ERROR_INVALID_PARAM;
+        }
+        if (i > 0 && meta_table[i].tag <= meta_table[i - 1].tag)
+        {
+            sorted = false;
+        }
+    }
+
+    if (!sorted)
+    {
+        if (size > TLV_MAX_META_COUNT)
+        {
+            tlv_printf("ERROR: Unsorted meta table exceeds TLV_MAX_META_COUNT\n");
+            return TLV_ERROR_NO_BUFFER_MEMORY;
+        }
+
+        // 插入排序（稳定）,构建下标表
+        for (uint16_t i = 0; i < size; i++)
+        {
+            uint16_t j = i;
+            while (j > 0 && meta_table[g_lookup_order[j - 1]].tag > meta_table[i].tag)
+            {
+                g_lookup_order[j] = g_lookup_order[j - 1];
+                j--;
+            }
+            g_lookup_order[j] = i;
+        }
+
+        // 排序后检查重复Tag
+        for (uint16_t i = 1; i < size; i++)
+        {
+            if (meta_table[g_lookup_order[i]].tag == meta_table[g_lookup_order[i - 1]].tag)
+            {
+                tlv_printf("ERROR: Duplicate tag 0x%04X in meta table\n",
+                           meta_table[g_lookup_order[i]].tag);
+                return TLV_ERROR_INVALID_PARAM;
+            }
+        }
+    }
+
+    g_lookup_table = meta_table;
+    g_lookup_count = size;
+    g_lookup_sorted = sorted;
+
+    return TLV_OK;
+}
+
+/**
+ * @brief 根据Tag查找元数据
+ */
+const tlv_meta_const_t *tlv_meta_find(const tlv_meta_const_t *meta_table, uint16_t tag)
+{
+    if (!meta_table || tag == 0 || tag == 0xFFFF)
+    {
+        return NULL;
+    }
+
+    // 查找表未构建（或不是同一张表）,线性遍历
+    if (meta_table != g_lookup_table)
+    {
+        for (int i = 0; meta_table[i].tag != 0xFFFF; i++)
+        {
+            if (meta_table[i].tag == tag)
+            {
+                return &meta_table[i];
+            }
+        }
+        return NULL;
+    }
+
+    // 二分查找
+    uint16_t low = 0;
+    uint16_t high = g_lookup_count;
+    while (low < high)
+    {
+        uint16_t mid = low + (high - low) / 2;
+        uint16_t row = g_lookup_sorted ? mid : g_lookup_order[mid];
+        uint16_t mid_tag = meta_table[row].tag;
+
+        if (mid_tag == tag)
+        {
+            return &meta_table[row];
+        }
+        if (mid_tag < tag)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NULL;
+}
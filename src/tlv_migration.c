@@ -22,18 +22,7 @@ static const tlv_meta_const_t *get_meta(const tlv_context_t *ctx, uint16_t tag)
         return NULL;
     }
 
-    for (uint32_t i = 0; i < ctx->meta_table_size; i++)
-    {
-        if (ctx->meta_table[i].tag == tag)
-        {
-            return &ctx->meta_table[i];
-        }
-        if (ctx->meta_table[i].tag == 0xFFFF)
-        {
-            break;
-        }
-    }
-    return NULL;
+    return tlv_meta_find(ctx->meta_table, tag);
 }
 
 /* ============================ 核心迁移函数 ============================ */
@@ -138,122 +127,24 @@ int tlv_migrate_tag(const tlv_context_t *ctx,
 
 int tlv_migrate_all(void)
 {
-    extern const tlv_context_t *tlv_get_context(void);
-    const tlv_context_t *ctx = tlv_get_context();
-    if (!ctx || !ctx->index_table)
-    {
-        return TLV_ERROR_INVALID_PARAM;
-    }
-    if (ctx->state != TLV_STATE_INITIALIZED)
+    // 不限预算：每步仍以一个事务提交最多TLV_MAX_TXN_ENTRIES个Tag
+    int ret;
+    do
     {
-        return TLV_ERROR;
-    }
+        ret = tlv_migrate_step(UINT32_MAX);
+    } while (ret > 0);
 
-    g_migrated_count = 0;
-    g_failed_count = 0;
-
-    // 遍历所有索引
-    for (int i = 0; i < TLV_MAX_TAG_COUNT; i++)
+    if (ret < 0)
     {
-        tlv_index_entry_t *entry = &ctx->index_table->entries[i];
-
-        if (entry->tag == 0 || !(entry->flags & TLV_FLAG_VALID))
-        {
-            continue;
-        }
-
-        // 查找元数据
-        const tlv_meta_const_t *meta = get_meta(ctx, entry->tag);
-        if (!meta)
-        {
-            continue; // Tag不在元数据表中,跳过
-        }
-
-        // 检查版本
-        if (entry->version == meta->version)
-        {
-            continue; // 版本相同,无需迁移
-        }
-
-        if (entry->version > meta->version)
-        {
-            // 版本降级,警告但跳过
-            tlv_printf("WARNING: Tag 0x%04X version downgrade detected (v%u -> v%u)\n",
-                       entry->tag, entry->version, meta->version);
-            g_failed_count++;
-            continue;
-        }
-
-        if (!meta->migrate)
-        {
-            // 无迁移函数,警告但跳过
-            tlv_printf("WARNING: Tag 0x%04X needs migration but no function provided\n",
-                       entry->tag);
-            g_failed_count++;
-            continue;
-        }
-
-        // ========== 需要迁移 ==========
-
-        // 分配缓冲区（使用栈或静态,根据大小）
-        uint8_t stack_buffer[256]; // 小缓冲区在栈上
-        uint8_t *buffer = NULL;
-        uint16_t buffer_size = 0;
-
-        if (meta->max_length <= sizeof(stack_buffer))
-        {
-            // 小数据：使用栈缓冲区
-            buffer = stack_buffer;
-            buffer_size = sizeof(stack_buffer);
-        }
-        else if (meta->max_length <= TLV_BUFFER_SIZE)
-        {
-            // 中等数据：使用全局静态缓冲区
-            buffer = (uint8_t *)ctx->static_buffer;
-            buffer_size = TLV_BUFFER_SIZE;
-        }
-        else
-        {
-            // 数据太大,跳过
-            tlv_printf("ERROR: Tag 0x%04X too large for migration (%u bytes)\n",
-                       entry->tag, meta->max_length);
-            g_failed_count++;
-            continue;
-        }
-
-        // 读取旧数据
-        uint16_t read_len = buffer_size;
-        extern int read_data_block(uint32_t addr, void *buf, uint16_t *len);
-        int ret = read_data_block(entry->data_addr, buffer, &read_len);
-        if (ret != TLV_OK)
-        {
-            g_failed_count++;
-            continue;
-        }
-
-        // 迁移数据(原地)
-        uint16_t new_len = 0;
-        ret = tlv_migrate_tag(ctx, entry->tag, buffer, read_len, &new_len,
-                              buffer_size, entry->version);
-        if (ret != TLV_OK)
-        {
-            g_failed_count++;
-            continue;
-        }
-
-        // 写回新数据
-        ret = tlv_write(entry->tag, buffer, new_len);
-        if (ret < 0)
-        {
-            g_failed_count++;
-            continue;
-        }
-
-        // 更新索引版本（tlv_write已经更新）
-        g_migrated_count++;
+        return ret;
     }
 
-    return g_migrated_count;
+    tlv_migrate_progress_t progress;
+    tlv_get_migration_progress(&progress);
+    g_migrated_count = progress.migrated;
+    g_failed_count = progress.failed;
+
+    return (int)g_migrated_count;
 }
 
 /* ============================ 统计函数 ============================ */
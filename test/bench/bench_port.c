@@ -0,0 +1,228 @@
+/**
+ * @file bench_port.c
+ * @brief 主机基准测试用移植层实现
+ *
+ * 不真正延时,只把每次传输的模拟时间累加到计数器,结果与主机速度无关、可重复。
+ * 时间戳接口返回模拟时间,使运行结果完全确定。
+ * 掉电注入只让指定的一次写入落下一段前缀,之后的写入全部丢弃,模拟写入过程中断电。
+ */
+
+#include "bench_port.h"
+#include "tlv_port.h"
+#include <string.h>
+
+#if TLV_THREAD_SAFE || TLV_ASYNC_ENABLE
+#error "bench port implements neither the lock nor the async DMA interface"
+#endif
+
+static uint8_t s_fram[TLV_FRAM_MAX_SIZE];
+static bench_port_counters_t s_counters;
+static uint32_t s_txn_ns = 0;
+static uint32_t s_byte_ns = 0;
+static uint32_t s_cut_countdown = 0;
+static uint32_t s_cut_prefix = 0;
+static int s_power_lost = 0;
+static uint32_t s_watch_addr = 0;
+static uint32_t s_watch_size = 0;
+static uint32_t s_watch_hits = 0;
+
+/**
+ * @brief 按掉电注入状态计算本次写入实际落下的字节数
+ */
+static uint32_t bench_landed(uint32_t size)
+{
+    if (s_power_lost)
+    {
+        return 0;
+    }
+    if (s_cut_countdown == 0 || --s_cut_countdown > 0)
+    {
+        return size;
+    }
+
+    s_power_lost = 1;
+    return (s_cut_prefix < size) ? s_cut_prefix : size;
+}
+
+/**
+ * @brief 落下的写入与监视区重叠时计入命中
+ */
+static void bench_watch(uint32_t addr, uint32_t landed)
+{
+    if (landed > 0 && addr < s_watch_addr + s_watch_size && addr + landed > s_watch_addr)
+    {
+        s_watch_hits++;
+    }
+}
+
+/**
+ * @brief 累计一次传输
+ */
+static void bench_account(int is_write, uint32_t size)
+{
+    if (is_write)
+    {
+        s_counters.write_txns++;
+        s_counters.bytes_written += size;
+    }
+    else
+    {
+        s_counters.read_txns++;
+        s_counters.bytes_read += size;
+    }
+    s_counters.bus_ns += s_txn_ns + (uint64_t)s_byte_ns * size;
+}
+
+void bench_port_set_latency(uint32_t txn_ns, uint32_t byte_ns)
+{
+    s_txn_ns = txn_ns;
+    s_byte_ns = byte_ns;
+}
+
+void bench_port_fill(uint8_t value)
+{
+    memset(s_fram, value, sizeof(s_fram));
+}
+
+void bench_port_set_power_cut(uint32_t n, uint32_t prefix)
+{
+    s_cut_countdown = n;
+    s_cut_prefix = prefix;
+}
+
+int bench_port_power_lost(void)
+{
+    return s_power_lost;
+}
+
+void bench_port_power_on(void)
+{
+    s_cut_countdown = 0;
+    s_power_lost = 0;
+}
+
+void bench_port_set_watch(uint32_t addr, uint32_t size)
+{
+    s_watch_addr = addr;
+    s_watch_size = size;
+    s_watch_hits = 0;
+}
+
+uint32_t bench_port_take_watch_hits(void)
+{
+    uint32_t hits = s_watch_hits;
+    s_watch_hits = 0;
+    return hits;
+}
+
+void bench_port_reset_counters(void)
+{
+    memset(&s_counters, 0, sizeof(s_counters));
+}
+
+void bench_port_get_counters(bench_port_counters_t *counters)
+{
+    *counters = s_counters;
+}
+
+/* ============================ FRAM接口实现 ============================ */
+
+int tlv_port_fram_init(void)
+{
+    return TLV_OK;
+}
+
+int tlv_port_fram_read(uint32_t addr, void *data, uint32_t size)
+{
+    if (addr + size > TLV_FRAM_MAX_SIZE)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    memcpy(data, &s_fram[addr], size);
+    bench_account(0, size);
+    return TLV_OK;
+}
+
+int tlv_port_fram_write(uint32_t addr, const void *data, uint32_t size)
+{
+    if (addr + size > TLV_FRAM_MAX_SIZE)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    uint32_t landed = bench_landed(size);
+    memcpy(&s_fram[addr], data, landed);
+    bench_watch(addr, landed);
+    bench_account(1, size);
+    return TLV_OK;
+}
+
+#if TLV_PORT_VECTOR_IO
+int tlv_port_fram_writev(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < iovcnt; i++)
+    {
+        total += iov[i].size;
+    }
+    if (addr + total > TLV_FRAM_MAX_SIZE)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    // 聚集写入按一次写入注入,前缀依次覆盖各段
+    uint32_t landed = bench_landed(total);
+    bench_watch(addr, landed);
+    for (uint32_t i = 0; i < iovcnt && landed > 0; i++)
+    {
+        uint32_t size = (iov[i].size < landed) ? iov[i].size : landed;
+        memcpy(&s_fram[addr], iov[i].base, size);
+        addr += iov[i].size;
+        landed -= size;
+    }
+    bench_account(1, total);
+    return TLV_OK;
+}
+
+int tlv_port_fram_readv(uint32_t addr, const tlv_iovec_t *iov, uint32_t iovcnt)
+{
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < iovcnt; i++)
+    {
+        total += iov[i].size;
+    }
+    if (addr + total > TLV_FRAM_MAX_SIZE)
+    {
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    for (uint32_t i = 0; i < iovcnt; i++)
+    {
+        memcpy(iov[i].base, &s_fram[addr], iov[i].size);
+        addr += iov[i].size;
+    }
+    bench_account(0, total);
+    return TLV_OK;
+}
+#endif
+
+/* ============================ 时间接口实现 ============================ */
+
+uint32_t tlv_port_get_timestamp_s(void)
+{
+    return (uint32_t)(s_counters.bus_ns / 1000000000u);
+}
+
+uint32_t tlv_port_get_timestamp_ms(void)
+{
+    return (uint32_t)(s_counters.bus_ns / 1000000u);
+}
+
+#if TLV_PERF_STATS
+uint32_t tlv_port_get_perf_tick(void)
+{
+    // 以模拟总线时间（纳秒）计时,接口耗时即其中的FRAM传输时间
+    return (uint32_t)s_counters.bus_ns;
+}
+#endif
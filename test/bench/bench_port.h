@@ -0,0 +1,80 @@
+/**
+ * @file bench_port.h
+ * @brief 主机基准测试用移植层：RAM模拟FRAM,按事务与字节数累计模拟总线时间
+ */
+
+#ifndef BENCH_PORT_H
+#define BENCH_PORT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 端口传输计数 */
+typedef struct
+{
+    uint32_t read_txns;     // 读取事务数（分散读取计一次）
+    uint32_t write_txns;    // 写入事务数（聚集写入计一次）
+    uint64_t bytes_read;    // 读取字节数
+    uint64_t bytes_written; // 写入字节数
+    uint64_t bus_ns;        // 模拟总线时间（纳秒）
+} bench_port_counters_t;
+
+/**
+ * @brief 设置模拟延迟
+ * @param txn_ns 每次事务的固定开销（片选、命令与地址、驱动调用）
+ * @param byte_ns 每字节传输时间
+ */
+void bench_port_set_latency(uint32_t txn_ns, uint32_t byte_ns);
+
+/**
+ * @brief 以指定值填充整片模拟FRAM（不计入传输统计）
+ */
+void bench_port_fill(uint8_t value);
+
+/**
+ * @brief 设置掉电注入：之后第n次写入只落下前prefix字节,随后的写入全部丢弃（直至bench_port_power_on）
+ * @param n 距离掉电的写入次数（1为下一次写入,0为取消）
+ * @param prefix 掉电那次写入落下的字节数（不小于写入长度时整次写入落下）
+ */
+void bench_port_set_power_cut(uint32_t n, uint32_t prefix);
+
+/**
+ * @brief 是否已经发生注入的掉电
+ */
+int bench_port_power_lost(void);
+
+/**
+ * @brief 重新上电：取消掉电注入,此后写入恢复正常
+ */
+void bench_port_power_on(void);
+
+/**
+ * @brief 设置写入监视区：之后落在[addr, addr + size)内的写入（至少落下一个字节）计入命中次数
+ * @param addr 监视区起始地址
+ * @param size 监视区大小（0为取消监视）
+ */
+void bench_port_set_watch(uint32_t addr, uint32_t size);
+
+/**
+ * @brief 取出并清零监视区写入命中次数
+ */
+uint32_t bench_port_take_watch_hits(void);
+
+/**
+ * @brief 清零传输计数
+ */
+void bench_port_reset_counters(void);
+
+/**
+ * @brief 获取传输计数
+ */
+void bench_port_get_counters(bench_port_counters_t *counters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_PORT_H */
@@ -0,0 +1,941 @@
+/**
+ * @file tlv_bench.c
+ * @brief 主机基准测试：固定种子的典型负载,输出主机CPU时间与模拟FRAM传输量
+ *
+ * 用法：tlv_bench [-t 事务开销ns] [-b 每字节ns] [-n 规模倍数] [-s 种子] [-c 掉电次数]
+ * 任一操作返回错误、或掉电注入后数据既非旧值也非新值时以非0退出,可直接用于回归检查。
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include "tlv_file_system.h"
+#include "bench_port.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** 默认模拟20MHz SPI FRAM：每字节400ns,每次事务约2us（命令、地址与驱动开销） */
+#define BENCH_DEFAULT_TXN_NS  2000
+#define BENCH_DEFAULT_BYTE_NS 400
+
+/** 小Tag更新负载使用的Tag（max_length不超过16） */
+static const uint16_t s_small_tags[] = {
+    TAG_SYSTEM_MAC_ADDRESS, TAG_SYSTEM_BOOT_COUNT, TAG_SENSOR_CALIB_TEMP, TAG_SENSOR_CALIB_PRESSURE,
+    TAG_SENSOR_CALIB_HUMIDITY, TAG_SENSOR_OFFSET_X, TAG_SENSOR_OFFSET_Y, TAG_SENSOR_OFFSET_Z,
+    TAG_NET_IP_ADDRESS, TAG_NET_SUBNET_MASK, TAG_NET_GATEWAY, TAG_NET_DNS_SERVER,
+};
+
+/** 增长负载使用的Tag（较大的max_length） */
+static const uint16_t s_grow_tags[] = {
+    TAG_USER_HISTORY, TAG_USER_PROFILE, TAG_SYSTEM_CALIBRATION, TAG_USER_SETTINGS,
+};
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+static uint32_t s_seed = 1;
+static uint32_t s_scale = 1;
+static int s_failed = 0;
+static uint8_t s_buf[TLV_BUFFER_SIZE];
+
+/**
+ * @brief 线性同余伪随机数（与主机libc无关,结果可重复）
+ */
+static uint32_t bench_rand(void)
+{
+    s_seed = s_seed * 1103515245u + 12345u;
+    return (s_seed >> 16) & 0x7FFF;
+}
+
+static uint64_t host_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_fill(uint8_t *buf, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++)
+    {
+        buf[i] = (uint8_t)bench_rand();
+    }
+}
+
+static uint16_t tag_max(uint16_t tag)
+{
+    return tlv_get_tag_max_length(tlv_get_meta_table(), tag);
+}
+
+#define BENCH_CHECK(expr)                                                        \
+    do                                                                           \
+    {                                                                            \
+        int bench_ret_ = (expr);                                                 \
+        if (bench_ret_ < 0)                                                      \
+        {                                                                        \
+            printf("  FAILED %s:%d %s -> %d\n", __FILE__, __LINE__, #expr, bench_ret_); \
+            s_failed++;                                                          \
+            return;                                                              \
+        }                                                                        \
+    } while (0)
+
+/* ============================ 计量 ============================ */
+
+typedef struct
+{
+    uint64_t host_ns;
+    bench_port_counters_t port;
+} bench_mark_t;
+
+static void bench_begin(bench_mark_t *mark)
+{
+    bench_port_get_counters(&mark->port);
+    mark->host_ns = host_now_ns();
+}
+
+static void bench_end(const bench_mark_t *mark, const char *name, uint32_t ops)
+{
+    uint64_t host_ns = host_now_ns() - mark->host_ns;
+    bench_port_counters_t now;
+    bench_port_get_counters(&now);
+
+    uint64_t bus_ns = now.bus_ns - mark->port.bus_ns;
+    printf("%-14s %7u %10.1f %10.1f %9.2f %8u %8u %10llu %10llu\n", name, ops,
+           host_ns / 1000.0, bus_ns / 1000.0, ops ? (host_ns + bus_ns) / 1000.0 / ops : 0.0,
+           now.read_txns - mark->port.read_txns, now.write_txns - mark->port.write_txns,
+           (unsigned long long)(now.bytes_read - mark->port.bytes_read),
+           (unsigned long long)(now.bytes_written - mark->port.bytes_written));
+}
+
+/* ============================ 负载 ============================ */
+
+/**
+ * @brief 填充全部Tag,作为各负载的初始状态
+ */
+static int bench_populate(void)
+{
+    bench_port_fill(0);
+    tlv_init();
+    if (tlv_format(0) != TLV_OK || tlv_init() != TLV_INIT_OK)
+    {
+        return TLV_ERROR;
+    }
+
+    const tlv_meta_const_t *meta = tlv_get_meta_table();
+    for (int i = 0; i < tlv_get_meta_table_size(); i++)
+    {
+        // 日志Tag只能追加
+        uint16_t len = meta[i].log_record_size ? meta[i].log_record_size : meta[i].max_length / 2 + 1;
+        bench_fill(s_buf, len);
+        int ret = meta[i].log_record_size ? tlv_append(meta[i].tag, s_buf, len) : tlv_write(meta[i].tag, s_buf, len);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+    }
+
+    return tlv_flush();
+}
+
+/**
+ * @brief 启动：正常关机后重复上电初始化
+ */
+static void bench_boot(void)
+{
+    uint32_t n = 50 * s_scale;
+    BENCH_CHECK(bench_populate());
+    BENCH_CHECK(tlv_deinit());
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (tlv_init() != TLV_INIT_OK)
+        {
+            BENCH_CHECK(TLV_ERROR);
+        }
+        BENCH_CHECK(tlv_deinit());
+    }
+    bench_end(&mark, "boot", n);
+}
+
+/**
+ * @brief 随机小Tag更新（随机长度,偶尔读取）
+ */
+static void bench_small_updates(void)
+{
+    uint32_t n = 10000 * s_scale;
+    BENCH_CHECK(bench_populate());
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint16_t tag = s_small_tags[bench_rand() % ARRAY_SIZE(s_small_tags)];
+        uint16_t len = 1 + bench_rand() % tag_max(tag);
+        bench_fill(s_buf, len);
+        BENCH_CHECK(tlv_write(tag, s_buf, len));
+
+        if ((i & 3) == 0)
+        {
+            uint16_t read_len = sizeof(s_buf);
+            BENCH_CHECK(tlv_read(tag, s_buf, &read_len));
+        }
+    }
+    BENCH_CHECK(tlv_flush());
+    bench_end(&mark, "small_update", n);
+}
+
+/**
+ * @brief 改写结构体中的单个字段：tlv_write_range对照读-改-写整块
+ */
+static void bench_field_update(void)
+{
+    uint32_t n = 5000 * s_scale;
+    uint16_t len = tag_max(TAG_SYSTEM_CALIBRATION);
+    BENCH_CHECK(bench_populate());
+    bench_fill(s_buf, len);
+    BENCH_CHECK(tlv_write(TAG_SYSTEM_CALIBRATION, s_buf, len));
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t value = bench_rand();
+        uint16_t offset = (bench_rand() % (len / 4)) * 4;
+        BENCH_CHECK(tlv_write_range(TAG_SYSTEM_CALIBRATION, offset, &value, sizeof(value)));
+    }
+    BENCH_CHECK(tlv_flush());
+    bench_end(&mark, "field_range", n);
+
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t value = bench_rand();
+        uint16_t offset = (bench_rand() % (len / 4)) * 4;
+        uint16_t read_len = sizeof(s_buf);
+        BENCH_CHECK(tlv_read(TAG_SYSTEM_CALIBRATION, s_buf, &read_len));
+        memcpy(s_buf + offset, &value, sizeof(value));
+        BENCH_CHECK(tlv_write(TAG_SYSTEM_CALIBRATION, s_buf, read_len));
+    }
+    BENCH_CHECK(tlv_flush());
+    bench_end(&mark, "field_rmw", n);
+}
+
+/**
+ * @brief 大Tag逐步增长,空闲时执行增量碎片整理
+ */
+static void bench_grow_defrag(void)
+{
+    uint32_t rounds = 100 * s_scale;
+    uint32_t ops = 0;
+    uint32_t steps = 0;
+    uint32_t compactions = 0;
+    BENCH_CHECK(bench_populate());
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+        for (uint32_t t = 0; t < ARRAY_SIZE(s_grow_tags); t++)
+        {
+            uint16_t tag = s_grow_tags[t];
+            uint16_t max = tag_max(tag);
+            // 每轮变长,旧块释放为空洞；每隔若干轮回到短长度重新增长
+            uint16_t len = (uint16_t)(1 + ((r % 25) * max) / 25 + t);
+            len = (len > max) ? max : len;
+            bench_fill(s_buf, len);
+            BENCH_CHECK(tlv_write(tag, s_buf, len));
+            ops++;
+        }
+
+        // 自动调度的增量整理由空闲任务推进；每个增长周期结束时再显式整理一次
+        while (tlv_defrag_pending())
+        {
+            BENCH_CHECK(tlv_defrag_step(TLV_DEFRAG_SECTION_BYTES));
+            steps++;
+        }
+        if (r % 25 == 24)
+        {
+            BENCH_CHECK(tlv_defragment());
+            compactions++;
+        }
+    }
+    BENCH_CHECK(tlv_flush());
+    bench_end(&mark, "grow_defrag", ops);
+    printf("%-14s %7u auto defrag steps, %u full defrags\n", "", steps, compactions);
+}
+
+/**
+ * @brief 原子批量写入
+ */
+static void bench_batch(void)
+{
+    uint32_t n = 1000 * s_scale;
+    uint16_t tags[8];
+    const void *datas[8];
+    uint16_t lengths[8];
+    static uint8_t data[8][16];
+    STATIC_ASSERT(ARRAY_SIZE(tags) <= TLV_MAX_TXN_ENTRIES, "batch size <= TLV_MAX_TXN_ENTRIES");
+
+    BENCH_CHECK(bench_populate());
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        for (uint32_t k = 0; k < ARRAY_SIZE(tags); k++)
+        {
+            tags[k] = s_small_tags[(i + k) % ARRAY_SIZE(s_small_tags)];
+            lengths[k] = 1 + bench_rand() % tag_max(tags[k]);
+            bench_fill(data[k], lengths[k]);
+            datas[k] = data[k];
+        }
+        BENCH_CHECK(tlv_write_batch(tags, ARRAY_SIZE(tags), datas, lengths));
+    }
+    bench_end(&mark, "batch_x8", n);
+}
+
+/**
+ * @brief 分段写入与读取512字节Tag（32字节一段）
+ */
+static void bench_stream(void)
+{
+    uint32_t n = 200 * s_scale;
+    uint16_t total = tag_max(TAG_USER_HISTORY);
+    BENCH_CHECK(bench_populate());
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        tlv_stream_handle_t h = tlv_write_begin(TAG_USER_HISTORY, total);
+        if (h == TLV_STREAM_INVALID_HANDLE)
+        {
+            BENCH_CHECK(tlv_get_last_error() < 0 ? tlv_get_last_error() : TLV_ERROR);
+        }
+        for (uint16_t pos = 0; pos < total; pos += 32)
+        {
+            uint16_t len = (total - pos < 32) ? (uint16_t)(total - pos) : 32;
+            bench_fill(s_buf, len);
+            BENCH_CHECK(tlv_write_chunk(h, s_buf, len));
+        }
+        BENCH_CHECK(tlv_write_end(h));
+
+        uint16_t read_total;
+        h = tlv_read_begin(TAG_USER_HISTORY, &read_total);
+        if (h == TLV_STREAM_INVALID_HANDLE)
+        {
+            BENCH_CHECK(TLV_ERROR);
+        }
+        for (uint16_t pos = 0; pos < read_total;)
+        {
+            uint16_t len = 32;
+            BENCH_CHECK(tlv_read_chunk(h, s_buf, &len));
+            pos += len;
+        }
+        BENCH_CHECK(tlv_read_end(h));
+    }
+    bench_end(&mark, "stream_512", n);
+}
+
+/**
+ * @brief 高频遥测记录：环形日志追加,对照同样记录用tlv_write整块改写
+ */
+static void bench_log_append(void)
+{
+    uint32_t n = 5000 * s_scale;
+    uint16_t record_size = tlv_get_meta_table()[0].log_record_size;
+    for (int i = 0; i < tlv_get_meta_table_size(); i++)
+    {
+        if (tlv_get_meta_table()[i].log_record_size)
+        {
+            record_size = tlv_get_meta_table()[i].log_record_size;
+        }
+    }
+    BENCH_CHECK(bench_populate());
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        bench_fill(s_buf, record_size);
+        BENCH_CHECK(tlv_append(TAG_USER_EVENT_LOG, s_buf, record_size));
+    }
+    bench_end(&mark, "log_append", n);
+
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        bench_fill(s_buf, record_size);
+        BENCH_CHECK(tlv_write(TAG_USER_HISTORY, s_buf, record_size));
+    }
+    BENCH_CHECK(tlv_flush());
+    bench_end(&mark, "record_write", n);
+}
+
+/**
+ * @brief 大Tag写入与读取分段常数的校准表（TLV_COMPRESS_ENABLE时以压缩形式存储）
+ */
+static void bench_calib_table(void)
+{
+    uint32_t n = 1000 * s_scale;
+    uint16_t len = tag_max(TAG_USER_HISTORY);
+    BENCH_CHECK(bench_populate());
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        // 每16点一段的uint16分段常数表
+        uint16_t value = 0;
+        for (uint16_t k = 0; k + 1 < len; k += 2)
+        {
+            if (k % 32 == 0)
+            {
+                value = (uint16_t)bench_rand();
+            }
+            memcpy(s_buf + k, &value, sizeof(value));
+        }
+        BENCH_CHECK(tlv_write(TAG_USER_HISTORY, s_buf, len));
+
+        uint16_t read_len = sizeof(s_buf);
+        BENCH_CHECK(tlv_read(TAG_USER_HISTORY, s_buf, &read_len));
+    }
+    BENCH_CHECK(tlv_flush());
+    bench_end(&mark, "calib_table", n);
+}
+
+/** 产线写入负载使用的数据镜像 */
+static uint8_t s_image[8192];
+static uint32_t s_image_len;
+static uint32_t s_image_pos;
+
+static int image_write(const void *data, uint16_t len, void *user_data)
+{
+    (void)user_data;
+    if (s_image_len + len > sizeof(s_image))
+    {
+        return -1;
+    }
+    memcpy(s_image + s_image_len, data, len);
+    s_image_len += len;
+    return 0;
+}
+
+static int image_read(void *buf, uint16_t len, void *user_data)
+{
+    (void)user_data;
+    if (s_image_pos + len > s_image_len)
+    {
+        return -1;
+    }
+    memcpy(buf, s_image + s_image_pos, len);
+    s_image_pos += len;
+    return 0;
+}
+
+/**
+ * @brief 产线写入：空存储上写入全部普通Tag,按TLV_MAX_TXN_ENTRIES分批写入与导入数据镜像对比
+ */
+static void bench_provision(void)
+{
+    uint32_t n = 50 * s_scale;
+    const tlv_meta_const_t *meta = tlv_get_meta_table();
+    int meta_count = tlv_get_meta_table_size();
+    static uint8_t data[TLV_MAX_META_COUNT][64];
+    uint16_t tags[TLV_MAX_TXN_ENTRIES];
+    const void *datas[TLV_MAX_TXN_ENTRIES];
+    uint16_t lengths[TLV_MAX_TXN_ENTRIES];
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        bench_port_fill(0);
+        tlv_init();
+        BENCH_CHECK(tlv_format(0));
+        if (tlv_init() != TLV_INIT_OK)
+        {
+            BENCH_CHECK(TLV_ERROR);
+        }
+
+        uint16_t count = 0;
+        for (int k = 0; k < meta_count; k++)
+        {
+            if (meta[k].log_record_size != 0)
+            {
+                continue;
+            }
+            tags[count] = meta[k].tag;
+            lengths[count] = (meta[k].max_length < sizeof(data[k])) ? meta[k].max_length : sizeof(data[k]);
+            bench_fill(data[k], lengths[count]);
+            datas[count] = data[k];
+            if (++count == TLV_MAX_TXN_ENTRIES)
+            {
+                BENCH_CHECK(tlv_write_batch(tags, count, datas, lengths));
+                count = 0;
+            }
+        }
+        if (count > 0)
+        {
+            BENCH_CHECK(tlv_write_batch(tags, count, datas, lengths));
+        }
+        BENCH_CHECK(tlv_flush());
+    }
+    bench_end(&mark, "prov_batch", n);
+
+    // 最后一次分批写入的结果作为镜像
+    s_image_len = 0;
+    BENCH_CHECK(tlv_export_image(image_write, NULL));
+
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        bench_port_fill(0);
+        tlv_init();
+        BENCH_CHECK(tlv_format(0));
+        if (tlv_init() != TLV_INIT_OK)
+        {
+            BENCH_CHECK(TLV_ERROR);
+        }
+
+        s_image_pos = 0;
+        BENCH_CHECK(tlv_import_image(image_read, NULL));
+    }
+    bench_end(&mark, "prov_image", n);
+}
+
+/**
+ * @brief 全量校验
+ */
+static void bench_verify(void)
+{
+    uint32_t n = 50 * s_scale;
+    uint32_t corrupted;
+    BENCH_CHECK(bench_populate());
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        BENCH_CHECK(tlv_verify_all(&corrupted));
+    }
+    bench_end(&mark, "verify_all", n);
+}
+
+/* ============================ 掉电注入 ============================ */
+
+static uint32_t s_cut_trials = 300;
+
+#if TLV_JOURNAL_ENABLE
+/** 掉电注入负载使用的Tag（小Tag与增长Tag） */
+#define CUT_TAG_COUNT (ARRAY_SIZE(s_small_tags) + ARRAY_SIZE(s_grow_tags))
+
+/** 掉电注入的模型：各Tag已提交的值（长度0表示不存在） */
+static uint8_t s_cut_model[CUT_TAG_COUNT][TLV_BUFFER_SIZE];
+static uint16_t s_cut_model_len[CUT_TAG_COUNT];
+
+/** 中断的操作试图写入的新值 */
+static uint8_t s_cut_new[CUT_TAG_COUNT][TLV_BUFFER_SIZE];
+static uint16_t s_cut_new_len[CUT_TAG_COUNT];
+
+/** 备份区中的值（备份恢复后各Tag应回到这里） */
+static uint8_t s_cut_backup[CUT_TAG_COUNT][TLV_BUFFER_SIZE];
+static uint16_t s_cut_backup_len[CUT_TAG_COUNT];
+static uint32_t s_cut_touched;
+static uint32_t s_cut_op;
+/** 中断的操作是否须原子生效（批量写入与事务） */
+static bool s_cut_atomic;
+
+static uint16_t cut_tag(uint32_t k)
+{
+    return (k < ARRAY_SIZE(s_small_tags)) ? s_small_tags[k] : s_grow_tags[k - ARRAY_SIZE(s_small_tags)];
+}
+
+/**
+ * @brief 为Tag生成新值（长度0表示删除）并记入中断操作的新值
+ */
+static void cut_stage(uint32_t k, uint16_t len)
+{
+    s_cut_new_len[k] = len;
+    bench_fill(s_cut_new[k], len);
+    s_cut_touched |= 1UL << k;
+}
+
+/**
+ * @brief 执行一个随机操作（写入、删除、批量写入、分段写入、整理、落盘、备份、从备份恢复、事务或正常关机）
+ * @return 0: 成功或已掉电（掉电后的返回值没有意义）, 其他: 错误码
+ */
+static int cut_run_op(void)
+{
+    uint32_t op = bench_rand() % 14;
+    s_cut_op = op;
+    uint32_t k = bench_rand() % CUT_TAG_COUNT;
+    uint16_t len = 1 + bench_rand() % tag_max(cut_tag(k));
+    int ret = TLV_OK;
+
+    s_cut_touched = 0;
+    s_cut_atomic = false;
+    switch (op)
+    {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+        cut_stage(k, len);
+        ret = tlv_write(cut_tag(k), s_cut_new[k], len);
+        break;
+    case 4:
+        cut_stage(k, 0);
+        ret = tlv_delete(cut_tag(k));
+        ret = (ret == TLV_ERROR_NOT_FOUND && s_cut_model_len[k] == 0) ? TLV_OK : ret;
+        break;
+    case 5:
+    {
+        uint16_t tags[4];
+        const void *datas[4];
+        uint16_t lengths[4];
+        for (uint32_t i = 0; i < ARRAY_SIZE(tags); i++)
+        {
+            uint32_t t = (k + i) % ARRAY_SIZE(s_small_tags);
+            cut_stage(t, 1 + bench_rand() % tag_max(s_small_tags[t]));
+            tags[i] = s_small_tags[t];
+            datas[i] = s_cut_new[t];
+            lengths[i] = s_cut_new_len[t];
+        }
+        s_cut_atomic = true;
+        ret = tlv_write_batch(tags, ARRAY_SIZE(tags), datas, lengths);
+        break;
+    }
+    case 6:
+    {
+        cut_stage(k, len);
+        tlv_stream_handle_t h = tlv_write_begin(cut_tag(k), len);
+        if (h == TLV_STREAM_INVALID_HANDLE)
+        {
+            return bench_port_power_lost() ? TLV_OK : TLV_ERROR;
+        }
+        for (uint16_t pos = 0; pos < len && ret == TLV_OK; pos += 32)
+        {
+            ret = tlv_write_chunk(h, s_cut_new[k] + pos, (len - pos < 32) ? (uint16_t)(len - pos) : 32);
+        }
+        ret = (ret == TLV_OK) ? tlv_write_end(h) : ret;
+        break;
+    }
+    case 7:
+        ret = tlv_defrag_step(TLV_DEFRAG_SECTION_BYTES);
+        ret = (ret > 0) ? TLV_OK : ret;
+        break;
+    case 8:
+        ret = tlv_defragment();
+        break;
+    case 9:
+        ret = tlv_flush();
+        break;
+    case 10:
+        ret = tlv_backup_all();
+        break;
+    case 11:
+        // 恢复后各Tag回到备份区中的值
+        for (uint32_t i = 0; i < CUT_TAG_COUNT; i++)
+        {
+            s_cut_new_len[i] = s_cut_backup_len[i];
+            memcpy(s_cut_new[i], s_cut_backup[i], s_cut_backup_len[i]);
+        }
+        s_cut_touched = (1UL << CUT_TAG_COUNT) - 1;
+        ret = tlv_restore_from_backup();
+        break;
+    case 12:
+        s_cut_atomic = true;
+        ret = tlv_txn_begin();
+        for (uint32_t i = 0; i < 3 && ret == TLV_OK; i++)
+        {
+            uint32_t t = (k + i) % CUT_TAG_COUNT;
+            cut_stage(t, 1 + bench_rand() % tag_max(cut_tag(t)));
+            ret = tlv_txn_write(cut_tag(t), s_cut_new[t], s_cut_new_len[t]);
+        }
+        ret = (ret == TLV_OK) ? tlv_txn_commit() : ret;
+        if (ret != TLV_OK && !bench_port_power_lost())
+        {
+            tlv_txn_abort();
+        }
+        break;
+    default:
+        ret = tlv_deinit();
+        if (ret == TLV_OK && tlv_init() != TLV_INIT_OK)
+        {
+            ret = TLV_ERROR;
+        }
+        break;
+    }
+
+    return bench_port_power_lost() ? TLV_OK : ret;
+}
+
+/**
+ * @brief 以当前模型作为备份区中的值
+ */
+static void cut_snapshot_backup(void)
+{
+    memcpy(s_cut_backup_len, s_cut_model_len, sizeof(s_cut_backup_len));
+    for (uint32_t k = 0; k < CUT_TAG_COUNT; k++)
+    {
+        memcpy(s_cut_backup[k], s_cut_model[k], s_cut_model_len[k]);
+    }
+}
+
+/**
+ * @brief 重新上电后逐个核对Tag
+ *
+ * 未恢复时中断操作涉及的Tag为旧值或新值之一,其余Tag为旧值,批量写入与事务的Tag须全部为旧值或全部为新值。
+ * 从备份恢复时各Tag为备份区中的值；中断操作写过备份区时也可为操作前的值
+ * （差量备份逐页写入,中断的备份可能只更新了部分页）。
+ * @param restored 是否已从备份恢复
+ * @param backed_up 中断的操作是否写过备份区
+ * @return 0: 一致, 其他: 不一致
+ */
+static int cut_check(bool restored, bool backed_up)
+{
+    bool kept = false;
+    bool applied = false;
+    for (uint32_t k = 0; k < CUT_TAG_COUNT; k++)
+    {
+        uint16_t len = sizeof(s_buf);
+        int ret = tlv_read(cut_tag(k), s_buf, &len);
+        if (ret == TLV_ERROR_NOT_FOUND)
+        {
+            len = 0;
+        }
+        else if (ret != TLV_OK)
+        {
+            printf("  FAILED tag 0x%04X unreadable after power cut in op %u -> %d\n", cut_tag(k), s_cut_op, ret);
+            return TLV_ERROR;
+        }
+
+        bool is_old = (len == s_cut_model_len[k] && memcmp(s_buf, s_cut_model[k], len) == 0);
+        if (restored)
+        {
+            bool is_backup = (len == s_cut_backup_len[k] && memcmp(s_buf, s_cut_backup[k], len) == 0);
+            if (!is_backup && !(backed_up && is_old))
+            {
+                printf("  FAILED tag 0x%04X differs from backup (%u bytes) after restore in op %u (%u bytes)\n",
+                       cut_tag(k), s_cut_backup_len[k], s_cut_op, len);
+                return TLV_ERROR;
+            }
+
+            // 恢复时备份区内容复制到管理区,读到的值即备份区中的值
+            s_cut_backup_len[k] = len;
+            memcpy(s_cut_backup[k], s_buf, len);
+        }
+        else
+        {
+            bool touched = (s_cut_touched & (1UL << k)) != 0;
+            bool is_new = touched && len == s_cut_new_len[k] && memcmp(s_buf, s_cut_new[k], len) == 0;
+            if (!is_old && !is_new)
+            {
+                printf("  FAILED tag 0x%04X is neither old (%u bytes) nor new value after power cut in op %u (%u bytes)\n",
+                       cut_tag(k), s_cut_model_len[k], s_cut_op, len);
+                return TLV_ERROR;
+            }
+            kept = kept || (touched && !is_new);
+            applied = applied || (is_new && !is_old);
+        }
+
+        s_cut_model_len[k] = len;
+        memcpy(s_cut_model[k], s_buf, len);
+    }
+
+    if (s_cut_atomic && kept && applied)
+    {
+        printf("  FAILED op %u partially applied after power cut\n", s_cut_op);
+        return TLV_ERROR;
+    }
+
+    return TLV_OK;
+}
+
+/**
+ * @brief 掉电注入：随机操作中让某次写入只落下一段前缀后断电,重新上电后检查数据
+ *
+ * 覆盖提交日志重放、事务日志重放、增量整理、差量备份与备份恢复。
+ * 写入备份区的操作（备份、整理以及写入时触发的整理）使备份区回到操作前的模型；
+ * 备份恢复（TLV_INIT_RECOVERED）须回到备份区中的值,之后以读到的值作为新的模型。
+ */
+static void bench_power_cut(void)
+{
+    uint32_t cuts = 0;
+    uint32_t recovered = 0;
+    uint32_t ops = 0;
+    BENCH_CHECK(bench_populate());
+    BENCH_CHECK(tlv_backup_all());
+    s_cut_touched = 0;
+    memset(s_cut_model_len, 0, sizeof(s_cut_model_len));
+    memset(s_cut_new_len, 0, sizeof(s_cut_new_len));
+    for (uint32_t k = 0; k < CUT_TAG_COUNT; k++)
+    {
+        s_cut_model_len[k] = sizeof(s_cut_model[k]);
+        int ret = tlv_read(cut_tag(k), s_cut_model[k], &s_cut_model_len[k]);
+        BENCH_CHECK(ret);
+    }
+    cut_snapshot_backup();
+    bench_port_set_watch(TLV_BACKUP_ADDR, TLV_DATA_REGION_SIZE);
+
+    bench_mark_t mark;
+    bench_begin(&mark);
+    while (cuts < s_cut_trials * s_scale)
+    {
+        bench_port_set_power_cut(1 + bench_rand() % 24, bench_rand() % 300);
+        bench_port_take_watch_hits();
+        BENCH_CHECK(cut_run_op());
+        bool backed_up = bench_port_take_watch_hits() > 0;
+        ops++;
+
+        if (!bench_port_power_lost())
+        {
+            bench_port_set_power_cut(0, 0);
+            if (backed_up)
+            {
+                cut_snapshot_backup();
+            }
+            for (uint32_t k = 0; k < CUT_TAG_COUNT; k++)
+            {
+                if (s_cut_touched & (1UL << k))
+                {
+                    s_cut_model_len[k] = s_cut_new_len[k];
+                    memcpy(s_cut_model[k], s_cut_new[k], s_cut_new_len[k]);
+                }
+            }
+            continue;
+        }
+
+        cuts++;
+        bench_port_power_on();
+        tlv_init_result_t result = tlv_init();
+        if (result == TLV_INIT_RECOVERED)
+        {
+            recovered++;
+            BENCH_CHECK(cut_check(true, backed_up));
+            continue;
+        }
+        if (result != TLV_INIT_OK)
+        {
+            printf("  FAILED tlv_init after power cut -> %d\n", result);
+            BENCH_CHECK(TLV_ERROR);
+        }
+        BENCH_CHECK(cut_check(false, backed_up));
+
+        // 中断的备份可能只更新了部分页,重新备份使备份区中的值确定
+        if (backed_up)
+        {
+            BENCH_CHECK(tlv_backup_all());
+            cut_snapshot_backup();
+        }
+    }
+    bench_port_set_watch(0, 0);
+    bench_end(&mark, "power_cut", ops);
+    printf("%-14s %7u power cuts, %u restored from backup\n", "", cuts, recovered);
+}
+#else
+/**
+ * @brief 未启用提交日志时更新与整理原地进行,掉电后不保证旧值或新值之一,跳过掉电注入
+ */
+static void bench_power_cut(void)
+{
+    printf("%-14s skipped (TLV_JOURNAL_ENABLE=0: in-place updates are not power-safe)\n", "power_cut");
+}
+#endif
+
+#if TLV_PERF_STATS
+/**
+ * @brief 打印存储系统自身的性能统计（tick为模拟总线纳秒）
+ */
+static void bench_print_perf(void)
+{
+    static const char *const names[TLV_PERF_OP_COUNT] = {
+        "read", "write", "delete", "flush", "defrag", "backup", "verify", "migrate", "port_read", "port_write",
+    };
+    tlv_perf_stats_t stats;
+    if (tlv_get_perf_stats(&stats) != TLV_OK)
+    {
+        return;
+    }
+
+    printf("\n%-14s %8s %8s %10s %10s %10s\n", "perf op", "count", "errors", "min_ns", "avg_ns", "max_ns");
+    for (int i = 0; i < TLV_PERF_OP_COUNT; i++)
+    {
+        const tlv_perf_op_stats_t *s = &stats.ops[i];
+        if (s->count)
+        {
+            printf("%-14s %8u %8u %10u %10u %10u\n", names[i], s->count, s->errors, s->min_ticks, s->avg_ticks,
+                   s->max_ticks);
+        }
+    }
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    uint32_t txn_ns = BENCH_DEFAULT_TXN_NS;
+    uint32_t byte_ns = BENCH_DEFAULT_BYTE_NS;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        uint32_t value = (uint32_t)strtoul(argv[i + 1], NULL, 0);
+        if (strcmp(argv[i], "-t") == 0)
+        {
+            txn_ns = value;
+        }
+        else if (strcmp(argv[i], "-b") == 0)
+        {
+            byte_ns = value;
+        }
+        else if (strcmp(argv[i], "-n") == 0 && value > 0)
+        {
+            s_scale = value;
+        }
+        else if (strcmp(argv[i], "-s") == 0)
+        {
+            s_seed = value;
+        }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            s_cut_trials = value;
+        }
+        else
+        {
+            printf("usage: %s [-t txn_ns] [-b byte_ns] [-n scale] [-s seed] [-c power_cuts]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bench_port_set_latency(txn_ns, byte_ns);
+    printf("TLV bench v%s: txn=%uns byte=%uns scale=%u seed=%u\n\n", TLV_FILE_SYSTEM_VERSION, txn_ns, byte_ns,
+           s_scale, s_seed);
+    printf("%-14s %7s %10s %10s %9s %8s %8s %10s %10s\n", "workload", "ops", "host_us", "bus_us", "us/op",
+           "rd_txn", "wr_txn", "rd_bytes", "wr_bytes");
+
+    bench_boot();
+    bench_small_updates();
+    bench_field_update();
+    bench_grow_defrag();
+    bench_batch();
+    bench_stream();
+    bench_log_append();
+    bench_calib_table();
+    bench_provision();
+    bench_verify();
+    bench_power_cut();
+
+#if TLV_PERF_STATS
+    bench_print_perf();
+#endif
+
+    tlv_deinit();
+    if (s_failed)
+    {
+        printf("\n%d workload(s) failed\n", s_failed);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file tlv_mkimage.c
+ * @brief 主机端数据镜像生成工具：按元数据表把数据文件写入RAM模拟的FRAM,再导出为tlv_import_image()的镜像
+ *
+ * 用法：tlv_mkimage -o 镜像文件 <Tag>=<数据文件> ...
+ *       tlv_mkimage -l                                  列出元数据表
+ * Tag为元数据表中的名称（如SystemConfig）或数值（如0x1001）。
+ * 工具与目标固件须使用相同的元数据表与tlv_config.h配置（例如是否启用TLV_COMPRESS_ENABLE）。
+ */
+
+#include "tlv_file_system.h"
+#include "bench_port.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint8_t s_data[TLV_BUFFER_SIZE > 4096 ? TLV_BUFFER_SIZE : 4096];
+
+/**
+ * @brief 镜像输出回调：写入镜像文件
+ */
+static int image_write(const void *data, uint16_t len, void *user_data)
+{
+    return (fwrite(data, 1, len, (FILE *)user_data) == len) ? 0 : -1;
+}
+
+/**
+ * @brief 解析Tag：元数据表名称或数值
+ * @return Tag值,0xFFFF表示不在元数据表中
+ */
+static uint16_t parse_tag(const char *text)
+{
+    const tlv_meta_const_t *meta_table = tlv_get_meta_table();
+    char *end;
+    unsigned long value = strtoul(text, &end, 0);
+    if (*end == '\0' && value > 0 && value < 0xFFFF)
+    {
+        return tlv_meta_find(meta_table, (uint16_t)value) ? (uint16_t)value : 0xFFFF;
+    }
+
+    return tlv_find_tag_by_name(meta_table, text);
+}
+
+/**
+ * @brief 写入一个数据文件（日志Tag按record_size拆分为多条记录追加）
+ */
+static int add_file(uint16_t tag, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        printf("cannot open %s\n", path);
+        return TLV_ERROR;
+    }
+
+    size_t size = fread(s_data, 1, sizeof(s_data), file);
+    int truncated = !feof(file);
+    fclose(file);
+
+    const tlv_meta_const_t *meta = tlv_meta_find(tlv_get_meta_table(), tag);
+    uint16_t limit = meta->log_record_size ? (uint16_t)sizeof(s_data) : meta->max_length;
+    if (size == 0 || truncated || size > limit)
+    {
+        printf("%s: size must be 1..%u bytes for %s\n", path, limit, meta->name);
+        return TLV_ERROR_INVALID_PARAM;
+    }
+
+    if (meta->log_record_size == 0)
+    {
+        return tlv_write(tag, s_data, (uint16_t)size);
+    }
+
+    for (size_t offset = 0; offset < size; offset += meta->log_record_size)
+    {
+        size_t len = size - offset;
+        if (len > meta->log_record_size)
+        {
+            len = meta->log_record_size;
+        }
+        int ret = tlv_append(tag, s_data + offset, (uint16_t)len);
+        if (ret != TLV_OK)
+        {
+            return ret;
+        }
+    }
+
+    return TLV_OK;
+}
+
+static void list_meta(void)
+{
+    const tlv_meta_const_t *meta = tlv_get_meta_table();
+    printf("%-20s %-6s %7s %4s %s\n", "name", "tag", "max_len", "ver", "kind");
+    for (int i = 0; i < tlv_get_meta_table_size(); i++)
+    {
+        printf("%-20s 0x%04X %7u %4u %s\n", meta[i].name ? meta[i].name : "", meta[i].tag, meta[i].max_length,
+               meta[i].version, meta[i].log_record_size ? "log" : "data");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *output = NULL;
+    int first_input = argc;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-l") == 0)
+        {
+            list_meta();
+            return 0;
+        }
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output = argv[++i];
+            continue;
+        }
+        first_input = i;
+        break;
+    }
+
+    if (!output || first_input >= argc)
+    {
+        printf("usage: %s -o image <tag>=<file> ...\n       %s -l\n", argv[0], argv[0]);
+        return 2;
+    }
+
+    bench_port_fill(0);
+    tlv_init();
+    if (tlv_format(0) != TLV_OK || tlv_init() != TLV_INIT_OK)
+    {
+        printf("storage init failed\n");
+        return 1;
+    }
+
+    for (int i = first_input; i < argc; i++)
+    {
+        char *sep = strchr(argv[i], '=');
+        if (!sep)
+        {
+            printf("bad argument %s, expected <tag>=<file>\n", argv[i]);
+            return 2;
+        }
+        *sep = '\0';
+
+        uint16_t tag = parse_tag(argv[i]);
+        if (tag == 0xFFFF)
+        {
+            printf("unknown tag %s (see -l)\n", argv[i]);
+            return 2;
+        }
+
+        int ret = add_file(tag, sep + 1);
+        if (ret != TLV_OK)
+        {
+            printf("%s: write failed (%d)\n", argv[i], ret);
+            return 1;
+        }
+    }
+
+    FILE *file = fopen(output, "wb");
+    if (!file)
+    {
+        printf("cannot create %s\n", output);
+        return 1;
+    }
+
+    int ret = tlv_export_image(image_write, file);
+    if (fclose(file) != 0 || ret != TLV_OK)
+    {
+        printf("export failed (%d)\n", ret);
+        remove(output);
+        return 1;
+    }
+
+    printf("%s: %u tags\n", output, (unsigned)(argc - first_input));
+    tlv_deinit();
+    return 0;
+}
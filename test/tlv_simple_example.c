@@ -4,6 +4,7 @@
  */
 
 #include "tlv_file_system.h"
+#include "tlv_meta_list.h"
 #include <string.h>
 
 // 假设这些是你在port.c中实现的硬件接口
@@ -57,6 +58,16 @@ void example_usage(void)
     uint16_t len = sizeof(read_config);
     tlv_read(TAG_SYSTEM_CONFIG, &read_config, &len);
 
+    // 类型化访问（由tlv_meta_list.h生成,长度在编译时检查）
+    uint32_t boot_count = 0;
+    tlv_get_BootCount(&boot_count);
+    boot_count++;
+    tlv_set_BootCount(&boot_count);
+
+    // 按范围读取（只传输需要的字段,如配置的高16位）
+    uint16_t config_hi;
+    tlv_read_range(TAG_SYSTEM_CONFIG, 2, &config_hi, sizeof(config_hi));
+
     // 批量操作（简化）
     float offsets[3] = {1.0f, 2.0f, 3.0f};
     uint16_t tags[] = {TAG_SENSOR_OFFSET_X, TAG_SENSOR_OFFSET_Y, TAG_SENSOR_OFFSET_Z};